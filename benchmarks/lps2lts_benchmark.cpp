@@ -0,0 +1,375 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file lps2lts_benchmark.cpp
+/// \brief Measures the performance of lps2lts_algorithm on scalable families of linear processes.
+///
+/// Usage: lps2lts_benchmark [--quick] [--family NAME] [--output FILE]
+///
+/// For every family, size, rewrite strategy and with and without enumeration caching the state
+/// space is generated, and the results are written as JSON.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+#include "mcrl2/atermpp/detail/aterm_implementation.h"
+#include "mcrl2/data/detail/rewrite.h"
+#include "mcrl2/lps/parse.h"
+#include "mcrl2/lts/detail/exploration.h"
+#include "mcrl2/utilities/logger.h"
+
+#include "../libraries/lps/test/test_specifications.h"
+
+using namespace mcrl2;
+
+// A rewriter that measures the time spent in the wrapped rewriter.
+class timing_rewriter: public data::detail::Rewriter
+{
+  protected:
+    std::shared_ptr<data::detail::Rewriter> m_rewriter;
+
+  public:
+    static double& rewrite_time()
+    {
+      static double result = 0.0;
+      return result;
+    }
+
+    static std::size_t& rewrite_calls()
+    {
+      static std::size_t result = 0;
+      return result;
+    }
+
+    timing_rewriter(const data::data_specification& dataspec, const std::shared_ptr<data::detail::Rewriter>& rewriter)
+      : data::detail::Rewriter(dataspec, rewriter->data_equation_selector),
+        m_rewriter(rewriter)
+    {}
+
+    data::rewrite_strategy getStrategy() override
+    {
+      return m_rewriter->getStrategy();
+    }
+
+    data::data_expression rewrite(const data::data_expression& term, substitution_type& sigma) override
+    {
+      auto start = std::chrono::steady_clock::now();
+      data::data_expression result = m_rewriter->rewrite(term, sigma);
+      rewrite_time() += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      rewrite_calls()++;
+      return result;
+    }
+};
+
+class timed_rewriter: public data::rewriter
+{
+  public:
+    timed_rewriter(const data::data_specification& dataspec, const data::rewriter& r)
+      : data::rewriter(r)
+    {
+      m_rewriter = std::make_shared<timing_rewriter>(dataspec, m_rewriter);
+    }
+};
+
+// A next state generator that uses a timed_rewriter.
+template <typename NextStateGenerator>
+class timed_next_state_generator: public NextStateGenerator
+{
+  public:
+    timed_next_state_generator(const lps::specification& spec, const data::rewriter& r)
+      : NextStateGenerator(spec, timed_rewriter(spec.data(), r))
+    {}
+};
+
+struct benchmark_result
+{
+  std::string family;
+  std::size_t size;
+  std::string rewriter;
+  bool cached;
+  std::size_t states;
+  std::size_t transitions;
+  double time;
+  double rewrite_time;
+  std::size_t rewrite_calls;
+  std::size_t peak_rss; // in kilobytes
+  std::size_t aterm_nodes;
+  std::size_t aterm_table_size;
+};
+
+// Resets the peak resident set size, if the platform supports it.
+inline
+void reset_peak_rss()
+{
+#ifdef __linux__
+  std::ofstream out("/proc/self/clear_refs");
+  out << "5";
+#endif
+}
+
+// Returns the peak resident set size in kilobytes since the last call of reset_peak_rss.
+inline
+std::size_t peak_rss()
+{
+#ifdef __linux__
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+    {
+      return std::stoul(line.substr(6));
+    }
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+#else
+  return 0;
+#endif
+}
+
+// A pipeline of n one place buffers with data values 0 .. d - 1.
+inline
+std::string buffers(std::size_t n, std::size_t d)
+{
+  std::ostringstream out;
+  out << "act r, s: Nat;\n"
+      << "proc P(";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (i > 1 ? ", " : "") << "b" << i;
+  }
+  out << ": Nat) =\n"
+      << "    sum d: Nat . (d < " << d << " && b1 == 0) -> r(d) . P(b1 = d + 1)\n";
+  for (std::size_t i = 1; i < n; i++)
+  {
+    out << "  + (b" << i << " > 0 && b" << i + 1 << " == 0) -> tau . P(b" << i << " = 0, b" << i + 1 << " = b" << i << ")\n";
+  }
+  out << "  + (b" << n << " > 0) -> s(Int2Nat(b" << n << " - 1)) . P(b" << n << " = 0);\n"
+      << "init P(";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (i > 1 ? ", " : "") << "0";
+  }
+  out << ");\n";
+  return out.str();
+}
+
+// The dining philosophers with n philosophers. Philosopher i is thinking (0), holds the
+// left fork (1) or is eating (2). The variable fi is true if fork i is on the table.
+inline
+std::string dining_philosophers(std::size_t n)
+{
+  std::ostringstream out;
+  out << "act get, eat: Nat;\n"
+      << "proc P(";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (i > 1 ? ", " : "") << "p" << i;
+  }
+  out << ": Nat, ";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (i > 1 ? ", " : "") << "f" << i;
+  }
+  out << ": Bool) =\n";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    std::size_t j = i % n + 1;
+    out << (i > 1 ? "  + " : "    ") << "(p" << i << " == 0 && f" << i << ") -> get(" << i << ") . P(p" << i << " = 1, f" << i << " = false)\n"
+        << "  + (p" << i << " == 1 && f" << j << ") -> get(" << j << ") . P(p" << i << " = 2, f" << j << " = false)\n"
+        << "  + (p" << i << " == 2) -> eat(" << i << ") . P(p" << i << " = 0, f" << i << " = true, f" << j << " = true)\n";
+  }
+  out << ";\ninit P(";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (i > 1 ? ", " : "") << "0";
+  }
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << ", true";
+  }
+  out << ");\n";
+  return out.str();
+}
+
+// The alternating bit protocol of test_specifications.h with n data values.
+inline
+std::string alternating_bit_protocol(std::size_t n)
+{
+  std::string text = LINEAR_ABP;
+  std::string domain = "D = struct d1 | d2;";
+  std::ostringstream out;
+  out << "D = struct ";
+  for (std::size_t i = 1; i <= n; i++)
+  {
+    out << (i > 1 ? " | " : "") << "d" << i;
+  }
+  out << ";";
+  text.replace(text.find(domain), domain.size(), out.str());
+  return text;
+}
+
+struct benchmark_family
+{
+  std::string name;
+  std::vector<std::size_t> sizes;
+  std::vector<std::size_t> quick_sizes;
+  std::string (*generate)(std::size_t);
+};
+
+inline std::string buffers_of_size(std::size_t n) { return buffers(n, 4); }
+
+template <typename NextStateGenerator>
+benchmark_result run_benchmark(const lps::specification& spec, data::rewrite_strategy strategy)
+{
+  lts::lts_generation_options options;
+  options.specification = spec;
+  options.strat = strategy;
+  options.use_enumeration_caching = std::is_same<NextStateGenerator, lps::cached_next_state_generator>::value;
+
+  timing_rewriter::rewrite_time() = 0.0;
+  timing_rewriter::rewrite_calls() = 0;
+  reset_peak_rss();
+  lts::lps2lts_algorithm<timed_next_state_generator<NextStateGenerator> > algorithm;
+  auto start = std::chrono::steady_clock::now();
+  algorithm.generate_lts(options);
+  double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  benchmark_result result;
+  result.rewriter = data::pp(strategy);
+  result.cached = options.use_enumeration_caching;
+  result.states = algorithm.number_of_states();
+  result.transitions = algorithm.number_of_transitions();
+  result.time = time;
+  result.rewrite_time = timing_rewriter::rewrite_time();
+  result.rewrite_calls = timing_rewriter::rewrite_calls();
+  result.peak_rss = peak_rss();
+  result.aterm_nodes = atermpp::detail::total_nodes_in_hashtable;
+  result.aterm_table_size = atermpp::detail::aterm_table_size;
+  return result;
+}
+
+inline
+void write_json(std::ostream& out, const std::vector<benchmark_result>& results)
+{
+  out << "{\n  \"benchmark\": \"lps2lts\",\n  \"results\": [\n";
+  for (std::size_t i = 0; i < results.size(); i++)
+  {
+    const benchmark_result& r = results[i];
+    out << "    {\"family\": \"" << r.family << "\", \"size\": " << r.size
+        << ", \"rewriter\": \"" << r.rewriter << "\", \"cached\": " << (r.cached ? "true" : "false")
+        << ", \"states\": " << r.states << ", \"transitions\": " << r.transitions
+        << ", \"time\": " << r.time
+        << ", \"states_per_second\": " << (r.time > 0 ? r.states / r.time : 0.0)
+        << ", \"transitions_per_second\": " << (r.time > 0 ? r.transitions / r.time : 0.0)
+        << ", \"rewrite_time\": " << r.rewrite_time << ", \"rewrite_calls\": " << r.rewrite_calls
+        << ", \"peak_rss_kb\": " << r.peak_rss
+        << ", \"aterm_nodes\": " << r.aterm_nodes << ", \"aterm_table_size\": " << r.aterm_table_size << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+  bool quick = false;
+  std::string family_name;
+  std::string output_filename;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--quick") == 0)
+    {
+      quick = true;
+    }
+    else if (std::strcmp(argv[i], "--family") == 0 && i + 1 < argc)
+    {
+      family_name = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+    {
+      output_filename = argv[++i];
+    }
+    else
+    {
+      std::cerr << "Usage: " << argv[0] << " [--quick] [--family buffers|philosophers|abp] [--output FILE]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  const std::vector<benchmark_family> families = {
+    { "buffers", { 2, 3, 4, 5, 6 }, { 2, 3 }, buffers_of_size },
+    { "philosophers", { 3, 4, 5, 6, 7, 8 }, { 3, 4 }, dining_philosophers },
+    { "abp", { 2, 4, 8, 16 }, { 2, 4 }, alternating_bit_protocol }
+  };
+
+  std::vector<data::rewrite_strategy> strategies = { data::jitty, data::jitty_prover };
+#ifdef MCRL2_JITTYC_AVAILABLE
+  strategies.push_back(data::jitty_compiling);
+#endif
+
+  log::mcrl2_logger::set_reporting_level(log::warning);
+
+  std::vector<benchmark_result> results;
+  try
+  {
+    for (const benchmark_family& family: families)
+    {
+      if (!family_name.empty() && family.name != family_name)
+      {
+        continue;
+      }
+      for (std::size_t size: quick ? family.quick_sizes : family.sizes)
+      {
+        lps::specification spec = lps::parse_linear_process_specification(family.generate(size));
+        for (data::rewrite_strategy strategy: strategies)
+        {
+          for (bool cached: { false, true })
+          {
+            benchmark_result result = cached ? run_benchmark<lps::cached_next_state_generator>(spec, strategy)
+                                             : run_benchmark<lps::next_state_generator>(spec, strategy);
+            result.family = family.name;
+            result.size = size;
+            std::cerr << family.name << " " << size << " " << result.rewriter << (cached ? " cached" : "") << ": "
+                      << result.states << " states in " << result.time << "s" << std::endl;
+            results.push_back(result);
+          }
+        }
+      }
+    }
+  }
+  catch (mcrl2::runtime_error& e)
+  {
+    std::cerr << "error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (output_filename.empty())
+  {
+    write_json(std::cout, results);
+  }
+  else
+  {
+    std::ofstream out(output_filename);
+    write_json(out, results);
+  }
+  return EXIT_SUCCESS;
+}
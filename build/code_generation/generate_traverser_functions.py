@@ -359,6 +359,22 @@ std::set<data::function_symbol> find_function_symbols(const T& x)
 }
 '''
 
+# Specifications in the lps and process libraries are large and maximally shared.
+# For these the replace and find functions use builders and traversers that
+# process each shared subterm only once.
+CACHED_SUBSTITUTE_FUNCTION_TEXT = SUBSTITUTE_FUNCTION_TEXT.replace('core::make_update_apply_builder<NAMESPACE::', 'core::make_update_apply_builder<NAMESPACE::cached_')
+
+CACHED_FIND_VARIABLES_FUNCTION_TEXT = FIND_VARIABLES_FUNCTION_TEXT
+for old, new in [('NAMESPACE::find_all_variables(x, std::inserter(result, result.end()));',
+                  'data::detail::make_find_all_variables_traverser<NAMESPACE::cached_variable_traverser>(std::inserter(result, result.end())).apply(x);'),
+                 ('NAMESPACE::find_free_variables(x, std::inserter(result, result.end()));',
+                  'data::detail::make_cached_find_free_variables_traverser<NAMESPACE::data_expression_traverser, NAMESPACE::add_data_variable_binding>(std::inserter(result, result.end())).apply(x);'),
+                 ('NAMESPACE::find_free_variables_with_bound(x, std::inserter(result, result.end()), bound);',
+                  'data::detail::make_cached_find_free_variables_traverser<NAMESPACE::data_expression_traverser, NAMESPACE::add_data_variable_binding>(std::inserter(result, result.end()), bound).apply(x);'),
+                 ('NAMESPACE::find_function_symbols(x, std::inserter(result, result.end()));',
+                  'data::detail::make_find_function_symbols_traverser<NAMESPACE::cached_data_expression_traverser>(std::inserter(result, result.end())).apply(x);')]:
+    CACHED_FIND_VARIABLES_FUNCTION_TEXT = CACHED_FIND_VARIABLES_FUNCTION_TEXT.replace(old, new)
+
 def generate_code(filename, namespace, label, text):
     text = re.sub('NAMESPACE', namespace, text)
     return insert_text_in_file(filename, text, 'generated %s %s code' % (namespace, label))
@@ -377,12 +393,12 @@ def generate_rewrite_functions():
 def generate_replace_functions():
     result = True
     result = generate_code(MCRL2_ROOT + 'libraries/data/include/mcrl2/data/replace.h'                  , 'data'            , 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
-    result = generate_code(MCRL2_ROOT + 'libraries/lps/include/mcrl2/lps/replace.h'                    , 'lps'             , 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
+    result = generate_code(MCRL2_ROOT + 'libraries/lps/include/mcrl2/lps/replace.h'                    , 'lps'             , 'replace', CACHED_SUBSTITUTE_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/modal_formula/include/mcrl2/modal_formula/replace.h', 'action_formulas' , 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/modal_formula/include/mcrl2/modal_formula/replace.h', 'regular_formulas', 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/modal_formula/include/mcrl2/modal_formula/replace.h', 'state_formulas'  , 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/pbes/include/mcrl2/pbes/replace.h'                  , 'pbes_system'     , 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
-    result = generate_code(MCRL2_ROOT + 'libraries/process/include/mcrl2/process/replace.h'            , 'process'         , 'replace', SUBSTITUTE_FUNCTION_TEXT) and result
+    result = generate_code(MCRL2_ROOT + 'libraries/process/include/mcrl2/process/replace.h'            , 'process'         , 'replace', CACHED_SUBSTITUTE_FUNCTION_TEXT) and result
     return result
 
 def generate_replace_capture_avoiding_functions():
@@ -399,12 +415,12 @@ def generate_replace_capture_avoiding_functions():
 def generate_find_functions():
     result = True
     result = generate_code(MCRL2_ROOT + 'libraries/data/include/mcrl2/data/find.h'                  , 'data'            , 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
-    result = generate_code(MCRL2_ROOT + 'libraries/lps/include/mcrl2/lps/find.h'                    , 'lps'             , 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
+    result = generate_code(MCRL2_ROOT + 'libraries/lps/include/mcrl2/lps/find.h'                    , 'lps'             , 'find', CACHED_FIND_VARIABLES_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/modal_formula/include/mcrl2/modal_formula/find.h', 'action_formulas' , 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/modal_formula/include/mcrl2/modal_formula/find.h', 'regular_formulas', 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/modal_formula/include/mcrl2/modal_formula/find.h', 'state_formulas'  , 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
     result = generate_code(MCRL2_ROOT + 'libraries/pbes/include/mcrl2/pbes/find.h'                  , 'pbes_system'     , 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
-    result = generate_code(MCRL2_ROOT + 'libraries/process/include/mcrl2/process/find.h'            , 'process'         , 'find', FIND_VARIABLES_FUNCTION_TEXT) and result
+    result = generate_code(MCRL2_ROOT + 'libraries/process/include/mcrl2/process/find.h'            , 'process'         , 'find', CACHED_FIND_VARIABLES_FUNCTION_TEXT) and result
     return result
 
 if __name__ == "__main__":
@@ -0,0 +1,114 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file concurrent_indexed_set_benchmark.cpp
+/// \brief Measures how the throughput of the concurrent indexed set scales with
+/// the number of threads.
+///
+/// Usage: atermpp_concurrent_indexed_set_benchmark [number_of_elements] [max_threads]
+///
+/// For 1, 2, 4, ... up to max_threads threads (the default is the number of hardware
+/// threads), the threads together insert number_of_elements numbers, of which about
+/// half are inserted by more than one thread, into an initially small set. This
+/// resembles the state numbering of a parallel state space exploration, in which
+/// states are often found more than once, and includes the cost of resizing. Then
+/// all numbers are looked up again. The speedup is relative to a single thread.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
+
+using namespace atermpp;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(const clock_type::time_point& start)
+{
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// Runs f(thread, first, last) on number_of_threads threads, that divide [0, n) among each other.
+template <typename Function>
+static double run_parallel(std::size_t n, std::size_t number_of_threads, Function f)
+{
+  const clock_type::time_point start = clock_type::now();
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < number_of_threads; k++)
+  {
+    threads.emplace_back(f, k, k * n / number_of_threads, (k + 1) * n / number_of_threads);
+  }
+  for (std::thread& thread: threads)
+  {
+    thread.join();
+  }
+  return seconds_since(start);
+}
+
+// A number that is found by several threads if i is odd.
+static std::size_t element(std::size_t i, std::size_t n)
+{
+  return (i % 2 == 0) ? i : (i * 0x9e3779b97f4a7c15ULL) % n;
+}
+
+int main(int argc, char* argv[])
+{
+  const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  const std::size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "put (s)" << std::setw(10) << "speedup"
+            << std::setw(14) << "index (s)" << std::setw(10) << "speedup" << std::endl;
+  double put_time_1 = 0;
+  double index_time_1 = 0;
+  for (std::size_t number_of_threads = 1; number_of_threads <= max_threads; number_of_threads *= 2)
+  {
+    concurrent_indexed_set<std::size_t> set(1024);
+    const double put_time = run_parallel(n, number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+      {
+        for (std::size_t i = first; i < last; i++)
+        {
+          set.put(element(i, n));
+        }
+      });
+    std::size_t found = 0;
+    std::vector<std::size_t> found_per_thread(number_of_threads, 0);
+    const double index_time = run_parallel(n, number_of_threads, [&](std::size_t thread, std::size_t first, std::size_t last)
+      {
+        std::size_t count = 0;
+        for (std::size_t i = first; i < last; i++)
+        {
+          count += set.index(element(i, n)) != concurrent_indexed_set<std::size_t>::npos;
+        }
+        found_per_thread[thread] = count;
+      });
+    for (std::size_t count: found_per_thread)
+    {
+      found += count;
+    }
+    if (found != n)
+    {
+      std::cerr << "error: " << n - found << " elements were not found" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (number_of_threads == 1)
+    {
+      put_time_1 = put_time;
+      index_time_1 = index_time;
+    }
+    std::cout << std::setw(8) << number_of_threads
+              << std::setw(14) << std::fixed << std::setprecision(3) << put_time << std::setw(10) << std::setprecision(2) << put_time_1 / put_time
+              << std::setw(14) << std::setprecision(3) << index_time << std::setw(10) << std::setprecision(2) << index_time_1 / index_time
+              << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file term_memory_benchmark.cpp
+/// \brief Measures the throughput of term creation and lookup for the available
+/// term memory back ends.
+///
+/// Usage: atermpp_term_memory_benchmark [number_of_terms] [options...]
+///
+/// Each option is a term memory specification as accepted by
+/// atermpp::parse_term_memory_options, e.g. "standard" or "thp,interleave".
+/// If no options are given, the page policies standard, thp and huge are measured.
+/// The workload resembles state space exploration: a large set of terms (states)
+/// is created, and then all of them are looked up again in a random order.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/term_memory.h"
+
+using namespace atermpp;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(const clock_type::time_point& start)
+{
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// Creates the term state(i mod 7, int(i), i mod 13, parent) that mimics a state vector.
+static aterm_appl make_state(const function_symbol& state, const function_symbol& value, std::size_t i, const aterm_appl& parent)
+{
+  return aterm_appl(state, aterm_appl(value, aterm_int(i % 7)), aterm_int(i), aterm_appl(value, aterm_int(i % 13)), parent);
+}
+
+// The suffix is used to make sure that every run creates new terms, since terms
+// of a previous run may not have been garbage collected yet.
+static void run(std::size_t n, const term_memory_options& options, const std::string& suffix)
+{
+  set_term_memory_options(options);
+
+  function_symbol state("state" + suffix, 4);
+  function_symbol value("value" + suffix, 1);
+  function_symbol root("root" + suffix, 0);
+
+  std::vector<std::size_t> order(n);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(12345));
+
+  clock_type::time_point start = clock_type::now();
+  std::vector<aterm_appl> states;
+  states.reserve(n);
+  aterm_appl initial(root);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    states.push_back(make_state(state, value, i, i == 0 ? initial : states[i / 2]));
+  }
+  const double create_time = seconds_since(start);
+
+  start = clock_type::now();
+  std::size_t found = 0;
+  for (std::size_t i: order)
+  {
+    aterm_appl t = make_state(state, value, i, i == 0 ? initial : states[i / 2]);
+    found += (t == states[i]) ? 1 : 0;
+  }
+  const double lookup_time = seconds_since(start);
+
+  if (found != n)
+  {
+    std::cerr << "error: " << (n - found) << " terms were not found" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  std::cout << print_term_memory_options(options)
+            << " create " << (n / create_time) / 1e6 << " Mterms/s"
+            << " lookup " << (n / lookup_time) / 1e6 << " Mterms/s"
+            << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  std::size_t n = 5000000;
+  std::vector<std::string> specifications;
+  if (argc > 1)
+  {
+    n = std::stoul(argv[1]);
+  }
+  for (int i = 2; i < argc; i++)
+  {
+    specifications.push_back(argv[i]);
+  }
+  if (specifications.empty())
+  {
+    specifications = { "standard", "thp", "huge" };
+  }
+
+  for (std::size_t i = 0; i < specifications.size(); i++)
+  {
+    run(n, parse_term_memory_options(specifications[i]), std::to_string(i));
+  }
+  return EXIT_SUCCESS;
+}
@@ -13,6 +13,7 @@
 #define MCRL2_ATERMPP_ATERM_IO_H
 
 #include <iomanip>
+#include <vector>
 #include "mcrl2/atermpp/aterm.h"
 
 namespace atermpp
@@ -32,6 +33,24 @@ void write_term_to_binary_stream(const aterm& t, std::ostream& os);
 /// \return The term which is read.
 aterm read_term_from_binary_stream(std::istream& is);
 
+/// \brief Writes term t to a memory buffer in binary aterm format.
+/// \param t A term.
+/// \param buffer A buffer to which the bytes are appended.
+void write_term_to_binary_buffer(const aterm& t, std::vector<unsigned char>& buffer);
+
+/// \brief Reads a term in binary aterm format from a block of memory.
+/// \param data A pointer to the first byte of the block.
+/// \param size The size of the block in bytes.
+/// \param bytes_read If not null, the number of bytes occupied by the term is stored here.
+/// \return The term which is read.
+aterm read_term_from_binary_buffer(const unsigned char* data, std::size_t size, std::size_t* bytes_read = nullptr);
+
+/// \brief Reads a term from a file in binary aterm format. The file is
+/// memory mapped if the platform supports it.
+/// \param filename The name of the file.
+/// \return The term which is read.
+aterm read_term_from_binary_file(const std::string& filename);
+
 
 /// \brief Writes term t to a stream in textual format.
 /// \param t A term.
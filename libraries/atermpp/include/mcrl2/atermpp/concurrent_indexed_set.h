@@ -0,0 +1,174 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/concurrent_indexed_set.h
+/// \brief Indexed set that supports concurrent insertions.
+
+#ifndef MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
+#define MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace atermpp
+{
+
+/// \brief An indexed set that assigns dense, stable indices 0, 1, 2, ... to its elements
+/// in the order in which they are inserted. Elements cannot be removed.
+/// \details The operations put, index and get may be called concurrently by
+/// multiple threads. Insertions use open addressing with compare-and-swap on the
+/// slots of the hash table, and never take a lock. A thread that inserts a new
+/// element first reserves a slot with the hash value of the element, so other
+/// threads only wait for the slot if they are looking for an element with the
+/// same hash value. Threads announce operations in a counter of their own,
+/// instead of in a shared counter. When the table becomes too full, the threads
+/// that insert elements cooperate to move the indices to a table of twice the
+/// size, while lookups continue on the old table. Elements are stored in segments
+/// of increasing size that are never moved, so references returned by get remain
+/// valid. An index is assigned before the element is constructed; the element is
+/// published by a release store of a flag once it has been constructed, and get
+/// waits until the element with the given index has been published. Note that copying
+/// elements is not thread safe for element types with non atomic reference counts,
+/// such as aterms; for those the set can only be used by a single thread.
+template <class ELEMENT, class Hash = std::hash<ELEMENT>, class Equal = std::equal_to<ELEMENT> >
+class concurrent_indexed_set
+{
+  protected:
+    struct hashtable
+    {
+      std::size_t mask;
+      std::unique_ptr<std::atomic<std::size_t>[]> slots;
+
+      explicit hashtable(std::size_t size);
+    };
+
+    // A counter of the operations of a thread that are in progress, padded to a cache line.
+    struct participation
+    {
+      std::atomic<std::size_t> count;
+      char padding[64 - sizeof(std::atomic<std::size_t>)];
+    };
+
+    static const std::size_t number_of_segments = 64 - 10;
+    static const std::size_t first_segment_log_size = 10;
+    static const std::size_t number_of_participations = 128;
+
+    Hash m_hash;
+    Equal m_equal;
+    unsigned int m_max_load;
+
+    std::atomic<hashtable*> m_table;
+    std::atomic<std::size_t> m_size;        // The number of assigned indices.
+    std::atomic<std::size_t> m_threshold;   // The size at which the table is resized.
+
+    // Elements are stored in segments; segment i contains 2^(i+10) elements. The
+    // flags in m_published[i] tell which elements of segment i have been constructed.
+    std::atomic<ELEMENT*> m_segments[number_of_segments];
+    std::atomic<std::atomic<bool>*> m_published[number_of_segments];
+    std::mutex m_segment_mutex;
+
+    // The operations in progress. Threads share a counter only if there are more
+    // than number_of_participations of them.
+    participation m_insertions[number_of_participations];
+    participation m_lookups[number_of_participations];
+
+    // Bookkeeping for cooperative resizing.
+    std::atomic<bool> m_resizing;
+    std::atomic<hashtable*> m_new_table;
+    std::atomic<std::size_t> m_number_of_chunks;
+    std::atomic<std::size_t> m_next_chunk;
+    std::atomic<std::size_t> m_finished_chunks;
+    std::atomic<std::size_t> m_helpers;
+
+    std::size_t hash(const ELEMENT& key) const;
+    static std::pair<std::size_t, std::size_t> segment_position(std::size_t index);
+    ELEMENT* element_address(std::size_t index) const;
+    void construct_element(std::size_t index, const ELEMENT& key);
+    void wait_until_published(std::size_t index) const;
+    void insert_index(hashtable& table, std::size_t index);
+
+    static std::atomic<std::size_t>& counter(participation* participations);
+    static void wait_until_observed_zero(participation* participations);
+    bool enter_insertion(std::atomic<std::size_t>& count);
+    void resize();
+    void help_resize();
+    void destroy();
+
+  public:
+    /// \brief A constant that if returned as an index means that the index does not exist.
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// \brief Create a new concurrent indexed set.
+    /// \param initial_size The initial capacity of the set.
+    /// \param max_load_pct The maximum load percentage of the hash table.
+    /// \param hash The hash function on elements.
+    /// \param equal The equality on elements.
+    explicit concurrent_indexed_set(std::size_t initial_size = 1024, unsigned int max_load_pct = 50, const Hash& hash = Hash(), const Equal& equal = Equal());
+
+    concurrent_indexed_set(const concurrent_indexed_set&) = delete;
+    concurrent_indexed_set& operator=(const concurrent_indexed_set&) = delete;
+
+    /// \brief Move assignment. This operation is not thread safe.
+    concurrent_indexed_set& operator=(concurrent_indexed_set&& other);
+
+    ~concurrent_indexed_set()
+    {
+      destroy();
+    }
+
+    /// \brief Removes all elements. This operation is not thread safe.
+    void clear();
+
+    /// \brief Enter an element into the set.
+    /// \return A pair denoting the index of the element in the set, and a boolean denoting
+    /// whether the element was inserted by this call.
+    std::pair<std::size_t, bool> put(const ELEMENT& key);
+
+    /// \brief Find the index of an element, without inserting it.
+    /// \return The index of the element, or npos if it is not in the set.
+    std::size_t index(const ELEMENT& key);
+
+    /// \brief Find the index of elem in the set. If elem is not in the set, it is added first.
+    std::size_t operator[](const ELEMENT& key)
+    {
+      return put(key).first;
+    }
+
+    /// \brief Retrieve the element with the given index.
+    /// \details The index must be smaller than size(). If another thread is still
+    /// constructing the element, this call waits until it has been published.
+    const ELEMENT& get(std::size_t index) const
+    {
+      assert(index < size());
+      wait_until_published(index);
+      return *element_address(index);
+    }
+
+    /// \brief Returns true if the element with the given index has been constructed.
+    /// \details The index must be smaller than size().
+    bool is_published(std::size_t index) const;
+
+    /// \brief Returns the number of indices that have been assigned. Elements with
+    /// these indices may still be under construction by other threads.
+    std::size_t size() const
+    {
+      return m_size.load(std::memory_order_acquire);
+    }
+};
+
+} // namespace atermpp
+
+#include "mcrl2/atermpp/detail/concurrent_indexed_set.h"
+
+#endif // MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
@@ -7,13 +7,19 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 //
 /// \file mcrl2/atermpp/detail/aterm_io_implementation.h
-/// \brief add your file description here.
+/// \brief Buffers for reading and writing terms in the binary aterm format.
 
 #ifndef MCRL2_ATERMPP_DETAIL_ATERM_IO_IMPLEMENTATION_H
 #define MCRL2_ATERMPP_DETAIL_ATERM_IO_IMPLEMENTATION_H
 
-#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <ostream>
 #include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
 #include "mcrl2/utilities/logger.h"
 
 namespace atermpp {
@@ -66,78 +72,339 @@ std::size_t writeIntToBuf(const std::size_t val, unsigned char* buf)
   return 5;
 }
 
+/// \brief Reverses the order of the lowest nr_bits bits of val.
 inline
-void writeInt(const std::size_t val, std::ostream &os)
+std::uint64_t reverse_bits(std::uint64_t val, const std::size_t nr_bits)
 {
-  unsigned char buf[8];
-  std::size_t nr_items = writeIntToBuf(val, buf);
-  os.write((char*)buf, nr_items);
+  assert(0 < nr_bits && nr_bits <= 64);
+  val = ((val >> 1) & 0x5555555555555555ULL) | ((val & 0x5555555555555555ULL) << 1);
+  val = ((val >> 2) & 0x3333333333333333ULL) | ((val & 0x3333333333333333ULL) << 2);
+  val = ((val >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((val & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  val = ((val >> 8) & 0x00FF00FF00FF00FFULL) | ((val & 0x00FF00FF00FF00FFULL) << 8);
+  val = ((val >> 16) & 0x0000FFFF0000FFFFULL) | ((val & 0x0000FFFF0000FFFFULL) << 16);
+  val = (val >> 32) | (val << 32);
+  return val >> (64 - nr_bits);
 }
 
-// read a positive integer from a stream
-// returns the number of bytes read
-inline
-std::size_t readInt(std::istream &is)
+/// \brief Output buffer for the binary aterm format. It supports writing
+/// byte aligned integers and strings, and writing groups of bits. Bit groups
+/// are written least significant bit first, and the bits are packed into bytes
+/// starting with the most significant bit. Pending bits are collected in a 64 bit
+/// word, that is appended to the output as a whole. The output is either a vector
+/// that receives all bytes, or a stream to which the bytes are written in chunks of
+/// a fixed size, such that the encoding of a large term is never held in memory.
+class binary_output_buffer
 {
-  int buf[8];
+  protected:
+    std::vector<unsigned char> m_chunk; // the pending bytes if the output is a stream
+    std::vector<unsigned char>& m_output;
+    std::ostream* m_stream = nullptr;
+    std::uint64_t m_bit_buffer = 0; // pending bits, aligned to the most significant bit
+    std::size_t m_bits_in_buffer = 0;
 
-  // Try to read 1st character
-  if ((buf[0] = is.get()) == EOF)
-  {
-    throw std::runtime_error("Fail to read an int from the input");
-  }
+    static std::size_t chunk_size()
+    {
+      return std::size_t(1) << 16;
+    }
 
-  // Check if 1st character is enough
-  if ((buf[0] & 0x80) == 0)
-  {
-    return buf[0];
-  }
+    void write_chunk_if_full()
+    {
+      if (m_stream != nullptr && m_output.size() >= chunk_size())
+      {
+        flush();
+      }
+    }
 
-  // Try to read 2nd character
-  if ((buf[1] = is.get()) == EOF)
-  {
-    throw std::runtime_error("Fail to read an int from the input");
-  }
+    void append_bit_buffer(const std::size_t nr_bytes)
+    {
+      for (std::size_t i = 0; i < nr_bytes; i++)
+      {
+        m_output.push_back(static_cast<unsigned char>(m_bit_buffer >> (56 - 8*i)));
+      }
+      m_bit_buffer = 0;
+      m_bits_in_buffer = 0;
+      write_chunk_if_full();
+    }
 
-  // Check if 2nd character is enough
-  if ((buf[0] & 0x40) == 0)
-  {
-    return buf[1] + ((buf[0] & ~0xc0) << 8);
-  }
+  public:
+    /// \brief Appends all output to the given vector.
+    explicit binary_output_buffer(std::vector<unsigned char>& output)
+      : m_output(output)
+    {}
 
-  // Try to read 3rd character
-  if ((buf[2] = is.get()) == EOF)
-  {
-    throw std::runtime_error("Fail to read an int from the input");
-  }
+    /// \brief Writes the output to the given stream, in chunks. The remaining bytes
+    /// are written by flush(), which the caller must invoke after the last write.
+    explicit binary_output_buffer(std::ostream& stream)
+      : m_output(m_chunk),
+        m_stream(&stream)
+    {
+      m_chunk.reserve(chunk_size() + 64);
+    }
 
-  // Check if 3rd character is enough
-  if ((buf[0] & 0x20) == 0)
-  {
-    return buf[2] + (buf[1] << 8) + ((buf[0] & ~0xe0) << 16);
-  }
+    binary_output_buffer(const binary_output_buffer&) = delete;
+    binary_output_buffer& operator=(const binary_output_buffer&) = delete;
 
-  // Try to read 4th character
-  if ((buf[3] = is.get()) == EOF)
-  {
-    throw std::runtime_error("Fail to read an int from the input");
-  }
+    /// \brief Writes the pending whole bytes to the stream, if the output is a stream.
+    void flush()
+    {
+      if (m_stream != nullptr && !m_output.empty())
+      {
+        m_stream->write(reinterpret_cast<const char*>(m_output.data()), m_output.size());
+        m_output.clear();
+      }
+    }
 
-  // Check if 4th character is enough
-  if ((buf[0] & 0x10) == 0)
-  {
-    return buf[3] + (buf[2] << 8) + (buf[1] << 16) + ((buf[0] & ~0xf0) << 24);
-  }
+    /// \brief Writes a positive integer in a variable length byte encoding.
+    void write_int(const std::size_t val)
+    {
+      assert(m_bits_in_buffer == 0);
+      unsigned char buf[8];
+      std::size_t nr_items = writeIntToBuf(val, buf);
+      m_output.insert(m_output.end(), buf, buf + nr_items);
+      write_chunk_if_full();
+    }
 
-  // Try to read 5th character
-  if ((buf[4] = is.get()) == EOF)
-  {
-    throw std::runtime_error("Fail to read an int from the input");
-  }
+    /// \brief Writes a string preceded by its length.
+    void write_string(const std::string& str)
+    {
+      write_int(str.size());
+      m_output.insert(m_output.end(), str.begin(), str.end());
+      write_chunk_if_full();
+    }
 
-  // Now 5th character should be enough
-  return buf[4] + (buf[3] << 8) + (buf[2] << 16) + (buf[1] << 24);
-}
+    /// \brief Writes the lowest nr_bits bits of val.
+    void write_bits(const std::size_t val, const std::size_t nr_bits)
+    {
+      assert(nr_bits <= 64);
+      assert(nr_bits == 64 || (static_cast<std::uint64_t>(val) >> nr_bits) == 0);
+      if (nr_bits == 0)
+      {
+        return;
+      }
+      const std::uint64_t bits = reverse_bits(val, nr_bits);
+      const std::size_t free_bits = 64 - m_bits_in_buffer;
+      if (nr_bits < free_bits)
+      {
+        m_bit_buffer |= bits << (free_bits - nr_bits);
+        m_bits_in_buffer += nr_bits;
+      }
+      else
+      {
+        const std::size_t rest = nr_bits - free_bits;
+        m_bit_buffer |= bits >> rest;
+        append_bit_buffer(8);
+        if (rest > 0)
+        {
+          m_bit_buffer = bits << (64 - rest);
+          m_bits_in_buffer = rest;
+        }
+      }
+    }
+
+    /// \brief Writes the pending bits, padded with zeroes to a whole byte.
+    void flush_bits()
+    {
+      append_bit_buffer((m_bits_in_buffer + 7) / 8);
+    }
+};
+
+/// \brief Input buffer for the binary aterm format, that reads from a contiguous
+/// block of memory or from a stream buffer. It is the counterpart of
+/// binary_output_buffer. Bits are extracted from a 64 bit word. From memory the
+/// word is refilled a word at a time. From a stream buffer only the bytes that are
+/// needed are taken, such that nothing beyond the end of a term is consumed and
+/// the input does not have to be seekable.
+class binary_input_buffer
+{
+  protected:
+    const unsigned char* m_begin = nullptr;
+    const unsigned char* m_current = nullptr;
+    const unsigned char* m_end = nullptr;
+    std::streambuf* m_source = nullptr;
+    std::size_t m_source_bytes_read = 0;
+    std::uint64_t m_bit_buffer = 0; // unread bits, aligned to the most significant bit
+    std::size_t m_bits_in_buffer = 0;
+
+    // Returns false if there is no more input.
+    bool next_byte(unsigned char& b)
+    {
+      if (m_source != nullptr)
+      {
+        const std::streambuf::int_type c = m_source->sbumpc();
+        if (std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof()))
+        {
+          return false;
+        }
+        m_source_bytes_read++;
+        b = static_cast<unsigned char>(std::streambuf::traits_type::to_char_type(c));
+        return true;
+      }
+      if (m_current == m_end)
+      {
+        return false;
+      }
+      b = *m_current++;
+      return true;
+    }
+
+    // Loads at least nr_bits bits into the empty bit buffer, if available.
+    // Returns false if there is no more input.
+    bool refill(const std::size_t nr_bits)
+    {
+      assert(m_bits_in_buffer == 0 && 0 < nr_bits && nr_bits <= 64);
+      m_bit_buffer = 0;
+      if (m_source == nullptr && m_end - m_current >= 8)
+      {
+        for (std::size_t i = 0; i < 8; i++)
+        {
+          m_bit_buffer = (m_bit_buffer << 8) | m_current[i];
+        }
+        m_current += 8;
+        m_bits_in_buffer = 64;
+        return true;
+      }
+      const std::size_t nr_bytes = (m_source == nullptr ? 8 : (nr_bits + 7) / 8);
+      unsigned char b;
+      while (m_bits_in_buffer < 8 * nr_bytes && next_byte(b))
+      {
+        m_bit_buffer |= static_cast<std::uint64_t>(b) << (56 - m_bits_in_buffer);
+        m_bits_in_buffer += 8;
+      }
+      return m_bits_in_buffer > 0;
+    }
+
+    unsigned char read_byte()
+    {
+      assert(m_bits_in_buffer == 0);
+      unsigned char b;
+      if (!next_byte(b))
+      {
+        throw std::runtime_error("Fail to read an int from the input");
+      }
+      return b;
+    }
+
+  public:
+    binary_input_buffer(const unsigned char* begin, const unsigned char* end)
+      : m_begin(begin), m_current(begin), m_end(end)
+    {}
+
+    /// \brief Constructor for reading from a stream buffer. Only the bytes of the
+    /// terms that are read are taken from it.
+    explicit binary_input_buffer(std::streambuf& source)
+      : m_source(&source)
+    {}
+
+    /// \brief Reads a positive integer in the variable length byte encoding.
+    std::size_t read_int()
+    {
+      const std::size_t b0 = read_byte();
+      if ((b0 & 0x80) == 0)
+      {
+        return b0;
+      }
+      const std::size_t b1 = read_byte();
+      if ((b0 & 0x40) == 0)
+      {
+        return b1 + ((b0 & ~0xc0) << 8);
+      }
+      const std::size_t b2 = read_byte();
+      if ((b0 & 0x20) == 0)
+      {
+        return b2 + (b1 << 8) + ((b0 & ~0xe0) << 16);
+      }
+      const std::size_t b3 = read_byte();
+      if ((b0 & 0x10) == 0)
+      {
+        return b3 + (b2 << 8) + (b1 << 16) + ((b0 & ~0xf0) << 24);
+      }
+      const std::size_t b4 = read_byte();
+      return b4 + (b3 << 8) + (b2 << 16) + (b1 << 24);
+    }
+
+    /// \brief Reads a string preceded by its length.
+    std::string read_string()
+    {
+      const std::size_t len = read_int();
+      if (m_source != nullptr)
+      {
+        std::string result;
+        char block[4096];
+        while (result.size() < len)
+        {
+          const std::streamsize n = std::min(len - result.size(), sizeof(block));
+          if (m_source->sgetn(block, n) != n)
+          {
+            throw std::runtime_error("Fail to read a string from the input");
+          }
+          result.append(block, static_cast<std::size_t>(n));
+        }
+        m_source_bytes_read += len;
+        return result;
+      }
+      if (static_cast<std::size_t>(m_end - m_current) < len)
+      {
+        throw std::runtime_error("Fail to read a string from the input");
+      }
+      std::string result(reinterpret_cast<const char*>(m_current), len);
+      m_current += len;
+      return result;
+    }
+
+    /// \brief Reads an nr_bits bit integer.
+    /// \return true on success, false on failure (end of input).
+    bool read_bits(std::size_t& val, const std::size_t nr_bits)
+    {
+      assert(nr_bits <= 64);
+      if (nr_bits == 0)
+      {
+        val = 0;
+        return true;
+      }
+      std::uint64_t bits;
+      if (nr_bits <= m_bits_in_buffer)
+      {
+        bits = m_bit_buffer >> (64 - nr_bits);
+        m_bit_buffer = (nr_bits == 64 ? 0 : m_bit_buffer << nr_bits);
+        m_bits_in_buffer -= nr_bits;
+      }
+      else
+      {
+        const std::size_t high_bits = m_bits_in_buffer;
+        const std::uint64_t high = (high_bits == 0 ? 0 : m_bit_buffer >> (64 - high_bits));
+        m_bits_in_buffer = 0;
+        const std::size_t rest = nr_bits - high_bits;
+        if (!refill(rest) || rest > m_bits_in_buffer)
+        {
+          return false;
+        }
+        const std::uint64_t low = m_bit_buffer >> (64 - rest);
+        m_bit_buffer = (rest == 64 ? 0 : m_bit_buffer << rest);
+        m_bits_in_buffer -= rest;
+        bits = (high_bits == 0 ? low : (high << rest) | low);
+      }
+      val = static_cast<std::size_t>(reverse_bits(bits, nr_bits));
+      return true;
+    }
+
+    /// \brief Discards the remaining bits of a partially read byte.
+    void align()
+    {
+      // From a stream buffer at most a partially read byte is buffered.
+      assert(m_source == nullptr || m_bits_in_buffer < 8);
+      m_current -= m_bits_in_buffer / 8;
+      m_bit_buffer = 0;
+      m_bits_in_buffer = 0;
+    }
+
+    /// \brief Returns the number of bytes that have been consumed, where a
+    /// partially read byte counts as consumed.
+    std::size_t bytes_read() const
+    {
+      const std::size_t consumed = (m_source == nullptr ? static_cast<std::size_t>(m_current - m_begin) : m_source_bytes_read);
+      return consumed - m_bits_in_buffer / 8;
+    }
+};
 
 } // namespace detail
 
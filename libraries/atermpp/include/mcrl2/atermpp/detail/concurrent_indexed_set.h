@@ -0,0 +1,443 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/detail/concurrent_indexed_set.h
+/// \brief Implementation of the concurrent indexed set.
+
+#ifndef MCRL2_ATERMPP_DETAIL_CONCURRENT_INDEXED_SET_H
+#define MCRL2_ATERMPP_DETAIL_CONCURRENT_INDEXED_SET_H
+
+#include <cstdint>
+#include <new>
+#include <thread>
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
+
+namespace atermpp
+{
+namespace detail
+{
+
+/* In the slots of the hash table an index n is stored as n+1, and zero indicates an
+   empty slot. A slot that has been claimed by a thread that is inserting a new
+   element, but has not yet written its index, has the highest bit set, and contains
+   the remaining bits of the hash value of the element. */
+static const std::size_t CONCURRENT_EMPTY = 0;
+static const std::size_t CONCURRENT_RESERVED = std::size_t(1) << (8 * sizeof(std::size_t) - 1);
+
+inline std::size_t concurrent_reservation(std::size_t hash)
+{
+  return CONCURRENT_RESERVED | (hash & ~CONCURRENT_RESERVED);
+}
+
+/* The number of indices that is moved by a thread at once during resizing. */
+static const std::size_t CONCURRENT_RESIZE_CHUNK = 4096;
+
+inline std::size_t floor_log2(std::size_t n)
+{
+  assert(n > 0);
+#if defined(__GNUC__)
+  return 8 * sizeof(unsigned long long) - 1 - __builtin_clzll(n);
+#else
+  std::size_t result = 0;
+  while (n >>= 1)
+  {
+    result++;
+  }
+  return result;
+#endif
+}
+
+} // namespace detail
+
+template <class ELEMENT, class Hash, class Equal>
+const std::size_t concurrent_indexed_set<ELEMENT, Hash, Equal>::npos;
+
+template <class ELEMENT, class Hash, class Equal>
+concurrent_indexed_set<ELEMENT, Hash, Equal>::hashtable::hashtable(std::size_t size)
+{
+  std::size_t n = 1;
+  while (n < size)
+  {
+    n <<= 1;
+  }
+  mask = n - 1;
+  slots.reset(new std::atomic<std::size_t>[n]);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    slots[i].store(detail::CONCURRENT_EMPTY, std::memory_order_relaxed);
+  }
+}
+
+template <class ELEMENT, class Hash, class Equal>
+concurrent_indexed_set<ELEMENT, Hash, Equal>::concurrent_indexed_set(std::size_t initial_size, unsigned int max_load_pct, const Hash& hash, const Equal& equal)
+  : m_hash(hash),
+    m_equal(equal),
+    m_max_load(max_load_pct),
+    m_size(0),
+    m_resizing(false),
+    m_new_table(nullptr),
+    m_next_chunk(0),
+    m_finished_chunks(0),
+    m_helpers(0)
+{
+  assert(0 < max_load_pct && max_load_pct < 100);
+  hashtable* table = new hashtable(std::max(initial_size, std::size_t(128)));
+  m_table.store(table);
+  m_threshold.store(((table->mask + 1) / 100) * m_max_load);
+  for (std::size_t i = 0; i < number_of_segments; i++)
+  {
+    m_segments[i].store(nullptr);
+    m_published[i].store(nullptr);
+  }
+  m_number_of_chunks.store(0);
+  for (std::size_t i = 0; i < number_of_participations; i++)
+  {
+    m_insertions[i].count.store(0);
+    m_lookups[i].count.store(0);
+  }
+}
+
+template <class ELEMENT, class Hash, class Equal>
+concurrent_indexed_set<ELEMENT, Hash, Equal>& concurrent_indexed_set<ELEMENT, Hash, Equal>::operator=(concurrent_indexed_set&& other)
+{
+  if (this != &other)
+  {
+    destroy();
+    m_hash = other.m_hash;
+    m_equal = other.m_equal;
+    m_max_load = other.m_max_load;
+    m_table.store(other.m_table.exchange(new hashtable(128)));
+    m_size.store(other.m_size.exchange(0));
+    m_threshold.store(other.m_threshold.exchange((128 / 100) * other.m_max_load));
+    for (std::size_t i = 0; i < number_of_segments; i++)
+    {
+      m_segments[i].store(other.m_segments[i].exchange(nullptr));
+      m_published[i].store(other.m_published[i].exchange(nullptr));
+    }
+  }
+  return *this;
+}
+
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::destroy()
+{
+  const std::size_t n = m_size.load();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    element_address(i)->~ELEMENT();
+  }
+  for (std::size_t i = 0; i < number_of_segments; i++)
+  {
+    ::operator delete(m_segments[i].exchange(nullptr));
+    delete[] m_published[i].exchange(nullptr);
+  }
+  delete m_table.exchange(nullptr);
+  m_size.store(0);
+}
+
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::clear()
+{
+  const std::size_t table_size = m_table.load()->mask + 1;
+  destroy();
+  m_table.store(new hashtable(table_size));
+}
+
+template <class ELEMENT, class Hash, class Equal>
+inline std::size_t concurrent_indexed_set<ELEMENT, Hash, Equal>::hash(const ELEMENT& key) const
+{
+  // The hash value is mixed to avoid clustering in the hash table, since the
+  // hash functions of terms are based on their addresses.
+  std::uint64_t h = m_hash(key);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<std::size_t>(h);
+}
+
+template <class ELEMENT, class Hash, class Equal>
+inline std::pair<std::size_t, std::size_t> concurrent_indexed_set<ELEMENT, Hash, Equal>::segment_position(std::size_t index)
+{
+  const std::size_t i = index + (std::size_t(1) << first_segment_log_size);
+  const std::size_t log = detail::floor_log2(i);
+  return std::make_pair(log - first_segment_log_size, i - (std::size_t(1) << log));
+}
+
+template <class ELEMENT, class Hash, class Equal>
+inline ELEMENT* concurrent_indexed_set<ELEMENT, Hash, Equal>::element_address(std::size_t index) const
+{
+  const std::pair<std::size_t, std::size_t> p = segment_position(index);
+  return m_segments[p.first].load(std::memory_order_acquire) + p.second;
+}
+
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::construct_element(std::size_t index, const ELEMENT& key)
+{
+  const std::pair<std::size_t, std::size_t> p = segment_position(index);
+  ELEMENT* segment = m_segments[p.first].load(std::memory_order_acquire);
+  if (segment == nullptr)
+  {
+    std::lock_guard<std::mutex> lock(m_segment_mutex);
+    segment = m_segments[p.first].load(std::memory_order_acquire);
+    if (segment == nullptr)
+    {
+      // The flags are in place before the segment becomes visible.
+      const std::size_t n = std::size_t(1) << (p.first + first_segment_log_size);
+      std::atomic<bool>* published = new std::atomic<bool>[n];
+      for (std::size_t i = 0; i < n; i++)
+      {
+        published[i].store(false, std::memory_order_relaxed);
+      }
+      m_published[p.first].store(published, std::memory_order_relaxed);
+      segment = static_cast<ELEMENT*>(::operator new(sizeof(ELEMENT) * n));
+      m_segments[p.first].store(segment, std::memory_order_release);
+    }
+  }
+  new (segment + p.second) ELEMENT(key);
+  m_published[p.first].load(std::memory_order_relaxed)[p.second].store(true, std::memory_order_release);
+}
+
+template <class ELEMENT, class Hash, class Equal>
+bool concurrent_indexed_set<ELEMENT, Hash, Equal>::is_published(std::size_t index) const
+{
+  assert(index < size());
+  const std::pair<std::size_t, std::size_t> p = segment_position(index);
+  if (m_segments[p.first].load(std::memory_order_acquire) == nullptr)
+  {
+    return false;
+  }
+  return m_published[p.first].load(std::memory_order_relaxed)[p.second].load(std::memory_order_acquire);
+}
+
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::wait_until_published(std::size_t index) const
+{
+  while (!is_published(index))
+  {
+    std::this_thread::yield();
+  }
+}
+
+// Returns the counter of the calling thread.
+template <class ELEMENT, class Hash, class Equal>
+inline std::atomic<std::size_t>& concurrent_indexed_set<ELEMENT, Hash, Equal>::counter(participation* participations)
+{
+  static std::atomic<std::size_t> next_thread(0);
+  static thread_local std::size_t thread = next_thread.fetch_add(1) % number_of_participations;
+  return participations[thread].count;
+}
+
+// Waits until each of the counters has been observed to be zero at least once. All
+// operations that were in progress when this function was called have then finished.
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::wait_until_observed_zero(participation* participations)
+{
+  for (std::size_t i = 0; i < number_of_participations; i++)
+  {
+    while (participations[i].count.load() != 0)
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// Announces an insertion in count. Returns false if a resize is in progress.
+template <class ELEMENT, class Hash, class Equal>
+inline bool concurrent_indexed_set<ELEMENT, Hash, Equal>::enter_insertion(std::atomic<std::size_t>& count)
+{
+  count.fetch_add(1);
+  if (m_resizing.load())
+  {
+    count.fetch_sub(1);
+    return false;
+  }
+  return true;
+}
+
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::insert_index(hashtable& table, std::size_t index)
+{
+  std::size_t c = hash(*element_address(index)) & table.mask;
+  while (true)
+  {
+    std::size_t expected = detail::CONCURRENT_EMPTY;
+    if (table.slots[c].compare_exchange_strong(expected, index + 1, std::memory_order_relaxed))
+    {
+      return;
+    }
+    c = (c + 1) & table.mask;
+  }
+}
+
+// Moves chunks of indices to the new table, until no chunks are left.
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::help_resize()
+{
+  m_helpers.fetch_add(1);
+  hashtable* table = m_new_table.load();
+  if (table != nullptr)
+  {
+    const std::size_t n = m_size.load();
+    const std::size_t number_of_chunks = m_number_of_chunks.load();
+    while (true)
+    {
+      const std::size_t chunk = m_next_chunk.fetch_add(1);
+      if (chunk >= number_of_chunks)
+      {
+        break;
+      }
+      const std::size_t last = std::min(n, (chunk + 1) * detail::CONCURRENT_RESIZE_CHUNK);
+      for (std::size_t i = chunk * detail::CONCURRENT_RESIZE_CHUNK; i < last; i++)
+      {
+        insert_index(*table, i);
+      }
+      m_finished_chunks.fetch_add(1);
+    }
+  }
+  m_helpers.fetch_sub(1);
+}
+
+template <class ELEMENT, class Hash, class Equal>
+void concurrent_indexed_set<ELEMENT, Hash, Equal>::resize()
+{
+  bool expected = false;
+  if (!m_resizing.compare_exchange_strong(expected, true))
+  {
+    return; // Another thread is resizing.
+  }
+  if (m_size.load() < m_threshold.load())
+  {
+    m_resizing.store(false);
+    return; // The table has already been resized.
+  }
+
+  // Wait until all insertions in the current table have finished. New insertions
+  // will see that a resize is in progress. Lookups continue in the current table,
+  // which does not change anymore.
+  wait_until_observed_zero(m_insertions);
+
+  hashtable* old_table = m_table.load();
+  hashtable* new_table = new hashtable(2 * (old_table->mask + 1));
+  m_number_of_chunks.store((m_size.load() + detail::CONCURRENT_RESIZE_CHUNK - 1) / detail::CONCURRENT_RESIZE_CHUNK);
+  m_next_chunk.store(0);
+  m_finished_chunks.store(0);
+  m_new_table.store(new_table);
+
+  help_resize();
+  while (m_finished_chunks.load() != m_number_of_chunks.load())
+  {
+    std::this_thread::yield();
+  }
+
+  // Make sure that no helper is still looking at the bookkeeping of this resize.
+  m_new_table.store(nullptr);
+  while (m_helpers.load() != 0)
+  {
+    std::this_thread::yield();
+  }
+
+  m_table.store(new_table);
+  m_threshold.store(((new_table->mask + 1) / 100) * m_max_load);
+  m_resizing.store(false);
+
+  // Lookups that started after this point use the new table.
+  wait_until_observed_zero(m_lookups);
+  delete old_table;
+}
+
+template <class ELEMENT, class Hash, class Equal>
+std::pair<std::size_t, bool> concurrent_indexed_set<ELEMENT, Hash, Equal>::put(const ELEMENT& key)
+{
+  const std::size_t h = hash(key);
+  const std::size_t reservation = detail::concurrent_reservation(h);
+  std::atomic<std::size_t>& count = counter(m_insertions);
+  while (!enter_insertion(count))
+  {
+    help_resize();
+    while (m_resizing.load())
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  hashtable& table = *m_table.load();
+  std::size_t c = h & table.mask;
+  while (true)
+  {
+    std::size_t v = table.slots[c].load(std::memory_order_acquire);
+    if (v == detail::CONCURRENT_EMPTY)
+    {
+      if (table.slots[c].compare_exchange_strong(v, reservation, std::memory_order_acquire))
+      {
+        const std::size_t n = m_size.fetch_add(1);
+        construct_element(n, key);
+        table.slots[c].store(n + 1, std::memory_order_release);
+        count.fetch_sub(1, std::memory_order_release);
+        if (n + 1 >= m_threshold.load(std::memory_order_relaxed))
+        {
+          resize();
+        }
+        return std::make_pair(n, true);
+      }
+      continue; // Another thread claimed the slot; inspect it again.
+    }
+    if ((v & detail::CONCURRENT_RESERVED) != 0)
+    {
+      if (v == reservation)
+      {
+        std::this_thread::yield(); // The slot may receive an element equal to key.
+        continue;
+      }
+    }
+    else if (m_equal(*element_address(v - 1), key))
+    {
+      count.fetch_sub(1, std::memory_order_release);
+      return std::make_pair(v - 1, false);
+    }
+    c = (c + 1) & table.mask;
+  }
+}
+
+template <class ELEMENT, class Hash, class Equal>
+std::size_t concurrent_indexed_set<ELEMENT, Hash, Equal>::index(const ELEMENT& key)
+{
+  const std::size_t h = hash(key);
+  const std::size_t reservation = detail::concurrent_reservation(h);
+  std::atomic<std::size_t>& count = counter(m_lookups);
+  count.fetch_add(1);
+
+  hashtable& table = *m_table.load();
+  std::size_t c = h & table.mask;
+  while (true)
+  {
+    const std::size_t v = table.slots[c].load(std::memory_order_acquire);
+    if (v == detail::CONCURRENT_EMPTY)
+    {
+      count.fetch_sub(1, std::memory_order_release);
+      return npos;
+    }
+    if ((v & detail::CONCURRENT_RESERVED) != 0)
+    {
+      if (v == reservation)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+    }
+    else if (m_equal(*element_address(v - 1), key))
+    {
+      count.fetch_sub(1, std::memory_order_release);
+      return v - 1;
+    }
+    c = (c + 1) & table.mask;
+  }
+}
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_CONCURRENT_INDEXED_SET_H
@@ -0,0 +1,51 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/detail/term_memory.h
+/// \brief The memory back end for blocks of terms and the term hashtable.
+
+#ifndef MCRL2_ATERMPP_DETAIL_TERM_MEMORY_H
+#define MCRL2_ATERMPP_DETAIL_TERM_MEMORY_H
+
+#include <cstddef>
+#include "mcrl2/atermpp/term_memory.h"
+
+namespace atermpp
+{
+
+namespace detail
+{
+
+class _aterm;
+
+/// \brief Allocates a block of memory of the given number of bytes to store terms.
+/// \details With a page policy other than standard, blocks of at most BLOCK_SIZE bytes
+/// are cut from large mapped chunks of memory. Freed blocks are reused for new blocks,
+/// but the chunks are not returned to the system.
+/// \return A pointer to the block, or nullptr if no memory is available.
+void* allocate_term_block(std::size_t size);
+
+/// \brief Frees a block that was obtained by allocate_term_block.
+void free_term_block(void* block, std::size_t size);
+
+/// \brief Allocates a hashtable with the given number of entries, all equal to nullptr.
+/// \return A pointer to the hashtable, or nullptr if no memory is available.
+_aterm** allocate_term_hashtable(std::size_t number_of_entries);
+
+/// \brief Frees a hashtable that was obtained by allocate_term_hashtable.
+void free_term_hashtable(_aterm** table, std::size_t number_of_entries);
+
+/// \brief Moves the term hashtable to newly allocated memory. This is used to let
+/// the hashtable take advantage of a change of the term memory options.
+void reallocate_aterm_hashtable();
+
+} // namespace detail
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_DETAIL_TERM_MEMORY_H
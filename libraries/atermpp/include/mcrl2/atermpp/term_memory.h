@@ -0,0 +1,66 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/atermpp/term_memory.h
+/// \brief Selection of the memory back end for the storage of terms.
+
+#ifndef MCRL2_ATERMPP_TERM_MEMORY_H
+#define MCRL2_ATERMPP_TERM_MEMORY_H
+
+#include <string>
+
+namespace atermpp
+{
+
+/// \brief The kind of pages that is used for the blocks of terms and the term hashtable.
+enum class page_policy
+{
+  standard,               ///< Memory is obtained with malloc and calloc.
+  transparent_huge_pages, ///< Memory is mapped and the kernel is advised to use huge pages.
+  huge_pages              ///< Memory is mapped from the preallocated huge pages of the system.
+};
+
+/// \brief The placement of term memory on the nodes of a NUMA machine. This is only
+/// used if the page policy is not standard.
+enum class numa_policy
+{
+  none,        ///< The policy of the process is used.
+  interleave,  ///< Pages are distributed round robin over all nodes.
+  first_touch  ///< Pages are placed on the node of the thread that first touches them.
+};
+
+struct term_memory_options
+{
+  page_policy pages = page_policy::standard;
+  numa_policy numa = numa_policy::none;
+};
+
+/// \brief Sets the memory back end that is used for terms from now on.
+/// \details Blocks of terms that were allocated before remain where they are, but
+/// the term hashtable is moved to memory that is allocated with the new options.
+/// On systems other than Linux only the standard page policy is available; other
+/// choices are silently replaced by it. Initially the options are taken from the
+/// environment variable MCRL2_TERM_MEMORY, see parse_term_memory_options.
+void set_term_memory_options(const term_memory_options& options);
+
+/// \brief Returns the current options of the memory back end for terms.
+const term_memory_options& get_term_memory_options();
+
+/// \brief Parses term memory options from a comma separated list of the keywords
+/// standard, thp, huge (the page policy) and interleave, first-touch (the NUMA policy).
+/// For example "thp,interleave". An empty string yields the default options.
+/// \exception mcrl2::runtime_error if the text contains an unknown keyword.
+term_memory_options parse_term_memory_options(const std::string& text);
+
+/// \brief Returns a textual representation of term memory options, in the format
+/// accepted by parse_term_memory_options.
+std::string print_term_memory_options(const term_memory_options& options);
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_TERM_MEMORY_H
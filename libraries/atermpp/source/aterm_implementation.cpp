@@ -26,6 +26,7 @@
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/atermpp/detail/aterm_implementation.h"
 #include "mcrl2/atermpp/detail/aterm_int.h"
+#include "mcrl2/atermpp/detail/term_memory.h"
 #include "mcrl2/atermpp/aterm_appl.h"
 
 
@@ -176,30 +177,21 @@ void free_term(detail::_aterm* t)
 }
 
 
-void resize_aterm_hashtable()
+// Moves all terms to a new hashtable of the given size. Returns false if the
+// new hashtable could not be allocated, in which case nothing is changed.
+static bool rehash_aterm_hashtable(const std::size_t new_size)
 {
-  static bool resizing_aterm_hashtable_has_failed=false;
-  if (resizing_aterm_hashtable_has_failed)
-  {
-    // Not increasing the hashtable has only a slight performance penalty,
-    // as the hashtables get fuller. But it saves memory, and does not lead
-    // to incorrect behaviour.
-    return;
-  }
   const std::size_t old_size=aterm_table_size;
-  aterm_table_size <<=1; // Double the size.
   // Intentionally do not throw the old hashtable away before allocating the new one.
   // It is better when the extra memory is used for blocks of aterms, than for increasing the
   // hashtable.
-  _aterm* * new_hashtable=reinterpret_cast<_aterm**>(calloc(aterm_table_size,sizeof(_aterm*)));
+  _aterm* * new_hashtable=allocate_term_hashtable(new_size);
 
   if (new_hashtable==nullptr)
   {
-    resizing_aterm_hashtable_has_failed=true;
-    mCRL2log(mcrl2::log::warning) << "could not resize hashtable to size " << aterm_table_size << ". ";
-    aterm_table_size = old_size;
-    return;
+    return false;
   }
+  aterm_table_size = new_size;
   aterm_table_mask = aterm_table_size-1;
 
   /*  Rehash all old elements */
@@ -218,8 +210,34 @@ void resize_aterm_hashtable()
       aterm_walker = next;
     }
   }
-  free(aterm_hashtable);
+  free_term_hashtable(aterm_hashtable, old_size);
   aterm_hashtable=new_hashtable;
+  return true;
+}
+
+void resize_aterm_hashtable()
+{
+  static bool resizing_aterm_hashtable_has_failed=false;
+  if (resizing_aterm_hashtable_has_failed)
+  {
+    // Not increasing the hashtable has only a slight performance penalty,
+    // as the hashtables get fuller. But it saves memory, and does not lead
+    // to incorrect behaviour.
+    return;
+  }
+  if (!rehash_aterm_hashtable(aterm_table_size << 1)) // Double the size.
+  {
+    resizing_aterm_hashtable_has_failed=true;
+    mCRL2log(mcrl2::log::warning) << "could not resize hashtable to size " << (aterm_table_size << 1) << ". ";
+  }
+}
+
+void reallocate_aterm_hashtable()
+{
+  if (aterm_hashtable!=nullptr)
+  {
+    rehash_aterm_hashtable(aterm_table_size);
+  }
 }
 
 void collect_terms_with_reference_count_0()
@@ -285,7 +303,7 @@ void collect_terms_with_reference_count_0()
         {
           previous_block->next_by_size=next_block;
         }
-        free(b);
+        free_term_block(b, reinterpret_cast<char*>(b->end)-reinterpret_cast<char*>(b));
       }
       else
       {
@@ -341,7 +359,7 @@ void initialise_aterm_administration()
    * due to the initialisation of a pre-main initialisation of a static variable, which some
    * compilers do. */
 
-  aterm_hashtable=reinterpret_cast<_aterm**>(calloc(aterm_table_size,sizeof(_aterm*)));
+  aterm_hashtable=allocate_term_hashtable(aterm_table_size);
   if (aterm_hashtable==nullptr)
   {
     throw std::runtime_error("Out of memory. Cannot create an aterm symbol hashtable.");
@@ -385,7 +403,7 @@ void allocate_block(const std::size_t size)
   std::size_t number_of_terms_in_data_block=(BLOCK_SIZE-block_header_size) / (size*sizeof(std::size_t));
   if (number_of_terms_in_data_block==0) number_of_terms_in_data_block=1; // Take care that there is room for at least one term.
 
-  Block* newblock = (Block*)malloc(block_header_size+number_of_terms_in_data_block*size*sizeof(std::size_t));
+  Block* newblock = reinterpret_cast<Block*>(allocate_term_block(block_header_size+number_of_terms_in_data_block*size*sizeof(std::size_t)));
   if (newblock == nullptr)
   {
     throw std::runtime_error("Out of memory. Could not allocate a block of memory to store terms.");
@@ -34,6 +34,7 @@
 
 #include "mcrl2/utilities/exception.h"
 #include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/memory_mapped_file.h"
 
 
 /* Integers in BAF are always exactly 32 or 64 bits.  The size must be fixed so that
@@ -44,9 +45,6 @@ static const std::size_t INT_SIZE_IN_BAF = 64;
 namespace atermpp
 {
 
-using detail::readInt;
-using detail::writeInt;
-
 using namespace std;
 
 static void aterm_io_init(std::ios& 
@@ -229,122 +227,19 @@ class sym_read_entry
     }
 };
 
-static char* text_buffer = nullptr;
-static std::size_t text_buffer_size = 0;
-
-static unsigned char bit_buffer = '\0';
-static std::size_t  bits_in_buffer = 0; /* how many bits in bit_buffer are used */
-
-static void writeBits(std::size_t val, const std::size_t nr_bits, ostream& os)
-{
-  for (std::size_t cur_bit=0; cur_bit<nr_bits; cur_bit++)
-  {
-    bit_buffer <<= 1;
-    bit_buffer |= (val & 0x01);
-    val >>= 1;
-    if (++bits_in_buffer == 8)
-    {
-      os.put(bit_buffer);
-      bits_in_buffer = 0;
-      bit_buffer = '\0';
-    }
-  }
-  assert(val==0);
-}
-
-
-static void flushBitsToWriter(ostream& os)
-{
-  if (bits_in_buffer > 0)
-  {
-    std::size_t left = 8-bits_in_buffer;
-    bit_buffer <<= left;
-    os.put(bit_buffer);
-    if (os.fail())
-    {
-      throw mcrl2::runtime_error("Failed to write the last byte to the output file/stream.");
-    }
-    bits_in_buffer = 0;
-    bit_buffer = '\0';
-  }
-}
-
-/**
- * @brief readBits Reads an n-bit integer from the input stream.
- * @param val      Variable to store integer in.
- * @param nr_bits  Number of bits to read from the input stream.
- * @param is       The input stream.
- * @return true on success, false on failure (EOF).
- */
-static
-bool readBits(std::size_t& val, const std::size_t nr_bits, istream& is)
-{
-  std::size_t cur_bit, mask = 1;
-
-  val = 0;
-  for (cur_bit=0; cur_bit<nr_bits; cur_bit++)
-  {
-    if (bits_in_buffer == 0)
-    {
-      int byte = is.get();
-      if (is.fail())
-      {
-        return false;
-      }
-      bit_buffer = (unsigned char)byte;
-      bits_in_buffer = 8;
-    }
-    val |= (bit_buffer & 0x80 ? mask : 0);
-    mask <<= 1;
-    bit_buffer <<= 1;
-    bits_in_buffer--;
-  }
-  return true;
-}
-
-static void writeString(const std::string& str, ostream& os)
-{
-  /* Write length. */
-  writeInt(str.size(), os);
-
-  /* Write actual string. */
-  os.write(str.c_str(), str.size());
-}
-
-
-static std::size_t readString(istream& is)
+static void writeString(const std::string& str, detail::binary_output_buffer& os)
 {
-  std::size_t len;
-
-  /* Get length of string */
-  len = readInt(is);
-
-  /* Assure buffer can hold the string */
-  if (text_buffer_size < (len+1))
-  {
-    text_buffer_size = 2*len;
-    text_buffer = (char*) realloc(text_buffer, text_buffer_size);
-    if (!text_buffer)
-    {
-      throw mcrl2::runtime_error("Out of memory while reading the input file. Fail to claim a block of memory of size "+ std::to_string(text_buffer_size) + ".");
-    }
-  }
-
-  /* Read the actual string */
-  is.read(text_buffer, len);
-
-  /* Ok, return length of string */
-  return len;
+  os.write_string(str);
 }
 
 /**
  * Write a symbol to file.
  */
 
-static void write_symbol(const function_symbol& sym, ostream& os)
+static void write_symbol(const function_symbol& sym, detail::binary_output_buffer& os)
 {
   writeString(sym.name(), os);
-  writeInt(sym.arity(), os);
+  os.write_int(sym.arity());
 }
 
 /**
@@ -541,21 +436,21 @@ static void collect_terms(const aterm& t, const std::unordered_map<function_symb
  * Write all symbols in a term to file.
  */
 
-static void write_all_symbols(ostream& os, const std::vector<sym_write_entry>& sym_entries)
+static void write_all_symbols(detail::binary_output_buffer& os, const std::vector<sym_write_entry>& sym_entries)
 {
   for(const sym_write_entry& cur_sym: sym_entries)
   {
     write_symbol(cur_sym.id, os);
-    writeInt(cur_sym.write_terms.size(), os);
+    os.write_int(cur_sym.write_terms.size());
 
     for (std::size_t arg_idx=0; arg_idx<cur_sym.id.arity(); arg_idx++)
     {
       std::size_t nr_symbols = cur_sym.top_symbols[arg_idx].symbols.size();
-      writeInt(nr_symbols, os);
+      os.write_int(nr_symbols);
       for (std::size_t top_idx=0; top_idx<nr_symbols; top_idx++)
       {
         const top_symbol& ts = cur_sym.top_symbols[arg_idx].symbols[top_idx];
-        writeInt(ts.index, os);
+        os.write_int(ts.index);
       }
     }
   }
@@ -575,7 +470,7 @@ static const top_symbol& find_top_symbol(top_symbols_t* syms, const function_sym
  * Write a term using a writer.
  */
 
-static void write_term(const aterm& t, const std::unordered_map<function_symbol, std::size_t>& index, ostream& os, std::vector<sym_write_entry>& sym_entries)
+static void write_term(const aterm& t, const std::unordered_map<function_symbol, std::size_t>& index, detail::binary_output_buffer& os, std::vector<sym_write_entry>& sym_entries)
 {
   std::stack<write_todo> stack;
   stack.emplace(t, index, sym_entries);
@@ -587,7 +482,7 @@ static void write_term(const aterm& t, const std::unordered_map<function_symbol,
     if (current.term.type_is_int())
     {
       // If aterm integers are > 32 bits, then they cannot be read on a 32 bit machine.
-      writeBits(aterm_int(current.term).value(), INT_SIZE_IN_BAF, os);
+      os.write_bits(aterm_int(current.term).value(), INT_SIZE_IN_BAF);
     }
     else
     if (current.arg < current.entry->id.arity())
@@ -595,10 +490,10 @@ static void write_term(const aterm& t, const std::unordered_map<function_symbol,
       write_todo item(subterm(current.term, current.arg), index, sym_entries);
 
       const top_symbol& ts = find_top_symbol(&current.entry->top_symbols[current.arg], item.entry->id);
-      writeBits(ts.code, current.entry->top_symbols[current.arg].code_width, os);
+      os.write_bits(ts.code, current.entry->top_symbols[current.arg].code_width);
       sym_write_entry& arg_sym = sym_entries[ts.index];
       std::size_t arg_trm_idx = arg_sym.write_terms.at(item.term); 
-      writeBits(arg_trm_idx, arg_sym.term_width, os);
+      os.write_bits(arg_trm_idx, arg_sym.term_width);
 
       ++current.arg;
 
@@ -613,16 +508,12 @@ static void write_term(const aterm& t, const std::unordered_map<function_symbol,
     stack.pop();
   }
   while (!stack.empty());
-  flushBitsToWriter(os);
+  os.flush_bits();
 }
 
 
-static void write_baf(const aterm& t, ostream& os)
+static void write_baf(const aterm& t, detail::binary_output_buffer& os)
 {
-  /* Initialize bit buffer */
-  bit_buffer     = '\0';
-  bits_in_buffer = 0; /* how many bits in bit_buffer are used */
-
   std::unordered_map<function_symbol, std::size_t> index; 
   std::unordered_map<function_symbol, std::size_t> count=count_the_number_of_unique_function_symbols_in_a_term(t);
   std::size_t nr_unique_symbols = count.size();
@@ -651,44 +542,52 @@ static void write_baf(const aterm& t, ostream& os)
 
   /* write header */
 
-  writeInt(0, os);
-  writeInt(BAF_MAGIC, os);
-  writeInt(BAF_VERSION, os);
-  writeInt(nr_unique_symbols, os);
+  os.write_int(0);
+  os.write_int(BAF_MAGIC);
+  os.write_int(BAF_VERSION);
+  os.write_int(nr_unique_symbols);
   write_all_symbols(os, sym_entries);
 
   /* Write the top symbol */
-  writeInt(get_top_symbol(t,index,sym_entries)-&sym_entries[0], os);
+  os.write_int(get_top_symbol(t,index,sym_entries)-&sym_entries[0]);
 
   write_term(t, index, os, sym_entries);
 }
 
+void write_term_to_binary_buffer(const aterm& t, std::vector<unsigned char>& buffer)
+{
+  detail::binary_output_buffer os(buffer);
+  write_baf(t, os);
+}
+
 void write_term_to_binary_stream(const aterm& t, std::ostream& os)
 {
   aterm_io_init(os);
-  write_baf(t, os);
+  detail::binary_output_buffer buffer(os);
+  write_baf(t, buffer);
+  buffer.flush();
+  if (os.fail())
+  {
+    throw mcrl2::runtime_error("Failed to write the term to the output file/stream.");
+  }
 }
 
 /**
   * Read a single symbol from file.
   */
 
-static function_symbol read_symbol(istream& is)
+static function_symbol read_symbol(detail::binary_input_buffer& is)
 {
-  std::size_t len=readString(is);
-
-  text_buffer[len] = '\0';
-
-  std::size_t arity = readInt(is);
-
-  return function_symbol(text_buffer, arity);
+  std::string name = is.read_string();
+  std::size_t arity = is.read_int();
+  return function_symbol(name, arity);
 }
 
 /**
  * Read all symbols from file.
  */
 
-static void read_all_symbols(istream& is, std::size_t nr_unique_symbols, std::vector<sym_read_entry>& read_symbols)
+static void read_all_symbols(detail::binary_input_buffer& is, std::size_t nr_unique_symbols, std::vector<sym_read_entry>& read_symbols)
 {
   std::size_t val;
 
@@ -700,7 +599,7 @@ static void read_all_symbols(istream& is, std::size_t nr_unique_symbols, std::ve
     read_symbols[i].sym = sym;
 
     /* Read term count and allocate space */
-    val = readInt(is);
+    val = is.read_int();
     if (val == 0)
     {
       throw mcrl2::runtime_error("Read file: internal file error: failed to read all function symbols.");
@@ -714,13 +613,13 @@ static void read_all_symbols(istream& is, std::size_t nr_unique_symbols, std::ve
 
     for (std::size_t j=0; j<sym.arity(); j++)
     {
-      val = readInt(is);
+      val = is.read_int();
       read_symbols[i].sym_width[j] = bit_width(val);
       read_symbols[i].topsyms[j] = std::vector<std::size_t>(val); 
 
       for (std::size_t k=0; k<read_symbols[i].topsyms[j].size(); k++)
       {
-        read_symbols[i].topsyms[j][k] = readInt(is);
+        read_symbols[i].topsyms[j][k] = is.read_int();
       }
     }
   }
@@ -742,7 +641,7 @@ struct read_todo
   }
 };
 
-static aterm read_term(sym_read_entry* sym, istream& is, std::vector<sym_read_entry>& read_symbols)
+static aterm read_term(sym_read_entry* sym, detail::binary_input_buffer& is, std::vector<sym_read_entry>& read_symbols)
 {
   aterm result;
   std::size_t value;
@@ -761,11 +660,11 @@ static aterm read_term(sym_read_entry* sym, istream& is, std::vector<sym_read_en
     // AS_INT is registered as having 1 argument, but that needs to be retrieved in a special way.
     if (current.sym->sym != detail::function_adm.AS_INT && current.args.size() < current.sym->sym.arity())
     {
-      if (readBits(value, current.sym->sym_width[current.args.size()], is) &&
+      if (is.read_bits(value, current.sym->sym_width[current.args.size()]) &&
           value < current.sym->topsyms[current.args.size()].size())
       {
         sym_read_entry* arg_sym = &read_symbols[current.sym->topsyms[current.args.size()][value]];
-        if (readBits(value, arg_sym->term_width, is) &&
+        if (is.read_bits(value, arg_sym->term_width) &&
             value < arg_sym->terms.size())
         {
           current.callresult = &arg_sym->terms[value];
@@ -781,7 +680,7 @@ static aterm read_term(sym_read_entry* sym, istream& is, std::vector<sym_read_en
 
     if (current.sym->sym == detail::function_adm.AS_INT)
     {
-      if (readBits(value, INT_SIZE_IN_BAF, is))
+      if (is.read_bits(value, INT_SIZE_IN_BAF))
       {
         *current.result = aterm_int(value);
       }
@@ -812,47 +711,62 @@ static aterm read_term(sym_read_entry* sym, istream& is, std::vector<sym_read_en
  */
 
 static
-aterm read_baf(istream& is)
+aterm read_baf(detail::binary_input_buffer& is)
 {
-  // Initialize bit buffer
-  bit_buffer     = '\0';
-  bits_in_buffer = 0; // how many bits in bit_buffer are used
-
   // Read header
-  std::size_t val = readInt(is);
+  std::size_t val = is.read_int();
   if (val == 0)
   {
-    val = readInt(is);
+    val = is.read_int();
   }
   if (val != BAF_MAGIC)
   {
     throw mcrl2::runtime_error("Error while reading file: The file is not correct as it does not have the BAF_MAGIC control sequence at the right place.");
   }
 
-  std::size_t version = readInt(is);
+  std::size_t version = is.read_int();
   if (version != BAF_VERSION)
   {
     throw mcrl2::runtime_error("The BAF version (" + std::to_string(version) + ") of the input file is incompatible with the version (" + std::to_string(BAF_VERSION) + 
                                ") of this tool. The input file must be regenerated. ");
   }
 
-  std::size_t nr_unique_symbols = readInt(is);
+  std::size_t nr_unique_symbols = is.read_int();
 
   // Allocate symbol space
   std::vector<sym_read_entry> read_symbols(nr_unique_symbols);
 
   read_all_symbols(is, nr_unique_symbols, read_symbols);
 
-  val = readInt(is);
+  val = is.read_int();
   aterm result=read_term(&read_symbols[val], is, read_symbols);
   return result;
 }
 
 
+aterm read_term_from_binary_buffer(const unsigned char* data, std::size_t size, std::size_t* bytes_read)
+{
+  detail::binary_input_buffer is(data, data + size);
+  aterm result=read_baf(is);
+  if (!result.defined())
+  {
+    throw mcrl2::runtime_error("Failed to read a term from the input. The file is not a proper binary file.");
+  }
+  if (bytes_read != nullptr)
+  {
+    *bytes_read = is.bytes_read();
+  }
+  return result;
+}
+
 aterm read_term_from_binary_stream(istream& is)
 {
   aterm_io_init(is);
-  aterm result=read_baf(is);
+
+  // The term is read directly from the stream buffer, which is left positioned
+  // directly after the term. This also works for streams that are not seekable.
+  detail::binary_input_buffer buffer(*is.rdbuf());
+  aterm result=read_baf(buffer);
   if (!result.defined())
   {
     throw mcrl2::runtime_error("Failed to read a term from the input. The file is not a proper binary file.");
@@ -860,4 +774,10 @@ aterm read_term_from_binary_stream(istream& is)
   return result;
 }
 
+aterm read_term_from_binary_file(const std::string& filename)
+{
+  mcrl2::utilities::memory_mapped_file file(filename);
+  return read_term_from_binary_buffer(file.data(), file.size());
+}
+
 } // namespace atermpp
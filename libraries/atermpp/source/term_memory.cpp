@@ -0,0 +1,365 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file atermpp/source/term_memory.cpp
+/// \brief This file contains the memory back end for blocks of terms and the
+///        term hashtable. Besides malloc it supports mapped memory with (transparent)
+///        huge pages and a NUMA placement policy.
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "mcrl2/atermpp/detail/aterm_implementation.h"
+#include "mcrl2/atermpp/detail/term_memory.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/logger.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace atermpp
+{
+
+namespace detail
+{
+
+static const std::size_t HUGE_PAGE_SIZE = std::size_t(1) << 21;
+
+// Blocks of terms are cut from chunks of this size.
+static const std::size_t CHUNK_SIZE = 8 * HUGE_PAGE_SIZE;
+
+struct term_memory_administration
+{
+  term_memory_options options;
+
+  // The mapped regions of memory, i.e. chunks and hashtables, with their sizes.
+  std::map<char*, std::size_t> regions;
+
+  // The unused part of the current chunk.
+  char* chunk_position = nullptr;
+  char* chunk_end = nullptr;
+
+  // A linked list of freed blocks in chunks; the first word of a block points to the next.
+  void* free_blocks = nullptr;
+
+  bool huge_pages_unavailable = false;
+
+  term_memory_administration()
+  {
+    const char* text = std::getenv("MCRL2_TERM_MEMORY");
+    if (text != nullptr)
+    {
+      try
+      {
+        options = parse_term_memory_options(text);
+      }
+      catch (mcrl2::runtime_error& e)
+      {
+        mCRL2log(mcrl2::log::warning) << "ignoring the value of MCRL2_TERM_MEMORY: " << e.what() << std::endl;
+      }
+    }
+#ifndef __linux__
+    options.pages = page_policy::standard;
+#endif
+  }
+};
+
+// The administration is a function local static, since terms may be created
+// during the initialisation of global variables in other translation units.
+static term_memory_administration& term_memory()
+{
+  static term_memory_administration administration;
+  return administration;
+}
+
+#ifdef __linux__
+// Returns a bit mask of the NUMA nodes that are online, as used by the mbind system call.
+static std::vector<unsigned long> online_numa_nodes()
+{
+  std::vector<unsigned long> result;
+  std::ifstream from("/sys/devices/system/node/online");
+  std::string text;
+  if (!std::getline(from, text))
+  {
+    return result;
+  }
+  const std::size_t bits = 8 * sizeof(unsigned long);
+  std::istringstream in(text);
+  std::string range;
+  while (std::getline(in, range, ','))
+  {
+    std::size_t first = 0;
+    std::size_t last = 0;
+    const std::size_t dash = range.find('-');
+    try
+    {
+      first = std::stoul(range.substr(0, dash));
+      last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+    }
+    catch (std::exception&)
+    {
+      return std::vector<unsigned long>();
+    }
+    for (std::size_t node = first; node <= last; node++)
+    {
+      if (result.size() <= node / bits)
+      {
+        result.resize(node / bits + 1, 0);
+      }
+      result[node / bits] |= 1ul << (node % bits);
+    }
+  }
+  return result;
+}
+
+static void apply_numa_policy(void* p, std::size_t size, numa_policy policy)
+{
+  // The values of the policies in linux/mempolicy.h.
+  const int MPOL_INTERLEAVE_ = 3;
+  const int MPOL_LOCAL_ = 4;
+
+  long result = 0;
+  if (policy == numa_policy::interleave)
+  {
+    static const std::vector<unsigned long> nodes = online_numa_nodes();
+    if (nodes.empty())
+    {
+      return;
+    }
+    result = syscall(SYS_mbind, p, size, MPOL_INTERLEAVE_, nodes.data(), 8 * sizeof(unsigned long) * nodes.size() + 1, 0);
+  }
+  else if (policy == numa_policy::first_touch)
+  {
+    result = syscall(SYS_mbind, p, size, MPOL_LOCAL_, nullptr, 0, 0);
+  }
+  if (result != 0)
+  {
+    mCRL2log(mcrl2::log::debug) << "could not set the NUMA policy of term memory" << std::endl;
+  }
+}
+
+// Maps an anonymous region of at least the given size, aligned at a huge page boundary.
+static void* map_memory(std::size_t size)
+{
+  term_memory_administration& m = term_memory();
+  size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  void* p = MAP_FAILED;
+  if (m.options.pages == page_policy::huge_pages && !m.huge_pages_unavailable)
+  {
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED)
+    {
+      m.huge_pages_unavailable = true;
+      mCRL2log(mcrl2::log::warning) << "no huge pages are available for terms, using transparent huge pages instead" << std::endl;
+    }
+  }
+  if (p == MAP_FAILED)
+  {
+    // Map an extra huge page, and remove the parts before and after the aligned region.
+    char* q = static_cast<char*>(mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (q == MAP_FAILED)
+    {
+      return nullptr;
+    }
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(q) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+    if (aligned > q)
+    {
+      munmap(q, aligned - q);
+    }
+    if (q + HUGE_PAGE_SIZE > aligned)
+    {
+      munmap(aligned + size, (q + HUGE_PAGE_SIZE) - aligned);
+    }
+    p = aligned;
+    madvise(p, size, MADV_HUGEPAGE);
+  }
+  apply_numa_policy(p, size, m.options.numa);
+  m.regions[static_cast<char*>(p)] = size;
+  return p;
+}
+
+static void unmap_memory(void* p)
+{
+  term_memory_administration& m = term_memory();
+  auto i = m.regions.find(static_cast<char*>(p));
+  assert(i != m.regions.end());
+  munmap(i->first, i->second);
+  m.regions.erase(i);
+}
+#else
+static void* map_memory(std::size_t)
+{
+  return nullptr;
+}
+
+static void unmap_memory(void*)
+{}
+#endif
+
+// Returns true if p is contained in a mapped region.
+static bool is_mapped(void* p)
+{
+  const std::map<char*, std::size_t>& regions = term_memory().regions;
+  auto i = regions.upper_bound(static_cast<char*>(p));
+  if (i == regions.begin())
+  {
+    return false;
+  }
+  --i;
+  return static_cast<char*>(p) < i->first + i->second;
+}
+
+void* allocate_term_block(std::size_t size)
+{
+  term_memory_administration& m = term_memory();
+  if (m.options.pages == page_policy::standard || size > BLOCK_SIZE)
+  {
+    return malloc(size);
+  }
+  if (m.free_blocks != nullptr)
+  {
+    void* result = m.free_blocks;
+    m.free_blocks = *static_cast<void**>(result);
+    return result;
+  }
+  if (m.chunk_position == m.chunk_end)
+  {
+    char* chunk = static_cast<char*>(map_memory(CHUNK_SIZE));
+    if (chunk == nullptr)
+    {
+      return malloc(size);
+    }
+    m.chunk_position = chunk;
+    m.chunk_end = chunk + CHUNK_SIZE;
+  }
+  void* result = m.chunk_position;
+  m.chunk_position += BLOCK_SIZE;
+  return result;
+}
+
+void free_term_block(void* block, std::size_t /* size */)
+{
+  term_memory_administration& m = term_memory();
+  if (is_mapped(block))
+  {
+    *static_cast<void**>(block) = m.free_blocks;
+    m.free_blocks = block;
+  }
+  else
+  {
+    free(block);
+  }
+}
+
+_aterm** allocate_term_hashtable(std::size_t number_of_entries)
+{
+  if (term_memory().options.pages != page_policy::standard)
+  {
+    // Anonymous mappings are filled with zeroes.
+    void* result = map_memory(number_of_entries * sizeof(_aterm*));
+    if (result != nullptr)
+    {
+      return static_cast<_aterm**>(result);
+    }
+  }
+  return static_cast<_aterm**>(calloc(number_of_entries, sizeof(_aterm*)));
+}
+
+void free_term_hashtable(_aterm** table, std::size_t /* number_of_entries */)
+{
+  if (term_memory().regions.count(reinterpret_cast<char*>(table)) > 0)
+  {
+    unmap_memory(table);
+  }
+  else
+  {
+    free(table);
+  }
+}
+
+} // namespace detail
+
+void set_term_memory_options(const term_memory_options& options)
+{
+  detail::term_memory_administration& m = detail::term_memory();
+  m.options = options;
+#ifndef __linux__
+  m.options.pages = page_policy::standard;
+#endif
+  // Blocks in the current chunk must not be handed out anymore if the policy changes.
+  m.chunk_position = m.chunk_end;
+  m.huge_pages_unavailable = false;
+  detail::reallocate_aterm_hashtable();
+}
+
+const term_memory_options& get_term_memory_options()
+{
+  return detail::term_memory().options;
+}
+
+term_memory_options parse_term_memory_options(const std::string& text)
+{
+  term_memory_options result;
+  std::istringstream in(text);
+  std::string word;
+  while (std::getline(in, word, ','))
+  {
+    if (word == "standard")
+    {
+      result.pages = page_policy::standard;
+    }
+    else if (word == "thp")
+    {
+      result.pages = page_policy::transparent_huge_pages;
+    }
+    else if (word == "huge")
+    {
+      result.pages = page_policy::huge_pages;
+    }
+    else if (word == "interleave")
+    {
+      result.numa = numa_policy::interleave;
+    }
+    else if (word == "first-touch")
+    {
+      result.numa = numa_policy::first_touch;
+    }
+    else if (!word.empty())
+    {
+      throw mcrl2::runtime_error("unknown term memory option " + word);
+    }
+  }
+  return result;
+}
+
+std::string print_term_memory_options(const term_memory_options& options)
+{
+  std::string result;
+  switch (options.pages)
+  {
+    case page_policy::standard: result = "standard"; break;
+    case page_policy::transparent_huge_pages: result = "thp"; break;
+    case page_policy::huge_pages: result = "huge"; break;
+  }
+  switch (options.numa)
+  {
+    case numa_policy::none: break;
+    case numa_policy::interleave: result += ",interleave"; break;
+    case numa_policy::first_touch: result += ",first-touch"; break;
+  }
+  return result;
+}
+
+} // namespace atermpp
@@ -0,0 +1,239 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file aterm_io_binary_test.cpp
+/// \brief Tests for the buffer based binary aterm format.
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/test/minimal.hpp>
+
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/aterm_list.h"
+#include "mcrl2/atermpp/detail/aterm_io_implementation.h"
+
+using namespace atermpp;
+
+// The bit by bit encoding of the original BAF implementation.
+struct reference_bit_writer
+{
+  std::vector<unsigned char> output;
+  unsigned char bit_buffer = 0;
+  std::size_t bits_in_buffer = 0;
+
+  void write_bits(std::size_t val, std::size_t nr_bits)
+  {
+    for (std::size_t i = 0; i < nr_bits; i++)
+    {
+      bit_buffer <<= 1;
+      bit_buffer |= (val & 0x01);
+      val >>= 1;
+      if (++bits_in_buffer == 8)
+      {
+        output.push_back(bit_buffer);
+        bits_in_buffer = 0;
+        bit_buffer = 0;
+      }
+    }
+  }
+
+  void flush()
+  {
+    if (bits_in_buffer > 0)
+    {
+      output.push_back(bit_buffer << (8 - bits_in_buffer));
+      bits_in_buffer = 0;
+      bit_buffer = 0;
+    }
+  }
+};
+
+void test_bit_buffers()
+{
+  std::vector<std::pair<std::size_t, std::size_t> > values;
+  std::size_t seed = 12345;
+  for (std::size_t i = 0; i < 1000; i++)
+  {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    std::size_t nr_bits = (seed >> 32) % 65;
+    std::size_t value = nr_bits == 64 ? seed : seed & ((std::size_t(1) << nr_bits) - 1);
+    values.emplace_back(value, nr_bits);
+  }
+
+  reference_bit_writer reference;
+  std::vector<unsigned char> output;
+  detail::binary_output_buffer buffer(output);
+  for (const auto& p: values)
+  {
+    reference.write_bits(p.first, p.second);
+    buffer.write_bits(p.first, p.second);
+  }
+  reference.flush();
+  buffer.flush_bits();
+  BOOST_CHECK(output == reference.output);
+
+  detail::binary_input_buffer input(output.data(), output.data() + output.size());
+  for (const auto& p: values)
+  {
+    std::size_t value;
+    BOOST_CHECK(input.read_bits(value, p.second));
+    BOOST_CHECK(value == p.first);
+  }
+  BOOST_CHECK(input.bytes_read() == output.size());
+}
+
+void test_ints()
+{
+  std::vector<std::size_t> values = { 0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 268435455, 268435456, 4294967295 };
+  std::vector<unsigned char> output;
+  detail::binary_output_buffer buffer(output);
+  for (std::size_t value: values)
+  {
+    buffer.write_int(value);
+  }
+  buffer.write_string("abc");
+  detail::binary_input_buffer input(output.data(), output.data() + output.size());
+  for (std::size_t value: values)
+  {
+    BOOST_CHECK(input.read_int() == value);
+  }
+  BOOST_CHECK(input.read_string() == "abc");
+  BOOST_CHECK(input.bytes_read() == output.size());
+}
+
+void test_buffer_io(const std::string& text)
+{
+  const aterm t = read_term_from_string(text);
+  std::vector<unsigned char> buffer;
+  write_term_to_binary_buffer(t, buffer);
+  std::size_t bytes_read = 0;
+  BOOST_CHECK(read_term_from_binary_buffer(buffer.data(), buffer.size(), &bytes_read) == t);
+  BOOST_CHECK(bytes_read == buffer.size());
+}
+
+// Two terms written to the same stream can be read back one after the other.
+void test_consecutive_terms()
+{
+  const aterm t1 = read_term_from_string("f([a,f(x),[]],2,[g,g(34566)])");
+  const aterm t2 = aterm_int(1234567890123ULL);
+  std::stringstream stream;
+  write_term_to_binary_stream(t1, stream);
+  write_term_to_binary_stream(t2, stream);
+  BOOST_CHECK(read_term_from_binary_stream(stream) == t1);
+  BOOST_CHECK(read_term_from_binary_stream(stream) == t2);
+}
+
+// A stream buffer that hands out its input in small pieces and does not support
+// positioning, like a pipe.
+class pipe_buffer: public std::streambuf
+{
+  protected:
+    std::string m_input;
+    std::size_t m_position = 0;
+    char m_piece[3];
+
+    int_type underflow() override
+    {
+      if (m_position == m_input.size())
+      {
+        return traits_type::eof();
+      }
+      const std::size_t n = std::min(sizeof(m_piece), m_input.size() - m_position);
+      std::copy(m_input.begin() + m_position, m_input.begin() + m_position + n, m_piece);
+      m_position += n;
+      setg(m_piece, m_piece, m_piece + n);
+      return traits_type::to_int_type(m_piece[0]);
+    }
+
+  public:
+    explicit pipe_buffer(const std::string& input)
+      : m_input(input)
+    {}
+};
+
+// The input after a term is not consumed when reading from a stream that is not seekable.
+void test_pipe()
+{
+  const aterm t1 = read_term_from_string("f([a,f(x),[]],2,[g,g(34566)])");
+  const aterm t2 = read_term_from_string("[a,b,[]]");
+  std::ostringstream out;
+  write_term_to_binary_stream(t1, out);
+  write_term_to_binary_stream(t2, out);
+  out << "rest";
+  pipe_buffer buffer(out.str());
+  std::istream in(&buffer);
+  BOOST_CHECK(read_term_from_binary_stream(in) == t1);
+  BOOST_CHECK(read_term_from_binary_stream(in) == t2);
+  std::string rest;
+  in >> rest;
+  BOOST_CHECK(rest == "rest");
+}
+
+// A stream buffer that records the largest piece of output it is given at once.
+class recording_buffer: public std::streambuf
+{
+  public:
+    std::string output;
+    std::size_t largest_write = 0;
+
+  protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+      output.append(s, n);
+      largest_write = std::max(largest_write, static_cast<std::size_t>(n));
+      return n;
+    }
+
+    int_type overflow(int_type c) override
+    {
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+        output.push_back(traits_type::to_char_type(c));
+        largest_write = std::max(largest_write, std::size_t(1));
+      }
+      return traits_type::not_eof(c);
+    }
+};
+
+// A large term is written to a stream in pieces, with the same bytes as to a buffer.
+void test_large_term()
+{
+  aterm_list l;
+  for (std::size_t i = 0; i < 200000; i++)
+  {
+    l.push_front(aterm_int(i));
+  }
+  const aterm t = l;
+  std::vector<unsigned char> buffer;
+  write_term_to_binary_buffer(t, buffer);
+  recording_buffer recording;
+  std::ostream out(&recording);
+  write_term_to_binary_stream(t, out);
+  BOOST_CHECK(std::string(buffer.begin(), buffer.end()) == recording.output);
+  BOOST_CHECK(recording.largest_write < buffer.size() / 4);
+  std::istringstream in(recording.output);
+  BOOST_CHECK(read_term_from_binary_stream(in) == t);
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_bit_buffers();
+  test_ints();
+  test_buffer_io("17");
+  test_buffer_io("f(g,h)");
+  test_buffer_io("[a,b,[]]");
+  test_buffer_io("f([a,f(x),[]],2,[g,g(34566)])");
+  test_consecutive_terms();
+  test_pipe();
+  test_large_term();
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file concurrent_indexed_set_test.cpp
+/// \brief Tests for the concurrent indexed set.
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/test/minimal.hpp>
+
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
+
+using namespace atermpp;
+
+void test_sequential()
+{
+  concurrent_indexed_set<aterm> t(16, 75);
+  std::pair<std::size_t, bool> p = t.put(read_term_from_string("a"));
+  BOOST_CHECK(p.first == 0 && p.second);
+  p = t.put(read_term_from_string("b"));
+  BOOST_CHECK(p.first == 1 && p.second);
+  p = t.put(read_term_from_string("a"));
+  BOOST_CHECK(p.first == 0 && !p.second);
+  BOOST_CHECK(t.size() == 2);
+  BOOST_CHECK(t.index(read_term_from_string("b")) == 1);
+  BOOST_CHECK(t.index(read_term_from_string("c")) == concurrent_indexed_set<aterm>::npos);
+  BOOST_CHECK(t.get(1) == read_term_from_string("b"));
+
+  // Force a number of resizes.
+  for (std::size_t i = 0; i < 10000; i++)
+  {
+    t.put(read_term_from_string("f(" + std::to_string(i) + ")"));
+  }
+  BOOST_CHECK(t.size() == 10002);
+  BOOST_CHECK(t.index(read_term_from_string("a")) == 0);
+  BOOST_CHECK(t.get(t.index(read_term_from_string("f(5000)"))) == read_term_from_string("f(5000)"));
+
+  t.clear();
+  BOOST_CHECK(t.size() == 0);
+  BOOST_CHECK(t.index(read_term_from_string("a")) == concurrent_indexed_set<aterm>::npos);
+}
+
+// Several threads insert overlapping ranges of numbers. Every number must get
+// exactly one index, and the indices must be dense.
+void test_concurrent()
+{
+  const std::size_t number_of_threads = 4;
+  const std::size_t n = 200000;
+  concurrent_indexed_set<std::size_t> t(16);
+  std::vector<std::vector<std::size_t> > indices(number_of_threads, std::vector<std::size_t>(n));
+
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < number_of_threads; k++)
+  {
+    threads.emplace_back([&, k]()
+      {
+        for (std::size_t i = 0; i < n; i++)
+        {
+          // Each thread inserts the numbers in a different order.
+          const std::size_t x = (k % 2 == 0) ? i : n - 1 - i;
+          indices[k][x] = t.put(x).first;
+        }
+      });
+  }
+  for (std::thread& thread: threads)
+  {
+    thread.join();
+  }
+
+  BOOST_CHECK(t.size() == n);
+  std::vector<bool> used(n, false);
+  for (std::size_t x = 0; x < n; x++)
+  {
+    const std::size_t i = indices[0][x];
+    BOOST_CHECK(i < n && !used[i]);
+    used[i] = true;
+    BOOST_CHECK(t.get(i) == x);
+    BOOST_CHECK(t.index(x) == i);
+    for (std::size_t k = 1; k < number_of_threads; k++)
+    {
+      BOOST_CHECK(indices[k][x] == i);
+    }
+  }
+}
+
+// Lookups run concurrently with insertions and resizes. A lookup either does not find
+// a number, or finds the index under which it has been inserted.
+void test_concurrent_lookups()
+{
+  const std::size_t n = 200000;
+  concurrent_indexed_set<std::size_t> t(16);
+  std::atomic<bool> done(false);
+  std::atomic<std::size_t> errors(0);
+
+  std::thread writer([&]()
+    {
+      for (std::size_t x = 0; x < n; x++)
+      {
+        t.put(x);
+      }
+      done.store(true);
+    });
+  std::vector<std::thread> readers;
+  for (std::size_t k = 0; k < 3; k++)
+  {
+    readers.emplace_back([&, k]()
+      {
+        std::size_t x = k;
+        while (!done.load())
+        {
+          const std::size_t i = t.index(x % n);
+          if (i != concurrent_indexed_set<std::size_t>::npos && t.get(i) != x % n)
+          {
+            errors.fetch_add(1);
+          }
+          x += 7;
+        }
+      });
+  }
+  writer.join();
+  for (std::thread& reader: readers)
+  {
+    reader.join();
+  }
+  BOOST_CHECK(errors.load() == 0);
+  for (std::size_t x = 0; x < n; x++)
+  {
+    BOOST_CHECK(t.index(x) == x);
+  }
+}
+
+// Readers retrieve every index below size() while several writers insert elements.
+// An index may be assigned before its element has been constructed; get waits for it.
+void test_concurrent_get()
+{
+  const std::size_t n = 200000;
+  concurrent_indexed_set<std::size_t> t(16);
+  std::atomic<std::size_t> writers_done(0);
+  std::atomic<std::size_t> errors(0);
+
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < 3; k++)
+  {
+    threads.emplace_back([&, k]()
+      {
+        for (std::size_t x = k; x < n; x += 3)
+        {
+          t.put(x);
+        }
+        writers_done.fetch_add(1);
+      });
+  }
+  for (std::size_t k = 0; k < 2; k++)
+  {
+    threads.emplace_back([&]()
+      {
+        std::size_t i = 0;
+        while (writers_done.load() < 3 || i < t.size())
+        {
+          if (i < t.size())
+          {
+            const std::size_t x = t.get(i);
+            if (x >= n || t.index(x) != i)
+            {
+              errors.fetch_add(1);
+            }
+            i++;
+          }
+        }
+      });
+  }
+  for (std::thread& thread: threads)
+  {
+    thread.join();
+  }
+  BOOST_CHECK(errors.load() == 0);
+  BOOST_CHECK(t.size() == n);
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_sequential();
+  test_concurrent();
+  test_concurrent_lookups();
+  test_concurrent_get();
+  return 0;
+}
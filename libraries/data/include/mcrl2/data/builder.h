@@ -43,6 +43,7 @@
 #include "mcrl2/data/variable_assignment.h"
 #include "mcrl2/data/where_clause.h"
 #include <functional>
+#include <unordered_map>
 
 
 namespace mcrl2
@@ -934,6 +935,63 @@ struct variable_builder: public add_variables<core::builder, Derived>
 };
 //--- end generated add_variables code ---//
 
+/// \brief Builder layer that memoizes the results of apply on data expressions.
+/// \details Terms are maximally shared, so a data expression may occur many times
+/// in an object. With this layer each distinct application, abstraction or where
+/// clause is rebuilt only once per builder object; subsequent occurrences take the
+/// result from a cache. It may only be used by builders for which the result of
+/// applying them to a data expression does not depend on the context in which the
+/// expression occurs, so in particular not in combination with variable binding.
+template <template <class> class Builder, class Derived>
+struct add_data_expression_cache: public Builder<Derived>
+{
+  typedef Builder<Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+
+  std::unordered_map<data_expression, data_expression> m_data_expression_cache;
+
+  data_expression apply(const data_expression& x)
+  {
+    if (is_variable(x) || is_function_symbol(x))
+    {
+      return super::apply(x);
+    }
+    auto i = m_data_expression_cache.find(x);
+    if (i != m_data_expression_cache.end())
+    {
+      return i->second;
+    }
+    data_expression result = super::apply(x);
+    m_data_expression_cache.insert(std::make_pair(x, result));
+    return result;
+  }
+};
+
+/// \brief Data expression builder that memoizes its results for shared subterms
+template <typename Derived>
+struct cached_data_expression_builder: public add_data_expression_cache<data::data_expression_builder, Derived>
+{
+  typedef add_data_expression_cache<data::data_expression_builder, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+};
+
+/// \brief Variable builder that memoizes its results for shared subterms
+template <typename Derived>
+struct cached_variable_builder: public add_data_expression_cache<data::variable_builder, Derived>
+{
+  typedef add_data_expression_cache<data::variable_builder, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+};
+
 } // namespace data
 
 } // namespace mcrl2
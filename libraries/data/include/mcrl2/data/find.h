@@ -17,9 +17,12 @@
 #include "mcrl2/data/detail/data_functional.h"
 #include "mcrl2/data/traverser.h"
 #include "mcrl2/data/variable.h"
+#include <algorithm>
 #include <functional>
 #include <iterator>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace mcrl2
 {
@@ -220,6 +223,95 @@ make_find_free_variables_traverser(OutputIterator out, const VariableContainer&
   return find_free_variables_traverser<Traverser, Binder, OutputIterator>(out, v);
 }
 
+/// \brief Variant of find_free_variables_traverser that exploits the sharing of terms.
+/// \details For each traversed data expression the set of variables is stored that
+/// were not written to the output because they were bound in the context of the
+/// expression. A next occurrence of the expression is skipped if all of these
+/// variables are bound again, since then it cannot contribute new variables. As a
+/// consequence a variable may be written to the output fewer times than it occurs,
+/// so the output should be collected in a set.
+template <template <class> class Traverser, template <template <class> class, class> class Binder, class OutputIterator>
+struct cached_find_free_variables_traverser: public Binder<Traverser, cached_find_free_variables_traverser<Traverser, Binder, OutputIterator> >
+{
+  typedef Binder<Traverser, cached_find_free_variables_traverser<Traverser, Binder, OutputIterator> > super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+  using super::is_bound;
+  using super::bound_variables;
+  using super::increase_bind_count;
+
+  OutputIterator out;
+
+  // Maps data expressions to the bound variables that were skipped while traversing them.
+  std::unordered_map<data_expression, variable_list> visited;
+
+  // The bound variables that were skipped during the current traversal.
+  std::vector<variable> skipped;
+
+  cached_find_free_variables_traverser(OutputIterator out_)
+    : out(out_)
+  {}
+
+  template <typename VariableContainer>
+  cached_find_free_variables_traverser(OutputIterator out_, const VariableContainer& v)
+    : out(out_)
+  {
+    increase_bind_count(v);
+  }
+
+  void apply(const variable& v)
+  {
+    if (is_bound(v))
+    {
+      skipped.push_back(v);
+    }
+    else
+    {
+      *out = v;
+    }
+  }
+
+  void apply(const data_expression& x)
+  {
+    if (is_variable(x) || is_function_symbol(x))
+    {
+      super::apply(x);
+      return;
+    }
+    auto i = visited.find(x);
+    if (i != visited.end() && std::all_of(i->second.begin(), i->second.end(), [&](const variable& v) { return is_bound(v); }))
+    {
+      skipped.insert(skipped.end(), i->second.begin(), i->second.end());
+      return;
+    }
+    const std::size_t first = skipped.size();
+    super::apply(x);
+
+    // Variables that are bound inside x only are removed, and duplicates are removed
+    // to keep the vector skipped small.
+    auto last = std::remove_if(skipped.begin() + first, skipped.end(), [&](const variable& v) { return !is_bound(v); });
+    std::sort(skipped.begin() + first, last);
+    last = std::unique(skipped.begin() + first, last);
+    skipped.erase(last, skipped.end());
+    visited[x] = variable_list(skipped.begin() + first, skipped.end());
+  }
+};
+
+template <template <class> class Traverser, template <template <class> class, class> class Binder, class OutputIterator>
+cached_find_free_variables_traverser<Traverser, Binder, OutputIterator>
+make_cached_find_free_variables_traverser(OutputIterator out)
+{
+  return cached_find_free_variables_traverser<Traverser, Binder, OutputIterator>(out);
+}
+
+template <template <class> class Traverser, template <template <class> class, class> class Binder, class OutputIterator, class VariableContainer>
+cached_find_free_variables_traverser<Traverser, Binder, OutputIterator>
+make_cached_find_free_variables_traverser(OutputIterator out, const VariableContainer& v)
+{
+  return cached_find_free_variables_traverser<Traverser, Binder, OutputIterator>(out, v);
+}
+
 template <template <class> class Traverser>
 struct search_variable_traverser: public Traverser<search_variable_traverser<Traverser> >
 {
@@ -13,6 +13,7 @@
 #define MCRL2_DATA_TRAVERSER_H
 
 #include <type_traits>
+#include <unordered_set>
 
 #include "mcrl2/core/traverser.h"
 #include "mcrl2/data/alias.h"
@@ -1193,6 +1194,53 @@ struct identifier_string_traverser: public add_traverser_identifier_strings<core
 };
 //--- end generated add_traverser_identifier_strings code ---//
 
+/// \brief Traverser layer that visits every distinct data expression only once.
+/// \details Terms are maximally shared, so a data expression may occur many times
+/// in an object. With this layer the traversal of an application, abstraction or
+/// where clause that has already been visited by the same traverser object is
+/// skipped. It may only be used by traversers whose effect does not depend on the
+/// context in which an expression occurs, and for which visiting an expression a
+/// second time has no additional effect, like collecting elements in a set.
+template <template <class> class Traverser, class Derived>
+struct add_visited_data_expressions: public Traverser<Derived>
+{
+  typedef Traverser<Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+
+  std::unordered_set<data_expression> m_visited_data_expressions;
+
+  void apply(const data_expression& x)
+  {
+    if (!is_variable(x) && !is_function_symbol(x) && !m_visited_data_expressions.insert(x).second)
+    {
+      return;
+    }
+    super::apply(x);
+  }
+};
+
+/// \brief Data expression traverser that visits shared subterms only once
+template <typename Derived>
+struct cached_data_expression_traverser: public add_visited_data_expressions<data::data_expression_traverser, Derived>
+{
+  typedef add_visited_data_expressions<data::data_expression_traverser, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+};
+
+/// \brief Variable traverser that visits shared subterms only once
+template <typename Derived>
+struct cached_variable_traverser: public add_visited_data_expressions<data::variable_traverser, Derived>
+{
+  typedef add_visited_data_expressions<data::variable_traverser, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+};
+
 } // namespace data
 
 } // namespace mcrl2
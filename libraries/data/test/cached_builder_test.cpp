@@ -0,0 +1,109 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file cached_builder_test.cpp
+/// \brief Tests for builders and traversers that memoize shared subterms.
+
+#include <boost/test/minimal.hpp>
+#include <iterator>
+#include <set>
+
+#include "mcrl2/data/find.h"
+#include "mcrl2/data/forall.h"
+#include "mcrl2/data/nat.h"
+#include "mcrl2/data/replace.h"
+#include "mcrl2/data/substitutions/mutable_map_substitution.h"
+
+using namespace mcrl2;
+using namespace mcrl2::data;
+
+// Returns the expression e_n, with e_0 = x and e_{i+1} = e_i + e_i. As a tree it
+// has 2^n leaves, but due to maximal sharing it consists of only n + 1 terms.
+data_expression shared_sum(const data_expression& x, std::size_t n)
+{
+  data_expression result = x;
+  for (std::size_t i = 0; i < n; i++)
+  {
+    result = sort_nat::plus(result, result);
+  }
+  return result;
+}
+
+void test_cached_builder()
+{
+  const std::size_t n = 64;
+  variable x("x", sort_nat::nat());
+  variable y("y", sort_nat::nat());
+  mutable_map_substitution<> sigma;
+  sigma[x] = y;
+
+  data_expression e = shared_sum(x, n);
+  data_expression result = core::make_update_apply_builder<data::cached_data_expression_builder>(sigma).apply(e);
+  BOOST_CHECK(result == shared_sum(y, n));
+
+  mutable_map_substitution<std::map<variable, variable> > tau;
+  tau[x] = y;
+  result = core::make_update_apply_builder<data::cached_variable_builder>(tau).apply(e);
+  BOOST_CHECK(result == shared_sum(y, n));
+
+  // The results must be the same as those of the builders without a cache.
+  data_expression small = shared_sum(x, 4);
+  BOOST_CHECK(core::make_update_apply_builder<data::cached_data_expression_builder>(sigma).apply(small) == data::replace_variables(small, sigma));
+}
+
+void test_cached_traverser()
+{
+  const std::size_t n = 64;
+  variable x("x", sort_nat::nat());
+  variable y("y", sort_nat::nat());
+
+  data_expression e = shared_sum(sort_nat::plus(x, y), n);
+  std::set<variable> v;
+  data::detail::make_find_all_variables_traverser<data::cached_variable_traverser>(std::inserter(v, v.end())).apply(e);
+  BOOST_CHECK(v == std::set<variable>({ x, y }));
+
+  std::set<function_symbol> f;
+  data::detail::make_find_function_symbols_traverser<data::cached_data_expression_traverser>(std::inserter(f, f.end())).apply(e);
+  BOOST_CHECK(f == data::find_function_symbols(sort_nat::plus(x, y)));
+}
+
+void test_cached_find_free_variables()
+{
+  const std::size_t n = 64;
+  variable x("x", sort_nat::nat());
+  variable y("y", sort_nat::nat());
+  data_expression e = shared_sum(sort_nat::plus(x, y), n);
+
+  // The shared subterm e occurs both inside and outside the scope of y.
+  data_expression b1 = equal_to(e, x);
+  data_expression b2 = sort_bool::and_(forall(variable_list({ y }), b1), b1);
+  data_expression b3 = sort_bool::and_(b1, forall(variable_list({ y }), b1));
+
+  for (const data_expression& b: { b1, b2, b3 })
+  {
+    std::set<variable> v;
+    data::detail::make_cached_find_free_variables_traverser<data::data_expression_traverser, data::add_data_variable_binding>(std::inserter(v, v.end())).apply(b);
+    BOOST_CHECK(v == std::set<variable>({ x, y }));
+  }
+
+  std::set<variable> v;
+  data::detail::make_cached_find_free_variables_traverser<data::data_expression_traverser, data::add_data_variable_binding>(std::inserter(v, v.end())).apply(forall(variable_list({ y }), b1));
+  BOOST_CHECK(v == std::set<variable>({ x }));
+
+  v.clear();
+  data::detail::make_cached_find_free_variables_traverser<data::data_expression_traverser, data::add_data_variable_binding>(std::inserter(v, v.end()), variable_list({ x })).apply(b1);
+  BOOST_CHECK(v == std::set<variable>({ y }));
+}
+
+int test_main(int argc, char* argv[])
+{
+  test_cached_builder();
+  test_cached_traverser();
+  test_cached_find_free_variables();
+  return 0;
+}
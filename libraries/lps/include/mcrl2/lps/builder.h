@@ -427,6 +427,28 @@ struct variable_builder: public add_variables<process::data_expression_builder,
 };
 //--- end generated add_variables code ---//
 
+/// \brief Data expression builder that memoizes its results for shared data expressions
+template <typename Derived>
+struct cached_data_expression_builder: public data::add_data_expression_cache<lps::data_expression_builder, Derived>
+{
+  typedef data::add_data_expression_cache<lps::data_expression_builder, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+};
+
+/// \brief Variable builder that memoizes its results for shared data expressions
+template <typename Derived>
+struct cached_variable_builder: public data::add_data_expression_cache<lps::variable_builder, Derived>
+{
+  typedef data::add_data_expression_cache<lps::variable_builder, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+};
+
 } // namespace lps
 
 } // namespace mcrl2
@@ -0,0 +1,526 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/ldd.h
+/// \brief List decision diagrams (LDDs) for representing sets of vectors of natural numbers.
+
+#ifndef MCRL2_LPS_DETAIL_LDD_H
+#define MCRL2_LPS_DETAIL_LDD_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+
+namespace lps
+{
+
+namespace detail
+{
+
+/// \brief An LDD is represented by the index of its root node in an ldd_manager.
+typedef std::uint32_t ldd;
+
+/// \brief Stores the nodes of list decision diagrams, and implements the operations on them.
+/// \details A node (value, down, right) represents the vectors that start with value and continue
+/// with a vector of down, together with the vectors of right. The values along a right chain are
+/// strictly increasing. The terminal false represents the empty set, and the terminal true the set
+/// that contains only the empty vector. All vectors in a set have the same length.
+///
+/// Nodes are hash-consed: they are stored contiguously in a vector, and an open addressing hash
+/// table with linear probing maps them to their index. Operations are memoized in a direct mapped
+/// cache of fixed size, in which an entry is overwritten on a collision. Nodes are never removed,
+/// hence cached results stay valid.
+class ldd_manager
+{
+  public:
+    static constexpr ldd false_ = 0;
+    static constexpr ldd true_ = 1;
+
+  protected:
+    struct node
+    {
+      std::uint32_t value;
+      ldd down;
+      ldd right;
+    };
+
+    struct cache_entry
+    {
+      std::uint32_t operation = 0; // 0 means that the entry is empty
+      std::uint32_t x = 0;
+      std::uint32_t y = 0;
+      std::uint32_t z = 0;
+      ldd result = 0;
+    };
+
+    enum operation_kind
+    {
+      op_union = 1,
+      op_minus = 2,
+      op_project = 3,
+      op_relprod = 4
+    };
+
+    // The projection and relational product depend on the parameters used by a group.
+    struct group_meta
+    {
+      std::vector<bool> used;
+      std::size_t last_used;
+    };
+
+    std::vector<node> m_nodes;
+    std::vector<ldd> m_table;      // 0 marks an empty slot
+    std::vector<cache_entry> m_cache;
+    std::vector<group_meta> m_groups;
+    std::unordered_map<ldd, double> m_count_cache;
+
+    // Temporary storage for the (value, down) pairs of a right chain that is being built.
+    std::vector<std::pair<std::uint32_t, ldd> > m_stack;
+
+    static std::size_t hash(std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d = 0)
+    {
+      std::uint64_t h = (std::uint64_t(a) << 32 | b) * 0x9e3779b97f4a7c15ULL;
+      h ^= (std::uint64_t(c) << 32 | d) + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2);
+      h *= 0xff51afd7ed558ccdULL;
+      return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    void resize_table()
+    {
+      std::vector<ldd> table(2 * m_table.size(), 0);
+      const std::size_t mask = table.size() - 1;
+      for (std::size_t i = 2; i < m_nodes.size(); i++)
+      {
+        const node& n = m_nodes[i];
+        std::size_t j = hash(n.value, n.down, n.right) & mask;
+        while (table[j] != 0)
+        {
+          j = (j + 1) & mask;
+        }
+        table[j] = static_cast<ldd>(i);
+      }
+      m_table.swap(table);
+    }
+
+    cache_entry& cache_slot(std::uint32_t operation, std::uint32_t x, std::uint32_t y, std::uint32_t z)
+    {
+      return m_cache[hash(operation, x, y, z) & (m_cache.size() - 1)];
+    }
+
+    bool cache_lookup(std::uint32_t operation, std::uint32_t x, std::uint32_t y, std::uint32_t z, ldd& result)
+    {
+      const cache_entry& e = cache_slot(operation, x, y, z);
+      if (e.operation == operation && e.x == x && e.y == y && e.z == z)
+      {
+        result = e.result;
+        return true;
+      }
+      return false;
+    }
+
+    void cache_insert(std::uint32_t operation, std::uint32_t x, std::uint32_t y, std::uint32_t z, ldd result)
+    {
+      cache_entry& e = cache_slot(operation, x, y, z);
+      e.operation = operation;
+      e.x = x;
+      e.y = y;
+      e.z = z;
+      e.result = result;
+    }
+
+    static std::uint32_t group_operation(operation_kind kind, std::size_t group)
+    {
+      return static_cast<std::uint32_t>(kind + 8 * group);
+    }
+
+    // Builds the right chain of the pairs on m_stack from position base, followed by rest,
+    // and removes them from the stack.
+    ldd build_chain(std::size_t base, ldd rest)
+    {
+      ldd result = rest;
+      for (std::size_t i = m_stack.size(); i > base; i--)
+      {
+        result = make_node(m_stack[i - 1].first, m_stack[i - 1].second, result);
+      }
+      m_stack.resize(base);
+      return result;
+    }
+
+    ldd project(ldd a, std::size_t group, std::size_t level)
+    {
+      const group_meta& meta = m_groups[group];
+      if (a == false_)
+      {
+        return false_;
+      }
+      if (level > meta.last_used)
+      {
+        return true_;
+      }
+      ldd result;
+      const std::uint32_t operation = group_operation(op_project, group);
+      if (cache_lookup(operation, a, static_cast<std::uint32_t>(level), 0, result))
+      {
+        return result;
+      }
+      if (meta.used[level])
+      {
+        std::size_t base = m_stack.size();
+        for (ldd x = a; x != false_; x = right(x))
+        {
+          ldd d = project(down(x), group, level + 1);
+          m_stack.emplace_back(value(x), d);
+        }
+        result = build_chain(base, false_);
+      }
+      else
+      {
+        result = false_;
+        for (ldd x = a; x != false_; x = right(x))
+        {
+          result = set_union(result, project(down(x), group, level + 1));
+        }
+      }
+      cache_insert(operation, a, static_cast<std::uint32_t>(level), 0, result);
+      return result;
+    }
+
+    ldd relprod(ldd s, ldd r, std::size_t group, std::size_t level)
+    {
+      const group_meta& meta = m_groups[group];
+      if (s == false_ || r == false_)
+      {
+        return false_;
+      }
+      if (level > meta.last_used)
+      {
+        return s;
+      }
+      ldd result;
+      const std::uint32_t operation = group_operation(op_relprod, group);
+      if (cache_lookup(operation, s, r, static_cast<std::uint32_t>(level), result))
+      {
+        return result;
+      }
+      if (!meta.used[level])
+      {
+        // The value of this parameter is copied.
+        std::size_t base = m_stack.size();
+        for (ldd x = s; x != false_; x = right(x))
+        {
+          ldd d = relprod(down(x), r, group, level + 1);
+          if (d != false_)
+          {
+            m_stack.emplace_back(value(x), d);
+          }
+        }
+        result = build_chain(base, false_);
+      }
+      else
+      {
+        // The values of s are matched with the read values of r, and replaced by the written values.
+        result = false_;
+        ldd x = s;
+        ldd y = r;
+        while (x != false_ && y != false_)
+        {
+          if (value(x) < value(y))
+          {
+            x = right(x);
+          }
+          else if (value(x) > value(y))
+          {
+            y = right(y);
+          }
+          else
+          {
+            std::size_t base = m_stack.size();
+            for (ldd w = down(y); w != false_; w = right(w))
+            {
+              ldd d = relprod(down(x), down(w), group, level + 1);
+              if (d != false_)
+              {
+                m_stack.emplace_back(value(w), d);
+              }
+            }
+            result = set_union(result, build_chain(base, false_));
+            x = right(x);
+            y = right(y);
+          }
+        }
+      }
+      cache_insert(operation, s, r, static_cast<std::uint32_t>(level), result);
+      return result;
+    }
+
+    template <typename Function>
+    void enumerate(ldd a, std::vector<std::uint32_t>& v, Function& f) const
+    {
+      if (a == true_)
+      {
+        f(const_cast<const std::vector<std::uint32_t>&>(v));
+        return;
+      }
+      for (ldd x = a; x != false_; x = right(x))
+      {
+        v.push_back(value(x));
+        enumerate(down(x), v, f);
+        v.pop_back();
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param log_cache_size The base 2 logarithm of the number of entries of the operation cache.
+    explicit ldd_manager(std::size_t log_cache_size = 20)
+      : m_nodes(2, node{0, 0, 0}),
+        m_table(std::size_t(1) << 16, 0),
+        m_cache(std::size_t(1) << log_cache_size)
+    {}
+
+    /// \brief Returns the number of nodes, including the terminals.
+    std::size_t node_count() const
+    {
+      return m_nodes.size();
+    }
+
+    std::uint32_t value(ldd a) const
+    {
+      assert(a > true_);
+      return m_nodes[a].value;
+    }
+
+    ldd down(ldd a) const
+    {
+      assert(a > true_);
+      return m_nodes[a].down;
+    }
+
+    ldd right(ldd a) const
+    {
+      assert(a > true_);
+      return m_nodes[a].right;
+    }
+
+    /// \brief Returns the node (value, down, right). If down is false, right is returned.
+    /// \pre If right is not false, value is smaller than the value of right.
+    ldd make_node(std::uint32_t value, ldd down, ldd right)
+    {
+      if (down == false_)
+      {
+        return right;
+      }
+      assert(right == false_ || value < m_nodes[right].value);
+      if (2 * m_nodes.size() > m_table.size())
+      {
+        resize_table();
+      }
+      const std::size_t mask = m_table.size() - 1;
+      std::size_t j = hash(value, down, right) & mask;
+      while (m_table[j] != 0)
+      {
+        const node& n = m_nodes[m_table[j]];
+        if (n.value == value && n.down == down && n.right == right)
+        {
+          return m_table[j];
+        }
+        j = (j + 1) & mask;
+      }
+      if (m_nodes.size() >= (std::numeric_limits<ldd>::max)())
+      {
+        throw mcrl2::runtime_error("the number of LDD nodes exceeds the maximum");
+      }
+      m_nodes.push_back(node{value, down, right});
+      m_table[j] = static_cast<ldd>(m_nodes.size() - 1);
+      return m_table[j];
+    }
+
+    /// \brief Returns the set that contains only the vector v.
+    ldd singleton(const std::vector<std::uint32_t>& v)
+    {
+      ldd result = true_;
+      for (std::size_t i = v.size(); i > 0; i--)
+      {
+        result = make_node(v[i - 1], result, false_);
+      }
+      return result;
+    }
+
+    /// \brief Returns the union of a and b.
+    ldd set_union(ldd a, ldd b)
+    {
+      if (a == b || b == false_)
+      {
+        return a;
+      }
+      if (a == false_)
+      {
+        return b;
+      }
+      if (a > b)
+      {
+        std::swap(a, b);
+      }
+      ldd result;
+      if (cache_lookup(op_union, a, b, 0, result))
+      {
+        return result;
+      }
+      std::size_t base = m_stack.size();
+      ldd x = a;
+      ldd y = b;
+      while (x != false_ && y != false_)
+      {
+        if (value(x) < value(y))
+        {
+          m_stack.emplace_back(value(x), down(x));
+          x = right(x);
+        }
+        else if (value(x) > value(y))
+        {
+          m_stack.emplace_back(value(y), down(y));
+          y = right(y);
+        }
+        else
+        {
+          ldd d = set_union(down(x), down(y));
+          m_stack.emplace_back(value(x), d);
+          x = right(x);
+          y = right(y);
+        }
+      }
+      result = build_chain(base, x != false_ ? x : y);
+      cache_insert(op_union, a, b, 0, result);
+      return result;
+    }
+
+    /// \brief Returns the difference of a and b.
+    ldd set_minus(ldd a, ldd b)
+    {
+      if (a == b || a == false_)
+      {
+        return false_;
+      }
+      if (b == false_)
+      {
+        return a;
+      }
+      ldd result;
+      if (cache_lookup(op_minus, a, b, 0, result))
+      {
+        return result;
+      }
+      std::size_t base = m_stack.size();
+      ldd x = a;
+      ldd y = b;
+      while (x != false_ && y != false_)
+      {
+        if (value(x) < value(y))
+        {
+          m_stack.emplace_back(value(x), down(x));
+          x = right(x);
+        }
+        else if (value(x) > value(y))
+        {
+          y = right(y);
+        }
+        else
+        {
+          ldd d = set_minus(down(x), down(y));
+          if (d != false_)
+          {
+            m_stack.emplace_back(value(x), d);
+          }
+          x = right(x);
+          y = right(y);
+        }
+      }
+      result = build_chain(base, x);
+      cache_insert(op_minus, a, b, 0, result);
+      return result;
+    }
+
+    /// \brief Registers a group of positions, for use in project and relprod.
+    /// \param used The positions of the group.
+    /// \pre At least one position is used.
+    /// \return The index of the group.
+    std::size_t add_group(const std::vector<bool>& used)
+    {
+      group_meta meta;
+      meta.used = used;
+      meta.last_used = 0;
+      for (std::size_t i = 0; i < used.size(); i++)
+      {
+        if (used[i])
+        {
+          meta.last_used = i;
+        }
+      }
+      m_groups.push_back(meta);
+      return m_groups.size() - 1;
+    }
+
+    /// \brief Returns the projection of a on the positions of a group.
+    ldd project(ldd a, std::size_t group)
+    {
+      return project(a, group, 0);
+    }
+
+    /// \brief Returns the successors of s with respect to the relation r on the positions of a group.
+    /// \details The relation is a set of vectors x0 y0 x1 y1 ... such that the values xi are
+    /// replaced by yi, where i ranges over the positions of the group. The other values are copied.
+    ldd relprod(ldd s, ldd r, std::size_t group)
+    {
+      return relprod(s, r, group, 0);
+    }
+
+    /// \brief Returns the number of vectors in a.
+    double count(ldd a)
+    {
+      if (a <= true_)
+      {
+        return a == true_ ? 1.0 : 0.0;
+      }
+      auto i = m_count_cache.find(a);
+      if (i != m_count_cache.end())
+      {
+        return i->second;
+      }
+      double result = 0.0;
+      for (ldd x = a; x != false_; x = right(x))
+      {
+        result += count(down(x));
+      }
+      m_count_cache[a] = result;
+      return result;
+    }
+
+    /// \brief Calls f for every vector of a, in lexicographical order.
+    template <typename Function>
+    void enumerate(ldd a, Function f) const
+    {
+      std::vector<std::uint32_t> v;
+      enumerate(a, v, f);
+    }
+};
+
+} // namespace detail
+
+} // namespace lps
+
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_DETAIL_LDD_H
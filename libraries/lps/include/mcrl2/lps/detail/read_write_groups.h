@@ -0,0 +1,90 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/detail/read_write_groups.h
+/// \brief Computes for each action summand the process parameters that it reads and writes.
+
+#ifndef MCRL2_LPS_DETAIL_READ_WRITE_GROUPS_H
+#define MCRL2_LPS_DETAIL_READ_WRITE_GROUPS_H
+
+#include <cstddef>
+#include <iterator>
+#include <set>
+#include <vector>
+#include "mcrl2/data/find.h"
+#include "mcrl2/lps/find.h"
+#include "mcrl2/lps/linear_process.h"
+
+namespace mcrl2
+{
+
+namespace lps
+{
+
+namespace detail
+{
+
+/// \brief Computes the indices of the process parameters that are read and written by each
+/// action summand of proc. A parameter is read if it occurs in the condition, the multi
+/// action or the right hand side of a non trivial assignment, and it is written if it is the
+/// left hand side of a non trivial assignment.
+/// \param proc A linear process
+/// \param read_group For each action summand the sorted indices of the parameters that are read
+/// \param write_group For each action summand the sorted indices of the parameters that are written
+inline
+void compute_read_write_groups(const linear_process& proc,
+                               std::vector<std::vector<std::size_t> >& read_group,
+                               std::vector<std::vector<std::size_t> >& write_group
+                              )
+{
+  const data::variable_list& parameters = proc.process_parameters();
+  read_group.assign(proc.action_summands().size(), std::vector<std::size_t>());
+  write_group.assign(proc.action_summands().size(), std::vector<std::size_t>());
+
+  std::size_t i = 0;
+  for (const action_summand& summand: proc.action_summands())
+  {
+    std::set<data::variable> used_read_variables;
+    std::set<data::variable> used_write_variables;
+
+    data::find_free_variables(summand.condition(), std::inserter(used_read_variables, used_read_variables.end()));
+    lps::find_free_variables(summand.multi_action(), std::inserter(used_read_variables, used_read_variables.end()));
+
+    for (const data::assignment& assignment: summand.assignments())
+    {
+      if (assignment.lhs() != assignment.rhs())
+      {
+        data::find_all_variables(assignment.lhs(), std::inserter(used_write_variables, used_write_variables.end()));
+        data::find_all_variables(assignment.rhs(), std::inserter(used_read_variables, used_read_variables.end()));
+      }
+    }
+
+    std::size_t j = 0;
+    for (const data::variable& parameter: parameters)
+    {
+      if (used_read_variables.find(parameter) != used_read_variables.end())
+      {
+        read_group[i].push_back(j);
+      }
+      if (used_write_variables.find(parameter) != used_write_variables.end())
+      {
+        write_group[i].push_back(j);
+      }
+      j++;
+    }
+    i++;
+  }
+}
+
+} // namespace detail
+
+} // namespace lps
+
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_DETAIL_READ_WRITE_GROUPS_H
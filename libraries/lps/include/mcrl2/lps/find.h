@@ -43,7 +43,7 @@ template <typename T>
 std::set<data::variable> find_all_variables(const T& x)
 {
   std::set<data::variable> result;
-  lps::find_all_variables(x, std::inserter(result, result.end()));
+  data::detail::make_find_all_variables_traverser<lps::cached_variable_traverser>(std::inserter(result, result.end())).apply(x);
   return result;
 }
 
@@ -75,7 +75,7 @@ template <typename T>
 std::set<data::variable> find_free_variables(const T& x)
 {
   std::set<data::variable> result;
-  lps::find_free_variables(x, std::inserter(result, result.end()));
+  data::detail::make_cached_find_free_variables_traverser<lps::data_expression_traverser, lps::add_data_variable_binding>(std::inserter(result, result.end())).apply(x);
   return result;
 }
 
@@ -87,7 +87,7 @@ template <typename T, typename VariableContainer>
 std::set<data::variable> find_free_variables_with_bound(const T& x, VariableContainer const& bound)
 {
   std::set<data::variable> result;
-  lps::find_free_variables_with_bound(x, std::inserter(result, result.end()), bound);
+  data::detail::make_cached_find_free_variables_traverser<lps::data_expression_traverser, lps::add_data_variable_binding>(std::inserter(result, result.end()), bound).apply(x);
   return result;
 }
 
@@ -150,7 +150,7 @@ template <typename T>
 std::set<data::function_symbol> find_function_symbols(const T& x)
 {
   std::set<data::function_symbol> result;
-  lps::find_function_symbols(x, std::inserter(result, result.end()));
+  data::detail::make_find_function_symbols_traverser<lps::cached_data_expression_traverser>(std::inserter(result, result.end())).apply(x);
   return result;
 }
 //--- end generated lps find code ---//
@@ -26,6 +26,7 @@
 #include "mcrl2/data/rewrite_strategy.h"
 #include "mcrl2/data/selection.h"
 #include "mcrl2/data/substitutions/mutable_indexed_substitution.h"
+#include "mcrl2/lps/detail/read_write_groups.h"
 #include "mcrl2/lps/find.h"
 #include "mcrl2/lps/io.h"
 #include "mcrl2/lps/next_state_generator.h"
@@ -454,62 +455,8 @@ class pins
       m_group_count  = proc.action_summands().size();
       m_state_length = proc.process_parameters().size();
 
-      m_read_group.resize(m_group_count);
-      m_write_group.resize(m_group_count);
-
-      // iterate over the list of summands
-      {
-        std::size_t i = 0;
-        for (const auto & summand : proc.action_summands())
-        {
-          std::set<data::variable> used_read_variables;
-          std::set<data::variable> used_write_variables;
-
-          data::find_free_variables(summand.condition(), std::inserter(used_read_variables, used_read_variables.end()));
-          lps::find_free_variables(summand.multi_action(), std::inserter(used_read_variables, used_read_variables.end()));
-
-          for (const auto & assignment : summand.assignments())
-          {
-            if (assignment.lhs() != assignment.rhs())
-            {
-              data::find_all_variables(assignment.lhs(), std::inserter(used_write_variables, used_write_variables.end()));
-              data::find_all_variables(assignment.rhs(), std::inserter(used_read_variables, used_read_variables.end()));
-            }
-          }
-
-          // process parameters used in condition, action or assignment of summand
-          std::set<data::variable> used_read_parameters;
-          std::set<data::variable> used_write_parameters;
-
-          std::set_intersection(used_read_variables.begin(),
-                                used_read_variables.end(),
-                                parameters.begin(),
-                                parameters.end(),
-                                std::inserter(used_read_parameters,
-                                              used_read_parameters.begin()));
-          std::set_intersection(used_write_variables.begin(),
-                                used_write_variables.end(),
-                                parameters.begin(),
-                                parameters.end(),
-                                std::inserter(used_write_parameters,
-                                              used_write_parameters.begin()));
-
-          std::size_t j = 0;
-          for (auto & param : m_parameters_list)
-          {
-            if (used_read_parameters.find(param) != used_read_parameters.end())
-            {
-              m_read_group[i].push_back(j);
-            }
-            if (used_write_parameters.find(param) != used_write_parameters.end())
-            {
-              m_write_group[i].push_back(j);
-            }
-            j++;
-          }
-          i++;
-        }
-      }
+      // the parameters that are read and written by the summands
+      lps::detail::compute_read_write_groups(proc, m_read_group, m_write_group);
 
       m_update_group.resize(m_group_count);
 
@@ -16,10 +16,12 @@
 #include <forward_list>
 #include <iterator>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "mcrl2/atermpp/detail/shared_subset.h"
 #include "mcrl2/data/enumerator.h"
+#include "mcrl2/lps/detail/read_write_groups.h"
 #include "mcrl2/lps/state.h"
 #include "mcrl2/lps/specification.h"
 
@@ -45,7 +47,27 @@ class next_state_generator
       std::size_t summand_index;
     };
 
+    /// \brief Statistics of the transition cache.
+    struct cache_statistics
+    {
+      std::size_t hits = 0;      // The number of lookups that were found in the cache.
+      std::size_t misses = 0;    // The number of lookups that were not found in the cache.
+      std::size_t entries = 0;   // The number of entries in the cache.
+      std::size_t memory = 0;    // An estimate of the number of bytes used by the entries.
+      bool is_full = false;      // True if an entry was not added because of the memory limit.
+    };
+
   protected:
+    typedef atermpp::term_appl<data::data_expression> transition_cache_key;
+
+    // A transition of a summand in the transition cache. The updates are the new values of
+    // the parameters that are written by the summand.
+    struct cached_transition
+    {
+      lps::multi_action action;
+      data::data_expression_vector updates;
+    };
+
     struct next_state_action_label
     {
       process::action_label label;
@@ -66,6 +88,14 @@ class next_state_generator
       atermpp::function_symbol condition_arguments_function;
       std::map<enumeration_cache_key, enumeration_cache_value> enumeration_cache;
 
+      // The indices of the parameters that are read and written by the summand. They are
+      // only used by the transition cache, that maps the values of the read parameters to
+      // the transitions of the summand.
+      std::vector<std::size_t> read_parameters;
+      std::vector<std::size_t> write_parameters;
+      atermpp::function_symbol read_parameters_function;
+      std::unordered_map<transition_cache_key, std::vector<cached_transition>> transition_cache;
+
       bool has_time() const
       {
         return time != data::data_expression();
@@ -86,8 +116,18 @@ class next_state_generator
       enumerator::iterator m_enumeration_iterator;
       enumerator_queue* m_enumeration_queue = nullptr;
 
+      // If not null, the iterator enumerates these transitions instead of computing them.
+      const std::vector<transition>* m_transitions = nullptr;
+      std::size_t m_transition_index = 0;
+
       next_state_iterator() = default;
 
+      explicit next_state_iterator(const std::vector<transition>* transitions)
+        : m_transitions(transitions)
+      {
+        increment();
+      }
+
       next_state_iterator(next_state_generator* generator,
                           const lps::state& state,
                           typename std::vector<next_state_summand>::iterator summands_first,
@@ -117,6 +157,10 @@ class next_state_generator
 
       bool is_at_end() const
       {
+        if (m_transitions)
+        {
+          return m_transition_index > m_transitions->size();
+        }
         return m_summands_first == m_summands_last;
       }
 
@@ -205,6 +249,16 @@ class next_state_generator
 
       void increment()
       {
+        if (m_transitions)
+        {
+          if (m_transition_index < m_transitions->size())
+          {
+            m_transition = (*m_transitions)[m_transition_index];
+          }
+          m_transition_index++;
+          return;
+        }
+
         if (!find_next_solution())
         {
           return;
@@ -242,6 +296,10 @@ class next_state_generator
                 : m_iterator(generator, state, summands_first, summands_last, substitution, enumeration_queue)
         {}
 
+        explicit iterator(const std::vector<transition>* transitions)
+          : m_iterator(transitions)
+        {}
+
       private:
         friend class boost::iterator_core_access;
 
@@ -272,6 +330,90 @@ class next_state_generator
     std::vector<next_state_summand> m_summands;
     lps::state m_initial_state;
 
+    bool m_use_transition_caching = false;
+    std::size_t m_transition_cache_max_memory = 0;
+    cache_statistics m_transition_cache_statistics;
+    std::vector<transition> m_cached_transitions;
+    data::data_expression_vector m_source_state;
+
+    // Returns an estimate of the number of bytes used by the cache entry (key, transitions).
+    static std::size_t transition_cache_entry_size(const next_state_summand& summand, const std::vector<cached_transition>& transitions)
+    {
+      return sizeof(std::pair<transition_cache_key, std::vector<cached_transition>>) + 4 * sizeof(void*)
+             + (summand.read_parameters.size() + 2) * sizeof(void*)
+             + transitions.size() * (sizeof(cached_transition) + summand.write_parameters.size() * sizeof(data::data_expression));
+    }
+
+    // Computes the transitions of state in m_cached_transitions. For every summand the
+    // transitions are looked up in the transition cache, using the values of the parameters
+    // that it reads. The targets are obtained by updating the parameters that it writes.
+    void compute_cached_transitions(const state& state, enumerator_queue* enumeration_queue)
+    {
+      m_cached_transitions.clear();
+      m_source_state.assign(state.begin(), state.end());
+      for (std::size_t i = 0; i < m_summands.size(); i++)
+      {
+        next_state_summand& summand = m_summands[i];
+
+        // A summand that reads all parameters has a different key for every state, so it is not cached.
+        if (summand.read_parameters.size() == m_process_parameters.size())
+        {
+          for (iterator j = begin(state, i, enumeration_queue); j != end(); ++j)
+          {
+            m_cached_transitions.push_back(*j);
+          }
+          continue;
+        }
+
+        transition_cache_key key(summand.read_parameters_function, summand.read_parameters.begin(), summand.read_parameters.end(),
+                                 [&](std::size_t j) { return m_source_state[j]; });
+        std::vector<cached_transition> computed;
+        const std::vector<cached_transition>* transitions;
+        auto k = summand.transition_cache.find(key);
+        if (k != summand.transition_cache.end())
+        {
+          m_transition_cache_statistics.hits++;
+          transitions = &k->second;
+        }
+        else
+        {
+          m_transition_cache_statistics.misses++;
+          for (iterator j = begin(state, i, enumeration_queue); j != end(); ++j)
+          {
+            cached_transition t;
+            t.action = j->action;
+            for (std::size_t p: summand.write_parameters)
+            {
+              t.updates.push_back(j->target_state.element_at(p, m_process_parameters.size()));
+            }
+            computed.push_back(t);
+          }
+          const std::size_t size = transition_cache_entry_size(summand, computed);
+          if (m_transition_cache_statistics.memory + size <= m_transition_cache_max_memory)
+          {
+            transitions = &summand.transition_cache.emplace(key, std::move(computed)).first->second;
+            m_transition_cache_statistics.entries++;
+            m_transition_cache_statistics.memory += size;
+          }
+          else
+          {
+            m_transition_cache_statistics.is_full = true;
+            transitions = &computed;
+          }
+        }
+
+        for (const cached_transition& t: *transitions)
+        {
+          data::data_expression_vector target = m_source_state;
+          for (std::size_t w = 0; w < summand.write_parameters.size(); w++)
+          {
+            target[summand.write_parameters[w]] = t.updates[w];
+          }
+          m_cached_transitions.push_back(transition{ t.action, lps::state(target.begin(), target.size()), i });
+        }
+      }
+    }
+
   public:
     /// \brief Constructor
     /// \param spec The process specification
@@ -337,8 +479,14 @@ class next_state_generator
     }
 
     /// \brief Returns an iterator for generating the successors of the given state.
+    /// \details If transition caching is enabled, the iterator is invalidated by the next call of begin.
     iterator begin(const state& state, enumerator_queue* enumeration_queue)
     {
+      if (m_use_transition_caching)
+      {
+        compute_cached_transitions(state, enumeration_queue);
+        return iterator(&m_cached_transitions);
+      }
       return iterator(this, state, m_summands.begin(), m_summands.end(), &m_substitution, enumeration_queue);
     }
 
@@ -366,6 +514,34 @@ class next_state_generator
     {
       return m_rewriter;
     }
+
+    /// \brief Enables the transition cache. For each summand it stores the transitions that
+    /// were computed for a projection of a state on the parameters that the summand reads, as
+    /// an action and the new values of the parameters that it writes. This avoids the
+    /// enumeration and rewriting of summands that only depend on a few parameters.
+    /// \param max_memory An approximate upper bound of the number of bytes used by the cache.
+    /// If the cache is full, no more entries are added.
+    void enable_transition_caching(std::size_t max_memory)
+    {
+      std::vector<std::vector<std::size_t> > read_group;
+      std::vector<std::vector<std::size_t> > write_group;
+      lps::detail::compute_read_write_groups(m_specification.process(), read_group, write_group);
+      for (std::size_t i = 0; i < m_summands.size(); i++)
+      {
+        next_state_summand& summand = m_summands[i];
+        summand.read_parameters = read_group[i];
+        summand.write_parameters = write_group[i];
+        summand.read_parameters_function = atermpp::function_symbol("read_parameters", summand.read_parameters.size());
+      }
+      m_use_transition_caching = true;
+      m_transition_cache_max_memory = max_memory;
+    }
+
+    /// \brief Returns the statistics of the transition cache.
+    const cache_statistics& transition_cache_statistics() const
+    {
+      return m_transition_cache_statistics;
+    }
 };
 
 class cached_next_state_generator: public next_state_generator
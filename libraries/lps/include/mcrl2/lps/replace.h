@@ -175,7 +175,7 @@ void replace_variables(T& x,
                        typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                       )
 {
-  core::make_update_apply_builder<lps::data_expression_builder>(sigma).update(x);
+  core::make_update_apply_builder<lps::cached_data_expression_builder>(sigma).update(x);
 }
 
 template <typename T, typename Substitution>
@@ -184,7 +184,7 @@ T replace_variables(const T& x,
                     typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                    )
 {
-  return core::make_update_apply_builder<lps::data_expression_builder>(sigma).apply(x);
+  return core::make_update_apply_builder<lps::cached_data_expression_builder>(sigma).apply(x);
 }
 
 template <typename T, typename Substitution>
@@ -193,7 +193,7 @@ void replace_all_variables(T& x,
                            typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                           )
 {
-  core::make_update_apply_builder<lps::variable_builder>(sigma).update(x);
+  core::make_update_apply_builder<lps::cached_variable_builder>(sigma).update(x);
 }
 
 template <typename T, typename Substitution>
@@ -202,7 +202,7 @@ T replace_all_variables(const T& x,
                         typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                        )
 {
-  return core::make_update_apply_builder<lps::variable_builder>(sigma).apply(x);
+  return core::make_update_apply_builder<lps::cached_variable_builder>(sigma).apply(x);
 }
 
 /// \brief Applies the substitution sigma to x.
@@ -0,0 +1,372 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/symbolic_reachability.h
+/// \brief Symbolic reachability analysis of linear processes using list decision diagrams.
+
+#ifndef MCRL2_LPS_SYMBOLIC_REACHABILITY_H
+#define MCRL2_LPS_SYMBOLIC_REACHABILITY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "mcrl2/atermpp/indexed_set.h"
+#include "mcrl2/lps/detail/ldd.h"
+#include "mcrl2/lps/detail/read_write_groups.h"
+#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/utilities/logger.h"
+
+namespace mcrl2
+{
+
+namespace lps
+{
+
+enum symbolic_reachability_strategy
+{
+  sr_breadth_first,
+  sr_chaining,
+  sr_saturation
+};
+
+inline
+symbolic_reachability_strategy parse_symbolic_reachability_strategy(const std::string& s)
+{
+  if (s == "breadth")
+  {
+    return sr_breadth_first;
+  }
+  if (s == "chaining")
+  {
+    return sr_chaining;
+  }
+  if (s == "saturation")
+  {
+    return sr_saturation;
+  }
+  throw mcrl2::runtime_error("unknown symbolic reachability strategy " + s);
+}
+
+inline
+std::string print_symbolic_reachability_strategy(const symbolic_reachability_strategy strategy)
+{
+  switch (strategy)
+  {
+    case sr_breadth_first:
+      return "breadth";
+    case sr_chaining:
+      return "chaining";
+    case sr_saturation:
+      return "saturation";
+    default:
+      throw mcrl2::runtime_error("unknown symbolic reachability strategy");
+  }
+}
+
+/// \brief Computes the reachable states of a linear process symbolically.
+/// \details A state is encoded as a vector of indices, where the value of parameter i is
+/// stored in a value table for that parameter. Sets of states are stored as list decision
+/// diagrams. The summands are partitioned into groups of summands that read or write the same
+/// parameters. The transition relation of a group is a relation on the projections of states
+/// on those parameters. It is learned on the fly, by computing the successors of the newly
+/// encountered projections with a next state generator.
+class symbolic_reachability_algorithm
+{
+  protected:
+    typedef detail::ldd ldd;
+
+    struct summand_group
+    {
+      std::vector<std::size_t> summands;       // the indices of the action summands of the group
+      std::vector<std::size_t> parameters;     // the parameters that are read or written
+      std::size_t ldd_group;                   // the index of the group in the ldd manager
+      ldd relation = detail::ldd_manager::false_;
+      ldd learned = detail::ldd_manager::false_; // the projections for which the relation was computed
+    };
+
+    next_state_generator m_generator;
+    std::size_t m_parameter_count;
+    std::vector<atermpp::indexed_set<data::data_expression> > m_values;
+    std::vector<summand_group> m_groups;
+    detail::ldd_manager m_ldd;
+    data::data_expression_vector m_state_template;
+    next_state_generator::enumerator_queue m_enumeration_queue;
+    std::size_t m_iteration_count = 0;
+
+    std::uint32_t value_index(std::size_t parameter, const data::data_expression& value)
+    {
+      std::size_t result = m_values[parameter].put(value).first;
+      if (result >= (std::numeric_limits<std::uint32_t>::max)())
+      {
+        throw mcrl2::runtime_error("too many values for parameter " + std::to_string(parameter));
+      }
+      return static_cast<std::uint32_t>(result);
+    }
+
+    static specification strip_actions(specification spec)
+    {
+      // The actions are not needed, so they are removed to reduce the read groups.
+      for (action_summand& summand: spec.process().action_summands())
+      {
+        summand.multi_action().actions() = process::action_list();
+      }
+      return spec;
+    }
+
+    void compute_groups(const specification& spec)
+    {
+      std::vector<std::vector<std::size_t> > read_group;
+      std::vector<std::vector<std::size_t> > write_group;
+      detail::compute_read_write_groups(spec.process(), read_group, write_group);
+
+      std::map<std::vector<std::size_t>, std::size_t> group_index;
+      for (std::size_t i = 0; i < read_group.size(); i++)
+      {
+        std::vector<std::size_t> parameters;
+        std::set_union(read_group[i].begin(), read_group[i].end(), write_group[i].begin(), write_group[i].end(), std::back_inserter(parameters));
+        if (parameters.empty())
+        {
+          // A summand that reads and writes no parameters only has self loops.
+          continue;
+        }
+        auto j = group_index.find(parameters);
+        if (j == group_index.end())
+        {
+          j = group_index.insert(std::make_pair(parameters, m_groups.size())).first;
+          summand_group group;
+          group.parameters = parameters;
+          std::vector<bool> used(m_parameter_count, false);
+          for (std::size_t p: parameters)
+          {
+            used[p] = true;
+          }
+          group.ldd_group = m_ldd.add_group(used);
+          m_groups.push_back(group);
+        }
+        m_groups[j->second].summands.push_back(i);
+      }
+    }
+
+    // Computes the transitions of group for the projections of the states in todo that were not learned before.
+    void learn_transitions(summand_group& group, ldd todo)
+    {
+      ldd projections = m_ldd.project(todo, group.ldd_group);
+      ldd new_projections = m_ldd.set_minus(projections, group.learned);
+      if (new_projections == detail::ldd_manager::false_)
+      {
+        return;
+      }
+      group.learned = m_ldd.set_union(group.learned, new_projections);
+
+      std::vector<std::vector<std::uint32_t> > sources;
+      m_ldd.enumerate(new_projections, [&](const std::vector<std::uint32_t>& x) { sources.push_back(x); });
+
+      std::vector<std::uint32_t> tuple(2 * group.parameters.size());
+      ldd relation = detail::ldd_manager::false_;
+      for (const std::vector<std::uint32_t>& x: sources)
+      {
+        data::data_expression_vector source = m_state_template;
+        for (std::size_t k = 0; k < group.parameters.size(); k++)
+        {
+          source[group.parameters[k]] = m_values[group.parameters[k]].get(x[k]);
+          tuple[2 * k] = x[k];
+        }
+        state s(source.begin(), source.size());
+        for (std::size_t summand: group.summands)
+        {
+          for (auto i = m_generator.begin(s, summand, &m_enumeration_queue); i != m_generator.end(); ++i)
+          {
+            for (std::size_t k = 0; k < group.parameters.size(); k++)
+            {
+              tuple[2 * k + 1] = value_index(group.parameters[k], i->target_state.element_at(group.parameters[k], m_parameter_count));
+            }
+            relation = m_ldd.set_union(relation, m_ldd.singleton(tuple));
+          }
+        }
+      }
+      group.relation = m_ldd.set_union(group.relation, relation);
+    }
+
+    ldd successors(summand_group& group, ldd todo)
+    {
+      learn_transitions(group, todo);
+      return m_ldd.relprod(todo, group.relation, group.ldd_group);
+    }
+
+    void report_progress(ldd visited)
+    {
+      mCRL2log(log::verbose) << "iteration " << m_iteration_count << ": " << std::fixed << std::setprecision(0) << m_ldd.count(visited)
+                             << " states, " << m_ldd.node_count() << " LDD nodes" << std::endl;
+    }
+
+    ldd run_breadth_first(ldd initial)
+    {
+      ldd visited = initial;
+      ldd todo = initial;
+      while (todo != detail::ldd_manager::false_)
+      {
+        ldd next = detail::ldd_manager::false_;
+        for (summand_group& group: m_groups)
+        {
+          next = m_ldd.set_union(next, successors(group, todo));
+        }
+        todo = m_ldd.set_minus(next, visited);
+        visited = m_ldd.set_union(visited, todo);
+        m_iteration_count++;
+        report_progress(visited);
+      }
+      return visited;
+    }
+
+    // Chaining: within an iteration, the successors of a group are immediately used by the next group.
+    ldd run_chaining(ldd initial)
+    {
+      ldd visited = initial;
+      ldd todo = initial;
+      while (todo != detail::ldd_manager::false_)
+      {
+        for (summand_group& group: m_groups)
+        {
+          todo = m_ldd.set_union(todo, successors(group, todo));
+        }
+        todo = m_ldd.set_minus(todo, visited);
+        visited = m_ldd.set_union(visited, todo);
+        m_iteration_count++;
+        report_progress(visited);
+      }
+      return visited;
+    }
+
+    // Saturation: the groups are ordered by their topmost parameter, deepest first. A group is
+    // applied until a fixpoint is reached, and if it produced new states the next round starts at
+    // the deepest group again. Hence the groups that touch only the bottom of the LDD are
+    // saturated before the groups that touch the top, which keeps the intermediate LDDs small.
+    ldd run_saturation(ldd initial)
+    {
+      std::vector<summand_group*> groups;
+      for (summand_group& group: m_groups)
+      {
+        groups.push_back(&group);
+      }
+      std::stable_sort(groups.begin(), groups.end(), [](const summand_group* x, const summand_group* y) { return x->parameters.front() > y->parameters.front(); });
+
+      ldd visited = initial;
+      std::size_t i = 0;
+      while (i < groups.size())
+      {
+        bool changed = false;
+        ldd todo = visited;
+        while (todo != detail::ldd_manager::false_)
+        {
+          todo = m_ldd.set_minus(successors(*groups[i], todo), visited);
+          visited = m_ldd.set_union(visited, todo);
+          changed = changed || todo != detail::ldd_manager::false_;
+        }
+        m_iteration_count++;
+        if (changed && i > 0)
+        {
+          report_progress(visited);
+          i = 0;
+        }
+        else
+        {
+          i++;
+        }
+      }
+      report_progress(visited);
+      return visited;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param spec A linear process specification.
+    /// \param rewriter The rewriter that is used for computing the transitions.
+    /// \param log_cache_size The base 2 logarithm of the number of entries of the LDD operation cache.
+    symbolic_reachability_algorithm(const specification& spec, const data::rewriter& rewriter, std::size_t log_cache_size = 20)
+      : m_generator(strip_actions(spec), rewriter),
+        m_parameter_count(spec.process().process_parameters().size()),
+        m_values(m_parameter_count),
+        m_ldd(log_cache_size)
+    {
+      compute_groups(strip_actions(spec));
+      const state& init = m_generator.initial_state();
+      m_state_template.assign(init.begin(), init.end());
+      mCRL2log(log::verbose) << "the " << spec.process().action_summands().size() << " summands are partitioned into "
+                             << m_groups.size() << " groups" << std::endl;
+    }
+
+    /// \brief Computes the reachable states.
+    /// \return An LDD that contains the encodings of the reachable states.
+    ldd run(symbolic_reachability_strategy strategy = sr_chaining)
+    {
+      std::vector<std::uint32_t> x(m_parameter_count);
+      for (std::size_t i = 0; i < m_parameter_count; i++)
+      {
+        x[i] = value_index(i, m_state_template[i]);
+      }
+      ldd initial = m_ldd.singleton(x);
+      m_iteration_count = 0;
+      switch (strategy)
+      {
+        case sr_breadth_first: return run_breadth_first(initial);
+        case sr_chaining: return run_chaining(initial);
+        case sr_saturation: return run_saturation(initial);
+        default: throw mcrl2::runtime_error("unknown symbolic reachability strategy");
+      }
+    }
+
+    /// \brief Returns the number of states in a set, without enumerating them.
+    double state_count(ldd states)
+    {
+      return m_ldd.count(states);
+    }
+
+    /// \brief Returns the number of summand groups.
+    std::size_t group_count() const
+    {
+      return m_groups.size();
+    }
+
+    /// \brief Returns the number of iterations of the last call of run.
+    std::size_t iteration_count() const
+    {
+      return m_iteration_count;
+    }
+
+    /// \brief Returns the LDD manager.
+    const detail::ldd_manager& manager() const
+    {
+      return m_ldd;
+    }
+
+    /// \brief Calls f for each state in the set states.
+    template <typename Function>
+    void for_each_state(ldd states, Function f) const
+    {
+      m_ldd.enumerate(states, [&](const std::vector<std::uint32_t>& x)
+      {
+        data::data_expression_vector v;
+        for (std::size_t i = 0; i < x.size(); i++)
+        {
+          v.push_back(m_values[i].get(x[i]));
+        }
+        f(state(v.begin(), v.size()));
+      });
+    }
+};
+
+} // namespace lps
+
+} // namespace mcrl2
+
+#endif // MCRL2_LPS_SYMBOLIC_REACHABILITY_H
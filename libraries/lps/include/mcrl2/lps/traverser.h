@@ -626,6 +626,26 @@ struct action_label_traverser: public add_traverser_action_labels<process::actio
 };
 //--- end generated add_traverser_action_labels code ---//
 
+/// \brief Data expression traverser that visits shared data expressions only once
+template <typename Derived>
+struct cached_data_expression_traverser: public data::add_visited_data_expressions<lps::data_expression_traverser, Derived>
+{
+  typedef data::add_visited_data_expressions<lps::data_expression_traverser, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+};
+
+/// \brief Variable traverser that visits shared data expressions only once
+template <typename Derived>
+struct cached_variable_traverser: public data::add_visited_data_expressions<lps::variable_traverser, Derived>
+{
+  typedef data::add_visited_data_expressions<lps::variable_traverser, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::apply;
+};
+
 } // namespace lps
 
 } // namespace mcrl2
@@ -0,0 +1,100 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file symbolic_reachability_algorithm_test.cpp
+/// \brief Tests for list decision diagrams and symbolic reachability.
+
+#define BOOST_TEST_MODULE symbolic_reachability_algorithm_test
+#include <boost/test/included/unit_test_framework.hpp>
+#include <deque>
+#include <set>
+
+#include "mcrl2/lps/parse.h"
+#include "mcrl2/lps/symbolic_reachability.h"
+
+using namespace mcrl2;
+using namespace mcrl2::lps;
+using detail::ldd;
+using detail::ldd_manager;
+
+BOOST_AUTO_TEST_CASE(test_ldd_operations)
+{
+  ldd_manager m(10);
+  const ldd empty = ldd_manager::false_;
+  ldd a = m.set_union(m.singleton({1, 2}), m.singleton({1, 3}));
+  ldd b = m.set_union(m.singleton({0, 2}), m.singleton({1, 3}));
+  ldd c = m.set_union(a, b);
+  BOOST_CHECK_EQUAL(m.count(c), 3.0);
+  BOOST_CHECK_EQUAL(m.set_union(b, a), c);
+  BOOST_CHECK_EQUAL(m.set_minus(c, b), m.singleton({1, 2}));
+  BOOST_CHECK_EQUAL(m.set_minus(a, c), empty);
+
+  std::vector<std::vector<std::uint32_t> > vectors;
+  m.enumerate(c, [&](const std::vector<std::uint32_t>& x) { vectors.push_back(x); });
+  BOOST_CHECK(vectors == (std::vector<std::vector<std::uint32_t> >{ {0, 2}, {1, 2}, {1, 3} }));
+
+  // A group on the second position, with the relation 2 -> 5, 2 -> 6 and 3 -> 3.
+  std::size_t group = m.add_group({false, true});
+  BOOST_CHECK_EQUAL(m.project(c, group), m.set_union(m.singleton({2}), m.singleton({3})));
+  ldd r = m.set_union(m.set_union(m.singleton({2, 5}), m.singleton({2, 6})), m.singleton({3, 3}));
+  ldd expected = m.singleton({0, 5});
+  for (const auto& x: std::vector<std::vector<std::uint32_t> >{ {0, 6}, {1, 5}, {1, 6}, {1, 3} })
+  {
+    expected = m.set_union(expected, m.singleton(x));
+  }
+  BOOST_CHECK_EQUAL(m.relprod(c, r, group), expected);
+}
+
+// Computes the number of reachable states by explicit breadth first search.
+std::size_t explicit_state_count(const specification& spec)
+{
+  next_state_generator generator(spec, data::rewriter(spec.data()));
+  next_state_generator::enumerator_queue queue;
+  std::set<state> visited = { generator.initial_state() };
+  std::deque<state> todo = { generator.initial_state() };
+  while (!todo.empty())
+  {
+    state s = todo.front();
+    todo.pop_front();
+    for (auto i = generator.begin(s, &queue); i != generator.end(); ++i)
+    {
+      if (visited.insert(i->target_state).second)
+      {
+        todo.push_back(i->target_state);
+      }
+    }
+  }
+  return visited.size();
+}
+
+BOOST_AUTO_TEST_CASE(test_symbolic_reachability)
+{
+  std::string text(
+    "act a, b: Nat;\n"
+    "proc P(s, t: Nat, u: Bool, v: List(Bool)) =\n"
+    "  (s < 6) -> a(s) . P(s = s + 1)\n"
+    "+ (t < 5) -> b(t) . P(t = t + 1, u = !u)\n"
+    "+ sum n: Nat . (n < 3 && s > 2 && #v < 3) -> a(n) . P(s = Int2Nat(s - 1), v = [n > 1] ++ v)\n"
+    "+ (#v > 2) -> b(0) . P(v = [])\n"
+    "+ (s == 4 && t == 2) -> a(s + t) . P(0, 0, false, [false]);\n"
+    "init P(0, 0, true, []);\n"
+  );
+  specification spec = parse_linear_process_specification(text);
+  std::size_t expected = explicit_state_count(spec);
+
+  for (symbolic_reachability_strategy strategy: { sr_breadth_first, sr_chaining, sr_saturation })
+  {
+    symbolic_reachability_algorithm algorithm(spec, data::rewriter(spec.data()), 12);
+    auto states = algorithm.run(strategy);
+    BOOST_CHECK_EQUAL(algorithm.state_count(states), static_cast<double>(expected));
+
+    std::size_t n = 0;
+    algorithm.for_each_state(states, [&](const state&) { n++; });
+    BOOST_CHECK_EQUAL(n, expected);
+  }
+}
@@ -0,0 +1,110 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file tau_star_reduce_benchmark.cpp
+/// \brief Measures the running time of the tau star reduction on generated LTSs
+/// with many internal steps.
+///
+/// Usage: lts_tau_star_reduce_benchmark [size]
+///
+/// Two families of LTSs are used:
+/// - chain: a chain of size tau steps, in parallel with a chain of visible steps,
+///   and a tau step back from the last state to the middle of the chain;
+/// - diamond: a grid of tau steps to the right and down with size / 10 states on each
+///   side, where every state on the diagonal has a visible step to the next state.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/lts_algorithm.h"
+
+using namespace mcrl2;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(const clock_type::time_point& start)
+{
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+static lts::lts_aut_t make_lts(std::size_t number_of_states)
+{
+  lts::lts_aut_t l;
+  l.add_action(lts::action_label_string("a"));
+  l.add_action(lts::action_label_string("b"));
+  l.set_num_states(number_of_states, false);
+  l.set_initial_state(0);
+  return l;
+}
+
+static lts::lts_aut_t tau_chain(std::size_t n)
+{
+  lts::lts_aut_t l = make_lts(n);
+  for (std::size_t i = 0; i + 1 < n; i++)
+  {
+    l.add_transition(lts::transition(i, l.tau_label_index(), i + 1));
+    l.add_transition(lts::transition(i, 1, i + 1));
+  }
+  l.add_transition(lts::transition(n - 1, l.tau_label_index(), n / 2));
+  return l;
+}
+
+static lts::lts_aut_t tau_diamond(std::size_t n)
+{
+  lts::lts_aut_t l = make_lts(n * n);
+  for (std::size_t i = 0; i < n; i++)
+  {
+    for (std::size_t j = 0; j < n; j++)
+    {
+      const std::size_t s = i * n + j;
+      if (j + 1 < n)
+      {
+        l.add_transition(lts::transition(s, l.tau_label_index(), s + 1));
+      }
+      if (i + 1 < n)
+      {
+        l.add_transition(lts::transition(s, l.tau_label_index(), s + n));
+      }
+      if (i == j)
+      {
+        l.add_transition(lts::transition(s, 1 + i % 2, (s + 1) % (n * n)));
+      }
+    }
+  }
+  return l;
+}
+
+static void run(const std::string& name, lts::lts_aut_t l)
+{
+  const std::size_t states = l.num_states();
+  const std::size_t transitions = l.num_transitions();
+  clock_type::time_point start = clock_type::now();
+  lts::detail::tau_star_reduce(l);
+  const double time = seconds_since(start);
+  std::cout << name
+            << " states " << states
+            << " transitions " << transitions
+            << " result " << l.num_transitions()
+            << " time " << time << "s"
+            << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  std::size_t n = 2000;
+  if (argc > 1)
+  {
+    n = std::stoul(argv[1]);
+  }
+  run("chain", tau_chain(n));
+  run("diamond", tau_diamond(n / 10));
+  return EXIT_SUCCESS;
+}
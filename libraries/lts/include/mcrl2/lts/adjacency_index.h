@@ -0,0 +1,223 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/adjacency_index.h
+/// \brief A compressed sparse row index of the transitions of an LTS.
+
+#ifndef MCRL2_LTS_ADJACENCY_INDEX_H
+#define MCRL2_LTS_ADJACENCY_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "mcrl2/lts/transition.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+/// \brief A transition as seen from one of its end points: the label, and the state
+/// at the other end of the transition.
+struct adjacent_transition
+{
+  std::size_t label;
+  std::size_t state;
+
+  bool operator<(const adjacent_transition& other) const
+  {
+    return label < other.label || (label == other.label && state < other.state);
+  }
+
+  bool operator==(const adjacent_transition& other) const
+  {
+    return label == other.label && state == other.state;
+  }
+};
+
+/// \brief A contiguous range of adjacent transitions.
+class adjacent_transition_range
+{
+  protected:
+    const adjacent_transition* m_begin;
+    const adjacent_transition* m_end;
+
+  public:
+    typedef const adjacent_transition* iterator;
+    typedef const adjacent_transition* const_iterator;
+
+    adjacent_transition_range(const adjacent_transition* first, const adjacent_transition* last)
+      : m_begin(first), m_end(last)
+    {}
+
+    const adjacent_transition* begin() const
+    {
+      return m_begin;
+    }
+
+    const adjacent_transition* end() const
+    {
+      return m_end;
+    }
+
+    std::size_t size() const
+    {
+      return m_end - m_begin;
+    }
+
+    bool empty() const
+    {
+      return m_begin == m_end;
+    }
+
+    const adjacent_transition& operator[](std::size_t i) const
+    {
+      return m_begin[i];
+    }
+};
+
+/// \brief A compressed sparse row (CSR) index of the transitions of an LTS, either per
+/// source state (forward) or per target state (backward).
+/// \details The transitions of a state are stored contiguously and are sorted on label,
+/// and then on the state at the other end. So the transitions with a given label form
+/// a subrange, that is found by binary search. Duplicate transitions are kept.
+class adjacency_index
+{
+  protected:
+    std::vector<std::size_t> m_begin;
+    std::vector<adjacent_transition> m_transitions;
+
+  public:
+    /// \brief Constructor.
+    adjacency_index() = default;
+
+    /// \brief Constructor.
+    /// \param number_of_states The number of states; the index is enlarged if some
+    ///        transition refers to a larger state number.
+    /// \param transitions The transitions of an LTS.
+    /// \param forward If true, the transitions are indexed by source, otherwise by target.
+    /// \param label_map A function that is applied to each label, typically the hidden label map.
+    template <typename LabelMap>
+    adjacency_index(std::size_t number_of_states, const std::vector<transition>& transitions, bool forward, LabelMap label_map)
+    {
+      for (const transition& t: transitions)
+      {
+        number_of_states = std::max(number_of_states, (forward ? t.from() : t.to()) + 1);
+      }
+
+      // A counting sort on the states, followed by a sort of the transitions of each state.
+      m_begin.assign(number_of_states + 1, 0);
+      for (const transition& t: transitions)
+      {
+        m_begin[(forward ? t.from() : t.to()) + 1]++;
+      }
+      for (std::size_t s = 0; s < number_of_states; ++s)
+      {
+        m_begin[s + 1] += m_begin[s];
+      }
+      m_transitions.resize(transitions.size());
+      std::vector<std::size_t> position(m_begin.begin(), m_begin.end() - 1);
+      for (const transition& t: transitions)
+      {
+        adjacent_transition& a = m_transitions[position[forward ? t.from() : t.to()]++];
+        a.label = label_map(t.label());
+        a.state = forward ? t.to() : t.from();
+      }
+      for (std::size_t s = 0; s < number_of_states; ++s)
+      {
+        std::sort(m_transitions.begin() + m_begin[s], m_transitions.begin() + m_begin[s + 1]);
+      }
+    }
+
+    /// \brief Returns the number of states of the index.
+    std::size_t num_states() const
+    {
+      return m_begin.empty() ? 0 : m_begin.size() - 1;
+    }
+
+    /// \brief Returns the number of transitions of the index.
+    std::size_t num_transitions() const
+    {
+      return m_transitions.size();
+    }
+
+    /// \brief Returns the transitions of state s.
+    adjacent_transition_range transitions(std::size_t s) const
+    {
+      if (s >= num_states())
+      {
+        return adjacent_transition_range(nullptr, nullptr);
+      }
+      return adjacent_transition_range(m_transitions.data() + m_begin[s], m_transitions.data() + m_begin[s + 1]);
+    }
+
+    /// \brief Returns the transitions of state s with the given label.
+    adjacent_transition_range transitions(std::size_t s, std::size_t label) const
+    {
+      adjacent_transition_range all = transitions(s);
+      const adjacent_transition* first = std::lower_bound(all.begin(), all.end(), label,
+        [](const adjacent_transition& a, std::size_t l) { return a.label < l; });
+      const adjacent_transition* last = std::upper_bound(first, all.end(), label,
+        [](std::size_t l, const adjacent_transition& a) { return l < a.label; });
+      return adjacent_transition_range(first, last);
+    }
+};
+
+namespace detail
+{
+
+/// \brief The adjacency indices that are cached by an LTS. Copying an LTS does not copy
+/// the cache, since it can be recomputed on demand.
+/// \details Changes to the LTS increment the generation. An index is stale if it was
+/// computed for an older generation. Stale indices are not freed when the LTS changes,
+/// but only when a new index is computed, and they are shared with the callers that
+/// requested them, such that references to them remain valid until then.
+struct adjacency_cache
+{
+  std::shared_ptr<const adjacency_index> outgoing;
+  std::shared_ptr<const adjacency_index> incoming;
+  std::size_t generation = 0;
+  std::size_t outgoing_generation = 0;
+  std::size_t incoming_generation = 0;
+
+  adjacency_cache() = default;
+
+  adjacency_cache(const adjacency_cache&)
+  {}
+
+  adjacency_cache& operator=(const adjacency_cache&)
+  {
+    invalidate();
+    return *this;
+  }
+
+  void invalidate()
+  {
+    ++generation;
+  }
+
+  bool outgoing_is_valid() const
+  {
+    return outgoing && outgoing_generation == generation;
+  }
+
+  bool incoming_is_valid() const
+  {
+    return incoming && incoming_generation == generation;
+  }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_ADJACENCY_INDEX_H
@@ -0,0 +1,379 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/aut_parser.h
+/// \brief A parallel parser for non probabilistic .aut files that operates
+///        directly on the characters of a (memory mapped) file.
+
+#ifndef MCRL2_LTS_DETAIL_AUT_PARSER_H
+#define MCRL2_LTS_DETAIL_AUT_PARSER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/parallel.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief A parser for .aut files without probabilities. The header is parsed by the
+/// constructor. The transitions are parsed by parse_transitions, which splits the text
+/// into chunks at line boundaries and scans the chunks in parallel.
+/// \details Every transition must be on a single line, but there may be more than one
+/// transition on a line. Labels are interned per chunk, and the chunk tables are merged
+/// in the order of the chunks. So the labels are numbered in the order of their first
+/// occurrence, and the result does not depend on the number of threads. The action tau
+/// always has number 0.
+class aut_parser
+{
+  protected:
+    // The results of scanning one chunk of transitions.
+    struct chunk
+    {
+      const char* first;
+      const char* last;
+      std::vector<std::size_t> transitions; // Triples (from, label, to), with label an index in labels.
+      std::vector<std::string> labels;      // The labels in the order of their first occurrence in the chunk.
+      std::size_t lines = 0;                // The number of newlines that were scanned.
+      std::string error;                    // Non empty if a syntax error was found at line 'lines' of the chunk.
+    };
+
+    const char* m_first;
+    const char* m_last;
+    const char* m_position; // The start of the transitions
+    std::size_t m_initial_state;
+    std::size_t m_number_of_transitions;
+    std::size_t m_number_of_states;
+    std::size_t m_header_lines = 0;
+
+    static bool is_space(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static bool is_digit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+    static std::string line_message(const std::string& message, std::size_t line)
+    {
+      return message + " at line " + std::to_string(line) + ".";
+    }
+
+    // Skips spaces and tabs, but not newlines.
+    static const char* skip_spaces(const char* p, const char* last)
+    {
+      while (p != last && is_space(*p))
+      {
+        ++p;
+      }
+      return p;
+    }
+
+    // Skips white space including newlines, and counts the newlines.
+    static const char* skip_white_space(const char* p, const char* last, std::size_t& lines)
+    {
+      while (p != last && (is_space(*p) || *p == '\n'))
+      {
+        if (*p == '\n')
+        {
+          ++lines;
+        }
+        ++p;
+      }
+      return p;
+    }
+
+    // Reads a natural number starting at p. Returns nullptr if there is no number, or if it
+    // does not fit in a std::size_t.
+    static const char* read_number(const char* p, const char* last, std::size_t& result)
+    {
+      if (p == last || !is_digit(*p))
+      {
+        return nullptr;
+      }
+      result = 0;
+      for (; p != last && is_digit(*p); ++p)
+      {
+        const std::size_t digit = *p - '0';
+        if (result > (std::numeric_limits<std::size_t>::max() - digit) / 10)
+        {
+          return nullptr;
+        }
+        result = 10 * result + digit;
+      }
+      return p;
+    }
+
+    // Reads the header, allowing arbitrary white space.
+    void parse_header()
+    {
+      const char* p = skip_white_space(m_first, m_last, m_header_lines);
+      if (p == m_last)
+      {
+        throw mcrl2::runtime_error("The .aut input is empty.");
+      }
+      if (m_last - p < 3 || std::strncmp(p, "des", 3) != 0)
+      {
+        throw mcrl2::runtime_error("Expect an .aut file to start with 'des'.");
+      }
+      p = skip_white_space(p + 3, m_last, m_header_lines);
+      if (p == m_last || *p != '(')
+      {
+        throw mcrl2::runtime_error("Expect an opening bracket '(' after 'des' in the first line of a .aut file.");
+      }
+      p = read_number(skip_white_space(p + 1, m_last, m_header_lines), m_last, m_initial_state);
+      if (p == nullptr)
+      {
+        throw mcrl2::runtime_error("Expect a state number at line 1.");
+      }
+      p = skip_white_space(p, m_last, m_header_lines);
+      if (p != m_last && is_digit(*p))
+      {
+        throw mcrl2::runtime_error("Encountered an initial probability distribution while reading an non probabilistic .aut file.");
+      }
+      if (p == m_last || *p != ',')
+      {
+        throw mcrl2::runtime_error("Expect a comma after the first number in the first line of a .aut file.");
+      }
+      p = read_number(skip_white_space(p + 1, m_last, m_header_lines), m_last, m_number_of_transitions);
+      p = p == nullptr ? nullptr : skip_white_space(p, m_last, m_header_lines);
+      if (p == nullptr || p == m_last || *p != ',')
+      {
+        throw mcrl2::runtime_error("Expect a comma after the second number in the first line of a .aut file.");
+      }
+      p = read_number(skip_white_space(p + 1, m_last, m_header_lines), m_last, m_number_of_states);
+      p = p == nullptr ? nullptr : skip_white_space(p, m_last, m_header_lines);
+      if (p == nullptr || p == m_last || *p != ')')
+      {
+        throw mcrl2::runtime_error("Expect a closing bracket ')' after the third number in the first line of a .aut file.");
+      }
+      if (m_number_of_states == 0)
+      {
+        throw mcrl2::runtime_error("cannot parse AUT input that has no states; at least an initial state is required.");
+      }
+      if (m_initial_state >= m_number_of_states)
+      {
+        throw mcrl2::runtime_error("The state number " + std::to_string(m_initial_state) + " is higher than the number of states (" +
+                                   std::to_string(m_number_of_states) + ").  Found at line 1.");
+      }
+      m_position = p + 1;
+    }
+
+    // Scans the transitions in [c.first, c.last). Stops at the first error.
+    void scan(chunk& c) const
+    {
+      std::unordered_map<std::string, std::size_t> label_index;
+      std::string name;
+      const char* last = c.last;
+      const char* p = skip_white_space(c.first, last, c.lines);
+      while (p != last)
+      {
+        std::size_t from;
+        std::size_t to;
+        if (*p != '(')
+        {
+          c.error = "Expect opening bracket";
+          return;
+        }
+        p = read_number(skip_spaces(p + 1, last), last, from);
+        p = p == nullptr ? nullptr : skip_spaces(p, last);
+        if (p == nullptr || p == last || *p != ',')
+        {
+          c.error = "Expect that the first number is followed by a comma";
+          return;
+        }
+        p = skip_spaces(p + 1, last);
+        const char* label_first;
+        const char* label_last;
+        if (p != last && *p == '"')
+        {
+          label_first = ++p;
+          while (p != last && *p != '"' && *p != '\n')
+          {
+            ++p;
+          }
+          if (p == last || *p != '"')
+          {
+            c.error = "Expect that the second item is a quoted label (using \")";
+            return;
+          }
+          label_last = p;
+          p = skip_spaces(p + 1, last);
+        }
+        else
+        {
+          label_first = p;
+          while (p != last && *p != ',' && *p != '\n')
+          {
+            ++p;
+          }
+          label_last = p;
+          while (label_last != label_first && is_space(label_last[-1]))
+          {
+            --label_last;
+          }
+        }
+        if (p == last || *p != ',')
+        {
+          c.error = "Expect a comma after the quoted label";
+          return;
+        }
+        p = read_number(skip_spaces(p + 1, last), last, to);
+        p = p == nullptr ? nullptr : skip_spaces(p, last);
+        if (p == nullptr)
+        {
+          c.error = "Expect a state number";
+          return;
+        }
+        if (p == last || *p != ')')
+        {
+          c.error = p != last && is_digit(*p) ? "Encountered a probabilistic target state while reading an non probabilistic .aut file"
+                                 : "Expect a closing bracket at the end of the transition";
+          return;
+        }
+        if (from >= m_number_of_states || to >= m_number_of_states)
+        {
+          c.error = "The state number " + std::to_string(std::max(from, to)) + " is higher than the number of states (" +
+                    std::to_string(m_number_of_states) + ").  Found";
+          return;
+        }
+
+        name.assign(label_first, label_last);
+        auto i = label_index.find(name);
+        if (i == label_index.end())
+        {
+          i = label_index.emplace(name, c.labels.size()).first;
+          c.labels.push_back(name);
+        }
+        c.transitions.push_back(from);
+        c.transitions.push_back(i->second);
+        c.transitions.push_back(to);
+        p = skip_white_space(p + 1, last, c.lines);
+      }
+    }
+
+  public:
+    /// \brief Constructor. Parses the header of the .aut file in [first, last).
+    aut_parser(const char* first, const char* last)
+      : m_first(first), m_last(last)
+    {
+      parse_header();
+    }
+
+    std::size_t initial_state() const
+    {
+      return m_initial_state;
+    }
+
+    std::size_t number_of_transitions() const
+    {
+      return m_number_of_transitions;
+    }
+
+    std::size_t number_of_states() const
+    {
+      return m_number_of_states;
+    }
+
+    /// \brief Parses the transitions.
+    /// \param add_label Is called as add_label(name) for every label other than tau, in the
+    ///        order of first occurrence. It must return the number of the label.
+    /// \param add_transition Is called as add_transition(from, label, to) for every transition,
+    ///        in the order of the file.
+    /// \param number_of_threads The number of threads; 0 means the number of hardware threads
+    /// \param chunk_size The approximate number of characters that is scanned by one thread at a time
+    template <typename AddLabel, typename AddTransition>
+    void parse_transitions(AddLabel add_label,
+                           AddTransition add_transition,
+                           std::size_t number_of_threads = 0,
+                           std::size_t chunk_size = std::size_t(1) << 24
+                          )
+    {
+      number_of_threads = utilities::number_of_threads(number_of_threads);
+      std::unordered_map<std::string, std::size_t> labels;
+      labels["tau"] = 0;
+      std::vector<std::size_t> label_numbers; // Maps the label indices of a chunk to label numbers.
+      std::vector<chunk> chunks;
+      std::size_t line = m_header_lines + 1;
+      std::size_t transition_count = 0;
+
+      // The chunks are processed in rounds of number_of_threads chunks, to limit the memory usage.
+      for (const char* p = m_position; p != m_last; )
+      {
+        chunks.clear();
+        for (std::size_t i = 0; i < number_of_threads && p != m_last; i++)
+        {
+          const char* q = m_last - p <= static_cast<std::ptrdiff_t>(chunk_size) ? m_last : p + chunk_size;
+          q = std::find(q, m_last, '\n');
+          chunks.emplace_back();
+          chunks.back().first = p;
+          chunks.back().last = q;
+          p = q;
+        }
+
+        utilities::parallel_for(chunks.size(), number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+        {
+          for (std::size_t i = first; i < last; i++)
+          {
+            scan(chunks[i]);
+          }
+        });
+
+        for (const chunk& c: chunks)
+        {
+          if (!c.error.empty())
+          {
+            throw mcrl2::runtime_error(line_message(c.error, line + c.lines));
+          }
+          label_numbers.clear();
+          for (const std::string& name: c.labels)
+          {
+            auto i = labels.find(name);
+            if (i == labels.end())
+            {
+              i = labels.emplace(name, add_label(name)).first;
+            }
+            label_numbers.push_back(i->second);
+          }
+          for (auto i = c.transitions.begin(); i != c.transitions.end(); i += 3)
+          {
+            add_transition(i[0], label_numbers[i[1]], i[2]);
+          }
+          transition_count += c.transitions.size() / 3;
+          line += c.lines;
+        }
+      }
+
+      if (transition_count != m_number_of_transitions)
+      {
+        throw mcrl2::runtime_error("number of transitions read (" + std::to_string(transition_count) +
+                                   ") does not correspond to the number of transition given in the header (" + std::to_string(m_number_of_transitions) + ").");
+      }
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_AUT_PARSER_H
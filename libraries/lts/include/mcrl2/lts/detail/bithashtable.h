@@ -1,4 +1,4 @@
-// Author(s): Muck van Weerdenburg
+// Author(s): Muck van Weerdenburg, Wieger Wesselink
 // Copyright: see the accompanying file COPYING or copy at
 // https://github.com/mCRL2org/mCRL2/blob/master/COPYING
 //
@@ -6,74 +6,346 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 //
-/// \file mcrl2/lts/bithashtable.h
+/// \file mcrl2/lts/detail/bithashtable.h
+/// \brief Sets of visited states that store fingerprints of states instead of the
+///        states themselves, for bit state hashing and hash compaction. Both may
+///        consider a state visited when it is not, i.e. states may be omitted.
 
 #ifndef MCRL2_LTS_DETAIL_BITHASHTABLE_H
 #define MCRL2_LTS_DETAIL_BITHASHTABLE_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
 #include <vector>
-#include "mcrl2/lps/next_state_generator.h"
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/utilities/exception.h"
 
 namespace mcrl2
 {
 namespace lts
 {
+namespace detail
+{
 
-class bit_hash_table
+/// \brief A 64 bit mixing function (the finalizer of splitmix64).
+inline std::uint64_t mix_fingerprint(std::uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/// \brief Computes 64 bit fingerprints of terms, for example states.
+/// \details The default hash of a term is based on its address. Terms that are no
+/// longer referenced are garbage collected, after which a different term can get the
+/// same address. So the fingerprint is computed from the structure of the term, with
+/// function symbols identified by their name and arity. The term is traversed with an
+/// explicit stack, so deeply nested terms such as long lists cannot overflow the call
+/// stack. A subterm that occurs more than once is traversed only once: during a
+/// traversal the fingerprints of subterms are cached by address, which is sound since
+/// the term keeps its subterms alive.
+class term_fingerprint
 {
-  private:
-    std::vector < bool > m_bit_hash_table;
-    std::unordered_map<std::size_t, std::size_t> m_number_translator;
+  protected:
+    struct frame
+    {
+      const atermpp::aterm_appl* term;
+      std::size_t next;        // The index of the next argument.
+      std::uint64_t value;     // The fingerprint of the arguments before next.
+    };
+
+    typedef std::pair<const atermpp::detail::_aterm*, std::uint64_t> cache_entry;
+
+    std::vector<frame> m_stack;
+    std::vector<cache_entry> m_cache;  // Open addressing; a null address marks an empty slot.
+    std::vector<std::size_t> m_used;   // The slots of m_cache that are in use.
+
+    static std::uint64_t leaf(const atermpp::aterm& t)
+    {
+      return mix_fingerprint(atermpp::down_cast<atermpp::aterm_int>(t).value() ^ 0x5555555555555555ULL);
+    }
+
+    static frame start(const atermpp::aterm& t)
+    {
+      const atermpp::aterm_appl& a = atermpp::down_cast<atermpp::aterm_appl>(t);
+      return frame{ &a, 0, mix_fingerprint(std::hash<std::string>()(a.function().name()) + a.function().arity()) };
+    }
+
+    std::size_t slot(const atermpp::detail::_aterm* p) const
+    {
+      const std::size_t mask = m_cache.size() - 1;
+      std::size_t k = mix_fingerprint(reinterpret_cast<std::uintptr_t>(p)) & mask;
+      while (m_cache[k].first != nullptr && m_cache[k].first != p)
+      {
+        k = (k + 1) & mask;
+      }
+      return k;
+    }
+
+    void insert(const atermpp::detail::_aterm* p, std::uint64_t value)
+    {
+      if (2 * (m_used.size() + 1) > m_cache.size())
+      {
+        std::vector<cache_entry> cache(2 * m_cache.size(), cache_entry(nullptr, 0));
+        m_cache.swap(cache);
+        m_used.clear();
+        for (const cache_entry& e: cache)
+        {
+          if (e.first != nullptr)
+          {
+            const std::size_t k = slot(e.first);
+            m_cache[k] = e;
+            m_used.push_back(k);
+          }
+        }
+      }
+      const std::size_t k = slot(p);
+      m_cache[k] = cache_entry(p, value);
+      m_used.push_back(k);
+    }
 
-    std::size_t calc_hash(const lps::state& state)
+    void clear_cache()
     {
-      std::hash<atermpp::aterm> hasher;
-      return hasher(state) % m_bit_hash_table.size();
+      for (std::size_t k: m_used)
+      {
+        m_cache[k].first = nullptr;
+      }
+      m_used.clear();
     }
 
   public:
-    bit_hash_table()=default;
+    term_fingerprint()
+      : m_cache(256, cache_entry(nullptr, 0))
+    {}
 
-    bit_hash_table(const std::size_t size) :
-      m_bit_hash_table(size,false)
-    {};
+    /// \brief Returns the fingerprint of t.
+    std::uint64_t operator()(const atermpp::aterm& t)
+    {
+      if (t.type_is_int())
+      {
+        return leaf(t);
+      }
+      std::uint64_t result = 0;
+      m_stack.clear();
+      m_stack.push_back(start(t));
+      while (!m_stack.empty())
+      {
+        frame& f = m_stack.back();
+        if (f.next == f.term->size())
+        {
+          result = f.value;
+          if (f.term->size() > 0)
+          {
+            insert(atermpp::detail::address(*f.term), result);
+          }
+          m_stack.pop_back();
+          if (!m_stack.empty())
+          {
+            m_stack.back().value = mix_fingerprint(m_stack.back().value + result);
+          }
+          continue;
+        }
+        const atermpp::aterm& arg = (*f.term)[f.next++];
+        if (arg.type_is_int())
+        {
+          f.value = mix_fingerprint(f.value + leaf(arg));
+          continue;
+        }
+        const cache_entry& e = m_cache[slot(atermpp::detail::address(arg))];
+        if (e.first != nullptr)
+        {
+          f.value = mix_fingerprint(f.value + e.second);
+          continue;
+        }
+        m_stack.push_back(start(arg));
+      }
+      clear_cache();
+      return result;
+    }
+};
 
+/// \brief Returns a 64 bit fingerprint of a term, for example a state. See term_fingerprint.
+inline std::uint64_t fingerprint(const atermpp::aterm& t)
+{
+  static thread_local term_fingerprint f;
+  return f(t);
+}
+
+/// \brief Bit state hashing (supertrace): a set of fingerprints that is stored in a
+/// Bloom filter. A fingerprint is inserted by setting a number of bits that are derived
+/// from it. A fingerprint is considered present if all its bits are set, so a new state
+/// is omitted if its bits happen to have been set by other states.
+class bit_hash_table
+{
+  protected:
+    std::vector<std::uint64_t> m_bits;
+    std::size_t m_size;                    // The number of bits.
+    std::size_t m_number_of_hash_functions;
+    std::size_t m_number_of_set_bits = 0;
+    double m_expected_omissions = 0;
 
-    void add_states(lps::next_state_generator::transition::state_probability_list states)
+    bool test_and_set(std::size_t i)
     {
-      for(lps::next_state_generator::transition::state_probability_list::const_iterator i=states.begin(); i!=states.end(); ++i)
+      std::uint64_t& word = m_bits[i / 64];
+      const std::uint64_t mask = std::uint64_t(1) << (i % 64);
+      if (word & mask)
       {
-        add_state(i->state());
+        return true;
       }
+      word |= mask;
+      m_number_of_set_bits++;
+      return false;
     }
 
-    std::pair<std::size_t, bool> add_state(const lps::state& state)
+  public:
+    /// \brief Constructor.
+    /// \param size The number of bits of the table
+    /// \param number_of_hash_functions The number of bits that is set for every state
+    explicit bit_hash_table(std::size_t size, std::size_t number_of_hash_functions = 3)
+      : m_bits((size + 63) / 64, 0), m_size(size), m_number_of_hash_functions(number_of_hash_functions)
     {
-      std::size_t i = calc_hash(state);
-      bool is_new = !m_bit_hash_table[i];
-      if (is_new)
-      { 
-        m_bit_hash_table[i] = true;
-        std::size_t new_index=m_number_translator.size();
-        m_number_translator[i]=new_index;
-        return std::pair<std::size_t, bool>(new_index, true);
+      if (size == 0)
+      {
+        throw mcrl2::runtime_error("the size of a bit hash table must be positive");
+      }
+    }
+
+    /// \brief Inserts a fingerprint. Returns true if it was not yet present.
+    bool insert(std::uint64_t fingerprint)
+    {
+      // The probability that a new state is found to be present, i.e. is omitted.
+      const double p = std::pow(static_cast<double>(m_number_of_set_bits) / m_size, m_number_of_hash_functions);
+
+      // Double hashing: bit i is h1 + i * h2.
+      const std::uint64_t h1 = fingerprint;
+      const std::uint64_t h2 = mix_fingerprint(fingerprint) | 1;
+      bool is_new = false;
+      for (std::size_t i = 0; i < m_number_of_hash_functions; i++)
+      {
+        if (!test_and_set(static_cast<std::size_t>((h1 + i * h2) % m_size)))
+        {
+          is_new = true;
+        }
       }
-      else
+      if (is_new)
       {
-        return std::pair<std::size_t, bool>(m_number_translator.at(i), false);
+        m_expected_omissions += p;
       }
+      return is_new;
     }
 
-    std::size_t state_index(const lps::state& state)
+    /// \brief Returns the expected number of states that have been omitted.
+    double expected_omissions() const
     {
-      assert(m_bit_hash_table[calc_hash(state)]);
-      return m_number_translator.at(calc_hash(state));
+      return m_expected_omissions;
+    }
+
+    /// \brief Returns the number of bytes used by the table.
+    std::size_t memory_usage() const
+    {
+      return m_bits.size() * sizeof(std::uint64_t);
     }
 };
 
+/// \brief Hash compaction: a set of 64 bit fingerprints, stored in a hash table with
+/// linear probing. A new state is omitted if its fingerprint equals the fingerprint of
+/// a state that was inserted before.
+class hash_compaction_table
+{
+  protected:
+    std::vector<std::uint64_t> m_table; // The value 0 marks an empty slot.
+    std::size_t m_size = 0;
+    double m_expected_omissions = 0;
 
-}
+    void resize()
+    {
+      std::vector<std::uint64_t> table(std::max(std::size_t(1024), 2 * m_table.size()), 0);
+      for (std::uint64_t f: m_table)
+      {
+        if (f != 0)
+        {
+          std::size_t k = mix_fingerprint(f) & (table.size() - 1);
+          while (table[k] != 0)
+          {
+            k = (k + 1) & (table.size() - 1);
+          }
+          table[k] = f;
+        }
+      }
+      m_table.swap(table);
+    }
+
+  public:
+    explicit hash_compaction_table(std::size_t initial_size = 1024)
+    {
+      std::size_t n = 1024;
+      while (n < initial_size)
+      {
+        n *= 2;
+      }
+      m_table.resize(n / 2);
+      resize();
+    }
+
+    /// \brief Inserts a fingerprint. Returns true if it was not yet present.
+    bool insert(std::uint64_t fingerprint)
+    {
+      if (fingerprint == 0)
+      {
+        fingerprint = 1;
+      }
+      std::size_t k = mix_fingerprint(fingerprint) & (m_table.size() - 1);
+      while (m_table[k] != 0)
+      {
+        if (m_table[k] == fingerprint)
+        {
+          return false;
+        }
+        k = (k + 1) & (m_table.size() - 1);
+      }
+      m_table[k] = fingerprint;
+
+      // The probability that the fingerprint of a new state equals one of the m_size
+      // fingerprints that are already present.
+      m_expected_omissions += std::ldexp(static_cast<double>(m_size), -64);
+      m_size++;
+      if (4 * m_size > 3 * m_table.size())
+      {
+        resize();
+      }
+      return true;
+    }
+
+    /// \brief Returns the expected number of states that have been omitted.
+    double expected_omissions() const
+    {
+      return m_expected_omissions;
+    }
+
+    /// \brief Returns the number of bytes used by the table.
+    std::size_t memory_usage() const
+    {
+      return m_table.size() * sizeof(std::uint64_t);
+    }
+};
+
+/// \brief Returns the probability that at least one state was omitted, given the
+/// expected number of omitted states.
+inline double omission_probability(double expected_omissions)
+{
+  return -std::expm1(-expected_omissions);
 }
 
-#endif // MCRL2_LTS_DETAIL_BITHASHTABLE_H
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
 
+#endif // MCRL2_LTS_DETAIL_BITHASHTABLE_H
@@ -257,7 +257,39 @@ class check_complexity
         for_all_transitions_that_need_postproc_a_priori_4_12,
         for_all_transitions_that_need_postproc_a_posteriori_4_12,
         for_all_old_bottom_states_s_in_RedB_4_15,
-        TRANS_MAX = for_all_old_bottom_states_s_in_RedB_4_15
+        TRANS_MAX = for_all_old_bottom_states_s_in_RedB_4_15,
+
+        // counters for the algorithm that works directly on the labelled
+        // transitions (liblts_bisim_dnj.h).  Only the work on the smaller
+        // subblock of a refinement is counted.
+
+        // state counters: every state is visited O(log n) times
+            // Invariant: s->constln->size() << (counter value) <= n
+        dnj_for_all_states_in_SpB,
+        DNJ_STATE_MIN = dnj_for_all_states_in_SpB,
+            // Invariant: s->block->size() << (counter value) <= n
+        dnj_small_subblock_state,
+
+        // new bottom state counter: every state is visited once
+        dnj_new_bottom_state,
+        DNJ_STATE_MAX = dnj_new_bottom_state,
+
+        // transition counters: every transition is visited O(log n) times
+            // Invariant: target->constln->size() << (counter value) <= n
+        dnj_for_all_incoming_transitions_of_SpB,
+        DNJ_TRANS_MIN = dnj_for_all_incoming_transitions_of_SpB,
+        dnj_mark_sources_of_splitter_slice,
+            // Invariant: source->constln->size() << (counter value) <= n
+        dnj_find_tau_slice_of_splitter,
+        dnj_mark_tau_sources_in_splitter,
+            // Invariant: source->block->size() << (counter value) <= n
+        dnj_small_subblock_outgoing_transition,
+            // Invariant: target->block->size() << (counter value) <= n
+        dnj_small_subblock_incoming_inert_transition,
+
+        // new bottom transition counter: every transition is visited once
+        dnj_postprocess_out_slice,
+        DNJ_TRANS_MAX = dnj_postprocess_out_slice
     };
 
     /// \brief special value for temporary work without changing the balance
@@ -297,7 +329,7 @@ class check_complexity
 
   public:
     /// \brief printable names of the counter types (for error messages)
-    static const char *work_names[TRANS_MAX - BLOCK_MIN + 1];
+    static const char *work_names[DNJ_TRANS_MAX - BLOCK_MIN + 1];
 
     /// \brief check that not too much superfluous work has been done
     /// \details After having moved all temporary work counters to the normal
@@ -801,6 +833,13 @@ class check_complexity
     };
 
 
+    /// \brief counters for a state in liblts_bisim_dnj.h
+    typedef counter_t<DNJ_STATE_MIN, DNJ_STATE_MAX> dnj_state_counter_t;
+
+    /// \brief counters for a transition in liblts_bisim_dnj.h
+    typedef counter_t<DNJ_TRANS_MIN, DNJ_TRANS_MAX> dnj_trans_counter_t;
+
+
     #if 0
         /// \brief prints a message for each counter, for debugging purposes
         /// \details The function can be called, e. g., from
@@ -10,17 +10,29 @@
 #ifndef MCRL2_LTS_DETAIL_EXPLORATION_NEW_H
 #define MCRL2_LTS_DETAIL_EXPLORATION_NEW_H
 
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <limits>
 #include <memory>
-#include <unordered_set>
+#include <unordered_map>
 
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/atermpp/aterm_string.h"
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
 #include "mcrl2/atermpp/indexed_set.h"
 #include "mcrl2/lps/detail/instantiate_global_variables.h"
 #include "mcrl2/lps/next_state_generator.h"
 #include "mcrl2/lps/one_point_rule_rewrite.h"
 #include "mcrl2/lps/resolve_name_clashes.h"
 #include "mcrl2/lts/lts_lts.h"
+#include "mcrl2/lts/lts_lts_view.h"
+#include "mcrl2/lts/detail/bithashtable.h"
+#include "mcrl2/lts/detail/external_state_store.h"
+#include "mcrl2/lts/detail/parent_store.h"
+#include "mcrl2/lts/detail/worker_processes.h"
 #include "mcrl2/lts/detail/queue.h"
 #include "mcrl2/lts/detail/lts_generation_options.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
@@ -29,6 +41,7 @@
 #include "mcrl2/lts/detail/exploration.h"
 #include "mcrl2/lts/detail/counter_example.h"
 #include "mcrl2/lts/probabilistic_lts.h"
+#include "mcrl2/trace/trace.h"
 
 namespace mcrl2 {
 
@@ -43,12 +56,30 @@ class lps2lts_algorithm
     // TODO: this generator should not be stored as a pointer
     std::unique_ptr<NextStateGenerator> m_generator;
 
-    atermpp::indexed_set<lps::state> m_state_numbers;
+    atermpp::concurrent_indexed_set<lps::state> m_state_numbers;
     atermpp::indexed_set<process::action_list> m_action_label_numbers;
     std::size_t m_number_of_states = 0;
     std::size_t m_number_of_transitions = 0;
     std::size_t m_level = 0;
 
+    // The initial state, or its representative if confluence reduction is used.
+    lps::state m_initial_state;
+
+    // The indices of the summands that are treated as confluent tau summands.
+    std::vector<std::size_t> m_confluent_summands;
+    lps::next_state_generator::enumerator_queue m_confluence_queue;
+
+    // A direct mapped cache of the representatives of states that were visited by
+    // find_representative. It has a fixed number of entries, so it does not grow with the
+    // state space.
+    std::vector<std::pair<lps::state, lps::state> > m_representative_cache;
+
+    // The parents of the states, which are used to reconstruct traces. It is only used
+    // if traces are saved.
+    std::unique_ptr<detail::parent_store> m_parents;
+    std::size_t m_number_of_traces = 0;
+    lps::next_state_generator::enumerator_queue m_trace_queue;
+
     // TODO: the details of writing the computed LTS (in two different formats!?) should not be hard coded like this
     lts_lts_t m_output_lts;
     std::ofstream m_aut_file;
@@ -70,30 +101,91 @@ class lps2lts_algorithm
 
       on_start_exploration();
 
-      m_state_numbers.put(m_generator->initial_state());
       m_number_of_states = 1;
 
       mCRL2log(log::verbose) << "generating state space with '" << es_breadth << "' strategy...\n";
 
-      if (m_options.max_states == 0)
+      if (m_options.bithashing > 0)
       {
-        return true;
+        detail::bit_hash_table visited(m_options.bithashing);
+        generate_lts_breadth_first(visited, "bit state hashing");
+      }
+      else if (m_options.hash_compaction)
+      {
+        detail::hash_compaction_table visited(m_options.initial_table_size);
+        generate_lts_breadth_first(visited, "hash compaction");
+      }
+      else if (!m_options.external_memory_directory.empty())
+      {
+        generate_lts_external_memory();
+      }
+      else if (m_options.number_of_processes > 1)
+      {
+        generate_lts_multi_process();
+      }
+      else
+      {
+        m_state_numbers.put(m_initial_state);
+        if (m_options.save_traces)
+        {
+          const std::string& prefix = m_options.trace_prefix;
+          const std::size_t slash = prefix.find_last_of('/');
+          m_parents = std::make_unique<detail::parent_store>(m_options.specification.process().action_summands().size(),
+                                                             m_options.trace_memory_limit,
+                                                             slash == std::string::npos ? "." : prefix.substr(0, slash));
+          m_parents->push_back(0, 0);
+        }
+        if (m_options.max_states == 0)
+        {
+          return true;
+        }
+        generate_lts_breadth_first();
       }
 
-      generate_lts_breadth_first();
-
-      mCRL2log(log::verbose) << "done with state space generation ("
-                             << m_level - 1 << " level" << ((m_level == 2) ? "" : "s") << ", "
-                             << m_number_of_states << " state" << ((m_number_of_states == 1) ? "" : "s")
+      mCRL2log(log::verbose) << "done with state space generation (";
+      if (m_options.number_of_processes <= 1)
+      {
+        mCRL2log(log::verbose) << m_level - 1 << " level" << ((m_level == 2) ? "" : "s") << ", ";
+      }
+      mCRL2log(log::verbose) << m_number_of_states << " state" << ((m_number_of_states == 1) ? "" : "s")
                              << " and " << m_number_of_transitions << " transition"
                              << ((m_number_of_transitions == 1) ? "" : "s") << ")"
                              << std::endl;
+      if (m_parents)
+      {
+        mCRL2log(log::verbose) << "the parents of the states used at most " << m_parents->record_size() << " bytes per state, of which "
+                               << m_parents->bytes_written() << " bytes were written to disk; " << m_number_of_traces
+                               << " trace" << (m_number_of_traces == 1 ? " was" : "s were") << " saved.\n";
+      }
+
+      // The worker processes each have their own cache, so the statistics are only available for a single process.
+      if (m_options.use_transition_caching && m_options.number_of_processes <= 1)
+      {
+        const auto& statistics = m_generator->transition_cache_statistics();
+        const std::size_t lookups = statistics.hits + statistics.misses;
+        mCRL2log(log::verbose) << "transition cache: " << statistics.hits << " hits and " << statistics.misses << " misses (hit rate "
+                               << std::fixed << std::setprecision(2) << (lookups == 0 ? 0.0 : 100.0 * statistics.hits / lookups) << "%), "
+                               << statistics.entries << " entries using approximately " << statistics.memory << " bytes"
+                               << (statistics.is_full ? "; the cache was full" : "") << ".\n";
+      }
 
       on_end_exploration();
 
       return true;
     }
 
+    /// \brief Returns the number of states that were found by the last call of generate_lts.
+    std::size_t number_of_states() const
+    {
+      return m_number_of_states;
+    }
+
+    /// \brief Returns the number of transitions that were found by the last call of generate_lts.
+    std::size_t number_of_transitions() const
+    {
+      return m_number_of_transitions;
+    }
+
     void abort()
     {
       // Stops the exploration algorithm if it is running by making sure
@@ -138,7 +230,7 @@ class lps2lts_algorithm
       }
       else if (m_options.outformat != lts_none)
       {
-        auto initial_state_number = m_output_lts.add_state(state_label_lts(m_generator->initial_state()));
+        auto initial_state_number = m_output_lts.add_state(state_label_lts(m_initial_state));
         m_output_lts.set_initial_state(initial_state_number);
       }
     }
@@ -190,7 +282,14 @@ class lps2lts_algorithm
         {
           case lts_lts:
           {
-            m_output_lts.save(m_options.filename);
+            if (m_options.save_indexed)
+            {
+              save_indexed_lts(m_output_lts, m_options.filename);
+            }
+            else
+            {
+              m_output_lts.save(m_options.filename);
+            }
             break;
           }
           case lts_fsm:
@@ -223,10 +322,35 @@ class lps2lts_algorithm
     bool initialise_lts_generation(const lts_generation_options& options)
     {
       m_options = options;
-      m_state_numbers = atermpp::indexed_set<lps::state>(m_options.initial_table_size, 50);
+      if ((m_options.bithashing > 0 || m_options.hash_compaction || !m_options.external_memory_directory.empty()) && m_options.outformat != lts_none)
+      {
+        throw mcrl2::runtime_error("an LTS cannot be saved when bit state hashing, hash compaction or external memory exploration is used");
+      }
+      if (m_options.use_transition_caching && m_options.use_enumeration_caching)
+      {
+        throw mcrl2::runtime_error("transition caching cannot be combined with enumeration caching");
+      }
+      if (m_options.save_traces && (m_options.bithashing > 0 || m_options.hash_compaction || !m_options.external_memory_directory.empty() || m_options.number_of_processes > 1))
+      {
+        throw mcrl2::runtime_error("traces cannot be saved when bit state hashing, hash compaction, external memory exploration or multiple worker processes are used");
+      }
+      if (m_options.number_of_processes > 1)
+      {
+        if (m_options.bithashing > 0 || m_options.hash_compaction || !m_options.external_memory_directory.empty())
+        {
+          throw mcrl2::runtime_error("multiple worker processes cannot be combined with bit state hashing, hash compaction or external memory exploration");
+        }
+        if (m_options.outformat != lts_none && m_options.outformat != lts_aut)
+        {
+          throw mcrl2::runtime_error("with multiple worker processes an LTS can only be saved in the aut format");
+        }
+      }
+      m_state_numbers = atermpp::concurrent_indexed_set<lps::state>(m_options.initial_table_size, 50);
       m_number_of_states = 0;
       m_number_of_transitions = 0;
       m_level = 1;
+      m_parents.reset();
+      m_number_of_traces = 0;
 
       // preprocess the LPS
       lps::specification& lpsspec = m_options.specification;
@@ -253,7 +377,33 @@ class lps2lts_algorithm
         rewriter = data::rewriter(lpsspec.data(), m_options.strat);
       }
 
-      bool compute_actions = m_options.outformat != lts_none;
+      m_confluent_summands.clear();
+      m_representative_cache.clear();
+      if (!m_options.confluence_action.empty())
+      {
+        std::size_t index = 0;
+        for (auto& summand: lpsspec.process().action_summands())
+        {
+          const process::action_list& actions = summand.multi_action().actions();
+          const bool is_confluent = m_options.confluence_action == "tau"
+                                    ? summand.is_tau()
+                                    : actions.size() == 1 && core::pp(actions.front().label().name()) == m_options.confluence_action;
+          if (is_confluent)
+          {
+            m_confluent_summands.push_back(index);
+            summand.multi_action().actions() = process::action_list(); // confluent transitions are labelled tau
+          }
+          index++;
+        }
+        if (!m_confluent_summands.empty())
+        {
+          m_representative_cache.resize(representative_cache_size());
+        }
+        mCRL2log(log::verbose) << "confluence reduction: " << m_confluent_summands.size() << " summands with action '"
+                               << m_options.confluence_action << "' are treated as confluent tau summands.\n";
+      }
+
+      bool compute_actions = m_options.outformat != lts_none || m_options.save_traces;
       if (!compute_actions)
       {
         for (auto& summand: lpsspec.process().action_summands())
@@ -262,6 +412,11 @@ class lps2lts_algorithm
         }
       }
       m_generator = std::make_unique<NextStateGenerator>(lpsspec, rewriter);
+      if (m_options.use_transition_caching)
+      {
+        m_generator->enable_transition_caching(m_options.transition_cache_size);
+      }
+      m_initial_state = find_representative(m_generator->initial_state());
 
       if (m_options.detect_deadlock)
       {
@@ -302,6 +457,190 @@ class lps2lts_algorithm
       return false;
     }
 
+    static std::size_t representative_cache_size()
+    {
+      return std::size_t(1) << 16;
+    }
+
+    std::pair<lps::state, lps::state>& representative_cache_entry(const lps::state& state)
+    {
+      return m_representative_cache[std::hash<lps::state>()(state) & (representative_cache_size() - 1)];
+    }
+
+    // Returns true if the representative of state is known, in which case it is assigned to
+    // representative. Only representatives get a state number, so a numbered state is its own
+    // representative. Other states are looked up in the cache.
+    bool known_representative(const lps::state& state, lps::state& representative)
+    {
+      if (m_state_numbers.index(state) != atermpp::concurrent_indexed_set<lps::state>::npos)
+      {
+        representative = state;
+        return true;
+      }
+      const std::pair<lps::state, lps::state>& entry = representative_cache_entry(state);
+      if (entry.first == state)
+      {
+        representative = entry.second;
+        return true;
+      }
+      return false;
+    }
+
+    // Returns the representative of state with respect to the confluent tau summands. The first
+    // confluent transition is followed until a state without confluent transitions is reached, a
+    // state with a known representative is reached, or a state on the path is revisited. In the
+    // latter case the representative is the state on the confluent tau cycle with the smallest
+    // fingerprint, so it does not depend on where the cycle was entered. Since all states on the
+    // path are branching bisimilar, only the representatives need to be explored. The states on
+    // the path are entered in a cache of fixed size, so a confluent path that is reached again
+    // soon is usually not followed again, while the memory use stays bounded.
+    lps::state find_representative(const lps::state& state)
+    {
+      if (m_confluent_summands.empty())
+      {
+        return state;
+      }
+      lps::state representative;
+      if (known_representative(state, representative))
+      {
+        return representative;
+      }
+
+      std::vector<lps::state> path;
+      std::unordered_map<lps::state, std::size_t> position; // The position of a state on the path.
+      lps::state current = state;
+      while (true)
+      {
+        position.emplace(current, path.size());
+        path.push_back(current);
+        bool found = false;
+        lps::state next;
+        for (std::size_t i: m_confluent_summands)
+        {
+          m_confluence_queue.clear();
+          auto j = m_generator->begin(current, i, &m_confluence_queue);
+          if (j != m_generator->end())
+          {
+            next = j->target_state;
+            found = true;
+            break;
+          }
+        }
+        if (!found)
+        {
+          representative = current;
+          break;
+        }
+        if (known_representative(next, representative))
+        {
+          break;
+        }
+        auto cycle = position.find(next);
+        if (cycle != position.end())
+        {
+          representative = *std::min_element(path.begin() + cycle->second, path.end(),
+                             [](const lps::state& s1, const lps::state& s2)
+                             {
+                               return detail::fingerprint(s1) < detail::fingerprint(s2);
+                             });
+          break;
+        }
+        current = next;
+      }
+      for (const lps::state& s: path)
+      {
+        representative_cache_entry(s) = std::make_pair(s, representative);
+      }
+      return representative;
+    }
+
+    // Returns the transitions of the given summand from state.
+    std::vector<lps::next_state_generator::transition> summand_transitions(const lps::state& state, std::size_t summand_index)
+    {
+      std::vector<lps::next_state_generator::transition> result;
+      m_trace_queue.clear();
+      for (auto i = m_generator->begin(state, summand_index, &m_trace_queue); i != m_generator->end(); ++i)
+      {
+        result.push_back(*i);
+      }
+      return result;
+    }
+
+    // Adds the confluent transitions that are followed by find_representative from state to
+    // its representative to the trace.
+    void add_confluent_path(trace::Trace& trace, lps::state state, const lps::state& representative)
+    {
+      while (state != representative)
+      {
+        bool found = false;
+        for (std::size_t i: m_confluent_summands)
+        {
+          const std::vector<lps::next_state_generator::transition> transitions = summand_transitions(state, i);
+          if (!transitions.empty())
+          {
+            trace.addAction(transitions.front().action);
+            trace.setState(transitions.front().target_state);
+            state = transitions.front().target_state;
+            found = true;
+            break;
+          }
+        }
+        if (!found)
+        {
+          throw mcrl2::runtime_error("could not reconstruct the confluent transitions of a trace");
+        }
+      }
+    }
+
+    // Saves a shortest trace from the initial state to the state with the given number. The
+    // path is found by following the parents, and the transitions on it are computed again.
+    void save_trace(std::size_t state_number, const std::string& info)
+    {
+      if (!m_parents || m_number_of_traces >= m_options.max_traces)
+      {
+        return;
+      }
+
+      std::vector<std::pair<std::size_t, std::size_t>> path; // pairs (state number, summand index)
+      for (std::size_t s = state_number; s != 0; )
+      {
+        const std::pair<std::size_t, std::size_t> parent = (*m_parents)[s];
+        path.emplace_back(s, parent.second);
+        s = parent.first;
+      }
+
+      trace::Trace trace;
+      trace.setState(m_generator->initial_state());
+      add_confluent_path(trace, m_generator->initial_state(), m_initial_state);
+      lps::state current = m_initial_state;
+      for (auto i = path.rbegin(); i != path.rend(); ++i)
+      {
+        const lps::state target = m_state_numbers.get(i->first);
+        bool found = false;
+        for (const lps::next_state_generator::transition& t: summand_transitions(current, i->second))
+        {
+          if (find_representative(t.target_state) == target)
+          {
+            trace.addAction(t.action);
+            trace.setState(t.target_state);
+            add_confluent_path(trace, t.target_state, target);
+            found = true;
+            break;
+          }
+        }
+        if (!found)
+        {
+          throw mcrl2::runtime_error("could not reconstruct the trace to state " + std::to_string(state_number));
+        }
+        current = target;
+      }
+
+      const std::string filename = m_options.trace_prefix + "_" + info + "_" + std::to_string(m_number_of_traces) + ".trc";
+      trace.save(filename);
+      m_number_of_traces++;
+      mCRL2log(log::info) << "a trace of length " << path.size() << " to state " << state_number << " was saved to '" << filename << "'.\n";
+    }
+
     std::pair<std::size_t, bool> add_target_state(const lps::state& source_state, const lps::state& target_state)
     {
       std::pair<std::size_t, bool> target_state_number = m_state_numbers.put(target_state);
@@ -317,6 +656,11 @@ class lps2lts_algorithm
     {
       std::size_t source_state_number = m_state_numbers[source_state];
       const std::pair<std::size_t, bool> target_state_number = add_target_state(source_state, transition.target_state);
+      if (m_parents && target_state_number.second)
+      {
+        assert(m_parents->size() == target_state_number.first);
+        m_parents->push_back(source_state_number, transition.summand_index);
+      }
       on_transition(source_state_number, transition.action, target_state_number.first);
       m_number_of_transitions++;
       return target_state_number.second;
@@ -358,6 +702,7 @@ class lps2lts_algorithm
 #endif
 
     void generate_transitions(const lps::state& state,
+                              std::size_t state_number,
                               std::vector<lps::next_state_generator::transition>& transitions,
                               lps::next_state_generator::enumerator_queue& enumeration_queue
     )
@@ -371,6 +716,13 @@ class lps2lts_algorithm
         {
           transitions.push_back(*i);
         }
+        if (!m_confluent_summands.empty())
+        {
+          for (lps::next_state_generator::transition& t: transitions)
+          {
+            t.target_state = find_representative(t.target_state);
+          }
+        }
       }
       catch (mcrl2::runtime_error& e)
       {
@@ -384,7 +736,8 @@ class lps2lts_algorithm
 
       if (m_options.detect_deadlock && transitions.empty())
       {
-        mCRL2log(log::info) << "deadlock-detect: deadlock found (state index: " << m_state_numbers.index(state) << ").\n";
+        mCRL2log(log::info) << "deadlock-detect: deadlock found (state index: " << state_number << ").\n";
+        save_trace(state_number, "dlk");
       }
 
       if (m_options.detect_nondeterminism)
@@ -392,24 +745,50 @@ class lps2lts_algorithm
         lps::next_state_generator::transition nondeterministic_transition;
         if (is_nondeterministic(transitions, nondeterministic_transition))
         {
-          mCRL2log(log::info) << "Nondeterministic state found (state index: " << m_state_numbers.index(state) << ").\n";
+          mCRL2log(log::info) << "Nondeterministic state found (state index: " << state_number << ").\n";
+          save_trace(state_number, "nondet");
         }
       }
     }
 
+    // Updates the level after a state has been explored, and prints a progress message if needed.
+    void update_level_and_progress(std::size_t current_state, std::size_t& start_level_seen, std::size_t& start_level_transitions, time_t& last_log_time)
+    {
+      if (current_state == start_level_seen)
+      {
+        mCRL2log(log::debug) << "Number of states at level " << m_level << " is " << m_number_of_states - start_level_seen << "\n";
+        m_level++;
+        start_level_seen = m_number_of_states;
+        start_level_transitions = m_number_of_transitions;
+      }
+
+      time_t new_log_time;
+      if (!m_options.suppress_progress_messages && time(&new_log_time) > last_log_time)
+      {
+        last_log_time = new_log_time;
+        std::size_t lvl_states = m_number_of_states - start_level_seen;
+        std::size_t lvl_transitions = m_number_of_transitions - start_level_transitions;
+        mCRL2log(log::status) << std::fixed << std::setprecision(2)
+                              << m_number_of_states << "st, " << m_number_of_transitions << "tr"
+                              << ", explored " << 100.0 * ((float) current_state / m_number_of_states)
+                              << "%. Last level: " << m_level << ", " << lvl_states << "st, " << lvl_transitions
+                              << "tr.\n";
+      }
+    }
+
     void generate_lts_breadth_first()
     {
       std::size_t current_state = 0;
       std::size_t start_level_seen = 1;
       std::size_t start_level_transitions = 0;
       std::vector<lps::next_state_generator::transition> transitions;
-      time_t last_log_time = time(nullptr) - 1, new_log_time;
+      time_t last_log_time = time(nullptr) - 1;
       lps::next_state_generator::enumerator_queue enumeration_queue;
 
       while (!m_must_abort && (current_state < m_state_numbers.size()) && (current_state < m_options.max_states))
       {
         lps::state state = m_state_numbers.get(current_state);
-        generate_transitions(state, transitions, enumeration_queue);
+        generate_transitions(state, current_state, transitions, enumeration_queue);
 
         for (const lps::next_state_generator::transition& t: transitions)
         {
@@ -418,31 +797,377 @@ class lps2lts_algorithm
         transitions.clear();
 
         current_state++;
-        if (current_state == start_level_seen)
+        update_level_and_progress(current_state, start_level_seen, start_level_transitions, last_log_time);
+      }
+
+      if (current_state == m_options.max_states)
+      {
+        mCRL2log(log::verbose) << "explored the maximum number (" << m_options.max_states << ") of states, terminating." << std::endl;
+      }
+    }
+
+    // Breadth first exploration in which only fingerprints of the visited states are stored in
+    // visited, which is a bit_hash_table or a hash_compaction_table. Only the states in the
+    // queue are stored explicitly. States are numbered in the order in which they are found.
+    template <typename VisitedSet>
+    void generate_lts_breadth_first(VisitedSet& visited, const std::string& method)
+    {
+      std::size_t current_state = 0;
+      std::size_t start_level_seen = 1;
+      std::size_t start_level_transitions = 0;
+      std::vector<lps::next_state_generator::transition> transitions;
+      time_t last_log_time = time(nullptr) - 1;
+      lps::next_state_generator::enumerator_queue enumeration_queue;
+      std::deque<lps::state> todo;
+
+      visited.insert(detail::fingerprint(m_initial_state));
+      todo.push_back(m_initial_state);
+
+      while (!m_must_abort && !todo.empty() && (current_state < m_options.max_states))
+      {
+        lps::state state = todo.front();
+        todo.pop_front();
+        generate_transitions(state, current_state, transitions, enumeration_queue);
+
+        for (const lps::next_state_generator::transition& t: transitions)
         {
-          mCRL2log(log::debug) << "Number of states at level " << m_level << " is " << m_number_of_states - start_level_seen << "\n";
-          m_level++;
-          start_level_seen = m_number_of_states;
-          start_level_transitions = m_number_of_transitions;
+          if (visited.insert(detail::fingerprint(t.target_state)))
+          {
+            m_number_of_states++;
+            todo.push_back(t.target_state);
+          }
+          m_number_of_transitions++;
+        }
+        transitions.clear();
+
+        current_state++;
+        update_level_and_progress(current_state, start_level_seen, start_level_transitions, last_log_time);
+      }
+
+      if (current_state == m_options.max_states)
+      {
+        mCRL2log(log::verbose) << "explored the maximum number (" << m_options.max_states << ") of states, terminating." << std::endl;
+      }
+      mCRL2log(log::info) << method << " used " << visited.memory_usage() << " bytes for " << m_number_of_states
+                          << " states; the estimated probability that states were omitted is "
+                          << detail::omission_probability(visited.expected_omissions())
+                          << " (expected number of omitted states: " << visited.expected_omissions() << ").\n";
+    }
+
+    // Exploration by a number of worker processes. Every worker owns the states of which the
+    // fingerprint modulo the number of workers equals its number, and explores them in breadth
+    // first order. Successors that are owned by another worker are sent to their owner in
+    // batches, together with the number of the source state. So a transition is counted, and
+    // saved, by the owner of its target. Termination is detected with Safra's algorithm.
+    // Afterwards the states of each worker are numbered consecutively, starting with the worker
+    // that owns the initial state, and the transitions of the workers are merged.
+    void generate_lts_multi_process()
+    {
+      const std::size_t n = m_options.number_of_processes;
+      const std::size_t initial_owner = detail::fingerprint(m_initial_state) % n;
+      m_aut_file.flush();
+      std::vector<std::string> results = detail::run_worker_processes(n, [&](std::size_t id, std::vector<detail::worker_channel>& channels)
+      {
+        return run_worker(id, channels, initial_owner);
+      });
+
+      std::vector<std::size_t> offsets(n);
+      m_number_of_states = 0;
+      m_number_of_transitions = 0;
+      for (std::size_t k = 0; k < n; k++)
+      {
+        const std::size_t i = (initial_owner + k) % n;
+        std::size_t states;
+        std::size_t transitions;
+        std::istringstream in(results[i]);
+        if (!(in >> states >> transitions))
+        {
+          throw mcrl2::runtime_error("worker process " + std::to_string(i) + " did not report its results");
         }
+        mCRL2log(log::verbose) << "worker " << i << " owns " << states << " states and " << transitions << " incoming transitions.\n";
+        offsets[i] = m_number_of_states;
+        m_number_of_states += states;
+        m_number_of_transitions += transitions;
+      }
 
-        if (!m_options.suppress_progress_messages && time(&new_log_time) > last_log_time)
+      if (m_options.outformat == lts_aut)
+      {
+        for (std::size_t i = 0; i < n; i++)
         {
-          last_log_time = new_log_time;
-          std::size_t lvl_states = m_number_of_states - start_level_seen;
-          std::size_t lvl_transitions = m_number_of_transitions - start_level_transitions;
-          mCRL2log(log::status) << std::fixed << std::setprecision(2)
-                                << m_number_of_states << "st, " << m_number_of_transitions << "tr"
-                                << ", explored " << 100.0 * ((float) current_state / m_number_of_states)
-                                << "%. Last level: " << m_level << ", " << lvl_states << "st, " << lvl_transitions
-                                << "tr.\n";
+          const std::string filename = worker_transitions_filename(i);
+          std::ifstream in(filename);
+          std::size_t source_owner;
+          std::size_t source;
+          std::size_t target;
+          std::string label;
+          while (in >> source_owner >> source >> target && in.get() == ' ' && std::getline(in, label))
+          {
+            m_aut_file << "(" << offsets[source_owner] + source << ",\"" << label << "\"," << offsets[i] + target << ")\n";
+          }
+          in.close();
+          std::remove(filename.c_str());
+        }
+      }
+    }
+
+    std::string worker_transitions_filename(std::size_t id) const
+    {
+      return m_options.filename + ".worker" + std::to_string(id);
+    }
+
+    // The body of worker process id in generate_lts_multi_process. Returns the number of states
+    // owned by the worker and the number of transitions to them.
+    std::string run_worker(std::size_t id, std::vector<detail::worker_channel>& channels, std::size_t initial_owner)
+    {
+      const std::size_t n = channels.size();
+      const std::size_t batch_size = 1000;
+      const std::size_t max_states = m_options.max_states / n + (m_options.max_states % n == 0 ? 0 : 1);
+      const bool save_transitions = m_options.outformat == lts_aut;
+      const atermpp::function_symbol item_symbol("worker_transition", 3);
+
+      atermpp::indexed_set<lps::state> states(m_options.initial_table_size);
+      std::size_t current_state = 0;
+      std::size_t transition_count = 0;
+      std::vector<std::vector<atermpp::aterm>> batches(n);
+      std::vector<bool> is_open(n, true);
+      std::vector<lps::next_state_generator::transition> transitions;
+      lps::next_state_generator::enumerator_queue enumeration_queue;
+      std::ofstream transitions_file;
+      if (save_transitions)
+      {
+        transitions_file.open(worker_transitions_filename(id));
+        if (!transitions_file.is_open())
+        {
+          throw mcrl2::runtime_error("cannot open '" + worker_transitions_filename(id) + "' for writing");
+        }
+      }
+
+      // The variables of the termination detection.
+      std::int64_t message_count = 0; // The number of batches sent minus the number received.
+      bool black = false;
+      bool has_token = id == 0;
+      bool token_round_started = false;
+      detail::termination_token token;
+      bool terminated = false;
+
+      auto add_transition = [&](std::size_t source_owner, std::size_t source, const std::string& label, const lps::state& target_state)
+      {
+        const std::size_t target = states.put(target_state).first;
+        transition_count++;
+        if (save_transitions)
+        {
+          transitions_file << source_owner << ' ' << source << ' ' << target << ' ' << label << '\n';
+        }
+      };
+
+      auto send_batch = [&](std::size_t j)
+      {
+        std::vector<unsigned char> payload;
+        atermpp::write_term_to_binary_buffer(atermpp::aterm_list(batches[j].begin(), batches[j].end()), payload);
+        channels[j].send(detail::worker_message_type::states, payload);
+        batches[j].clear();
+        message_count++;
+      };
+
+      auto receive = [&](std::size_t from, detail::worker_message_type type, const unsigned char* data, std::size_t size)
+      {
+        switch (type)
+        {
+          case detail::worker_message_type::states:
+          {
+            message_count--;
+            black = true;
+            const atermpp::aterm_list batch = atermpp::down_cast<atermpp::aterm_list>(atermpp::read_term_from_binary_buffer(data, size));
+            for (const atermpp::aterm& item: batch)
+            {
+              const atermpp::aterm_appl& a = atermpp::down_cast<atermpp::aterm_appl>(item);
+              add_transition(from,
+                             atermpp::down_cast<atermpp::aterm_int>(a[0]).value(),
+                             atermpp::down_cast<atermpp::aterm_string>(a[1]),
+                             atermpp::down_cast<lps::state>(a[2]));
+            }
+            break;
+          }
+          case detail::worker_message_type::token:
+          {
+            has_token = true;
+            token = detail::termination_token::decode(data, size);
+            break;
+          }
+          case detail::worker_message_type::terminate:
+          {
+            terminated = true;
+            break;
+          }
+          default:
+            throw mcrl2::runtime_error("received an unknown message from worker process " + std::to_string(from));
+        }
+      };
+
+      if (id == initial_owner)
+      {
+        states.put(m_initial_state);
+      }
+
+      while (!terminated)
+      {
+        // Explore a number of states.
+        for (std::size_t k = 0; k < 100 && !m_must_abort && current_state < states.size() && current_state < max_states; k++)
+        {
+          const lps::state state = states.get(current_state);
+          generate_transitions(state, current_state, transitions, enumeration_queue);
+          for (const lps::next_state_generator::transition& t: transitions)
+          {
+            const std::size_t owner = detail::fingerprint(t.target_state) % n;
+            const std::string label = save_transitions ? lps::pp(t.action) : std::string();
+            if (owner == id)
+            {
+              add_transition(id, current_state, label, t.target_state);
+            }
+            else
+            {
+              batches[owner].push_back(atermpp::aterm_appl(item_symbol, atermpp::aterm_int(current_state), atermpp::aterm_string(label), t.target_state));
+              if (batches[owner].size() >= batch_size)
+              {
+                send_batch(owner);
+              }
+            }
+          }
+          transitions.clear();
+          current_state++;
+        }
+
+        const bool active = !m_must_abort && current_state < states.size() && current_state < max_states;
+        if (!active)
+        {
+          for (std::size_t j = 0; j < n; j++)
+          {
+            if (!batches[j].empty())
+            {
+              send_batch(j);
+            }
+          }
+
+          // A passive worker passes on the token.
+          if (has_token)
+          {
+            has_token = false;
+            if (id != 0)
+            {
+              token.count += message_count;
+              token.black = token.black || black;
+              black = false;
+              channels[(id + 1) % n].send(detail::worker_message_type::token, token.encode());
+            }
+            else if (token_round_started && !token.black && !black && token.count + message_count == 0)
+            {
+              for (std::size_t j = 1; j < n; j++)
+              {
+                channels[j].send(detail::worker_message_type::terminate);
+              }
+              terminated = true;
+            }
+            else
+            {
+              token = detail::termination_token();
+              token_round_started = true;
+              black = false;
+              channels[1].send(detail::worker_message_type::token, token.encode());
+            }
+          }
+        }
+
+        // Exchange messages with the other workers.
+        if (!terminated)
+        {
+          detail::wait_for_channels(channels, is_open, id, active ? 0 : 100);
+        }
+        for (std::size_t j = 0; j < n; j++)
+        {
+          if (j != id && is_open[j])
+          {
+            channels[j].flush();
+            // A worker only closes its connections after the termination has been detected.
+            is_open[j] = channels[j].receive([&](detail::worker_message_type type, const unsigned char* data, std::size_t size)
+                                             {
+                                               receive(j, type, data, size);
+                                             });
+          }
+        }
+      }
+
+      for (std::size_t j = 0; j < n; j++)
+      {
+        if (j != id && is_open[j])
+        {
+          channels[j].flush_blocking();
+        }
+      }
+      return std::to_string(states.size()) + " " + std::to_string(transition_count);
+    }
+
+    // Breadth first exploration with delayed duplicate detection, in which the visited states
+    // are stored on disk. The successors of a level are only compared with the visited states
+    // once the level has been explored. States are numbered in the order in which they are
+    // explored, which within a level is the order of their encodings.
+    void generate_lts_external_memory()
+    {
+      std::size_t current_state = 0;
+      std::vector<lps::next_state_generator::transition> transitions;
+      time_t last_log_time = time(nullptr) - 1;
+      lps::next_state_generator::enumerator_queue enumeration_queue;
+      detail::state_encoder encoder;
+      detail::external_state_store store(m_options.external_memory_directory, m_options.external_memory_buffer_size);
+      std::string encoded_state;
+
+      encoder.encode(m_initial_state, encoded_state);
+      store.initialize(encoded_state);
+
+      while (!m_must_abort && store.current_level_size() > 0 && (current_state < m_options.max_states))
+      {
+        const std::size_t start_level_state = current_state;
+        const std::size_t start_level_transitions = m_number_of_transitions;
+        detail::state_run_reader level = store.read_current_level();
+        while (!m_must_abort && (current_state < m_options.max_states) && level.next())
+        {
+          lps::state state = encoder.decode(level.value());
+          generate_transitions(state, current_state, transitions, enumeration_queue);
+          for (const lps::next_state_generator::transition& t: transitions)
+          {
+            encoder.encode(t.target_state, encoded_state);
+            store.insert(encoded_state);
+          }
+          m_number_of_transitions += transitions.size();
+          transitions.clear();
+          current_state++;
+
+          time_t new_log_time;
+          if (!m_options.suppress_progress_messages && time(&new_log_time) > last_log_time)
+          {
+            last_log_time = new_log_time;
+            mCRL2log(log::status) << std::fixed << std::setprecision(2)
+                                  << m_number_of_states << "st, " << m_number_of_transitions << "tr"
+                                  << ", explored " << 100.0 * ((float) current_state / m_number_of_states)
+                                  << "%. Current level: " << m_level << ", " << current_state - start_level_state << " of "
+                                  << store.current_level_size() << "st, " << m_number_of_transitions - start_level_transitions
+                                  << "tr.\n";
+          }
+        }
+
+        if (current_state - start_level_state == store.current_level_size())
+        {
+          mCRL2log(log::debug) << "Number of states at level " << m_level << " is " << store.current_level_size() << "\n";
+          m_level++;
         }
+        m_number_of_states += store.next_level();
       }
 
       if (current_state == m_options.max_states)
       {
         mCRL2log(log::verbose) << "explored the maximum number (" << m_options.max_states << ") of states, terminating." << std::endl;
       }
+      mCRL2log(log::verbose) << "external memory exploration wrote " << store.bytes_written() << " bytes to disk, and "
+                             << store.run_count() << " sorted run" << (store.run_count() == 1 ? "" : "s") << " of successor states.\n";
     }
 };
 
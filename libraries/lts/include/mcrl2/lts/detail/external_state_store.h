@@ -0,0 +1,569 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/external_state_store.h
+/// \brief A store for the states of a breadth first exploration that keeps the visited
+///        states and the levels on disk, with delayed duplicate detection.
+
+#ifndef MCRL2_LTS_DETAIL_EXTERNAL_STATE_STORE_H
+#define MCRL2_LTS_DETAIL_EXTERNAL_STATE_STORE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/atermpp/aterm_appl.h"
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/data/data_expression.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief Appends n to out in a variable length encoding of 7 bits per byte.
+inline void write_varint(std::string& out, std::size_t n)
+{
+  while (n >= 0x80)
+  {
+    out.push_back(static_cast<char>((n & 0x7F) | 0x80));
+    n >>= 7;
+  }
+  out.push_back(static_cast<char>(n));
+}
+
+/// \brief Reads a number that was written by write_varint from [p, last), and advances p.
+inline std::size_t read_varint(const char*& p, const char* last)
+{
+  std::size_t result = 0;
+  for (std::size_t shift = 0; ; shift += 7)
+  {
+    if (p == last || shift >= 64)
+    {
+      throw mcrl2::runtime_error("invalid encoding of a state");
+    }
+    const unsigned char c = static_cast<unsigned char>(*p++);
+    result |= static_cast<std::size_t>(c & 0x7F) << shift;
+    if ((c & 0x80) == 0)
+    {
+      return result;
+    }
+  }
+}
+
+/// \brief Encodes states as strings of bytes, and decodes them again.
+/// \details A term is encoded in prefix order. Function symbols are replaced by their index
+/// in a table, and data function symbols, which are large terms that occur in every state,
+/// are replaced by their index in a table of constants. The tables are only kept in memory,
+/// so an encoding can only be decoded by the encoder that made it. Equal states have equal
+/// encodings.
+class state_encoder
+{
+  protected:
+    enum { int_tag = 0, constant_tag = 1, first_function_symbol_tag = 2 };
+
+    std::vector<atermpp::function_symbol> m_function_symbols;
+    std::unordered_map<atermpp::function_symbol, std::size_t> m_function_symbol_index;
+    std::vector<atermpp::aterm> m_constants;
+    std::unordered_map<atermpp::aterm, std::size_t> m_constant_index;
+
+    void encode_term(const atermpp::aterm& t, std::string& out)
+    {
+      if (t.type_is_int())
+      {
+        write_varint(out, int_tag);
+        write_varint(out, atermpp::down_cast<atermpp::aterm_int>(t).value());
+        return;
+      }
+      const atermpp::aterm_appl& a = atermpp::down_cast<atermpp::aterm_appl>(t);
+      if (data::is_function_symbol(a))
+      {
+        auto i = m_constant_index.find(t);
+        if (i == m_constant_index.end())
+        {
+          i = m_constant_index.emplace(t, m_constants.size()).first;
+          m_constants.push_back(t);
+        }
+        write_varint(out, constant_tag);
+        write_varint(out, i->second);
+        return;
+      }
+      auto i = m_function_symbol_index.find(a.function());
+      if (i == m_function_symbol_index.end())
+      {
+        i = m_function_symbol_index.emplace(a.function(), m_function_symbols.size()).first;
+        m_function_symbols.push_back(a.function());
+      }
+      write_varint(out, first_function_symbol_tag + i->second);
+      for (const atermpp::aterm& arg: a)
+      {
+        encode_term(arg, out);
+      }
+    }
+
+    atermpp::aterm decode_term(const char*& p, const char* last) const
+    {
+      const std::size_t tag = read_varint(p, last);
+      if (tag == int_tag)
+      {
+        return atermpp::aterm_int(read_varint(p, last));
+      }
+      if (tag == constant_tag)
+      {
+        const std::size_t i = read_varint(p, last);
+        if (i >= m_constants.size())
+        {
+          throw mcrl2::runtime_error("invalid encoding of a state");
+        }
+        return m_constants[i];
+      }
+      if (tag - first_function_symbol_tag >= m_function_symbols.size())
+      {
+        throw mcrl2::runtime_error("invalid encoding of a state");
+      }
+      const atermpp::function_symbol& f = m_function_symbols[tag - first_function_symbol_tag];
+      std::vector<atermpp::aterm> arguments;
+      arguments.reserve(f.arity());
+      for (std::size_t i = 0; i < f.arity(); i++)
+      {
+        arguments.push_back(decode_term(p, last));
+      }
+      return atermpp::aterm_appl(f, arguments.begin(), arguments.end());
+    }
+
+  public:
+    /// \brief Stores the encoding of s in out.
+    void encode(const lps::state& s, std::string& out)
+    {
+      out.clear();
+      encode_term(s, out);
+    }
+
+    /// \brief Returns the state with encoding s.
+    lps::state decode(const std::string& s) const
+    {
+      const char* p = s.data();
+      const char* last = p + s.size();
+      const atermpp::aterm t = decode_term(p, last);
+      if (p != last)
+      {
+        throw mcrl2::runtime_error("invalid encoding of a state");
+      }
+      return lps::state(atermpp::down_cast<lps::state>(t));
+    }
+};
+
+/// \brief Writes a sorted sequence of encoded states to a file. Every state is stored as the
+/// length of the prefix it shares with its predecessor followed by the remaining bytes
+/// (front coding), which compresses sorted runs considerably.
+class state_run_writer
+{
+  protected:
+    std::string m_filename;
+    std::ofstream m_out;
+    std::string m_previous;
+    std::string m_record;
+    std::size_t m_size = 0;
+    std::size_t m_bytes = 0;
+
+  public:
+    explicit state_run_writer(const std::string& filename)
+      : m_filename(filename), m_out(filename, std::ios::binary)
+    {
+      if (!m_out)
+      {
+        throw mcrl2::runtime_error("cannot open the file " + filename + " for writing");
+      }
+    }
+
+    void write(const std::string& s)
+    {
+      assert(m_size == 0 || m_previous < s);
+      const std::size_t n = std::mismatch(s.begin(), s.begin() + std::min(s.size(), m_previous.size()), m_previous.begin()).first - s.begin();
+      m_record.clear();
+      write_varint(m_record, n);
+      write_varint(m_record, s.size() - n);
+      m_record.append(s, n, std::string::npos);
+      m_out.write(m_record.data(), m_record.size());
+      m_previous = s;
+      m_size++;
+      m_bytes += m_record.size();
+    }
+
+    void close()
+    {
+      m_out.close();
+      if (m_out.fail())
+      {
+        throw mcrl2::runtime_error("could not write the file " + m_filename);
+      }
+    }
+
+    /// \brief Returns the number of states that were written.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief Returns the number of bytes that were written.
+    std::size_t bytes() const
+    {
+      return m_bytes;
+    }
+};
+
+/// \brief Reads the states in a file that was written by state_run_writer.
+class state_run_reader
+{
+  protected:
+    std::string m_filename;
+    std::ifstream m_in;
+    std::string m_value;
+
+    bool read_varint(std::size_t& n)
+    {
+      n = 0;
+      for (std::size_t shift = 0; shift < 64; shift += 7)
+      {
+        const std::ifstream::int_type c = m_in.get();
+        if (c == std::ifstream::traits_type::eof())
+        {
+          return false;
+        }
+        n |= static_cast<std::size_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void corrupt() const
+    {
+      throw mcrl2::runtime_error("the file " + m_filename + " is corrupt");
+    }
+
+  public:
+    explicit state_run_reader(const std::string& filename)
+      : m_filename(filename), m_in(filename, std::ios::binary)
+    {
+      if (!m_in)
+      {
+        throw mcrl2::runtime_error("cannot open the file " + filename + " for reading");
+      }
+    }
+
+    /// \brief Reads the next state. Returns false if there are no more states.
+    bool next()
+    {
+      std::size_t prefix;
+      std::size_t suffix;
+      if (!read_varint(prefix))
+      {
+        if (!m_in.eof())
+        {
+          corrupt();
+        }
+        return false;
+      }
+      if (!read_varint(suffix) || prefix > m_value.size())
+      {
+        corrupt();
+      }
+      m_value.resize(prefix + suffix);
+      m_in.read(&m_value[prefix], suffix);
+      if (static_cast<std::size_t>(m_in.gcount()) != suffix)
+      {
+        corrupt();
+      }
+      return true;
+    }
+
+    /// \brief Returns the state that was read by the last successful call of next().
+    const std::string& value() const
+    {
+      return m_value;
+    }
+};
+
+/// \brief Merges the runs in the given files, and calls f(s) for every state s that occurs
+/// in at least one of them, in increasing order.
+template <typename Function>
+void merge_state_runs(const std::vector<std::string>& filenames, Function f)
+{
+  std::vector<std::unique_ptr<state_run_reader>> runs;
+  for (const std::string& filename: filenames)
+  {
+    runs.push_back(std::make_unique<state_run_reader>(filename));
+  }
+  auto greater = [&](std::size_t i, std::size_t j) { return runs[j]->value() < runs[i]->value(); };
+  std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> heap(greater);
+  for (std::size_t i = 0; i < runs.size(); i++)
+  {
+    if (runs[i]->next())
+    {
+      heap.push(i);
+    }
+  }
+
+  std::string current;
+  bool first = true;
+  while (!heap.empty())
+  {
+    const std::size_t i = heap.top();
+    heap.pop();
+    if (first || runs[i]->value() != current)
+    {
+      current = runs[i]->value();
+      first = false;
+      f(current);
+    }
+    if (runs[i]->next())
+    {
+      heap.push(i);
+    }
+  }
+}
+
+/// \brief Stores the states of a breadth first exploration on disk, such that the number of
+/// states is not limited by the available memory.
+/// \details The visited states and the states of the current level are stored in files, as
+/// sorted runs of encoded states. The successors of the current level are inserted into a
+/// buffer of bounded size. When it is full, it is sorted and written to disk as a run. When
+/// the level is finished, the runs are merged with the visited states, and the successors that
+/// were not visited before form the next level (delayed duplicate detection). The files are
+/// removed when the store is destroyed.
+class external_state_store
+{
+  protected:
+    // The maximum number of runs that are merged at the same time.
+    static std::size_t max_merged_runs()
+    {
+      return 64;
+    }
+
+    std::string m_prefix;
+    std::size_t m_buffer_size;
+    std::size_t m_file_count = 0;
+
+    std::vector<std::string> m_buffer;
+    std::size_t m_buffer_bytes = 0;
+
+    std::vector<std::string> m_runs;
+    std::string m_visited;
+    std::string m_level;
+    std::size_t m_level_size = 0;
+
+    std::size_t m_run_count = 0;
+    std::size_t m_bytes_written = 0;
+
+    std::string new_filename()
+    {
+      return m_prefix + std::to_string(m_file_count++) + ".states";
+    }
+
+    static void remove_file(std::string& filename)
+    {
+      if (!filename.empty())
+      {
+        std::remove(filename.c_str());
+        filename.clear();
+      }
+    }
+
+    void close(state_run_writer& writer)
+    {
+      writer.close();
+      m_bytes_written += writer.bytes();
+    }
+
+    // Sorts the buffer and writes it to disk as a new run.
+    void write_buffer()
+    {
+      if (m_buffer.empty())
+      {
+        return;
+      }
+      std::sort(m_buffer.begin(), m_buffer.end());
+      m_buffer.erase(std::unique(m_buffer.begin(), m_buffer.end()), m_buffer.end());
+      m_runs.push_back(new_filename());
+      state_run_writer writer(m_runs.back());
+      for (const std::string& s: m_buffer)
+      {
+        writer.write(s);
+      }
+      close(writer);
+      m_run_count++;
+      m_buffer.clear();
+      m_buffer.shrink_to_fit();
+      m_buffer_bytes = 0;
+    }
+
+    // Merges runs until at most max_merged_runs() of them are left.
+    void reduce_runs()
+    {
+      while (m_runs.size() > max_merged_runs())
+      {
+        std::vector<std::string> runs(m_runs.begin(), m_runs.begin() + max_merged_runs());
+        m_runs.erase(m_runs.begin(), m_runs.begin() + max_merged_runs());
+        m_runs.push_back(new_filename());
+        state_run_writer writer(m_runs.back());
+        merge_state_runs(runs, [&](const std::string& s) { writer.write(s); });
+        close(writer);
+        for (std::string& run: runs)
+        {
+          remove_file(run);
+        }
+      }
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param directory The directory in which the files are stored
+    /// \param buffer_size The (approximate) maximum number of bytes used for storing the successors of a level
+    external_state_store(const std::string& directory, std::size_t buffer_size)
+      : m_buffer_size(buffer_size)
+    {
+      std::ostringstream out;
+      out << (directory.empty() ? "." : directory) << "/mcrl2_states_" << std::hex << std::random_device()() << "_";
+      m_prefix = out.str();
+    }
+
+    external_state_store(const external_state_store&) = delete;
+    external_state_store& operator=(const external_state_store&) = delete;
+
+    ~external_state_store()
+    {
+      for (std::string& run: m_runs)
+      {
+        remove_file(run);
+      }
+      remove_file(m_visited);
+      remove_file(m_level);
+    }
+
+    /// \brief Makes the set of visited states and the current level equal to {s}.
+    void initialize(const std::string& s)
+    {
+      for (std::string* filename: { &m_visited, &m_level })
+      {
+        remove_file(*filename);
+        *filename = new_filename();
+        state_run_writer writer(*filename);
+        writer.write(s);
+        close(writer);
+      }
+      m_level_size = 1;
+    }
+
+    /// \brief Returns a reader for the states of the current level.
+    state_run_reader read_current_level() const
+    {
+      return state_run_reader(m_level);
+    }
+
+    /// \brief Returns the number of states of the current level.
+    std::size_t current_level_size() const
+    {
+      return m_level_size;
+    }
+
+    /// \brief Inserts a successor of the current level.
+    void insert(const std::string& s)
+    {
+      m_buffer.push_back(s);
+      m_buffer_bytes += s.size() + sizeof(std::string);
+      if (m_buffer_bytes >= m_buffer_size)
+      {
+        write_buffer();
+      }
+    }
+
+    /// \brief Makes the inserted states that were not visited before the current level,
+    /// and adds them to the visited states. Returns the number of states of the new level.
+    std::size_t next_level()
+    {
+      write_buffer();
+      reduce_runs();
+
+      std::string visited_filename = new_filename();
+      std::string level_filename = new_filename();
+      state_run_writer visited_writer(visited_filename);
+      state_run_writer level_writer(level_filename);
+      state_run_reader visited(m_visited);
+      bool has_visited = visited.next();
+
+      merge_state_runs(m_runs, [&](const std::string& s)
+      {
+        while (has_visited && visited.value() < s)
+        {
+          visited_writer.write(visited.value());
+          has_visited = visited.next();
+        }
+        if (has_visited && visited.value() == s)
+        {
+          return;
+        }
+        visited_writer.write(s);
+        level_writer.write(s);
+      });
+      while (has_visited)
+      {
+        visited_writer.write(visited.value());
+        has_visited = visited.next();
+      }
+      close(visited_writer);
+      close(level_writer);
+
+      for (std::string& run: m_runs)
+      {
+        remove_file(run);
+      }
+      m_runs.clear();
+      remove_file(m_visited);
+      remove_file(m_level);
+      m_visited = visited_filename;
+      m_level = level_filename;
+      m_level_size = level_writer.size();
+      return m_level_size;
+    }
+
+    /// \brief Returns the number of runs that were written for the successors of levels.
+    std::size_t run_count() const
+    {
+      return m_run_count;
+    }
+
+    /// \brief Returns the total number of bytes that was written to disk.
+    std::size_t bytes_written() const
+    {
+      return m_bytes_written;
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_EXTERNAL_STATE_STORE_H
@@ -0,0 +1,514 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file lts/detail/liblts_bisim_dnj.h
+///
+/// \brief O(m log n)-time branching bisimulation algorithm on labelled
+/// transition systems
+///
+/// \details This file implements the partition refinement algorithm of
+/// Groote / Jansen / Keiren / Wijs (liblts_bisim_gjkw.h) directly on the
+/// labelled transitions.  The GJKW implementation first converts the LTS to a
+/// Kripke structure, which adds an extra state for every non-inert pair
+/// (label, target state) and roughly triples the memory use.  Here, the
+/// transitions are instead grouped into _block-bunch slices_: the transitions
+/// with the same source block, the same label and the same target
+/// constellation.  A constellation is split by moving its smaller half (a
+/// block) into a constellation of its own;  the block-bunch slices into that
+/// block then are the splitters of the next refinement step.
+///
+/// As in GJKW, the states are kept in a permutation array, in which every
+/// constellation and every block occupies a contiguous range, and the
+/// refinements are done by two searches that run in lockstep, so that only
+/// the work on the smaller subblock counts.  In Debug mode, the time budget
+/// O(m log n) is checked by the counters of check_complexity.h.
+///
+/// Tau-loops must have been removed (by scc_reduce) before the algorithm is
+/// started in the branching case.  When divergence is preserved, the
+/// remaining tau-self-loops get a fresh label, so they are never inert.
+
+#ifndef _LIBLTS_BISIM_DNJ_H
+#define _LIBLTS_BISIM_DNJ_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mcrl2/lts/detail/liblts_scc.h"
+#include "mcrl2/lts/detail/liblts_merge.h"
+#include "mcrl2/lts/detail/check_complexity.h"
+#include "mcrl2/lts/detail/fixed_vector.h"
+#include "mcrl2/lts/transition.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+namespace bisim_dnj
+{
+
+// state_type and trans_type are defined in check_complexity.h.
+
+/// \brief type used to store label numbers
+typedef std::size_t label_type;
+
+class state_info_entry;
+class block_t;
+class constln_t;
+class succ_entry;
+class pred_entry;
+class block_bunch_entry;
+class bunch_slice_t;
+
+/// \brief entry in the permutation array
+typedef state_info_entry* permutation_entry;
+typedef permutation_entry* permutation_iter_t;
+
+/// \brief the outgoing transitions of a state with the same label into the
+/// same constellation
+/// \details The outgoing transitions of every state are sorted by label and
+/// (the position of) the target constellation, so an out-slice is a
+/// contiguous range in the array of outgoing transitions.
+struct out_descriptor
+{
+    succ_entry* begin;
+    succ_entry* end;
+};
+
+/// \brief information about a state
+class state_info_entry
+{
+  public:
+    /// position of the state in the permutation array
+    permutation_iter_t pos;
+
+    /// block of the state
+    block_t* block;
+
+    /// first outgoing transition; the last one is just before the first
+    /// outgoing transition of the next state.
+    succ_entry* succ_begin;
+
+    /// first incoming transition; the incoming transitions end where those
+    /// of the next state begin.
+    pred_entry* pred_begin;
+
+    /// first incoming inert transition.  The inert incoming transitions are
+    /// placed after the non-inert ones.
+    pred_entry* pred_inert_begin;
+
+    /// number of outgoing inert transitions
+    trans_type inert_out;
+
+    /// \brief an outgoing transition that is used to check quickly whether
+    /// the state has a transition in some out-slice
+    /// \details After marking the state as source of a splitter in the main
+    /// loop, this is a transition to the new constellation.  During
+    /// postprocessing of new bottom states, it points to the first out-slice
+    /// that has not yet been handled.
+    succ_entry* current_out_slice;
+
+    /// refinement during which colour and notblue were assigned
+    std::size_t epoch;
+
+    /// number of inert successors that are not yet known to be blue
+    trans_type notblue;
+
+    /// colour during a refinement, valid if epoch is the current refinement
+    unsigned char colour;
+
+    succ_entry* succ_end() const  {  return this[1].succ_begin;  }
+    pred_entry* pred_end() const  {  return this[1].pred_begin;  }
+
+    #ifndef NDEBUG
+        bisim_gjkw::check_complexity::dnj_state_counter_t work_counter;
+        static const state_info_entry* s_i_begin;
+        std::string debug_id() const
+        {
+            return "state " + std::to_string(this - s_i_begin);
+        }
+    #endif
+};
+
+/// \brief an outgoing transition
+class succ_entry
+{
+  public:
+    state_info_entry* target;
+    label_type label;
+    block_bunch_entry* block_bunch;
+    out_descriptor* out_slice;
+
+    #ifndef NDEBUG
+        bisim_gjkw::check_complexity::dnj_trans_counter_t work_counter;
+        std::string debug_id() const;
+    #endif
+};
+
+/// \brief an incoming transition
+class pred_entry
+{
+  public:
+    state_info_entry* source;
+    succ_entry* succ;
+};
+
+/// \brief an entry in the array of transitions ordered by block-bunch slice
+class block_bunch_entry
+{
+  public:
+    pred_entry* pred;
+    bunch_slice_t* slice;
+};
+
+/// \brief the transitions with the same source block, label and target
+/// constellation
+/// \details The slices of a block form a doubly linked list.  A slice is only
+/// stable if every bottom state of its source block has a transition in it,
+/// except for the slice with label tau into the constellation of the source
+/// block, which contains the inert transitions.
+class bunch_slice_t
+{
+  public:
+    block_bunch_entry* begin;
+    block_bunch_entry* end;
+    block_t* source_block;
+    label_type label;
+    constln_t* target_constln;
+
+    /// list of slices of the source block
+    bunch_slice_t* prev;
+    bunch_slice_t* next;
+
+    /// \brief slice into which transitions are moved
+    /// \details Only used while a block or a constellation is split.
+    bunch_slice_t* split;
+
+    /// \brief the transitions from the same block with the same label into
+    /// the remainder of the split constellation
+    /// \details Only set for slices into the splitter during a round of the
+    /// main loop.
+    bunch_slice_t* counterpart;
+
+    /// the slice still is a splitter in the current round of the main loop
+    bool pending;
+
+    /// the slice is registered for postprocessing of new bottom states
+    bool needs_postprocessing;
+
+    /// all transitions of the slice have been moved to other slices
+    bool dead;
+
+    trans_type size() const  {  return end - begin;  }
+};
+
+/// \brief a block of the refinable partition
+/// \details The states of a block occupy the range [begin, end) of the
+/// permutation array.  The non-bottom states come first;  the bottom states
+/// [bottom_begin, end) are further divided into new bottom states
+/// [bottom_begin, marked_bottom_begin) and old ones.
+class block_t
+{
+  public:
+    permutation_iter_t begin;
+    permutation_iter_t bottom_begin;
+    permutation_iter_t marked_bottom_begin;
+    permutation_iter_t end;
+    constln_t* constln;
+
+    /// first slice of outgoing transitions
+    bunch_slice_t* slices;
+
+    /// unique number of the block, used as state number of the quotient
+    state_type seqnr;
+
+    state_type size() const  {  return end - begin;  }
+    bool has_new_bottom_states() const
+    {
+        return bottom_begin != marked_bottom_begin;
+    }
+
+    #ifndef NDEBUG
+        std::string debug_id() const
+        {
+            return "block " + std::to_string(seqnr);
+        }
+    #endif
+};
+
+/// \brief a constellation: a range of blocks in the permutation array
+class constln_t
+{
+  public:
+    permutation_iter_t begin;
+    permutation_iter_t end;
+
+    /// the constellation is in the list of nontrivial constellations
+    bool listed;
+
+    state_type size() const  {  return end - begin;  }
+};
+
+} // end namespace bisim_dnj
+
+/// \class bisim_partitioner_dnj
+/// \brief computes the strong or (divergence-preserving) branching
+/// bisimulation quotient of an LTS without converting it to a Kripke structure
+template <class LTS_TYPE>
+class bisim_partitioner_dnj
+{
+  public:
+    /// \brief Constructor
+    /// \details The constructor builds the data structures and immediately
+    /// calculates the bisimulation quotient.  However, it does not change the
+    /// LTS.  In the branching case, the LTS must not contain tau-cycles other
+    /// than tau-self-loops.
+    bisim_partitioner_dnj(LTS_TYPE& l, bool branching = false,
+                                        bool preserve_divergence = false);
+
+    /// \brief replaces the transitions of the LTS by those of the quotient
+    /// \details The number of states, the state labels and the initial state
+    /// are adapted as well.
+    void replace_transition_system();
+
+    /// \brief the number of equivalence classes
+    state_type num_eq_classes() const
+    {
+        return m_blocks.size();
+    }
+
+    /// \brief the equivalence class of a state
+    state_type get_eq_class(state_type s) const
+    {
+        return m_states[s].block->seqnr;
+    }
+
+    /// \brief checks whether two states are equivalent
+    bool in_same_class(state_type s, state_type t) const
+    {
+        return m_states[s].block == m_states[t].block;
+    }
+
+  private:
+    typedef bisim_dnj::state_info_entry state_info_entry;
+    typedef bisim_dnj::block_t block_t;
+    typedef bisim_dnj::constln_t constln_t;
+    typedef bisim_dnj::succ_entry succ_entry;
+    typedef bisim_dnj::pred_entry pred_entry;
+    typedef bisim_dnj::block_bunch_entry block_bunch_entry;
+    typedef bisim_dnj::bunch_slice_t bunch_slice_t;
+    typedef bisim_dnj::out_descriptor out_descriptor;
+    typedef bisim_dnj::permutation_iter_t permutation_iter_t;
+    typedef bisim_dnj::label_type label_type;
+
+    /// \brief the seeds of the red states in refine()
+    enum refine_mode
+    {
+      refine_marked,         // the states in m_red (splitter in the main loop)
+      refine_old_bottom,     // the old bottom states (separate new bottom states)
+      refine_counterpart,    // the sources of FromRed (remainder of the split
+                             // constellation in the main loop)
+      refine_postprocessing  // the sources of FromRed (postprocessing)
+    };
+
+    /// colours used during refine()
+    enum { uncoloured, red, blue };
+
+    /// key of an out-slice or a bunch slice: label and target constellation
+    typedef std::pair<label_type, const bisim_dnj::permutation_entry*> key_type;
+
+    LTS_TYPE& aut;
+    const bool m_branching;
+    const bool m_preserve_divergence;
+
+    /// label of inert transitions; no valid label in the strong case
+    const label_type m_tau_label;
+
+    /// fresh label for tau-self-loops if divergence is preserved
+    const label_type m_divergence_label;
+
+    const trans_type m_nr_of_transitions;
+
+    bisim_gjkw::fixed_vector<state_info_entry> m_states;
+    bisim_gjkw::fixed_vector<bisim_dnj::permutation_entry> m_permutation;
+    bisim_gjkw::fixed_vector<succ_entry> m_succ;
+    bisim_gjkw::fixed_vector<pred_entry> m_pred;
+    bisim_gjkw::fixed_vector<block_bunch_entry> m_block_bunch;
+
+    std::deque<out_descriptor> m_out_descriptors;
+    std::vector<out_descriptor*> m_free_out_descriptors;
+    std::deque<block_t> m_blocks;
+    std::deque<constln_t> m_constlns;
+    std::deque<bunch_slice_t> m_slices;
+    std::vector<bunch_slice_t*> m_free_slices;
+    std::vector<bunch_slice_t*> m_dead_slices;
+
+    std::vector<constln_t*> m_nontrivial_constlns;
+    std::vector<bunch_slice_t*> m_pending;
+    std::vector<bunch_slice_t*> m_counterparts;
+    std::vector<bunch_slice_t*> m_touched_slices;
+    std::map<key_type, std::vector<bunch_slice_t*> > m_postprocess;
+
+    std::size_t m_epoch;
+    std::vector<state_info_entry*> m_red;
+    std::vector<state_info_entry*> m_blue;
+    std::vector<state_info_entry*> m_new_bottom;
+
+    /// the splitter is placed before the remainder of its old constellation
+    bool m_splitter_first;
+
+    static bool transition_label(const LTS_TYPE& l, bool branching,
+                                 bool preserve_divergence, const transition& t,
+                                                            label_type& label);
+    static trans_type count_transitions(const LTS_TYPE& l, bool branching,
+                                                     bool preserve_divergence);
+    void create_initial_partition();
+    void refine_partition_until_it_becomes_stable();
+    void split_constellation(constln_t* C);
+
+    block_t* refine(block_t* B, refine_mode mode,
+                                              const bunch_slice_t* FromRed);
+    block_t* split(block_t* B, const std::vector<state_info_entry*>& moved,
+                                                                bool moved_red);
+    block_t* postprocess_new_bottom(block_t* RedB);
+    void stabilise_new_bottom(block_t* RfnB);
+    void register_for_postprocessing(block_t* RfnB);
+    bool bottom_state_in_slice(state_info_entry* s, const key_type& key);
+    bool has_transition(const state_info_entry* s, const key_type& key) const;
+    bool has_counterpart_transition(const state_info_entry* s,
+                                                const bunch_slice_t* FromRed);
+
+    static key_type out_key(const succ_entry* t)
+    {
+        return key_type(t->label, t->target->block->constln->begin);
+    }
+    static key_type slice_key(const bunch_slice_t* S)
+    {
+        return key_type(S->label, S->target_constln->begin);
+    }
+
+    void begin_refine();
+    void mark_red(state_info_entry* s);
+    bool is_red(const state_info_entry* s) const
+    {
+        return m_epoch == s->epoch && red == s->colour;
+    }
+    void swap_permutation(permutation_iter_t p1, permutation_iter_t p2);
+    void swap_succ(succ_entry* t1, succ_entry* t2);
+    void swap_pred(pred_entry* t1, pred_entry* t2);
+    void swap_block_bunch(block_bunch_entry* t1, block_bunch_entry* t2);
+
+    block_t* new_block(permutation_iter_t begin, permutation_iter_t end,
+                                                           constln_t* constln);
+    bunch_slice_t* new_slice(block_t* B, label_type label,
+                                                           constln_t* target);
+    void kill_slice(bunch_slice_t* S);
+    out_descriptor* new_out_descriptor(succ_entry* begin, succ_entry* end);
+    void make_nontrivial(constln_t* C);
+
+    #ifndef NDEBUG
+        void assert_stability() const;
+    #endif
+};
+
+/** \brief Reduce transition system l with respect to strong or (divergence
+ *  preserving) branching bisimulation.
+ * \param[in,out] l                   The transition system that is reduced.
+ * \param         branching           If true branching bisimulation is
+ *                                    applied, otherwise strong bisimulation.
+ * \param         preserve_divergence Indicates whether loops of internal
+ *                                    actions on states must be preserved. If
+ *                                    false these are removed. If true these
+ *                                    are preserved. */
+template <class LTS_TYPE>
+void bisimulation_reduce_dnj(LTS_TYPE& l, bool const branching = false,
+                                        bool const preserve_divergence = false)
+{
+  // First, remove tau loops in case of branching bisimulation.
+  if (branching)
+  {
+    scc_reduce(l, preserve_divergence);
+  }
+
+  // Second, apply the branching bisimulation reduction algorithm. If there are
+  // no taus, this will automatically yield strong bisimulation.
+  detail::bisim_partitioner_dnj<LTS_TYPE> bisim_part(l, branching,
+                                                          preserve_divergence);
+  bisim_part.replace_transition_system();
+}
+
+/** \brief Checks whether the two initial states of two LTSs are strong or
+ * branching bisimilar.
+ * \details The LTSs l1 and l2 are not usable anymore after this call.
+ * \param[in,out] l1                  A first transition system.
+ * \param[in,out] l2                  A second transistion system.
+ * \param         branching           If true branching bisimulation is used,
+ *                                    otherwise strong bisimulation is applied.
+ * \param         preserve_divergence If true and branching is true, preserve
+ *                                    tau loops on states.
+ * \retval True iff the initial states of the current transition system and l2
+ * are (divergence preserving) (branching) bisimilar. */
+template <class LTS_TYPE>
+bool destructive_bisimulation_compare_dnj(LTS_TYPE& l1, LTS_TYPE& l2,
+          bool const branching = false, bool const preserve_divergence = false,
+                                  bool const generate_counter_examples = false)
+{
+  if (generate_counter_examples)
+  {
+    mCRL2log(log::warning) << "The DNJ branching bisimulation algorithm does "
+                                            "not generate counterexamples.\n";
+  }
+  state_type init_l2 = l2.initial_state() + l1.num_states();
+  mcrl2::lts::detail::merge(l1, l2);
+  l2.clear(); // No use for l2 anymore.
+
+  // First remove tau loops in case of branching bisimulation.
+  if (branching)
+  {
+    detail::scc_partitioner<LTS_TYPE> scc_part(l1);
+    scc_part.replace_transition_system(preserve_divergence);
+    init_l2 = scc_part.get_eq_class(init_l2);
+  }
+
+  detail::bisim_partitioner_dnj<LTS_TYPE> bisim_part(l1, branching,
+                                                          preserve_divergence);
+  return bisim_part.in_same_class(l1.initial_state(), init_l2);
+}
+
+/** \brief Checks whether the two initial states of two LTSs are strong or
+ * branching bisimilar.
+ * \details The LTSs l1 and l2 are first duplicated and subsequently reduced
+ * modulo bisimulation.  It runs in O(m log n) time, where n is the number of
+ * states and m is the number of transitions.
+ * \param[in,out] l1                  A first transition system.
+ * \param[in,out] l2                  A second transistion system.
+ * \param         branching           If true branching bisimulation is used,
+ *                                    otherwise strong bisimulation is applied.
+ * \param         preserve_divergence If true and branching is true, preserve
+ *                                    tau loops on states.
+ * \retval True iff the initial states of the current transition system and l2
+ * are (divergence preserving) (branching) bisimilar. */
+template <class LTS_TYPE>
+inline bool bisimulation_compare_dnj(const LTS_TYPE& l1, const LTS_TYPE& l2,
+          bool const branching = false, bool const preserve_divergence = false)
+{
+  LTS_TYPE l1_copy(l1);
+  LTS_TYPE l2_copy(l2);
+  return destructive_bisimulation_compare_dnj(l1_copy, l2_copy, branching,
+                                                          preserve_divergence);
+}
+
+} // end namespace detail
+} // end namespace lts
+} // end namespace mcrl2
+
+#endif // ifndef _LIBLTS_BISIM_DNJ_H
@@ -16,32 +16,50 @@
 // There are six algorithms. One for trace inclusion, one for failures inclusion and one for failures-divergence inclusion.
 // All algorithms come in a variant with and without internal steps. 
 // It is possible to generate a counter transition system in case the inclusion is answered by no.
+//
+// The sets of states of the specification are sorted vectors, that are hash-consed in a
+// state_set_store, such that each set is stored only once and can be identified by a number.
+// Pairs in the anti-chain are compared using a simulation preorder, as proposed in 
+// P.A. Abdulla, Y.-F. Chen, L. Holik, R. Mayr and T. Vojnar. When Simulation Meets Antichains. 
+// In proceedings TACAS 2010, Lecture Notes in Computer Science no 6015, pages 158-174, 2010.
 
 #ifndef _LIBLTS_FAILURES_REFINEMENT_H
 #define _LIBLTS_FAILURES_REFINEMENT_H
 
-#include "unordered_set"
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 #include "mcrl2/lts/detail/liblts_bisim_gjkw.h"
 #include "mcrl2/lts/detail/counter_example.h"
+#include "mcrl2/lts/detail/liblts_sim.h"
+#include "mcrl2/lts/detail/subset_store.h"
+#include "mcrl2/utilities/hash_utility.h"
 
 namespace mcrl2
 {
 namespace lts
 {
+
+enum refinement_type { trace, failures, failures_divergence };
+
 namespace detail
 {
   typedef std::size_t state_type;
   typedef std::size_t label_type;
-  typedef std::set<state_type> set_of_states;
-  typedef std::multimap <detail::state_type,detail::set_of_states> anti_chain_type;
+  typedef std::vector<state_type> set_of_states;  // A sorted vector without duplicates.
+  typedef std::vector<std::vector<std::size_t> > anti_chain_type;  // For each state the indices of sets of states.
   typedef std::set < label_type > action_label_set;
 
+  /// \brief The sets of states of the specification are hash-consed in the store that is
+  ///        also used for determinisation.
+  typedef subset_store state_set_store;
+
   template < class COUNTER_EXAMPLE_CONSTRUCTOR >
   class state_states_counter_example_index_triple
   {
     protected:
       detail::state_type m_state;
-      detail::set_of_states m_states;
+      std::size_t m_states;
       typename COUNTER_EXAMPLE_CONSTRUCTOR::index_type m_counter_example_index;
 
     public:
@@ -51,7 +69,7 @@ namespace detail
       /// \brief Constructor.
       state_states_counter_example_index_triple(
               const state_type state, 
-              const set_of_states& states, 
+              const std::size_t states, 
               const typename COUNTER_EXAMPLE_CONSTRUCTOR::index_type& counter_example_index)
        : m_state(state),
          m_states(states),
@@ -71,8 +89,8 @@ namespace detail
         std::swap(m_counter_example_index,other.m_counter_example_index);
       }
 
-      /// \brief Get the set of states.
-      const set_of_states& states() const
+      /// \brief Get the index of the set of states in the state_set_store.
+      std::size_t states() const
       {
         return m_states;
       }
@@ -84,11 +102,6 @@ namespace detail
       }
   };
  
-  template <  class COUNTER_EXAMPLE_CONSTRUCTOR >
-  inline bool antichain_insert(
-                  anti_chain_type& anti_chain, 
-                  const state_states_counter_example_index_triple<COUNTER_EXAMPLE_CONSTRUCTOR>& impl_spec);
-
   // The class below recalls what the stable states and the states with a divergent
   // self loop of a transition system are, such that it does not have to be recalculated each time again.
   template < class LTS_TYPE >
@@ -97,7 +110,8 @@ namespace detail
     protected:
       LTS_TYPE& m_l;
       std::vector<std::vector<state_type> > m_tau_reachable_states;
-      std::vector<std::vector<transition> > m_sorted_transitions;
+      // The outgoing transitions per state. The labels are not hidden, as they are used in counter examples.
+      adjacency_index m_sorted_transitions;
       std::vector<bool> m_divergent;
       std::vector<action_label_set> m_enabled_actions;
       
@@ -105,21 +119,23 @@ namespace detail
       void calculate_weak_property_cache(const bool weak_reduction)
       {
         scc_partitioner<LTS_TYPE> strongly_connected_component_partitioner(m_l);
-        for(const transition& t: m_l.get_transitions()) 
+        const LTS_TYPE& l=m_l;
+        m_sorted_transitions=adjacency_index(l.num_states(), l.get_transitions(), true, [](const label_type a) { return a; });
+        for(state_type from=0; from<l.num_states(); ++from)
         {
-          assert(t.from()<m_l.num_states());
-          if (m_l.is_tau(m_l.apply_hidden_label_map(t.label())) && weak_reduction)
-          {
-            m_tau_reachable_states[t.from()].push_back(t.to());  // There is an outgoing tau. 
-          }
-          m_sorted_transitions[t.from()].push_back(t);
-         
-          if (weak_reduction && m_l.is_tau(m_l.apply_hidden_label_map(t.label())) && 
-              strongly_connected_component_partitioner.in_same_class(t.from(),t.to()))
+          for(const adjacent_transition& t: m_sorted_transitions.transitions(from))
           {
-            m_divergent[t.from()]=true;  // There is a self loop.
+            const label_type label=l.apply_hidden_label_map(t.label);
+            if (l.is_tau(label) && weak_reduction)
+            {
+              m_tau_reachable_states[from].push_back(t.state);  // There is an outgoing tau. 
+              if (strongly_connected_component_partitioner.in_same_class(from,t.state))
+              {
+                m_divergent[from]=true;  // There is a self loop.
+              }
+            }
+            m_enabled_actions[from].insert(label);
           }
-          m_enabled_actions[t.from()].insert(m_l.apply_hidden_label_map(t.label()));
         }
       }
 
@@ -128,7 +144,6 @@ namespace detail
       lts_cache(/* const */ LTS_TYPE& l, const bool weak_reduction)    /* l is not changed, but the use of the scc partitioner requires l to be non const */
         : m_l(l),
           m_tau_reachable_states(l.num_states()),
-          m_sorted_transitions(l.num_states()),
           m_divergent(l.num_states(),false),
           m_enabled_actions(l.num_states())
       { 
@@ -145,10 +160,9 @@ namespace detail
         return m_tau_reachable_states[s];
       }
 
-      const std::vector<transition>& transitions(const state_type s) const
+      adjacent_transition_range transitions(const state_type s) const
       {
-        assert(s<m_sorted_transitions.size());
-        return m_sorted_transitions[s];
+        return m_sorted_transitions.transitions(s);
       }
 
       bool diverges(const state_type s) const
@@ -162,6 +176,104 @@ namespace detail
       }
   };
 
+  /* The class below contains a simulation preorder on the states of a transition system, stored as
+     a partition-relation pair. It is used to compare pairs in the anti-chain: a pair (impl,spec) does not need to be
+     investigated if a pair (impl',spec') has been encountered such that impl is simulated by impl', and
+     each state in spec' is simulated by some state in spec. Any counterexample for (impl,spec) is then also
+     a counterexample for (impl',spec').
+     For trace refinement, the simulation preorder is used. For failures refinement, ready simulation is used,
+     where the enabled actions, including internal actions, must be equal; this preserves stable failures. For
+     failures-divergence refinement, the divergence of states must also be equal.
+     The relation on the blocks takes b^2 bits for b blocks. If the number of blocks exceeds a bound, the computation is abandoned
+     and the identity relation is used instead, in which case the comparison of pairs is an ordinary subset check. This is
+     reported in verbose mode.
+  */
+  template < class LTS_TYPE >
+  class refinement_simulation
+  {
+    protected:
+      simulation_relation m_relation;
+
+      void compute(const LTS_TYPE& l, const lts_cache<LTS_TYPE>& cache, const bool ready, const bool divergence, const std::size_t number_of_states, const std::size_t max_blocks)
+      {
+        // Initially, a state is simulated by all states with the same class. A class consists of the 
+        // enabled actions, and the divergence, if relevant.
+        std::vector<std::size_t> state_class(number_of_states, 0);
+        std::size_t number_of_classes=1;
+        if (ready)
+        {
+          std::map<std::pair<action_label_set, bool>, std::size_t> classes;
+          for(state_type s=0; s<number_of_states; ++s)
+          {
+            const std::pair<action_label_set, bool> key(cache.action_labels(s), divergence && cache.diverges(s));
+            state_class[s]=classes.insert(std::make_pair(key, classes.size())).first->second;
+          }
+          number_of_classes=classes.size();
+        }
+        if (!m_relation.compute(l.outgoing_transition_index(), state_class, number_of_classes,
+                                [](const std::size_t c, const std::size_t d) { return c==d; }, 0, max_blocks))
+        {
+          mCRL2log(log::verbose) << "The simulation preorder has more than " << max_blocks
+                                 << " blocks; the refinement check continues without simulation subsumption.\n";
+        }
+      }
+
+    public:
+      /// \brief Constructor.
+      /// \param max_blocks If the simulation preorder on l has more blocks, the identity relation
+      ///        is used. The preorder takes b^2 bits for b blocks, so the default limits it to 128MB.
+      refinement_simulation(const LTS_TYPE& l, const lts_cache<LTS_TYPE>& cache, const refinement_type refinement, const std::size_t max_blocks=std::size_t(1)<<15)
+      {
+        compute(l, cache, refinement!=trace, refinement==failures_divergence, l.num_states(), max_blocks);
+      }
+
+      /// \brief Returns true if the relation is not the identity relation.
+      bool available() const
+      {
+        return !m_relation.empty();
+      }
+
+      /// \brief Returns true if s is simulated by t.
+      bool simulated_by(const state_type s, const state_type t) const
+      {
+        return available() ? m_relation.simulated_by(s, t) : s==t;
+      }
+
+      /// \brief Returns true if every state in [first1, last1) is simulated by a state in the sorted range [first2, last2).
+      bool set_simulated_by(const state_type* first1, const state_type* last1, const state_type* first2, const state_type* last2) const
+      {
+        if (!available())
+        {
+          return std::includes(first2, last2, first1, last1);
+        }
+        for(const state_type* i=first1; i!=last1; ++i)
+        {
+          bool found=std::binary_search(first2, last2, *i);
+          for(const state_type* j=first2; !found && j!=last2; ++j)
+          {
+            found=m_relation.simulated_by(*i, *j);
+          }
+          if (!found)
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      /// \brief Applies f to all states that simulate s.
+      template <typename Function>
+      void for_each_simulating_state(const state_type s, Function f) const
+      {
+        if (!available())
+        {
+          f(s);
+          return;
+        }
+        m_relation.for_each_simulating_state(s, f);
+      }
+  };
+
   template < class LTS_TYPE >
   set_of_states collect_reachable_states_via_taus(
                  const state_type s, 
@@ -170,20 +282,31 @@ namespace detail
 
   template < class LTS_TYPE >
   set_of_states collect_reachable_states_via_an_action(
-                 const state_type s, 
+                 const std::size_t states,
                  const label_type e,
                  const lts_cache<LTS_TYPE>& weak_property_cache,
                  const bool weak_reduction,
-                 const LTS_TYPE& l);
+                 const LTS_TYPE& l,
+                 const state_set_store& store);
+
+  template < class LTS_TYPE >
+  bool antichain_insert(
+                  anti_chain_type& anti_chain, 
+                  const state_type impl,
+                  const std::size_t spec,
+                  const state_set_store& store,
+                  const refinement_simulation<LTS_TYPE>& simulation);
 
   template < class LTS_TYPE >
   bool refusals_contained_in(
               const state_type impl, 
-              const set_of_states& spec, 
+              const std::size_t spec, 
               const lts_cache<LTS_TYPE>& weak_property_cache,
               label_type& culprit,
               const LTS_TYPE& l,
-              const bool provide_a_counter_example);
+              const bool provide_a_counter_example,
+              const state_set_store& store,
+              std::unordered_map<std::size_t, set_of_states>& stable_states_cache);
 
   /* Construct a path to state s using the backward map, and return it in result */
   inline
@@ -209,7 +332,7 @@ namespace detail
                                                                            const LTS_TYPE& l,
                                                                            const bool find_trace_with_taus)
   {
-    set_of_states visited;
+    std::unordered_set<state_type> visited;
     visited.insert(s);
     std::deque<state_type> todo_stack={s};
     std::map<state_type, std::pair<label_type,state_type> > backward_map;
@@ -222,9 +345,9 @@ namespace detail
       {
         // Check that the current state does not occur in all outgoing transitions. 
         bool found=false;
-        for(const transition& t: lts_cache.transitions(current_state))
+        for(const adjacent_transition& t: lts_cache.transitions(current_state))
         {
-          if (t.label()==offending_action)
+          if (t.label==offending_action)
           {
             found=true;
             break;
@@ -240,14 +363,14 @@ namespace detail
       }
       else // The current state is not stable. 
       {
-        for(const transition& t: lts_cache.transitions(current_state))
+        for(const adjacent_transition& t: lts_cache.transitions(current_state))
         {
-          if (find_trace_with_taus && l.is_tau(l.apply_hidden_label_map(t.label())))
+          if (find_trace_with_taus && l.is_tau(l.apply_hidden_label_map(t.label)))
           {
-            if (visited.insert(t.to()).second)  // The state to() was not yet explored.
+            if (visited.insert(t.state).second)  // The target state was not yet explored.
             {
-              todo_stack.push_back(t.to());
-              backward_map[t.to()]=std::pair<label_type,state_type>(t.label(), t.from()); // Store how the to state could be reached.
+              todo_stack.push_back(t.state);
+              backward_map[t.state]=std::pair<label_type,state_type>(t.label, current_state); // Store how the target state could be reached.
             }
           }
         }
@@ -259,8 +382,6 @@ namespace detail
 
 } // namespace detail
 
-enum refinement_type { trace, failures, failures_divergence };
-
 /* This function checks using algorithms in the paper mentioned above that
  * whether transition system l1 is included in transition system l2, in the
  * sense of trace inclusions, failures inclusion and divergence failures 
@@ -303,15 +424,21 @@ bool destructive_refinement_checker(
   }
 
   const detail::lts_cache<LTS_TYPE> weak_property_cache(l1,weak_reduction);
+  const detail::refinement_simulation<LTS_TYPE> simulation(l1,weak_property_cache,refinement);
+  detail::state_set_store spec_sets;                  // The sets of states of the specification.
+  std::unordered_map<std::pair<std::size_t, detail::label_type>, std::size_t> after_action;  // A cache for the sets spec'.
+  std::unordered_map<std::size_t, detail::set_of_states> stable_states_cache;  // A cache with the stable states reachable from a set.
+
   std::deque< detail::state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > > 
               working(  // let working be a stack containg the triple (init1,{s|init2-->s},root_index);
                     { detail::state_states_counter_example_index_triple< COUNTER_EXAMPLE_CONSTRUCTOR >(
                                   l1.initial_state(), 
-                                  detail::collect_reachable_states_via_taus(init_l2,weak_property_cache,weak_reduction),
+                                  spec_sets.insert(detail::collect_reachable_states_via_taus(init_l2,weak_property_cache,weak_reduction)).first,
                                   generate_counter_example.root_index() ) });
                                                       // let antichain := emptyset;
-  detail::anti_chain_type anti_chain;
-  detail::antichain_insert(anti_chain, working.front());   // antichain := antichain united with (impl,spec); 
+  detail::anti_chain_type anti_chain(l1.num_states());
+  detail::antichain_insert(anti_chain, working.front().state(), working.front().states(), spec_sets, simulation);   
+                                                           // antichain := antichain united with (impl,spec); 
                                                            // This line occurs at another place in the code than in 
                                                            // the original algorithm, where insertion in the anti-chain
                                                            // was too late, causing too many impl-spec pairs to be investigated. 
@@ -326,8 +453,8 @@ bool destructive_refinement_checker(
                                                       // if impl diverges
     {
       bool spec_diverges=false;
-      for(const detail::state_type s: impl_spec.states())       // if spec does not diverge
-      {
+      for(const detail::state_type s: spec_sets.get(impl_spec.states()))  
+      {                                               // if spec does not diverge
         if (weak_property_cache.diverges(s))
         {
           spec_diverges=true;
@@ -351,7 +478,9 @@ bool destructive_refinement_checker(
                                            weak_property_cache,
                                            offending_action,
                                            l1,
-                                           !generate_counter_example.is_dummy()))   
+                                           !generate_counter_example.is_dummy(),
+                                           spec_sets,
+                                           stable_states_cache))   
         {
           std::vector<detail::label_type> counter_example_extension;
           if (offending_action!=std::size_t(-1))
@@ -368,35 +497,40 @@ bool destructive_refinement_checker(
         }
       }
       
-      for(const transition& t: weak_property_cache.transitions(impl_spec.state()))
+      for(const adjacent_transition& t: weak_property_cache.transitions(impl_spec.state()))
       {
         const typename COUNTER_EXAMPLE_CONSTRUCTOR::index_type new_counterexample_index=
-               generate_counter_example.add_transition(t.label(),impl_spec.counter_example_index());
-        detail::set_of_states spec_prime;
-        if (l1.is_tau(l1.apply_hidden_label_map(t.label())) && weak_reduction)                   // if e=tau then
+               generate_counter_example.add_transition(t.label,impl_spec.counter_example_index());
+        std::size_t spec_prime;
+        const detail::label_type e=l1.apply_hidden_label_map(t.label);
+        if (l1.is_tau(e) && weak_reduction)                   // if e=tau then
         {
-          spec_prime=impl_spec.states();        // spec' := spec;
+          spec_prime=impl_spec.states();              // spec' := spec;
         }
         else
-        {                                           // spec' := {s' | exists s in spec. s-e->s'};
-          for(const detail::state_type s: impl_spec.states())  
+        {                                             // spec' := {s' | exists s in spec. s-e->s'};
+          const std::pair<std::size_t, detail::label_type> key(impl_spec.states(), e);
+          const std::unordered_map<std::pair<std::size_t, detail::label_type>, std::size_t>::const_iterator i=after_action.find(key);
+          if (i!=after_action.end())
           {
-            detail::set_of_states reachable_states_from_s_via_e=
-                    detail::collect_reachable_states_via_an_action(s,l1.apply_hidden_label_map(t.label()),weak_property_cache,weak_reduction,l1);
-            spec_prime.insert(reachable_states_from_s_via_e.begin(),reachable_states_from_s_via_e.end());
+            spec_prime=i->second;
+          }
+          else
+          {
+            spec_prime=spec_sets.insert(detail::collect_reachable_states_via_an_action(impl_spec.states(),e,weak_property_cache,weak_reduction,l1,spec_sets)).first;
+            after_action[key]=spec_prime;
           }
         }
-        if (spec_prime.empty())                     // if spec'={} then
+        if (spec_sets.empty(spec_prime))              // if spec'={} then
         {
           generate_counter_example.save_counter_example(new_counterexample_index,l1);
-          return false;                             //    return false;  
+          return false;                               //    return false;  
         }
-                                                    // if (impl',spec') in antichain is not true then
-        const detail::state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR > 
-                          impl_spec_counterex(t.to(),spec_prime,new_counterexample_index);
-        if (detail::antichain_insert(anti_chain, impl_spec_counterex))   
+                                                      // if (impl',spec') in antichain is not true then
+        if (detail::antichain_insert(anti_chain, t.state, spec_prime, spec_sets, simulation))   
         {
-          working.push_back(impl_spec_counterex);   // push(impl,spec') into working;
+                                                      // push(impl,spec') into working;
+          working.push_back(detail::state_states_counter_example_index_triple < COUNTER_EXAMPLE_CONSTRUCTOR >(t.state,spec_prime,new_counterexample_index));
         }
       }
     }
@@ -408,9 +542,9 @@ bool destructive_refinement_checker(
 
 namespace detail
 {
-  /* This function generates the set of states reachable from s within labelled
+  /* This function generates the set of states reachable from the states in s within labelled
      transition system l1 by internal transitions, provided weak_reduction is true.
-     Otherwise it generates a set with only state s in it.
+     Otherwise it returns s. The result is sorted. 
   */
   template < class LTS_TYPE >
   set_of_states collect_reachable_states_via_taus(
@@ -418,27 +552,26 @@ namespace detail
               const lts_cache<LTS_TYPE>& weak_property_cache, 
               const bool weak_reduction)
   {
-    set_of_states result(s);
     if (!weak_reduction)
     {
+      set_of_states result(s);
+      std::sort(result.begin(), result.end());
+      result.erase(std::unique(result.begin(), result.end()), result.end());
       return result;
     }
-    set_of_states visited(s);
-    std::deque<state_type> todo_stack(s.begin(),s.end());
-    while (todo_stack.size()>0)
+    std::unordered_set<state_type> visited(s.begin(),s.end());
+    set_of_states result(visited.begin(),visited.end());
+    for(std::size_t i=0; i<result.size(); ++i)
     {
-      state_type current_state=todo_stack.front();
-      todo_stack.pop_front();
-      for(const state_type s: weak_property_cache.tau_reachable_states(current_state)) 
+      for(const state_type t: weak_property_cache.tau_reachable_states(result[i])) 
       {
-        if (visited.insert(s).second)  // The element has been inserted.
+        if (visited.insert(t).second)  // The element has been inserted.
         {
-          todo_stack.push_back(s);
-          result.insert(s);
+          result.push_back(t);
         }
       }
     }
-    
+    std::sort(result.begin(), result.end());
     return result;
   }
 
@@ -448,109 +581,121 @@ namespace detail
                   const lts_cache<LTS_TYPE>& weak_property_cache, 
                   const bool weak_reduction)
   {
-    set_of_states set_with_s({s});
-    return collect_reachable_states_via_taus(set_with_s, weak_property_cache, weak_reduction);
+    return collect_reachable_states_via_taus(set_of_states({s}), weak_property_cache, weak_reduction);
   }
 
+  /* This function returns the states that are reachable by an e-step from a set of states, followed by 
+     internal steps if weak_reduction is true. The set of states is closed under internal steps. 
+  */
   template < class LTS_TYPE >
   set_of_states collect_reachable_states_via_an_action(
-                 const state_type s,
+                 const std::size_t states,
                  const label_type e,  // This is already the hidden action.
                  const lts_cache<LTS_TYPE>& weak_property_cache,
                  const bool weak_reduction,
-                 const LTS_TYPE& l)
+                 const LTS_TYPE& l,
+                 const state_set_store& store)
   {
-    const set_of_states set_before_action_e=collect_reachable_states_via_taus(s,weak_property_cache,weak_reduction);
     set_of_states states_reachable_via_e;
-    for(const state_type s: set_before_action_e)
+    for(const state_type s: store.get(states))
     {
-      for(const transition& t: weak_property_cache.transitions(s))
+      for(const adjacent_transition& t: weak_property_cache.transitions(s))
       {
-        {
-          if (l.apply_hidden_label_map(t.label())==e)
-          { 
-            assert(set_before_action_e.count(t.from())>0);
-            states_reachable_via_e.insert(t.to());
-          }
+        if (l.apply_hidden_label_map(t.label)==e)
+        { 
+          states_reachable_via_e.push_back(t.state);
         }
       }
     }
     return collect_reachable_states_via_taus(states_reachable_via_e, weak_property_cache, weak_reduction);
   }
 
-  /* This function implements the insertion of <p,state(), p.states()> in the anti_chain.
-     Concretely, this means that p.states() is inserted among the sets s1,...,sn associated to p.state().
+  /* This function implements the insertion of <impl,spec> in the anti_chain.
      It is important that an anti_chain contains for each state a set of states of which 
-     no set is a subset of another. The idea is that if such two sets occur, it is enough
-     to keep the smallest.
-     If p.states() is smaller than a set si associated to p.state(), this set is removed.
-     If p.states() is larger than a set si, there is no need to add p.states(), as a better candidate
-     is already there. 
+     no set is smaller than another. The idea is that if such two sets occur, it is enough
+     to keep the smallest. A pair <impl,spec> is smaller than <impl',spec'> if impl is simulated by
+     impl', and every state in spec' is simulated by a state in spec. Without a simulation
+     preorder this means that impl=impl' and spec' is a subset of spec. 
+     If there is a pair that is smaller than <impl,spec>, there is no need to add it, as a 
+     better candidate is already there. Otherwise, the sets of impl that are larger are removed.
      This function returns true if insertion was succesful, and false otherwise.
    */
-  template <  class COUNTER_EXAMPLE_CONSTRUCTOR >
-  inline bool antichain_insert(
+  template < class LTS_TYPE >
+  bool antichain_insert(
                   anti_chain_type& anti_chain, 
-                  const state_states_counter_example_index_triple<COUNTER_EXAMPLE_CONSTRUCTOR>& impl_spec)
+                  const state_type impl,
+                  const std::size_t spec,
+                  const state_set_store& store,
+                  const refinement_simulation<LTS_TYPE>& simulation)
   {
-    // First check whether there is a set in the antichain for impl_spec.state() which is smaller than impl_spec.states().
-    // If so, impl_spec.states() does not have to be inserted in the anti_chain.
-    for(anti_chain_type::const_iterator i=anti_chain.lower_bound(impl_spec.state()); i!=anti_chain.upper_bound(impl_spec.state()); ++i)
+    // First check whether there is a smaller pair in the antichain.
+    // If so, <impl,spec> does not have to be inserted in the anti_chain.
+    const set_of_states spec_states=store.get(spec);
+    set_of_states spec_prime_states;
+    bool subsumed=false;
+    simulation.for_each_simulating_state(impl, [&](const state_type impl_prime)
     {
-      const set_of_states s=i->second;
-      // If s is included in impl_spec.states() 
-      if (std::includes(impl_spec.states().begin(), impl_spec.states().end(), s.begin(),s.end()))
+      for(const std::size_t spec_prime: anti_chain[impl_prime])
       {
-        return false;
+        if (subsumed)
+        {
+          return;
+        }
+        if (spec_prime==spec)
+        {
+          subsumed=true;
+          return;
+        }
+        spec_prime_states.clear();
+        store.get(spec_prime, spec_prime_states);
+        subsumed=simulation.set_simulated_by(spec_prime_states.data(), spec_prime_states.data()+spec_prime_states.size(), 
+                                             spec_states.data(), spec_states.data()+spec_states.size());
       }
-    }
-
-    // Here impl_spec.states() must be inserted in the antichain. Moreover, all sets in the antichain that 
-    // are a superset of impl_spec.states() must be removed.
-    for(anti_chain_type::iterator i=anti_chain.lower_bound(impl_spec.state()); i!=anti_chain.upper_bound(impl_spec.state()); )
+    });
+    if (subsumed)
     {
-      const set_of_states s=i->second;
-      // if s is a superset of impl_spec.states() 
-      // if (std::includes(impl_spec.states().begin(),impl_spec.states().end(),s.begin(),s.end()))  
-      if (std::includes(s.begin(), s.end(), impl_spec.states().begin(),impl_spec.states().end()))  
-      {
-        // set s must be removed. 
-        i=anti_chain.erase(i);
-      }
-      else
-      {
-        ++i;
-      }
+      return false;
     }
-    anti_chain.insert(std::pair<detail::state_type,detail::set_of_states>(impl_spec.state(),impl_spec.states()));
+
+    // Here spec must be inserted in the antichain. Moreover, all sets for impl in the antichain that 
+    // are larger than spec must be removed.
+    std::vector<std::size_t>& sets=anti_chain[impl];
+    sets.erase(std::remove_if(sets.begin(), sets.end(), [&](const std::size_t spec_prime)
+                              {
+                                spec_prime_states.clear();
+                                store.get(spec_prime, spec_prime_states);
+                                return simulation.set_simulated_by(spec_states.data(), spec_states.data()+spec_states.size(), 
+                                                                   spec_prime_states.data(), spec_prime_states.data()+spec_prime_states.size());
+                              }), 
+               sets.end());
+    sets.push_back(spec);
     return true;
   }
   
   /* Calculate the states that are stable and reachable through tau-steps */
   template < class LTS_TYPE >
   const set_of_states& calculate_tau_reachable_states(
-        const set_of_states& states, 
-        const lts_cache<LTS_TYPE>& weak_property_cache)
+        const std::size_t states, 
+        const lts_cache<LTS_TYPE>& weak_property_cache,
+        const state_set_store& store,
+        std::unordered_map<std::size_t, set_of_states>& cache)
   {
-    static std::map<set_of_states, set_of_states> cache;
-    const std::map<set_of_states, set_of_states>::const_iterator i=cache.find(states);
+    const std::unordered_map<std::size_t, set_of_states>::const_iterator i=cache.find(states);
     if (i!=cache.end())
     {
       return i->second;
     }
 
-    static set_of_states visited;
-    assert(visited.empty());
-    static std::stack < state_type > todo_stack;
-    assert(todo_stack.empty());
+    std::unordered_set<state_type> visited;
+    std::stack < state_type > todo_stack;
     set_of_states result;
 
-    for(const state_type s: states)
+    for(const state_type s: store.get(states))
     {
       if (weak_property_cache.stable(s))
       { 
         // Put the outgoing action labels in a set and put these in the result.
-        result.insert(s);
+        result.push_back(s);
       }
       else
       {
@@ -569,7 +714,7 @@ namespace detail
         if (weak_property_cache.stable(s))
         { 
           // Put the outgoing action labels in a set and put these in the result.
-          result.insert(s);
+          result.push_back(s);
         }
         else
         {
@@ -580,9 +725,9 @@ namespace detail
         }
       }
     }
-    cache[states]=result;
-    visited.clear();
-    return cache[states];
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return cache[states]=result;
   }
 
   /* This function checks that the refusals(impl) are contained in the refusals of spec, where
@@ -595,11 +740,13 @@ namespace detail
   template < class LTS_TYPE >
   bool refusals_contained_in(
               const state_type impl, 
-              const set_of_states& spec, 
+              const std::size_t spec, 
               const lts_cache<LTS_TYPE>& weak_property_cache,
               label_type& culprit,
               const LTS_TYPE& l,
-              const bool provide_a_counter_example)
+              const bool provide_a_counter_example,
+              const state_set_store& store,
+              std::unordered_map<std::size_t, set_of_states>& stable_states_cache)
   {
     if (!weak_property_cache.stable(impl)) return true; // Checking in case of instability is not necessary, but rather time consuming. 
 
@@ -609,7 +756,7 @@ namespace detail
     // from any of the states in spec: enable(s'')\enable(s') is not empty.
 
     // First calculate the refusal sets reachable from spec.
-    const set_of_states& tau_reachable_states_of_the_specification=calculate_tau_reachable_states(spec,weak_property_cache);
+    const set_of_states& tau_reachable_states_of_the_specification=calculate_tau_reachable_states(spec,weak_property_cache,store,stable_states_cache);
 
     // Now walk through the tau-reachable stable states s' of impl.
     static std::unordered_set<state_type> visited;
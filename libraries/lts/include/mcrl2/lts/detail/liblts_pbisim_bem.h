@@ -19,6 +19,7 @@
 #include "mcrl2/utilities/execution_timer.h"
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/probabilistic_fast_fraction.h"
 #include "mcrl2/lts/detail/liblts_plts_merge.h"
 
 namespace mcrl2
@@ -28,7 +29,7 @@ namespace lts
 namespace detail
 {
 
-template < class LTS_TYPE>
+template < class LTS_TYPE, class PROBABILITY_FRACTION_TYPE = typename fast_probability_fraction<typename LTS_TYPE::probabilistic_state_t::probability_t>::type >
 class prob_bisim_partitioner_bem
 {
 
@@ -150,12 +151,13 @@ class prob_bisim_partitioner_bem
   typedef std::size_t state_type;
   typedef std::size_t label_type;
   typedef std::size_t distribution_key_type;
-  typedef typename LTS_TYPE::probabilistic_state_t::probability_t probability_fraction_type;
+  typedef PROBABILITY_FRACTION_TYPE probability_fraction_type;
 
   struct distribution_type
   {
     distribution_key_type key;
     std::vector< std::list<transition*> > incoming_transitions_per_label; // Incoming transitions organized per label
+    std::vector< std::pair<state_type, probability_fraction_type> > state_probabilities; // The distribution, converted to probability_fraction_type
   };
   
   struct block_type
@@ -224,6 +226,10 @@ class prob_bisim_partitioner_bem
     {
       distribution.key = key;
       distribution.incoming_transitions_per_label.resize(aut.num_action_labels());
+      for (const typename LTS_TYPE::probabilistic_state_t::state_probability_pair& prob_pair : aut.probabilistic_state(key))
+      {
+        distribution.state_probabilities.emplace_back(prob_pair.state(), probability_fraction_type(prob_pair.probability()));
+      }
       key++;
     }
 
@@ -398,15 +404,13 @@ class prob_bisim_partitioner_bem
   probability_fraction_type probability_to_block(distribution_type& d, block_type& b)
   {
     probability_fraction_type prob_to_block;
-    const typename LTS_TYPE::probabilistic_state_t& prob_state = aut.probabilistic_state(d.key);
 
     /* Check whether the state is in the distribution d and add up the probability*/
-    for (const typename LTS_TYPE::probabilistic_state_t::state_probability_pair& prob_pair : prob_state)
+    for (const std::pair<state_type, probability_fraction_type>& prob_pair : d.state_probabilities)
     {
-      const state_type& s = prob_pair.state();
-      if (block_index_of_a_state[s] == b.key)
+      if (block_index_of_a_state[prob_pair.first] == b.key)
       {
-        prob_to_block = prob_to_block + prob_pair.probability();
+        prob_to_block = prob_to_block + prob_pair.second;
       }
     }
 
@@ -428,19 +432,19 @@ class prob_bisim_partitioner_bem
       if (prob_state_map.count(new_state) == 0)
       {
         /* The state is not yet in the mapping. Add the state with its probability*/
-        prob_state_map[new_state] = sp_pair.probability();
+        prob_state_map[new_state] = probability_fraction_type(sp_pair.probability());
       }
       else
       {
         /* The state is already in the mapping. Sum up probabilities */
-        prob_state_map[new_state] = prob_state_map[new_state] + sp_pair.probability();
+        prob_state_map[new_state] = prob_state_map[new_state] + probability_fraction_type(sp_pair.probability());
       }
     }
 
     /* Add all the state probabilities pairs in the mapping to its actual data type*/
     for (const std::pair<state_type, probability_fraction_type>& i : prob_state_map)
     {
-      new_prob_state.add(i.first, i.second);
+      new_prob_state.add(i.first, static_cast<typename LTS_TYPE::probabilistic_state_t::probability_t>(i.second));
     }
 
     return new_prob_state;
@@ -19,6 +19,7 @@
 #include "mcrl2/lts/detail/embedded_list.h"
 #include "mcrl2/lts/detail/liblts_plts_merge.h"
 #include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/probabilistic_fast_fraction.h"
 
 namespace mcrl2
 {
@@ -27,7 +28,7 @@ namespace lts
 namespace detail
 {
 
-template < class LTS_TYPE>
+template < class LTS_TYPE, class PROBABILITY_FRACTION_TYPE = typename fast_probability_fraction<typename LTS_TYPE::probabilistic_state_t::probability_t>::type >
 class prob_bisim_partitioner_grv  // Called after Groote, Rivera Verduzco and de Vink
 {
   public:
@@ -147,10 +148,8 @@ class prob_bisim_partitioner_grv  // Called after Groote, Rivera Verduzco and de
     typedef std::size_t transition_key_type;
     typedef std::size_t state_key_type;
     typedef std::size_t label_type;
-    // typedef probabilistic_arbitrary_precision_fraction probability_label_type;
-    typedef typename LTS_TYPE::probabilistic_state_t::probability_t probability_label_type;
-    // typedef probabilistic_arbitrary_precision_fraction probability_fraction_type;
-    typedef typename LTS_TYPE::probabilistic_state_t::probability_t probability_fraction_type;
+    typedef PROBABILITY_FRACTION_TYPE probability_label_type;
+    typedef PROBABILITY_FRACTION_TYPE probability_fraction_type;
 
     struct action_transition_type : public embedded_list_node <action_transition_type>
     {
@@ -604,7 +603,7 @@ class prob_bisim_partitioner_grv  // Called after Groote, Rivera Verduzco and de
         {
           probabilistic_transition_type pt;
           pt.from = i;
-          pt.label = sp_pair.probability();
+          pt.label = probability_label_type(sp_pair.probability());
           pt.to = sp_pair.state();
           probabilistic_transitions.push_back(pt);
 
@@ -1264,19 +1263,19 @@ class prob_bisim_partitioner_grv  // Called after Groote, Rivera Verduzco and de
         if (prob_state_map.count(new_state) == 0)
         {
           /* The state is not yet in the mapping. Add the state with its probability*/
-          prob_state_map[new_state] = sp_pair.probability();
+          prob_state_map[new_state] = probability_fraction_type(sp_pair.probability());
         }
         else
         {
           /* The state is already in the mapping. Sum up probabilities */
-          prob_state_map[new_state] = prob_state_map[new_state] + sp_pair.probability();
+          prob_state_map[new_state] = prob_state_map[new_state] + probability_fraction_type(sp_pair.probability());
         }
       }
 
       /* Add all the state probabilities pairs in the mapping to its actual data type*/
       for (typename std::map<state_key_type, probability_fraction_type>::iterator i = prob_state_map.begin(); i != prob_state_map.end(); i++)
       {
-        new_prob_state.add(i->first, i->second);
+        new_prob_state.add(i->first, static_cast<typename LTS_TYPE::probabilistic_state_t::probability_t>(i->second));
       }
 
       return new_prob_state;
@@ -100,10 +100,10 @@ class scc_partitioner
 
     void group_components(const state_type t,
                           const state_type equivalence_class_index,
-                          const std::map < state_type, std::vector < state_type > >& tgt_src,
+                          const adjacency_index& tgt_src,
                           std::vector < bool >& visited);
     void dfs_numbering(const state_type t,
-                       const std::map < state_type, std::vector < state_type > >& src_tgt,
+                       const adjacency_index& src_tgt,
                        std::vector < bool >& visited);
 
 };
@@ -116,16 +116,8 @@ scc_partitioner<LTS_TYPE>::scc_partitioner(LTS_TYPE& l)
   mCRL2log(log::debug) << "Tau loop (SCC) partitioner created for " << l.num_states() << " states and " <<
               l.num_transitions() << " transitions" << std::endl;
 
-  // read and store tau transitions.
-  std::map < state_type, std::vector < state_type > > src_tgt;
-  for (const transition& t: aut.get_transitions())
-  {
-    if (aut.is_tau(l.apply_hidden_label_map(t.label())))
-    {
-      src_tgt[t.from()].push_back(t.to());
-    }
-  }
-  // Initialise the data structures
+  // The tau transitions are found in the indices of outgoing and incoming transitions.
+  const adjacency_index& src_tgt = aut.outgoing_transition_index();
   std::vector<bool> visited(aut.num_states(),false);
 
   // Number the states via a depth first search
@@ -133,16 +125,8 @@ scc_partitioner<LTS_TYPE>::scc_partitioner(LTS_TYPE& l)
   {
     dfs_numbering(i,src_tgt,visited);
   }
-  src_tgt.clear();
 
-  std::map < state_type, std::vector < state_type > > tgt_src;
-  for (const transition& t: aut.get_transitions())
-  {
-    if (aut.is_tau(l.apply_hidden_label_map(t.label())))
-    {
-      tgt_src[t.to()].push_back(t.from());
-    }
-  }
+  const adjacency_index& tgt_src = aut.incoming_transition_index();
   equivalence_class_index=0;
   block_index_of_a_state=std::vector < state_type >(aut.num_states(),0);
   for (std::vector < state_type >::reverse_iterator i=dfsn2state.rbegin();
@@ -237,7 +221,7 @@ template < class LTS_TYPE>
 void scc_partitioner<LTS_TYPE>::group_components(
   const state_type t,
   const state_type equivalence_class_index,
-  const std::map < state_type, std::vector < state_type > >& tgt_src,
+  const adjacency_index& tgt_src,
   std::vector < bool >& visited)
 {
   if (!visited[t])
@@ -246,14 +230,9 @@ void scc_partitioner<LTS_TYPE>::group_components(
   }
   {
     visited[t] = false;
-    if (tgt_src.count(t)>0)
+    for (const adjacent_transition& i: tgt_src.transitions(t, aut.tau_label_index()))
     {
-      const std::vector < state_type >& sources = tgt_src.find(t)->second;
-      for (std::vector < state_type >::const_iterator i=sources.begin();
-           i!=sources.end(); ++i)
-      {
-        group_components(*i,equivalence_class_index,tgt_src,visited);
-      }
+      group_components(i.state,equivalence_class_index,tgt_src,visited);
     }
     block_index_of_a_state[t]=equivalence_class_index;
   }
@@ -262,7 +241,7 @@ void scc_partitioner<LTS_TYPE>::group_components(
 template < class LTS_TYPE>
 void scc_partitioner<LTS_TYPE>::dfs_numbering(
   const state_type t,
-  const std::map < state_type, std::vector < state_type > >& src_tgt,
+  const adjacency_index& src_tgt,
   std::vector < bool >& visited)
 {
   if (visited[t])
@@ -270,14 +249,9 @@ void scc_partitioner<LTS_TYPE>::dfs_numbering(
     return;
   }
   visited[t] = true;
-  if (src_tgt.count(t)>0)
+  for (const adjacent_transition& i: src_tgt.transitions(t, aut.tau_label_index()))
   {
-    const std::vector < state_type >& targets = src_tgt.find(t)->second;
-    for (std::vector < state_type >::const_iterator i=targets.begin();
-         i!=targets.end() ; ++i)
-    {
-      dfs_numbering(*i,src_tgt,visited);
-    }
+    dfs_numbering(i.state,src_tgt,visited);
   }
   dfsn2state.push_back(t);
 }
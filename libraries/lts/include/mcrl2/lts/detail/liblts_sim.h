@@ -1,4 +1,4 @@
-// Author(s): Bas Ploeger
+// Author(s): Bas Ploeger, Wieger Wesselink
 // Copyright: see the accompanying file COPYING or copy at
 // https://github.com/mCRL2org/mCRL2/blob/master/COPYING
 //
@@ -11,20 +11,19 @@
 
 #ifndef LIBLTS_SIM_H
 #define LIBLTS_SIM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
 #include <vector>
-#include <cstdlib>
-#include <string>
-#include <sstream>
-#include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/hash_utility.h"
 #include "mcrl2/utilities/logger.h"
-#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/parallel.h"
 #include "mcrl2/lts/lts.h"
-#include "mcrl2/lts/lts_utilities.h"
-#include "mcrl2/lts/detail/sim_hashtable.h"
-#include "mcrl2/lts/lts_lts.h"
-#include "mcrl2/lts/lts_aut.h"
-#include "mcrl2/lts/lts_fsm.h"
-#include "mcrl2/lts/lts_dot.h"
+#include "mcrl2/lts/detail/liblts_bisim_gjkw.h"
+#include "mcrl2/lts/detail/liblts_merge.h"
 
 namespace mcrl2
 {
@@ -33,1074 +32,722 @@ namespace lts
 namespace detail
 {
 
-template <class LTS_TYPE>
-class sim_partitioner
-{
-  public:
-    /** Creates a partitioner for an LTS.
-     * \param[in] l Pointer to the LTS. */
-    sim_partitioner(LTS_TYPE& l);
-
-    /** Destroys this partitioner. */
-    ~sim_partitioner();
-
-    /** Computes the simulation equivalence classes and preorder
-     * relations of the LTS. */
-    virtual void partitioning_algorithm();
-
-    /** Gives the transition relation on the computed equivalence
-     * classes of the LTS. The label numbers of the transitions
-     * correspond to the label numbers of the LTS that was passed as an
-     * argument to the constructor of this partitioner.
-     * The state numbers of the transitions are the equivalence class
-     * numbers which range from 0 upto (and excluding) \ref num_eq_classes().
-     *
-     * \pre The simulation equivalence classes have been computed.
-     * \return A vector containing the transitions between the
-     * simulation equivalence classes. */
-    std::vector < mcrl2::lts::transition> get_transitions() const;
-
-    /** Gives the number of simulation equivalence classes of the LTS.
-     * \pre The simulation equivalence classes have been computed.
-     * \return The number of simulation equivalence classes of the LTS.
-     */
-    std::size_t num_eq_classes() const;
-
-    /** Gives the equivalence class number of a state.
-     * The equivalence class numbers range from 0 upto (and excluding)
-     * \ref num_eq_classes().
-     * \pre The simulation equivalence classes have been computed.
-     * \param[in] s A state number.
-     * \return The number of the equivalence class to which \e s
-     * belongs. */
-    std::size_t get_eq_class(std::size_t s) const;
-
-    /** Returns whether one state is simulated by another state.
-     * \pre The simulation preorder has been computed.
-     * \param[in] s A state number.
-     * \param[in] t A state number.
-     * \retval true if \e s is simulated by \e t;
-     * \retval false otherwise. */
-    bool in_preorder(std::size_t s,std::size_t t) const;
-
-    /** Returns whether two states are in the same simulation
-     * equivalence class.
-     * \pre The simulation equivalence classes have been computed.
-     * \param[in] s A state number.
-     * \param[in] t A state number.
-     * \retval true if \e s and \e t are in the same simulation
-     * equivalence class;
-     * \retval false otherwise. */
-    bool in_same_class(std::size_t s,std::size_t t) const;
-
-  protected:
-
-    /** Computes the simulation equivalence classes and preorder
-     * relations of the LTS.
-     * \pre : initialise_datastructures called */
-    void partitioning_algorithmG();
-    
-    struct state_bucket
-    {
-      ptrdiff_t next;
-      ptrdiff_t prev;
-    };
-
-    LTS_TYPE& aut;
-    mcrl2::lts::outgoing_transitions_per_state_action_t trans_index;
-    std::size_t s_Sigma;
-    std::size_t s_Pi;
-    std::vector<bool> state_touched;
-    std::vector<bool> block_touched;
-    std::vector<state_bucket> state_buckets;
-    std::vector<std::size_t> block_Pi;
-    std::vector<std::size_t> parent;
-    std::vector< std::vector<std::size_t> > children;
-    std::vector<ptrdiff_t> contents_t;
-    std::vector<ptrdiff_t> contents_u;
-    std::vector< std::vector<bool> > stable;
-    hash_table3* exists;
-    hash_table3* forall;
-    std::vector< std::vector<std::size_t> > pre_exists;
-    std::vector< std::vector<std::size_t> > pre_forall;
-    hash_table3* match;
-    std::vector< std::vector<bool> > P;
-    std::vector< std::vector<bool> > Q;
-
-    /* auxiliary variables */
-    std::vector<std::size_t> touched_blocks;
-    std::vector<std::size_t> contents;
-
-    void initialise_datastructures();
-    //void read_partition_from_file(char *parfile);
-
-    void refine(bool& change);
-    void update();
-    //void update_lts();
-
-    void touch(std::size_t a,std::size_t alpha);
-    void untouch(std::size_t alpha);
-
-    void reverse_topological_sort(std::vector<std::size_t>& Sort);
-    void dfs_visit(std::size_t u,std::vector<bool>& visited,
-                   std::vector<std::size_t>& Sort);
-
-    void initialise_Sigma(std::size_t gamma,std::size_t l);
-    void initialise_Pi(std::size_t gamma,std::size_t l);
-    void filter(std::size_t S,std::vector< std::vector<bool> >& R,bool B);
-    void cleanup(std::size_t alpha,std::size_t beta);
-    void initialise_pre_EA();
-    void induce_P_on_Pi();
-
-    std::string print_Sigma_P();
-    std::string print_Pi_Q();
-    std::string print_Sigma();
-    std::string print_Pi();
-    std::string print_relation(std::size_t s,std::vector< std::vector<bool> >& R);
-    std::string print_block(std::size_t b);
-    std::string print_structure(hash_table3* struc);
-    std::string print_reverse_topological_sort(const std::vector<std::size_t>& Sort);
-};
-
-
-#define LIST_END (-1)
-#define UNIVERSAL_PART (0)
-
-template <class LTS_TYPE>
-sim_partitioner<LTS_TYPE>::sim_partitioner(LTS_TYPE& l)
-  : aut(l)
-{
-  match  = new hash_table3(1000);
-  exists = new hash_table3(1000);
-  forall = new hash_table3(1000);
-}
-
-template <class LTS_TYPE>
-sim_partitioner<LTS_TYPE>::~sim_partitioner()
-{
-  delete match;
-  delete exists;
-  delete forall;
-}
-
-/* ----------------- PARTITIONING ALGORITHM ------------------------- */
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::partitioning_algorithm()
-{
-  initialise_datastructures();
-  partitioning_algorithmG();
-}
-
-/* Pre : initialise_datastructures called */
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::partitioning_algorithmG()
+/// \brief Returns the index of the lowest bit that is set in word, which must be non zero.
+inline std::size_t lowest_bit(std::uint64_t word)
 {
-  using namespace mcrl2::core;
-
-  bool change;
-  std::size_t i;
-
-  refine(change);
-  update();
-
-  change = true;
-  i = 0;
-  while (change)
-  {
-    change = false;
-
-    /* Set Sigma to Pi and P to Q*/
-    s_Sigma = s_Pi;
-    /* The following statement simultaneously assigns P to Q and Q to P.
-     * The assignment of Q to P is safe because Q is not used in
-     * refine() and will be freshly computed at the start of update().
-     * The advantage of using swap() is that it is executed in constant
-     * time. */
-    P.swap(Q);
-
-    mCRL2log(log::debug) << "--------------------- ITERATION " << i << " ----------------------------------" << std::endl;
-
-    mCRL2log(log::debug) << "  iteration " << i << "; number of blocks: " << s_Sigma << std::endl;
-
-    refine(change);
-    if (change)
-    {
-      update();
-    }
-    else
-    {
-      /* No blocks were split by refine(), so update() need not be
-       * called. However, we do need to swap P and Q again: Q currently
-       * contains the P-relation of the previous iteration (due to the
-       * call to swap() prior to the call to refine()) but we want it to
-       * contain that of the current iteration! */
-      P.swap(Q);
-    }
-    ++i;
-  }
-
-  if (mCRL2logEnabled(log::debug))
+#if defined(__GNUC__)
+  return __builtin_ctzll(word);
+#else
+  std::size_t result = 0;
+  while ((word & 1) == 0)
   {
-    mCRL2log(log::debug) << print_Pi_Q();
+    word >>= 1;
+    result++;
   }
+  return result;
+#endif
 }
 
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::initialise_datastructures()
+/// \brief The simulation preorder on the states of a transition system, stored as a
+/// partition-relation pair: a partition of the states into blocks, and a partial order on
+/// the blocks that is stored as a dense bit matrix. Row b contains the blocks that simulate b.
+/// \details The relation is the largest simulation that is contained in an initial relation,
+/// which is given by a class for each state and a partial order on the classes. The partition
+/// and the relation are refined together, as in the partition-relation algorithms of
+/// Gentilini, Piazza and Policriti, and of van Glabbeek and Ploeger. In each round, the
+/// signature of a state consists of the pairs (a, B) such that the state has an a-transition
+/// into block B, and no a-transition into a block above B. The blocks are split on these
+/// signatures. A new block c then stays above a new block b if their parents are related, and
+/// c is contained in Pre_a(row(B)) for every pair (a, B) in the signature of b. These sets are
+/// computed over the new blocks for all pairs (a, B) with the same label in parallel, and the
+/// rows are intersected with them one 64-bit word at a time with atomic AND operations. This
+/// is repeated until neither the partition nor the relation changes. Besides the bit matrix,
+/// which takes b^2 bits for b blocks, the memory use is linear in the size of the LTS.
+class simulation_relation
 {
-  // aut.sort_transitions(mcrl2::lts::lbl_tgt_src);
-  // trans_index = aut.get_transition_pre_table();
-  trans_index=transitions_per_outgoing_state_action_pair_reversed(aut.get_transitions(),aut.hidden_label_map());
-
-  std::size_t N = aut.num_states();
+  protected:
+    typedef std::pair<std::size_t, std::size_t> entry;  // A pair (label, block).
 
-  state_bucket sb = { LIST_END, LIST_END };
-  state_buckets.assign(N,sb);
-  state_touched.assign(N,false);
-  block_Pi.assign(N,UNIVERSAL_PART);
+    std::vector<std::size_t> m_block;           // The block of each state.
+    std::size_t m_number_of_blocks = 0;
+    std::size_t m_words = 0;                    // The number of words per row.
+    std::vector<std::atomic<std::uint64_t> > m_relation;
+    std::vector<std::size_t> m_member_begin;    // The states of block b are m_members[m_member_begin[b], m_member_begin[b + 1]).
+    std::vector<std::size_t> m_members;
 
-  /* put all states in one block */
-  s_Pi = 1;
-  contents_u.push_back(UNIVERSAL_PART);
-  contents_t.push_back(LIST_END);
-  for (std::size_t i = 0; i < N; ++i)
-  {
-    if (i > 0)
+    static std::size_t number_of_words(std::size_t number_of_bits)
     {
-      state_buckets[i].prev = i-1;
+      return (number_of_bits + 63) / 64;
     }
-    else
-    {
-      state_buckets[i].prev = LIST_END;
-    }
-    if (i < N-1)
+
+    std::atomic<std::uint64_t>* row(std::size_t b)
     {
-      state_buckets[i].next = i+1;
+      return m_relation.data() + b * m_words;
     }
-    else
+
+    const std::atomic<std::uint64_t>* row(std::size_t b) const
     {
-      state_buckets[i].next = LIST_END;
+      return m_relation.data() + b * m_words;
     }
-  }
-
-  block_touched.assign(s_Pi,false);
-  s_Sigma = s_Pi;
-
-  /* initialise P and children */
-  std::vector<std::size_t> vi;
-  children.assign(s_Sigma,vi);
-  std::vector<bool> vb(s_Sigma,false);
-  P.assign(s_Sigma,vb);
-  for (std::size_t i = 0; i < s_Sigma; ++i)
-  {
-    children[i].push_back(i);
-    P[i][i] = true;
-  }
-
-  mCRL2log(log::debug) << "--------------------- INITIALISATION ---------------------------" << std::endl;
-  mCRL2log(log::debug) << "  initialisation; number of blocks: " << s_Sigma << std::endl;
-}
 
-/* ----------------- INITIALISE ------------------------------------- */
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::initialise_Pi(std::size_t gamma,std::size_t l)
-{
-  std::size_t alpha, a, c;
-  std::vector<std::size_t>::iterator ci, last;
-
-  contents.clear();
-  for (ptrdiff_t i = contents_u[gamma]; i != LIST_END;
-       i = state_buckets[i].next)
-  {
-    contents.push_back(std::size_t(i));
-  }
-  for (ptrdiff_t i = contents_t[gamma]; i != LIST_END;
-       i = state_buckets[i].next)
-  {
-    contents.push_back(std::size_t(i));
-  }
-  last = contents.end();
-  for (ci = contents.begin(); ci != last; ++ci)
-  {
-    c = *ci;
-    /* iterate over the incoming l-transitions of c */
-    using namespace mcrl2::lts;
-    for (outgoing_transitions_per_state_action_t::iterator
-         t=trans_index.lower_bound(std::pair < transition::size_type, transition::size_type >(c,l));
-         t!=trans_index.upper_bound(std::pair < transition::size_type, transition::size_type >(c,l)); ++t)
+    /// \brief Makes the classes the initial blocks, and computes the initial relation on them.
+    /// \return False if there are more than max_blocks blocks; the relation is then not computed.
+    template <typename ClassOrder>
+    bool initialise(const std::vector<std::size_t>& state_class, std::size_t number_of_classes, ClassOrder below, std::size_t max_blocks)
     {
-      a = to(t); // As trans_index is reversed, this is actually the state from which the transition t goes.
-      if (!state_touched[a])
+      const std::size_t undefined = std::size_t(-1);
+      std::vector<std::size_t> index(number_of_classes, undefined);
+      std::vector<std::size_t> classes;  // The class of each block; only the classes that occur get a block.
+      m_block.resize(state_class.size());
+      for (std::size_t s = 0; s < state_class.size(); ++s)
       {
-        alpha = block_Pi[a];
-        touch(a,alpha);
-        if (!block_touched[alpha])
+        const std::size_t c = state_class[s];
+        if (index[c] == undefined)
         {
-          touched_blocks.push_back(alpha);
-          block_touched[alpha] = true;
+          index[c] = classes.size();
+          classes.push_back(c);
         }
+        m_block[s] = index[c];
       }
-    }
-  }
-}
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::initialise_Sigma(std::size_t gamma,std::size_t l)
-{
-  std::vector<std::size_t>::iterator deltai, last;
-  last = children[gamma].end();
-  for (deltai = children[gamma].begin(); deltai != last; ++deltai)
-  {
-    initialise_Pi(*deltai,l);
-  }
-}
-
-/* ----------------- REFINE ----------------------------------------- */
-
-/* PRE: s_Sigma = s_Pi */
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::refine(bool& change)
-{
-  using namespace mcrl2::core;
-  /* Initialise the parent and children functions */
-  std::vector<std::size_t> v;
-  children.assign(s_Pi,v);
-  parent.assign(s_Pi,0);
-  std::size_t alpha;
-  for (alpha = 0; alpha < s_Pi; ++alpha)
-  {
-    children[alpha].push_back(alpha);
-    parent[alpha] = alpha;
-  }
-
-  if (mCRL2logEnabled(log::debug))
-  {
-    mCRL2log(log::debug) << "--------------------- Refine ---------------------------------------" << std::endl;
-    mCRL2log(log::debug) << print_Sigma_P();
-  }
-
-  /* Compute a reverse topological sorting of Sigma w.r.t. P */
-  std::vector<std::size_t> Sort;
-  Sort.reserve(s_Sigma);
-  reverse_topological_sort(Sort);
-
-  if (mCRL2logEnabled(log::debug))
-  {
-    mCRL2log(log::debug) << print_reverse_topological_sort(Sort);
-  }
 
-  /* Some local variables */
-  std::vector<bool> v_false(s_Sigma,false);
-  std::vector<std::size_t>::iterator alphai, last, gammai;
-  std::vector< std::vector<bool> >::iterator stable_alpha, P_gamma;
-  bool stable_alpha_gamma;
-  std::size_t gamma, delta, l;
-
-  /* The main loop */
-  for (l = 0; l < aut.num_action_labels(); ++l)
-  {
-    mCRL2log(log::debug) << "---------------------------------------------------" << std::endl;
-    mCRL2log(log::debug) << "Label = \"" << mcrl2::lts::pp(aut.action_label(l)) << "\"" << std::endl;
-
-    /* reset the stable function */
-    stable.assign(s_Pi,v_false);
-
-    /* iterate over the reverse topological sorting */
-    for (gammai = Sort.begin(); gammai != Sort.end(); ++gammai)
-    {
-      gamma = *gammai;
-
-      touched_blocks.clear();
-      initialise_Sigma(gamma,l);
-
-      /* iterate over all alpha such that alpha -l->E gamma */
-      last = touched_blocks.end();
-      for (alphai = touched_blocks.begin(); alphai != last; ++alphai)
+      if (classes.size() > max_blocks)
       {
-        alpha = *alphai;
-        /* compute stable(alpha,gamma); use a local boolean variable for
-         * efficiency */
-        stable_alpha_gamma = false;
-        stable_alpha = stable.begin() + alpha;
-        P_gamma = P.begin() + gamma;
-        for (delta = 0; delta < s_Sigma && !stable_alpha_gamma; ++delta)
+        return false;
+      }
+      m_number_of_blocks = classes.size();
+      m_words = number_of_words(m_number_of_blocks);
+      std::vector<std::atomic<std::uint64_t> >(m_number_of_blocks * m_words).swap(m_relation);
+      for (std::size_t b = 0; b < m_number_of_blocks; ++b)
+      {
+        for (std::size_t c = 0; c < m_number_of_blocks; ++c)
         {
-          if ((*stable_alpha)[delta] && (*P_gamma)[delta])
+          if (below(classes[b], classes[c]))
           {
-            stable_alpha_gamma = true;
+            row(b)[c / 64].fetch_or(std::uint64_t(1) << (c % 64), std::memory_order_relaxed);
           }
         }
-        (*stable_alpha)[gamma] = stable_alpha_gamma;
-        if (!stable_alpha_gamma)
-        {
-          /* if alpha -l->A gamma then alpha cannot be split */
-          if (contents_u[alpha] != LIST_END)
-          {
-            /* split alpha; new block will be s_Pi */
-            change = true;
+      }
+      return true;
+    }
 
-            children[parent[alpha]].push_back(s_Pi);
-            parent.push_back(parent[alpha]);
-            stable.push_back(*stable_alpha);
-            block_touched.push_back(false);
-            contents_t.push_back(LIST_END);
+    /// \brief Computes the signature of each state, which is stored in entries[first[s], last[s]).
+    /// The entries of a signature are sorted.
+    void compute_signatures(const adjacency_index& outgoing,
+                            std::size_t number_of_threads,
+                            std::vector<entry>& entries,
+                            std::vector<std::size_t>& first,
+                            std::vector<std::size_t>& last) const
+    {
+      const std::size_t n = m_block.size();
+      std::vector<std::vector<entry> > buffers(number_of_threads);
+      std::vector<std::size_t> owner(n);
+      first.resize(n);
+      last.resize(n);
 
-            /* assign the untouched contents of alpha to s_Pi */
-            contents_u.push_back(contents_u[alpha]);
-            contents_u[alpha] = LIST_END;
+      utilities::parallel_for(n, number_of_threads, [&](std::size_t thread, std::size_t begin, std::size_t end)
+      {
+        std::vector<entry>& buffer = buffers[thread];
+        std::vector<entry> targets;
+        for (std::size_t s = begin; s < end; ++s)
+        {
+          targets.clear();
+          for (const adjacent_transition& t: outgoing.transitions(s))
+          {
+            targets.push_back(entry(t.label, m_block[t.state]));
+          }
+          std::sort(targets.begin(), targets.end());
+          targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
 
-            /* update the block information for the moved states */
-            for (ptrdiff_t i = contents_u[s_Pi]; i != LIST_END;
-                 i = state_buckets[i].next)
+          // Keep the maximal blocks per label.
+          first[s] = buffer.size();
+          for (std::size_t i = 0; i < targets.size(); )
+          {
+            std::size_t j = i;
+            while (j < targets.size() && targets[j].first == targets[i].first)
+            {
+              j++;
+            }
+            for (std::size_t k = i; k < j; ++k)
             {
-              block_Pi[i] = s_Pi;
+              bool maximal = true;
+              for (std::size_t k1 = i; maximal && k1 < j; ++k1)
+              {
+                maximal = k1 == k || !block_simulated_by(targets[k].second, targets[k1].second);
+              }
+              if (maximal)
+              {
+                buffer.push_back(targets[k]);
+              }
             }
-            ++s_Pi;
+            i = j;
           }
-          stable[alpha][gamma] = true;
+          last[s] = buffer.size();
+          owner[s] = thread;
         }
-        untouch(alpha);
-      }
-    }
-  }
-}
+      }, 256);
 
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::reverse_topological_sort(std::vector<std::size_t>& Sort)
-{
-  std::vector<bool> visited(s_Sigma,false);
-  for (std::size_t u = 0; u < s_Sigma; ++u)
-  {
-    if (!visited[u])
-    {
-      dfs_visit(u,visited,Sort);
+      entries.clear();
+      std::vector<std::size_t> offset(number_of_threads);
+      for (std::size_t thread = 0; thread < number_of_threads; ++thread)
+      {
+        offset[thread] = entries.size();
+        entries.insert(entries.end(), buffers[thread].begin(), buffers[thread].end());
+      }
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        first[s] += offset[owner[s]];
+        last[s] += offset[owner[s]];
+      }
     }
-  }
-}
 
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::dfs_visit(std::size_t u,std::vector<bool>& visited,
-    std::vector<std::size_t> &Sort)
-{
-  visited[u] = true;
-  for (std::size_t v = 0; v < s_Sigma; ++v)
-  {
-    if (!visited[v] && P[u][v])
+    /// \brief Splits the blocks on the signatures of their states.
+    /// \param parent Is set to the old block of each new block.
+    /// \param representative Is set to a state of each new block.
+    void split(const std::vector<entry>& entries,
+               const std::vector<std::size_t>& first,
+               const std::vector<std::size_t>& last,
+               std::vector<std::size_t>& parent,
+               std::vector<std::size_t>& representative)
     {
-      dfs_visit(v,visited,Sort);
-    }
-  }
-  Sort.push_back(u);
-}
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::touch(std::size_t a,std::size_t alpha)
-{
-  state_touched[a] = true;
-  ptrdiff_t p = state_buckets[a].prev;
-  ptrdiff_t n = state_buckets[a].next;
-  if (p == LIST_END)
-  {
-    contents_u[alpha] = n;
-  }
-  else
-  {
-    state_buckets[p].next = n;
-  }
-  if (n != LIST_END)
-  {
-    state_buckets[n].prev = p;
-  }
-  state_buckets[a].prev = LIST_END;
-  state_buckets[a].next = contents_t[alpha];
-  if (contents_t[alpha] != LIST_END)
-  {
-    state_buckets[contents_t[alpha]].prev = a;
-  }
-  contents_t[alpha] = a;
-}
-
-/* PRE: contents_t[alpha] != LIST_END */
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::untouch(std::size_t alpha)
-{
-  // search linearly for the last element of contents_t[alpha];
-  // untouch every state we encounter along the way
-  ptrdiff_t i = contents_t[alpha];
-  while (state_buckets[i].next != LIST_END)
-  {
-    state_touched[i] = false;
-    i = state_buckets[i].next;
-  }
-  // last element has not been untouched yet
-  state_touched[i] = false;
-
-  // insert the list contents_t[alpha] at the beginning of
-  // contents_u[alpha]
-  state_buckets[i].next = contents_u[alpha];
-  if (contents_u[alpha] != LIST_END)
-  {
-    state_buckets[contents_u[alpha]].prev = i;
-  }
-  contents_u[alpha] = contents_t[alpha];
-  contents_t[alpha] = LIST_END;
-  block_touched[alpha] = false;
-}
-
-/* ----------------- UPDATE ----------------------------------------- */
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::update()
-{
-  using namespace mcrl2::core;
-  mCRL2log(log::debug) << "--------------------- Update ---------------------------------------" << std::endl;
-
-  std::size_t l,alpha,gamma;
-  std::vector<std::size_t>::iterator alphai, last;
-
-  induce_P_on_Pi();
-
-  initialise_pre_EA();
-
-  /* Compute the pre_exists and pre_forall functions */
-  for (l = 0; l < aut.num_action_labels(); ++l)
-  {
-    pre_exists[l].reserve(s_Sigma + 1);
-    pre_forall[l].reserve(s_Sigma + 1);
-    pre_exists[l].push_back(exists->get_num_elements());
-    pre_forall[l].push_back(forall->get_num_elements());
-    for (gamma = 0; gamma < s_Sigma; ++gamma)
-    {
-      touched_blocks.clear();
-      initialise_Sigma(gamma,l);
-      last = touched_blocks.end();
-      for (alphai = touched_blocks.begin(); alphai != last; ++alphai)
+      const std::size_t n = m_block.size();
+      auto hash = [&](std::size_t s)
       {
-        alpha = *alphai;
-        exists->add(alpha,l,gamma);
-        if (contents_u[alpha] == LIST_END)
+        std::size_t h = m_block[s];
+        for (std::size_t i = first[s]; i != last[s]; ++i)
         {
-          forall->add(alpha,l,gamma);
+          h = utilities::detail::hash_combine(h, utilities::detail::hash_combine(entries[i].first, entries[i].second));
         }
-        untouch(alpha);
+        return h;
+      };
+      auto equal = [&](std::size_t s, std::size_t t)
+      {
+        return m_block[s] == m_block[t]
+               && last[s] - first[s] == last[t] - first[t]
+               && std::equal(entries.begin() + first[s], entries.begin() + last[s], entries.begin() + first[t]);
+      };
+      std::unordered_map<std::size_t, std::size_t, decltype(hash), decltype(equal)> index(n, hash, equal);
+
+      parent.clear();
+      representative.clear();
+      std::vector<std::size_t> block(n);
+      for (std::size_t s = 0; s < n; ++s)
+      {
+        const std::size_t b = index.insert(std::make_pair(s, parent.size())).first->second;
+        if (b == parent.size())
+        {
+          parent.push_back(m_block[s]);
+          representative.push_back(s);
+        }
+        block[s] = b;
       }
-      pre_exists[l].push_back(exists->get_num_elements());
-      pre_forall[l].push_back(forall->get_num_elements());
+      m_block.swap(block);
     }
-  }
 
-  mCRL2log(log::debug) << "------ Filter(false) ------\nExists: ";
-  mCRL2log(log::debug) << print_structure(exists);
-  mCRL2log(log::debug) << "\nForall: ";
-  mCRL2log(log::debug) << print_structure(forall);
-  mCRL2log(log::debug) << "\nSimulation relation: ";
-  mCRL2log(log::debug) << print_relation(s_Pi,Q);
-
-  /* Apply the first filtering to Q */
-  filter(s_Sigma,P,false);
-
-
-  initialise_pre_EA();
-
-  /* Compute the pre_exists and pre_forall functions */
-  for (l = 0; l < aut.num_action_labels(); ++l)
-  {
-    pre_exists[l].reserve(s_Pi + 1);
-    pre_forall[l].reserve(s_Pi + 1);
-    pre_exists[l].push_back(exists->get_num_elements());
-    pre_forall[l].push_back(forall->get_num_elements());
-    for (gamma = 0; gamma < s_Pi; ++gamma)
+    /// \brief Computes the relation on the new blocks, and replaces the old relation by it.
+    /// \return True if the partition or the relation has changed.
+    bool refine_relation(const std::vector<entry>& entries,
+                         const std::vector<std::size_t>& first,
+                         const std::vector<std::size_t>& last,
+                         const std::vector<std::size_t>& parent,
+                         const std::vector<std::size_t>& representative,
+                         std::size_t number_of_threads)
     {
-      touched_blocks.clear();
-      initialise_Pi(gamma,l);
-      last = touched_blocks.end();
-      for (alphai = touched_blocks.begin(); alphai != last; ++alphai)
+      const std::size_t k = parent.size();
+      const std::size_t words = number_of_words(k);
+
+      // Initially, block b is below block c if their parents are related. The row of b is
+      // obtained by replacing the blocks in the row of its parent by their children.
+      std::vector<std::size_t> child_begin(m_number_of_blocks + 1, 0);
+      std::vector<std::size_t> children(k);
+      for (std::size_t c = 0; c < k; ++c)
+      {
+        child_begin[parent[c] + 1]++;
+      }
+      for (std::size_t b = 0; b < m_number_of_blocks; ++b)
+      {
+        child_begin[b + 1] += child_begin[b];
+      }
       {
-        alpha = *alphai;
-        exists->add(alpha,l,gamma);
-        if (contents_u[alpha] == LIST_END)
+        std::vector<std::size_t> position(child_begin.begin(), child_begin.end() - 1);
+        for (std::size_t c = 0; c < k; ++c)
         {
-          forall->add(alpha,l,gamma);
+          children[position[parent[c]]++] = c;
         }
-        untouch(alpha);
       }
-      pre_exists[l].push_back(exists->get_num_elements());
-      pre_forall[l].push_back(forall->get_num_elements());
-    }
-  }
-
-  mCRL2log(log::debug) << "------ Filter(true) ------\nExists: ";
-  mCRL2log(log::debug) << print_structure(exists);
-  mCRL2log(log::debug) << "\nForall: ";
-  mCRL2log(log::debug) << print_structure(forall);
-  mCRL2log(log::debug) << "\nSimulation relation: ";
-  mCRL2log(log::debug) << print_relation(s_Pi,Q);
-
-  /* Apply the second filtering to Q */
-  filter(s_Pi,Q,true);
-}
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::initialise_pre_EA()
-{
-  /* Initialise the pre_exists and pre_forall data structures */
-  exists->clear();
-  forall->clear();
-  std::vector<std::size_t> v;
-  pre_exists.assign(aut.num_action_labels(),v);
-  pre_forall.assign(aut.num_action_labels(),v);
-}
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::induce_P_on_Pi()
-{
-  /* Compute the relation induced on Pi by P, store it in Q */
-  std::vector<bool> v(s_Pi,false);
-  Q.assign(s_Pi,v);
-
-  std::size_t alpha,beta;
-  std::vector< std::vector<bool> >::iterator P_parent_alpha;
-  for (alpha = 0; alpha < s_Pi; ++alpha)
-  {
-    P_parent_alpha = P.begin() + parent[alpha];
-    for (beta = 0; beta < s_Pi; ++beta)
-    {
-      Q[alpha][beta] = (*P_parent_alpha)[parent[beta]];
-    }
-  }
-}
-
-
-/* ----------------- FILTER ----------------------------------------- */
-
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::filter(std::size_t S,std::vector< std::vector<bool> > &R,
-                                       bool B)
-{
-  /* Initialise the match function */
-  match->clear();
-
-  std::size_t alpha,beta,gamma,delta,l;
-  hash_table3_iterator etrans(exists);
-  for (l = 0; l < aut.num_action_labels(); ++l)
-  {
-    for (delta = 0; delta < S; ++delta)
-    {
-      etrans.set_end(pre_exists[l][delta+1]);
-      for (etrans.set(pre_exists[l][delta]); !etrans.is_end(); ++etrans)
+      std::vector<std::atomic<std::uint64_t> > relation(k * words);
+      utilities::parallel_for(k, number_of_threads, [&](std::size_t, std::size_t begin, std::size_t end)
       {
-        beta = etrans.get_x();
-        for (gamma = 0; gamma < S; ++gamma)
+        for (std::size_t b = begin; b < end; ++b)
         {
-          if (R[gamma][delta])
+          std::atomic<std::uint64_t>* q = relation.data() + b * words;
+          const std::atomic<std::uint64_t>* r = row(parent[b]);
+          for (std::size_t w = 0; w < m_words; ++w)
           {
-            match->add(l,beta,gamma);
+            std::uint64_t word = r[w].load(std::memory_order_relaxed);
+            while (word != 0)
+            {
+              const std::size_t c = w * 64 + lowest_bit(word);
+              word &= word - 1;
+              for (std::size_t i = child_begin[c]; i != child_begin[c + 1]; ++i)
+              {
+                q[children[i] / 64].fetch_or(std::uint64_t(1) << (children[i] % 64), std::memory_order_relaxed);
+              }
+            }
           }
         }
-      }
-    }
-  }
+      }, 64);
 
-  hash_table3_iterator atrans(forall);
-  /* The main for loop */
-  for (l = 0; l < aut.num_action_labels(); ++l)
-  {
-    for (gamma = 0; gamma < S; ++gamma)
-    {
-      atrans.set_end(pre_forall[l][gamma+1]);
-      for (atrans.set(pre_forall[l][gamma]); !atrans.is_end(); ++atrans)
+      // The distinct pairs (a, B) in the signatures of the new blocks, with for each pair the
+      // new blocks that have it in their signature, i.e. the new blocks that contain Pre_a(B).
+      std::vector<std::pair<entry, std::size_t> > holders;
+      for (std::size_t b = 0; b < k; ++b)
+      {
+        const std::size_t s = representative[b];
+        for (std::size_t i = first[s]; i != last[s]; ++i)
+        {
+          holders.push_back(std::make_pair(entries[i], b));
+        }
+      }
+      std::sort(holders.begin(), holders.end());
+      std::vector<entry> pairs;
+      std::vector<std::size_t> holder_begin;
+      for (std::size_t i = 0; i < holders.size(); ++i)
+      {
+        if (i == 0 || holders[i].first != holders[i - 1].first)
+        {
+          pairs.push_back(holders[i].first);
+          holder_begin.push_back(i);
+        }
+      }
+      holder_begin.push_back(holders.size());
+
+      // For each pair (a, B), intersect the rows of its holders with Pre_a(row(B)). The pairs
+      // are handled per label, such that the old blocks B of the pairs of a label can be
+      // found with a bit mask.
+      std::atomic<bool> changed(k != m_number_of_blocks);
+      std::vector<std::uint64_t> present(m_words, 0);
+      std::vector<std::vector<std::uint64_t> > pre(number_of_threads);
+      for (std::size_t label_begin = 0; label_begin < pairs.size(); )
       {
-        alpha = atrans.get_x();
-        for (beta = 0; beta < s_Pi; ++beta)
+        const std::size_t a = pairs[label_begin].first;
+        std::size_t label_end = label_begin;
+        while (label_end < pairs.size() && pairs[label_end].first == a)
         {
-          if (Q[alpha][beta] && !match->find(l,beta,gamma))
+          present[pairs[label_end].second / 64] |= std::uint64_t(1) << (pairs[label_end].second % 64);
+          label_end++;
+        }
+
+        utilities::parallel_for(label_end - label_begin, number_of_threads, [&](std::size_t thread, std::size_t begin, std::size_t end)
+        {
+          std::vector<std::uint64_t>& p = pre[thread];
+          for (std::size_t i = label_begin + begin; i < label_begin + end; ++i)
           {
-            Q[alpha][beta] = false;
-            if (B)
+            // p := Pre_a(row(B)), over the new blocks.
+            p.assign(words, 0);
+            const std::atomic<std::uint64_t>* r = row(pairs[i].second);
+            for (std::size_t w = 0; w < m_words; ++w)
+            {
+              std::uint64_t word = r[w].load(std::memory_order_relaxed) & present[w];
+              while (word != 0)
+              {
+                const entry e(a, w * 64 + lowest_bit(word));
+                word &= word - 1;
+                const std::size_t j = std::lower_bound(pairs.begin() + label_begin, pairs.begin() + label_end, e) - pairs.begin();
+                for (std::size_t h = holder_begin[j]; h != holder_begin[j + 1]; ++h)
+                {
+                  p[holders[h].second / 64] |= std::uint64_t(1) << (holders[h].second % 64);
+                }
+              }
+            }
+
+            // row(b) := row(b) /\ p for all holders b of (a, B).
+            for (std::size_t h = holder_begin[i]; h != holder_begin[i + 1]; ++h)
             {
-              cleanup(alpha,beta);
+              std::atomic<std::uint64_t>* q = relation.data() + holders[h].second * words;
+              for (std::size_t w = 0; w < words; ++w)
+              {
+                if ((q[w].load(std::memory_order_relaxed) & ~p[w]) != 0
+                    && (q[w].fetch_and(p[w], std::memory_order_relaxed) & ~p[w]) != 0)
+                {
+                  changed.store(true, std::memory_order_relaxed);
+                }
+              }
             }
           }
+        }, 16);
+
+        for (std::size_t i = label_begin; i < label_end; ++i)
+        {
+          present[pairs[i].second / 64] = 0;
         }
+        label_begin = label_end;
       }
-    }
-  }
-}
 
-/* ----------------- CLEANUP ---------------------------------------- */
+      m_relation.swap(relation);
+      m_number_of_blocks = k;
+      m_words = words;
+      return changed.load();
+    }
 
-template <class LTS_TYPE>
-void sim_partitioner<LTS_TYPE>::cleanup(std::size_t alpha,std::size_t beta)
-{
-  std::size_t l,alpha1,beta1,delta;
-  bool match_l_beta1_alpha;
-  hash_table3_iterator alpha1i(forall);
-  hash_table3_iterator beta1i(exists);
-  for (l = 0; l < aut.num_action_labels(); ++l)
-  {
-    alpha1i.set_end(pre_forall[l][alpha+1]);
-    beta1i.set_end(pre_exists[l][beta+1]);
-    for (beta1i.set(pre_exists[l][beta]); !beta1i.is_end(); ++beta1i)
+  public:
+    simulation_relation() = default;
+
+    /// \brief Computes the largest simulation that is contained in the initial relation.
+    /// \param outgoing The outgoing transitions per state
+    /// \param state_class For each state a class, that is smaller than number_of_classes
+    /// \param number_of_classes The number of classes
+    /// \param below A function such that below(c, d) is true if states of class c may be
+    ///        simulated by states of class d. It must be a partial order.
+    /// \param number_of_threads The number of threads; 0 means the number of hardware threads
+    /// \param max_blocks The maximum number of blocks. The bit matrix takes b^2 bits for b
+    ///        blocks; if the partition gets more than max_blocks blocks, the computation is
+    ///        abandoned before the matrix is allocated.
+    /// \return False if the computation was abandoned, in which case the relation is empty.
+    template <typename ClassOrder>
+    bool compute(const adjacency_index& outgoing,
+                 const std::vector<std::size_t>& state_class,
+                 std::size_t number_of_classes,
+                 ClassOrder below,
+                 std::size_t number_of_threads = 0,
+                 std::size_t max_blocks = std::size_t(-1))
     {
-      beta1 = beta1i.get_x();
-      match_l_beta1_alpha = false;
-      for (delta = 0; delta < s_Pi && !match_l_beta1_alpha; ++delta)
+      number_of_threads = utilities::number_of_threads(number_of_threads);
+      if (!initialise(state_class, number_of_classes, below, max_blocks))
       {
-        if (exists->find(beta1,l,delta) && Q[alpha][delta])
-        {
-          match_l_beta1_alpha = true;
-        }
+        clear();
+        return false;
       }
-      if (!match_l_beta1_alpha)
+
+      std::vector<entry> entries;
+      std::vector<std::size_t> first;
+      std::vector<std::size_t> last;
+      std::vector<std::size_t> parent;
+      std::vector<std::size_t> representative;
+      std::size_t rounds = 0;
+      bool changed = true;
+      while (changed)
       {
-        match->remove(l,beta1,alpha);
-        for (alpha1i.set(pre_forall[l][alpha]); !alpha1i.is_end();
-             ++alpha1i)
+        rounds++;
+        compute_signatures(outgoing, number_of_threads, entries, first, last);
+        split(entries, first, last, parent, representative);
+        if (parent.size() > max_blocks)
         {
-          alpha1 = alpha1i.get_x();
-          if (Q[alpha1][beta1])
-          {
-            Q[alpha1][beta1] = false;
-            cleanup(alpha1,beta1);
-          }
+          mCRL2log(log::verbose) << "Abandoned the simulation preorder after " << rounds << " rounds, since it has more than "
+                                 << max_blocks << " blocks.\n";
+          clear();
+          return false;
         }
+        changed = refine_relation(entries, first, last, parent, representative, number_of_threads);
+      }
+
+      // Group the states per block.
+      m_member_begin.assign(m_number_of_blocks + 1, 0);
+      for (std::size_t b: m_block)
+      {
+        m_member_begin[b + 1]++;
+      }
+      for (std::size_t b = 0; b < m_number_of_blocks; ++b)
+      {
+        m_member_begin[b + 1] += m_member_begin[b];
       }
+      m_members.resize(m_block.size());
+      std::vector<std::size_t> position(m_member_begin.begin(), m_member_begin.end() - 1);
+      for (std::size_t s = 0; s < m_block.size(); ++s)
+      {
+        m_members[position[m_block[s]]++] = s;
+      }
+      mCRL2log(log::verbose) << "Computed a simulation preorder on " << m_block.size() << " states with "
+                             << m_number_of_blocks << " blocks in " << rounds << " rounds.\n";
+      return true;
     }
-  }
-}
 
-/* ----------------- FOR POST-PROCESSING ---------------------------- */
+    /// \brief Returns true if the relation has not been computed.
+    bool empty() const
+    {
+      return m_block.empty();
+    }
 
-template <class LTS_TYPE>
-std::vector < mcrl2::lts::transition> sim_partitioner<LTS_TYPE>::get_transitions() const
-{
-  using namespace mcrl2::lts;
+    /// \brief Returns the number of blocks, i.e. the number of equivalence classes of the relation.
+    std::size_t number_of_blocks() const
+    {
+      return m_number_of_blocks;
+    }
 
-  std::vector < mcrl2::lts::transition> ts;
-  ts.reserve(forall->get_num_elements());
+    /// \brief Returns the block of state s.
+    std::size_t block(std::size_t s) const
+    {
+      return m_block[s];
+    }
 
-  std::vector<bool> pre_sim;
-  transition::size_type l,beta,gamma;
-  hash_table3_iterator alphai(exists);
-  hash_table3_iterator gammai(forall);
-  for (beta = 0; beta < s_Pi; ++beta)
-  {
-    for (l = 0; l < aut.num_action_labels(); ++l)
+    /// \brief Returns true if the states of block b are simulated by the states of block c.
+    bool block_simulated_by(std::size_t b, std::size_t c) const
+    {
+      return (row(b)[c / 64].load(std::memory_order_relaxed) >> (c % 64)) & 1;
+    }
+
+    /// \brief Returns true if s is simulated by t.
+    bool simulated_by(std::size_t s, std::size_t t) const
     {
-      // there is an l-transition from alpha to beta iff:
-      // - alpha -l->A [beta]
-      // - not Exists gamma : beta Q gamma  /\  alpha -l->E gamma
-      // first compute for which alpha the latter statement does not
-      // hold
-      pre_sim.assign(s_Pi,false);
-      for (gamma = 0; gamma < s_Pi; ++gamma)
+      return block_simulated_by(m_block[s], m_block[t]);
+    }
+
+    /// \brief Applies f to all states of block b.
+    template <typename Function>
+    void for_each_member(std::size_t b, Function f) const
+    {
+      for (std::size_t i = m_member_begin[b]; i != m_member_begin[b + 1]; ++i)
       {
-        // only consider gammas that are unequal to beta
-        if (gamma != beta && Q[beta][gamma])
-        {
-          alphai.set_end(pre_exists[l][gamma+1]);
-          for (alphai.set(pre_exists[l][gamma]); !alphai.is_end();
-               ++alphai)
-          {
-            pre_sim[alphai.get_x()] = true;
-          }
-        }
+        f(m_members[i]);
       }
-      gammai.set_end(pre_forall[l][beta+1]);
-      for (gammai.set(pre_forall[l][beta]); !gammai.is_end(); ++gammai)
+    }
+
+    /// \brief Applies f to all states that simulate s.
+    template <typename Function>
+    void for_each_simulating_state(std::size_t s, Function f) const
+    {
+      const std::atomic<std::uint64_t>* r = row(m_block[s]);
+      for (std::size_t w = 0; w < m_words; ++w)
       {
-        gamma = gammai.get_x();
-        if (!pre_sim[gamma])
+        std::uint64_t word = r[w].load(std::memory_order_relaxed);
+        while (word != 0)
         {
-          // add the transition gamma -l-> beta
-          ts.push_back(transition(gamma,l,beta));
+          for_each_member(w * 64 + lowest_bit(word), f);
+          word &= word - 1;
         }
       }
     }
-  }
-  return ts;
-}
 
-template <class LTS_TYPE>
-std::size_t sim_partitioner<LTS_TYPE>::num_eq_classes() const
-{
-  return s_Pi;
-}
-
-template <class LTS_TYPE>
-std::size_t sim_partitioner<LTS_TYPE>::get_eq_class(std::size_t s) const
-{
-  return block_Pi[s];
-}
-
-template <class LTS_TYPE>
-bool sim_partitioner<LTS_TYPE>::in_preorder(std::size_t s,std::size_t t) const
-{
-  return Q[block_Pi[s]][block_Pi[t]];
-}
+    /// \brief Releases the memory of the relation.
+    void clear()
+    {
+      std::vector<std::size_t>().swap(m_block);
+      std::vector<std::atomic<std::uint64_t> >().swap(m_relation);
+      std::vector<std::size_t>().swap(m_member_begin);
+      std::vector<std::size_t>().swap(m_members);
+      m_number_of_blocks = 0;
+      m_words = 0;
+    }
+};
 
+/// \brief Computes the (ready) simulation preorder of an LTS, and the quotient modulo
+/// (ready) simulation equivalence.
+/// \details The preorder is computed with a simulation_relation, whose blocks are the
+/// equivalence classes. For simulation the initial relation relates states s and t if the
+/// enabled actions of s are contained in those of t, for ready simulation if they are equal.
 template <class LTS_TYPE>
-bool sim_partitioner<LTS_TYPE>::in_same_class(std::size_t s,std::size_t t) const
+class sim_partitioner
 {
-  return (block_Pi[s] == block_Pi[t]);
-}
+  protected:
+    const LTS_TYPE& aut;
+    bool m_ready;
+    std::size_t m_number_of_threads;
+    simulation_relation m_relation;
 
-/*
-// PRE: FORALL and EXISTS structures on Pi are computed
-void sim_partitione<LTS_TYPE>r::update_nfa()
-{
-  std::vector< std::vector<std::size_t> > v(s_Pi);
-  std::vector< std::vector< std::vector<std::size_t> > > post_trans(L,v);
+  public:
+    /** Creates a partitioner for an LTS.
+     * \param[in] l The LTS.
+     * \param[in] ready If true, ready simulation is computed instead of simulation.
+     * \param[in] number_of_threads The number of threads; 0 means the number of hardware threads. */
+    sim_partitioner(const LTS_TYPE& l, bool ready = false, std::size_t number_of_threads = 0)
+      : aut(l),
+        m_ready(ready),
+        m_number_of_threads(number_of_threads)
+    {}
 
-  std::vector<bool> pre_sim;
-  std::size_t l,beta,alpha,gamma;
-  hash_table3_iterator alphai(exists);
-  hash_table3_iterator gammai(forall);
-  for (beta = 0; beta < s_Pi; ++beta)
-  {
-    for (l = 0; l < aut.num_action_labels(); ++l)
+    /** Computes the simulation equivalence classes and preorder
+     * relations of the LTS. */
+    void partitioning_algorithm()
     {
-      // there is an l-transition from alpha to beta iff:
-      // - alpha -l->A [beta]
-      // - not Exists gamma : beta Q gamma  /\  alpha -l->E gamma
-      // first compute for which alpha the latter statement does not
-      // hold
-      pre_sim.assign(s_Pi,false);
-      for (gamma = 0; gamma < s_Pi; ++gamma)
+      const std::size_t n = aut.num_states();
+      const adjacency_index& outgoing = aut.outgoing_transition_index();
+
+      // The initial classes are the sets of enabled actions.
+      std::map<std::vector<std::size_t>, std::size_t> index;
+      std::vector<std::vector<std::size_t> > enabled;
+      std::vector<std::size_t> state_class(n);
+      std::vector<std::size_t> labels;
+      for (std::size_t s = 0; s < n; ++s)
       {
-        // only consider gammas that are unequal to beta
-        if (gamma != beta && Q[beta][gamma])
+        labels.clear();
+        for (const adjacent_transition& t: outgoing.transitions(s))
         {
-          alphai.set_end(pre_exists[l][gamma+1]);
-          for (alphai.set(pre_exists[l][gamma]); !alphai.is_end();
-              ++alphai)
+          if (labels.empty() || labels.back() != t.label)
           {
-            pre_sim[alphai.get_x()] = true;
+            labels.push_back(t.label);
           }
         }
-      }
-      gammai.set_end(pre_forall[l][beta+1]);
-      for (gammai.set(pre_forall[l][beta]); !gammai.is_end(); ++gammai)
-      {
-        gamma = gammai.get_x();
-        if (!pre_sim[gamma])
+        const std::map<std::vector<std::size_t>, std::size_t>::const_iterator i = index.insert(std::make_pair(labels, enabled.size())).first;
+        if (i->second == enabled.size())
         {
-          post_trans[l][gamma].push_back(beta);
+          enabled.push_back(labels);
         }
+        state_class[s] = i->second;
       }
-    }
-  }
 
-  std::vector<transition> *trans = new std::vector<transition> ();
-  std::vector<bool> *final = new std::vector<bool> ();
+      m_relation.compute(outgoing, state_class, enabled.size(),
+        [&](std::size_t c, std::size_t d)
+        {
+          return m_ready ? c == d : std::includes(enabled[d].begin(), enabled[d].end(), enabled[c].begin(), enabled[c].end());
+        },
+        m_number_of_threads);
+      mCRL2log(log::verbose) << "The LTS has " << m_relation.number_of_blocks() << " " << (m_ready ? "ready " : "") << "simulation equivalence classes.\n";
+    }
 
-  // Do a breadth first search over the computed graph to assign ids to
-  // the reachable blocks and construct the final transition relation
-  std::vector<std::size_t>::iterator post_it,post_last;
-  std::queue<std::size_t> todo;
-  std::vector<std::size_t> block_id(s_Pi,s_Pi);
-  todo.push(block_Pi[aut.initial_state()]);
-  block_id[block_Pi[aut.initial_state()]] = 0;
-  std::size_t n_s = 1;
-  std::size_t n_f = 0;
-  if (aut.is_final(aut.initial_state()))
-  {
-    final->push_back(true);
-    ++n_f;
-  }
-  else
-  {
-    final->push_back(false);
-  }
-  while (!todo.empty())
-  {
-    // visit todo.front()
-    beta = todo.front();
-    for (l = 0; l < L; ++l)
+    /** Gives the transition relation on the computed equivalence
+     * classes of the LTS. The label numbers of the transitions
+     * correspond to the label numbers of the LTS that was passed as an
+     * argument to the constructor of this partitioner, after applying
+     * the hidden label map. The state numbers of the transitions are
+     * the equivalence class numbers which range from 0 upto (and excluding)
+     * \ref num_eq_classes(). Only the transitions to maximal classes are kept,
+     * i.e. there is a transition b -a-> c if some state of b has an a-transition
+     * to c, and there is no other class c' above c to which b has an a-transition.
+     *
+     * \pre The simulation equivalence classes have been computed.
+     * \return A vector containing the transitions between the
+     * simulation equivalence classes. */
+    std::vector<transition> get_transitions() const
     {
-      post_last = post_trans[l][beta].end();
-      for (post_it = post_trans[l][beta].begin(); post_it != post_last;
-          ++post_it)
+      const adjacency_index& outgoing = aut.outgoing_transition_index();
+      std::vector<transition> result;
+      std::vector<std::pair<std::size_t, std::size_t> > targets;
+      for (std::size_t b = 0; b < m_relation.number_of_blocks(); ++b)
       {
-        alpha = *post_it;
-        if (block_id[alpha] == s_Pi)
+        targets.clear();
+        m_relation.for_each_member(b, [&](std::size_t s)
+        {
+          for (const adjacent_transition& t: outgoing.transitions(s))
+          {
+            targets.push_back(std::make_pair(t.label, m_relation.block(t.state)));
+          }
+        });
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        for (std::size_t i = 0; i < targets.size(); )
         {
-          todo.push(alpha);
-          block_id[alpha] = n_s;
-          ++n_s;
-          if (aut.is_final(contents_u[alpha]))
+          std::size_t j = i;
+          while (j < targets.size() && targets[j].first == targets[i].first)
           {
-            final->push_back(true);
-            ++n_f;
+            j++;
           }
-          else
+          for (std::size_t k = i; k < j; ++k)
           {
-            final->push_back(false);
+            bool maximal = true;
+            for (std::size_t k1 = i; maximal && k1 < j; ++k1)
+            {
+              maximal = k1 == k || !m_relation.block_simulated_by(targets[k].second, targets[k1].second);
+            }
+            if (maximal)
+            {
+              result.push_back(transition(b, targets[k].first, targets[k].second));
+            }
           }
+          i = j;
         }
-        transition t = {block_id[beta], l, block_id[alpha]};
-        trans->push_back(t);
       }
+      return result;
     }
-    todo.pop();
-  }
 
-  // assign the new transition relation to aut
-  aut.clear_transition_relation();
-  aut.clear_final();
-  aut.set_num_states(n_s);
-  aut.set_num_transitions(trans->size());
-  aut.set_num_final(n_f);
-  aut.set_init(0);
-  aut.set_trans(trans);
-  aut.set_final(final);
-
-  // assign the simulation relation to aut
-  aut.init_simulation_relation();
-  for (beta = 0; beta < s_Pi; ++beta)
-  {
-    // only consider reachable blocks
-    if (block_id[beta] < s_Pi)
+    /** Gives the number of simulation equivalence classes of the LTS.
+     * \pre The simulation equivalence classes have been computed.
+     * \return The number of simulation equivalence classes of the LTS.
+     */
+    std::size_t num_eq_classes() const
     {
-      for (gamma = 0; gamma < s_Pi; ++gamma)
-      {
-        if (block_id[gamma] < s_Pi && Q[beta][gamma])
-        {
-          aut.add_simulation(block_id[beta],block_id[gamma]);
-        }
-      }
+      return m_relation.number_of_blocks();
     }
-  }
-}
-*/
-
-/* ----------------- FOR DEBUGGING ---------------------------------- */
 
-template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_Sigma_P()
-{
-  using namespace mcrl2::core;
-  std::stringstream result;
-  result << print_Sigma() << "Simulation relation: " << print_relation(s_Sigma,P);
-  return result.str();
-}
+    /** Gives the equivalence class number of a state.
+     * The equivalence class numbers range from 0 upto (and excluding)
+     * \ref num_eq_classes().
+     * \pre The simulation equivalence classes have been computed.
+     * \param[in] s A state number.
+     * \return The number of the equivalence class to which \e s
+     * belongs. */
+    std::size_t get_eq_class(std::size_t s) const
+    {
+      return m_relation.block(s);
+    }
 
-template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_Pi_Q()
-{
-  using namespace mcrl2::core;
-  std::stringstream result;
-  result << print_Pi() << "Simulation relation: " << print_relation(s_Pi,Q);
-  return result.str();
-}
+    /** Returns whether one state is simulated by another state.
+     * \pre The simulation preorder has been computed.
+     * \param[in] s A state number.
+     * \param[in] t A state number.
+     * \retval true if \e s is simulated by \e t;
+     * \retval false otherwise. */
+    bool in_preorder(std::size_t s, std::size_t t) const
+    {
+      return m_relation.simulated_by(s, t);
+    }
 
-template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_Sigma()
-{
-  using namespace mcrl2::core;
-  std::stringstream result;
-  std::vector<std::size_t>::iterator ci, last;
-  for (std::size_t b = 0; b < s_Sigma; ++b)
-  {
-    result << "block " << b << ": {";
-    last = children[b].end();
-    for (ci = children[b].begin(); ci != last; ++ci)
+    /** Returns whether two states are in the same simulation
+     * equivalence class.
+     * \pre The simulation equivalence classes have been computed.
+     * \param[in] s A state number.
+     * \param[in] t A state number.
+     * \retval true if \e s and \e t are in the same simulation
+     * equivalence class;
+     * \retval false otherwise. */
+    bool in_same_class(std::size_t s, std::size_t t) const
     {
-      result << print_block(*ci);
+      return m_relation.block(s) == m_relation.block(t);
     }
-    result << "}" << std::endl;
-  }
-  return result.str();
-}
+};
 
+/** \brief Reduces an LTS modulo (ready) simulation equivalence.
+ * \details The LTS is first reduced modulo strong bisimulation, which is finer than
+ *          (ready) simulation equivalence, to reduce the number of blocks. Only the
+ *          transitions to maximal classes are kept. The state labels are removed.
+ * \param[in,out] l The transition system that is reduced.
+ * \param[in] ready If true, ready simulation is used instead of simulation. */
 template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_Pi()
+void simulation_reduce(LTS_TYPE& l, const bool ready = false)
 {
-  std::stringstream result;
-  using namespace mcrl2::core;
-  for (std::size_t b = 0; b < s_Pi; ++b)
-  {
-    result << "block " << b << ": {" << print_block(b) << "}" << std::endl;
-  }
-  return result.str();
-}
+  bisimulation_reduce_gjkw(l, false, false);
 
-template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_block(std::size_t b)
-{
-  std::stringstream result;
-  using namespace mcrl2::core;
-  for (ptrdiff_t i = contents_u[b]; i != LIST_END; i = state_buckets[i].next)
-  {
-    result << i << ",";
-  }
-  for (ptrdiff_t i = contents_t[b]; i != LIST_END; i = state_buckets[i].next)
-  {
-    result << i << ",";
-  }
-  return result.str();
-}
+  sim_partitioner<LTS_TYPE> sp(l, ready);
+  sp.partitioning_algorithm();
+  const std::vector<transition> transitions = sp.get_transitions();
+  const std::size_t initial_state = sp.get_eq_class(l.initial_state());
 
-template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_relation(std::size_t s,
-    std::vector< std::vector<bool> > &R)
-{
-  using namespace mcrl2::core;
-  std::stringstream result;
-  result << "{";
-  std::size_t beta,gamma;
-  for (beta = 0; beta < s; ++beta)
+  // Clear this LTS, but keep the labels
+  l.clear_state_labels();
+  l.clear_transitions();
+  l.set_num_states(sp.num_eq_classes());
+  l.set_initial_state(initial_state);
+  for (const transition& t: transitions)
   {
-    for (gamma = 0; gamma < s; ++gamma)
-    {
-      if (R[beta][gamma])
-      {
-        result << "(" << beta << "," << gamma << "),";
-      }
-    }
+    l.add_transition(t);
   }
-  result << "}" << std::endl;
-  return result.str();
 }
 
+/** \brief Checks whether the initial state of l1 is (ready) simulated by, or (ready)
+ *         simulation equivalent to, the initial state of l2.
+ * \details The LTSs l1 and l2 are not usable anymore after this call. They are first
+ *          reduced modulo strong bisimulation, and then merged.
+ * \param[in,out] l1 A first transition system.
+ * \param[in,out] l2 A second transition system.
+ * \param[in] ready If true, ready simulation is used instead of simulation.
+ * \param[in] equivalence If true, equivalence is checked instead of the preorder. */
 template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_structure(hash_table3* struc)
+bool destructive_simulation_compare(LTS_TYPE& l1, LTS_TYPE& l2, const bool ready, const bool equivalence)
 {
-  using namespace mcrl2::core;
-  std::stringstream result;
-  result << "{";
-  hash_table3_iterator i(struc);
-  for (; !i.is_end(); ++i)
-  {
-    result << "(" << i.get_x() << "," << mcrl2::lts::pp(aut.action_label(i.get_y()))
-           << "," << i.get_z() << "),";
-  }
-  result << "}";
-  return result.str();
-}
+  bisimulation_reduce_gjkw(l1, false, false);
+  bisimulation_reduce_gjkw(l2, false, false);
 
-template <class LTS_TYPE>
-std::string sim_partitioner<LTS_TYPE>::print_reverse_topological_sort(const std::vector<std::size_t> &Sort)
-{
-  using namespace mcrl2::core;
-  std::stringstream result;
-  result << "reverse topological sort is: [";
-  for (std::size_t i = 0; i < Sort.size(); ++i)
-    {
-      result << Sort[i];
-      if (i+1 < Sort.size())
-	{
-	  result << ",";
-	}
-    }
-  result << "]" << std::endl;
-  return result.str();
-} 
+  // In the merged LTS, the initial state i of l2 has number i + N, where N is the
+  // number of states of l1.
+  const std::size_t init_l2 = l2.initial_state() + l1.num_states();
+  detail::merge(l1, l2);
+  l2.clear(); // l2 is not needed anymore.
 
+  sim_partitioner<LTS_TYPE> sp(l1, ready);
+  sp.partitioning_algorithm();
+  return equivalence ? sp.in_same_class(l1.initial_state(), init_l2) : sp.in_preorder(l1.initial_state(), init_l2);
+}
 
 } // namespace detail
 } // namespace lts
 } // namespace mcrl2
-#endif
+
+#endif // LIBLTS_SIM_H
@@ -11,9 +11,13 @@
 #ifndef _LIBLTS_TAUSTARREDUCE_H
 #define _LIBLTS_TAUSTARREDUCE_H
 
+#include <algorithm>
+#include <memory>
+#include <vector>
 #include "mcrl2/utilities/logger.h"
 #include "mcrl2/lts/lts_utilities.h"
 #include "mcrl2/lts/probabilistic_lts.h"
+#include "mcrl2/lts/detail/tarjan_components.h"
 
 namespace mcrl2
 {
@@ -49,18 +53,12 @@ std::map < std::size_t,
   map_from_states_to_states resulting_tau_transitions;
 
   // Copy the internal transitions into the result.
-  for(std::vector < mcrl2::lts::transition>::const_iterator i=l.get_transitions().begin(); i!=l.get_transitions().end(); ++i)
+  const adjacency_index& index = forward ? l.outgoing_transition_index() : l.incoming_transition_index();
+  for (state_t s = 0; s < index.num_states(); ++s)
   {
-    if (l.is_tau(l.apply_hidden_label_map(i->label())))
+    for (const adjacent_transition& t: index.transitions(s, l.tau_label_index()))
     {
-      if (forward) 
-      { 
-        resulting_tau_transitions[i->from()].insert(i->to());
-      }
-      else
-      {
-        resulting_tau_transitions[i->to()].insert(i->from());
-      }
+      resulting_tau_transitions[s].insert(t.state);
     }
   }
 
@@ -145,131 +143,165 @@ void remove_redundant_transitions(lts<STATE_LABEL_T, ACTION_LABEL_T, LTS_BASE_CL
   typedef typename lts<STATE_LABEL_T, ACTION_LABEL_T, LTS_BASE_CLASS>::states_size_type state_type;
   typedef typename lts<STATE_LABEL_T, ACTION_LABEL_T, LTS_BASE_CLASS>::labels_size_type label_type;
 
-  outgoing_transitions_per_state_t outgoing_transitions=transitions_per_outgoing_state(l.get_transitions());
+  // The index is shared, such that it remains available when the transitions are cleared.
+  // The labels in the index are those after applying the hidden label map; the
+  // transitions that are kept are added again with their original label.
+  const std::shared_ptr<const adjacency_index> outgoing_transition_index=l.shared_outgoing_transition_index();
+  const adjacency_index& outgoing_transitions=*outgoing_transition_index;
+  const label_type tau=l.tau_label_index();
+  std::vector<transition> transitions;
+  transitions.swap(l.get_transitions());
   l.clear_transitions();
-  std::set < state_type > states_reachable_in_one_visible_action;
-  std::set < state_type > states_reachable_in_one_hidden_action;
 
-  for(outgoing_transitions_per_state_t::const_iterator i=outgoing_transitions.begin(); i!=outgoing_transitions.end(); ++i)
+  // Returns true if there is a transition from -label-> to.
+  auto has_transition=[&](const state_type from, const label_type label, const state_type to)
   {
-    const state_type from_=from(i);
-    const label_type label_=label(i);
-    const state_type to_=to(i);
-
-    states_reachable_in_one_visible_action.clear();
-    states_reachable_in_one_hidden_action.clear();
+    const adjacent_transition_range r=outgoing_transitions.transitions(from, label);
+    return std::binary_search(r.begin(), r.end(), adjacent_transition{ label, to });
+  };
 
-    // For every transition from-label->to we calculate the sets { s | from -a->s } and { s | from -tau-> s }.
-    for(outgoing_transitions_per_state_t::const_iterator j=outgoing_transitions.lower_bound(from_);
-                    j!=outgoing_transitions.upper_bound(from_); ++j)
-    {
-      if (l.is_tau(l.apply_hidden_label_map(label(j))))
-      {
-        states_reachable_in_one_hidden_action.insert(to(j));
-      }
-      else if (label_==label(j))
-      {
-        assert(!l.is_tau(l.apply_hidden_label_map(label_)));
-        states_reachable_in_one_visible_action.insert(to(j)); 
-      }
-    }
+  for(const transition& t: transitions)
+  {
+    const state_type from_=t.from();
+    const label_type label_=l.apply_hidden_label_map(t.label());
+    const state_type to_=t.to();
 
-    // Now check whether to is reachable in one step from one of the two sets constructed above. If no,
-    // insert the transition in l.transitions. 
+    // Find a step from -tau-> middle -label-> to. If label is hidden this is a
+    // sequence of two hidden steps.
     bool found=false;
-    
-    for(const state_type& middle: states_reachable_in_one_hidden_action)
+    for(const adjacent_transition& middle: outgoing_transitions.transitions(from_, tau))
     {
-      // Find a visible step from state middle to state to, unless label is hidden, in which case we search
-      // a hidden step. 
-      for(outgoing_transitions_per_state_t::const_iterator j=outgoing_transitions.lower_bound(middle);
-                  !found && j!=outgoing_transitions.upper_bound(middle); ++j)
+      if (has_transition(middle.state, label_, to_))
       {
-        if (l.is_tau(l.apply_hidden_label_map(label_)))
-        { 
-          if (l.is_tau(l.apply_hidden_label_map(label(j))) && to(j)==to_)
-          {
-            assert(!found);
-            found=true; break;
-          }
-        }
-        else // label is visible.
-        {
-          if (label(j)==label_ && to(j)==to_)
-          {
-            assert(!found);
-            found=true; break;
-          }
-        }
+        found=true;
+        break;
       }
-      if (found) break;
     }
-    
-    if (!found && !l.is_tau(l.apply_hidden_label_map(label_)))
+
+    // Find a step from -label-> middle -tau-> to.
+    if (!found && label_!=tau)
     {
-      for(const state_type& middle: states_reachable_in_one_visible_action)
+      for(const adjacent_transition& middle: outgoing_transitions.transitions(from_, label_))
       {
-        // Find a hidden step from state middle to state to.
-        for(outgoing_transitions_per_state_t::const_iterator j=outgoing_transitions.lower_bound(middle);
-                    !found && j!=outgoing_transitions.upper_bound(middle); ++j)
+        if (has_transition(middle.state, tau, to_))
         {
-          if (l.is_tau(l.apply_hidden_label_map(label(j))) && to(j)==to_)
-          { 
-            assert(!found);
-            found=true; break;
-          } 
+          found=true;
+          break;
         }
-        if (found) break;
       }
     }
 
     // If no alternative transition is found, add this transition to l.transitions().
     if (!found) 
     {
-      l.add_transition(transition(from_, label_, to_));
+      l.add_transition(t);
     }
-  }  
+  }
 }
 
 
+/// \brief Replaces every sequence tau* a by a single transition a, and removes all tau transitions.
+/// \details The tau strongly connected components are collapsed first. The visible
+///          transitions that can be done after tau steps are then collected per
+///          component, in topological order of the acyclic tau graph, as sorted
+///          vectors. This takes time and memory linear in the size of the result.
 template < class STATE_LABEL_T, class ACTION_LABEL_T, class LTS_BASE_CLASS >
 void tau_star_reduce(lts< STATE_LABEL_T, ACTION_LABEL_T, LTS_BASE_CLASS >& l)
-// This method assumes there are no tau loops!
 {
-  using namespace std;
-  typedef typename lts<STATE_LABEL_T, ACTION_LABEL_T, LTS_BASE_CLASS>::states_size_type state_t;
-  vector < transition >& original_transitions=l.get_transitions();
-  set < transition> new_transitions;
+  typedef std::pair<std::size_t, std::size_t> label_state_pair;
+  const std::size_t n=l.num_states();
 
-  // Add all the original non tau transitions.
-  for(std::vector < transition >::const_iterator i=original_transitions.begin(); i!=original_transitions.end(); ++i)
+  // Split the transitions in tau transitions and visible transitions, grouped by source.
+  std::vector<bool> is_tau(l.num_action_labels());
+  for(std::size_t a=0; a<l.num_action_labels(); ++a)
+  {
+    is_tau[a]=l.is_tau(l.apply_hidden_label_map(a));
+  }
+  std::vector<std::size_t> tau_begin(n+1, 0);
+  std::vector<std::size_t> visible_begin(n+1, 0);
+  for(const transition& t: l.get_transitions())
   {
-    if (!l.is_tau(l.apply_hidden_label_map(i->label())))
+    (is_tau[t.label()] ? tau_begin : visible_begin)[t.from()+1]++;
+  }
+  for(std::size_t s=0; s<n; ++s)
+  {
+    tau_begin[s+1]+=tau_begin[s];
+    visible_begin[s+1]+=visible_begin[s];
+  }
+  std::vector<std::size_t> tau_successors(tau_begin[n]);
+  std::vector<label_state_pair> visible(visible_begin[n]);
+  {
+    std::vector<std::size_t> tau_position(tau_begin.begin(), tau_begin.end()-1);
+    std::vector<std::size_t> visible_position(visible_begin.begin(), visible_begin.end()-1);
+    for(const transition& t: l.get_transitions())
     {
-      new_transitions.insert(*i);
+      if (is_tau[t.label()])
+      {
+        tau_successors[tau_position[t.from()]++]=t.to();
+      }
+      else
+      {
+        visible[visible_position[t.from()]++]=label_state_pair(t.label(), t.to());
+      }
     }
   }
 
-  // Add for every tau*.a transitions sequence a single transition a, provided a is not tau.
-  map <state_t, set <state_t> > backward_tau_closure=calculate_non_reflexive_transitive_tau_closure(l,false);
-  for(std::vector < transition >::const_iterator i=original_transitions.begin(); i!=original_transitions.end(); ++i)
+  // Collapse the tau strongly connected components.
+  std::vector<std::size_t> component;
+  const std::size_t number_of_components=tarjan_components(tau_begin, tau_successors, component);
+  std::vector<std::size_t> member_begin(number_of_components+1, 0);
+  for(std::size_t s=0; s<n; ++s)
+  {
+    member_begin[component[s]+1]++;
+  }
+  for(std::size_t c=0; c<number_of_components; ++c)
+  {
+    member_begin[c+1]+=member_begin[c];
+  }
+  std::vector<std::size_t> members(n);
+  {
+    std::vector<std::size_t> position(member_begin.begin(), member_begin.end()-1);
+    for(std::size_t s=0; s<n; ++s)
+    {
+      members[position[component[s]]++]=s;
+    }
+  }
+
+  // The visible transitions after tau* of component c are reachable[reachable_begin[c], reachable_begin[c+1]).
+  // The tau successors of a component have a smaller number, so they are done before it.
+  std::vector<std::size_t> reachable_begin(number_of_components+1, 0);
+  std::vector<label_state_pair> reachable;
+  std::vector<label_state_pair> scratch;
+  for(std::size_t c=0; c<number_of_components; ++c)
   {
-    if (!l.is_tau(l.apply_hidden_label_map(i->label())))
+    scratch.clear();
+    for(std::size_t j=member_begin[c]; j<member_begin[c+1]; ++j)
     {
-      set<state_t>& new_from_states=backward_tau_closure[i->from()];
-      for(typename set<state_t>::const_iterator j=new_from_states.begin(); j!=new_from_states.end(); ++j)
+      const std::size_t s=members[j];
+      scratch.insert(scratch.end(), visible.begin()+visible_begin[s], visible.begin()+visible_begin[s+1]);
+      for(std::size_t k=tau_begin[s]; k<tau_begin[s+1]; ++k)
       {
-        new_transitions.insert(transition(*j,i->label(),i->to()));
+        const std::size_t d=component[tau_successors[k]];
+        if (d!=c)
+        {
+          scratch.insert(scratch.end(), reachable.begin()+reachable_begin[d], reachable.begin()+reachable_begin[d+1]);
+        }
       }
     }
+    std::sort(scratch.begin(), scratch.end());
+    reachable.insert(reachable.end(), scratch.begin(), std::unique(scratch.begin(), scratch.end()));
+    reachable_begin[c+1]=reachable.size();
   }
+
+  // The new transitions are added sorted on source, label and target.
   l.clear_transitions();
-  
-  // Add the newly generated transitions
-  for(set < transition >::const_iterator i=new_transitions.begin();
-            i!=new_transitions.end(); ++i)
+  for(std::size_t s=0; s<n; ++s)
   {
-    l.add_transition(*i);
+    const std::size_t c=component[s];
+    for(std::size_t k=reachable_begin[c]; k<reachable_begin[c+1]; ++k)
+    {
+      l.add_transition(transition(s, reachable[k].first, reachable[k].second));
+    }
   }
 
   reachability_check(l, true); // Remove unreachable parts.
@@ -7,10 +7,10 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 //
 /// \file lts/detail/liblts_weak_bisim.h
-/// \brief This file defines an algorithm for weak bisimulation, by
-///        calculating the transitive tau closure and apply strong
-///        bisimulation afterwards. In order to apply this algorithm
-///        it is advisable to first apply a branching bisimulation reduction.
+/// \brief This file defines an algorithm for weak bisimulation. After a
+///        branching bisimulation reduction, signature refinement with weak
+///        signatures is applied. The weak signatures are computed on the fly
+///        from the tau graph, so the transitive tau closure is not calculated.
 
 #ifndef _LIBLTS_WEAK_BISIM_H
 #define _LIBLTS_WEAK_BISIM_H
@@ -26,6 +26,7 @@
 #include "mcrl2/lts/lts_aut.h"
 #include "mcrl2/lts/lts_fsm.h"
 #include "mcrl2/lts/lts_dot.h"
+#include "mcrl2/lts/sigref.h"
 
 namespace mcrl2
 {
@@ -35,6 +36,12 @@ namespace detail
 {
 
 /** \brief Reduce LTS l with respect to (divergence-preserving) weak bisimulation.
+ * \details The tau closure of l is not stored. Instead, the weak signatures and the
+ *          sets of blocks that are reachable by tau steps are computed per tau component,
+ *          and equal sets are stored once. This takes O(n + m + t*L*b*b) memory, where
+ *          n, m, L and b are the numbers of states, transitions, labels and blocks, and t
+ *          is the number of threads (see signature_weak_bisim). The tau closure can take
+ *          O(n*n) memory.
  * \param[in/out] l The transition system that is reduced.
  * \param[in] preserve_divergences Indicates whether loops of internal actions on states must be preserved. If false
  *            these are removed. If true these are preserved.  */
@@ -46,17 +53,23 @@ void weak_bisimulation_reduce(
   bisimulation_reduce_gjkw(l, true, preserve_divergences);
   //< Apply branching bisimulation to l.
 
+  if (preserve_divergences)                                   // Apply weak bisimulation to l.
+  {
+    sigref<LTS_TYPE, signature_divergence_preserving_weak_bisim<LTS_TYPE> >(l).run();
+  }
+  else
+  {
+    sigref<LTS_TYPE, signature_weak_bisim<LTS_TYPE> >(l).run();
+  }
+
   std::size_t divergence_label;
   if (preserve_divergences)
   {
     divergence_label=mark_explicit_divergence_transitions(l);
   } 
-  reflexive_transitive_tau_closure(l);                        // Apply transitive tau closure to l.
-  bisimulation_reduce_gjkw(l, false, false);                  // Apply strong bisimulation to l.
-  scc_reduce(l);                                              // Remove tau loops.
   remove_redundant_transitions(l);                            // Remove transitions s -a-> s' if also s-a->-tau->s' or s-tau->-a->s' is present.
-                                                              // Note that this is correct, because l is reduced modulo strong bisimulation and
-                                                              // does not contain tau loops. 
+                                                              // Note that this is correct, because l is reduced modulo weak bisimulation and
+                                                              // does not contain tau loops apart from the marked divergences.
   if (preserve_divergences)
   {
     unmark_explicit_divergence_transitions(l,divergence_label);
@@ -66,8 +79,8 @@ void weak_bisimulation_reduce(
 
 /** \brief Checks whether the initial states of two LTSs are weakly bisimilar.
  * \details The LTSs l1 and l2 are not usable anymore after this call.
- *          The space consumption is O(n) and running time is dominated by the
- *          transitive closure (after branching bisimulation).
+ *          The running time is dominated by the computation of the weak
+ *          signatures (after branching bisimulation).
  * \param[in/out] l1 A first transition system.
  * \param[in/out] l2 A second transistion system.
  * \param[preserve_divergences] If true and branching is true, preserve tau loops on states.
@@ -88,10 +101,9 @@ bool destructive_weak_bisimulation_compare(
  *  \details The LTSs l1 and l2 are first duplicated and subsequently
  *           reduced modulo bisimulation. If memory space is a concern, one could consider to
  *           use destructive_weak_bisimulation_compare.  The running time
- *           of this routine is dominated by the transitive closure
- *           (after branching bisimulation).  It uses O(m+n) memory
- *           in addition to the copies of l1 and l2, where n is the
- *           number of states and m is the number of transitions.
+ *           of this routine is dominated by the computation of the weak
+ *           signatures (after branching bisimulation). Besides the copies of l1
+ *           and l2 it uses the memory of weak_bisimulation_reduce.
  * \param[in/out] l1 A first transition system.
  * \param[in/out] l2 A second transistion system.
  * \param[preserve_divergences] If true and branching is true, preserve tau loops on states.
@@ -43,12 +43,56 @@ class lts_generation_options
 
     lts_type outformat = lts_none;
     bool outinfo = true;
+    bool save_indexed = false;
     std::string filename;
 
     bool detect_deadlock = false;
     bool detect_nondeterminism = false;
+
+    /// \brief If true, a shortest trace to every state that is reported by detect_deadlock or
+    /// detect_nondeterminism is saved, in the file trace_prefix + "_dlk_" + N + ".trc" or
+    /// trace_prefix + "_nondet_" + N + ".trc". At most max_traces traces are saved.
+    bool save_traces = false;
+    std::size_t max_traces = default_max_traces;
+    std::string trace_prefix = "mcrl3explore";
+
+    /// \brief The maximum number of bytes that is used in memory for the parents of the states,
+    /// which are needed to reconstruct traces. The remaining parents are written to a file in
+    /// the directory of trace_prefix.
+    std::size_t trace_memory_limit = std::size_t(1) << 30;
     bool use_enumeration_caching = false;
 
+    /// \brief If true, the transitions of each summand are cached, using the values of the
+    /// parameters that the summand reads as the key.
+    bool use_transition_caching = false;
+
+    /// \brief The maximum number of bytes used by the transition cache.
+    std::size_t transition_cache_size = std::size_t(1) << 30;
+
+    /// \brief If non empty, the summands with this action (or the tau summands if it is "tau") are
+    /// treated as confluent tau summands. Only representatives of the states that are reachable
+    /// via confluent tau transitions are explored, which preserves branching bisimulation.
+    std::string confluence_action;
+
+    /// \brief If positive, bit state hashing with a table of this number of bits is used
+    /// instead of storing the visited states.
+    std::size_t bithashing = 0;
+
+    /// \brief If true, 64 bit fingerprints of the visited states are stored instead of the states.
+    bool hash_compaction = false;
+
+    /// \brief If non empty, the visited states are stored on disk in this directory, and
+    /// duplicates are detected per level (external memory exploration).
+    std::string external_memory_directory;
+
+    /// \brief The maximum number of bytes used for the successors of a level in external
+    /// memory exploration. If they do not fit, they are written to disk in sorted runs.
+    std::size_t external_memory_buffer_size = std::size_t(1) << 28;
+
+    /// \brief The number of worker processes. If it is larger than one, the states are
+    /// partitioned over processes that exchange states over UNIX sockets.
+    std::size_t number_of_processes = 1;
+
     /// \brief Constructor
     lts_generation_options() = default;
 
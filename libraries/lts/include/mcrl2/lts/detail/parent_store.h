@@ -0,0 +1,260 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/parent_store.h
+/// \brief A compact store of the parents of the states of a breadth first exploration,
+///        from which shortest traces can be reconstructed.
+
+#ifndef MCRL2_LTS_DETAIL_PARENT_STORE_H
+#define MCRL2_LTS_DETAIL_PARENT_STORE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief Stores for every state the number of the state from which it was found first,
+/// and the index of the summand of that transition.
+/// \details The records are packed in a few bytes: the summand index takes as many bytes
+/// as are needed for the number of summands, and the parent takes 4 bytes until a parent
+/// does not fit in 32 bits. The records are kept in blocks, and every block has its own
+/// width of the parents; a block is re-encoded with a larger width when a parent does not
+/// fit, and the next blocks start with that width. So the width grows with the number of
+/// states, not with an upper bound given in advance. If the blocks in memory take more
+/// than a given number of bytes, the oldest ones are
+/// appended to a file, from which they are read back when a trace is reconstructed. Since
+/// the states of a breadth first exploration are numbered in the order in which they are
+/// found, following the parents from a state gives a shortest path from the initial state.
+class parent_store
+{
+  protected:
+    // The number of records in a block.
+    static std::size_t block_size()
+    {
+      return std::size_t(1) << 16;
+    }
+
+    std::size_t m_summand_bytes;
+    std::size_t m_memory_limit;
+
+    // The blocks with an index smaller than m_first_block_in_memory are on disk, starting
+    // at the positions in m_block_positions.
+    std::vector<std::vector<unsigned char>> m_blocks;
+    std::vector<std::size_t> m_parent_bytes;
+    std::vector<std::size_t> m_block_positions;
+    std::size_t m_bytes_in_memory = 0;
+    std::size_t m_first_block_in_memory = 0;
+    std::size_t m_size = 0;
+
+    std::string m_filename;
+    std::fstream m_file;
+    std::size_t m_bytes_written = 0;
+
+    static std::size_t bytes_needed(std::size_t n)
+    {
+      std::size_t result = 1;
+      while (result < sizeof(std::size_t) && (n >> (8 * result)) != 0)
+      {
+        result++;
+      }
+      return result;
+    }
+
+    static void write_bytes(unsigned char* p, std::size_t n, std::size_t number_of_bytes)
+    {
+      for (std::size_t i = 0; i < number_of_bytes; i++)
+      {
+        p[i] = static_cast<unsigned char>(n >> (8 * i));
+      }
+    }
+
+    static std::size_t read_bytes(const unsigned char* p, std::size_t number_of_bytes)
+    {
+      std::size_t result = 0;
+      for (std::size_t i = 0; i < number_of_bytes; i++)
+      {
+        result |= static_cast<std::size_t>(p[i]) << (8 * i);
+      }
+      return result;
+    }
+
+    std::size_t record_bytes(std::size_t b) const
+    {
+      return m_parent_bytes[b] + m_summand_bytes;
+    }
+
+    // Rewrites the last block such that its parents take parent_bytes bytes.
+    void widen_last_block(std::size_t parent_bytes)
+    {
+      const std::size_t b = m_blocks.size() - 1;
+      const std::size_t old_record_bytes = record_bytes(b);
+      const std::size_t new_record_bytes = parent_bytes + m_summand_bytes;
+      const std::vector<unsigned char>& old_block = m_blocks[b];
+      const std::size_t n = old_block.size() / old_record_bytes;
+      std::vector<unsigned char> block(n * new_record_bytes);
+      block.reserve(block_size() * new_record_bytes);
+      for (std::size_t i = 0; i < n; i++)
+      {
+        const unsigned char* p = old_block.data() + i * old_record_bytes;
+        unsigned char* q = block.data() + i * new_record_bytes;
+        write_bytes(q, read_bytes(p, m_parent_bytes[b]), parent_bytes);
+        write_bytes(q + parent_bytes, read_bytes(p + m_parent_bytes[b], m_summand_bytes), m_summand_bytes);
+      }
+      m_bytes_in_memory += block.capacity() - old_block.capacity();
+      m_blocks[b].swap(block);
+      m_parent_bytes[b] = parent_bytes;
+    }
+
+    // Appends the oldest block in memory to the file.
+    void spill_block()
+    {
+      if (!m_file.is_open())
+      {
+        m_file.open(m_filename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+          throw mcrl2::runtime_error("cannot open the file " + m_filename + " for writing");
+        }
+      }
+      std::vector<unsigned char>& block = m_blocks[m_first_block_in_memory];
+      m_block_positions.push_back(m_bytes_written);
+      m_file.seekp(m_bytes_written);
+      m_file.write(reinterpret_cast<const char*>(block.data()), block.size());
+      if (!m_file)
+      {
+        throw mcrl2::runtime_error("could not write the file " + m_filename);
+      }
+      m_bytes_written += block.size();
+      m_bytes_in_memory -= block.capacity();
+      std::vector<unsigned char>().swap(block);
+      m_first_block_in_memory++;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param number_of_summands The number of summands
+    /// \param memory_limit The (approximate) maximum number of bytes of the records that are kept in memory
+    /// \param directory The directory in which the records are stored that do not fit in memory
+    parent_store(std::size_t number_of_summands, std::size_t memory_limit, const std::string& directory)
+      : m_summand_bytes(bytes_needed(number_of_summands == 0 ? 0 : number_of_summands - 1)),
+        m_memory_limit(memory_limit)
+    {
+      std::ostringstream out;
+      out << (directory.empty() ? "." : directory) << "/mcrl2_parents_" << std::hex << std::random_device()() << ".bin";
+      m_filename = out.str();
+    }
+
+    parent_store(const parent_store&) = delete;
+    parent_store& operator=(const parent_store&) = delete;
+
+    ~parent_store()
+    {
+      if (m_file.is_open())
+      {
+        m_file.close();
+        std::remove(m_filename.c_str());
+      }
+    }
+
+    /// \brief Adds the record of the next state.
+    void push_back(std::size_t parent, std::size_t summand_index)
+    {
+      assert(m_summand_bytes == sizeof(std::size_t) || (summand_index >> (8 * m_summand_bytes)) == 0);
+      if (m_size % block_size() == 0)
+      {
+        const std::size_t parent_bytes = m_parent_bytes.empty() ? 4 : m_parent_bytes.back();
+        while (m_first_block_in_memory < m_blocks.size() &&
+               m_bytes_in_memory + block_size() * (parent_bytes + m_summand_bytes) > m_memory_limit)
+        {
+          spill_block();
+        }
+        m_blocks.emplace_back();
+        m_parent_bytes.push_back(parent_bytes);
+        m_blocks.back().reserve(block_size() * record_bytes(m_blocks.size() - 1));
+        m_bytes_in_memory += m_blocks.back().capacity();
+      }
+      const std::size_t parent_bytes = std::max(m_parent_bytes.back(), bytes_needed(parent));
+      if (parent_bytes != m_parent_bytes.back())
+      {
+        widen_last_block(parent_bytes);
+      }
+      std::vector<unsigned char>& block = m_blocks.back();
+      const std::size_t n = record_bytes(m_blocks.size() - 1);
+      block.resize(block.size() + n);
+      unsigned char* p = block.data() + block.size() - n;
+      write_bytes(p, parent, parent_bytes);
+      write_bytes(p + parent_bytes, summand_index, m_summand_bytes);
+      m_size++;
+    }
+
+    /// \brief Returns the parent and the summand index of state i.
+    std::pair<std::size_t, std::size_t> operator[](std::size_t i)
+    {
+      assert(i < m_size);
+      const std::size_t b = i / block_size();
+      const std::size_t offset = (i % block_size()) * record_bytes(b);
+      unsigned char buffer[2 * sizeof(std::size_t)];
+      const unsigned char* p;
+      if (b < m_first_block_in_memory)
+      {
+        m_file.seekg(m_block_positions[b] + offset);
+        m_file.read(reinterpret_cast<char*>(buffer), record_bytes(b));
+        if (!m_file)
+        {
+          throw mcrl2::runtime_error("could not read the file " + m_filename);
+        }
+        p = buffer;
+      }
+      else
+      {
+        p = m_blocks[b].data() + offset;
+      }
+      return std::make_pair(read_bytes(p, m_parent_bytes[b]), read_bytes(p + m_parent_bytes[b], m_summand_bytes));
+    }
+
+    /// \brief Returns the number of records.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /// \brief Returns the number of bytes of a record in the most recent block.
+    std::size_t record_size() const
+    {
+      return m_parent_bytes.empty() ? 4 + m_summand_bytes : record_bytes(m_blocks.size() - 1);
+    }
+
+    /// \brief Returns the number of bytes that were written to disk.
+    std::size_t bytes_written() const
+    {
+      return m_bytes_written;
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_PARENT_STORE_H
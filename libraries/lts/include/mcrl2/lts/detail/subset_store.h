@@ -0,0 +1,279 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/subset_store.h
+/// \brief A store of hash-consed sets of states, and a subset construction
+///        that is based on it.
+
+#ifndef MCRL2_LTS_DETAIL_SUBSET_STORE_H
+#define MCRL2_LTS_DETAIL_SUBSET_STORE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "mcrl2/lts/adjacency_index.h"
+#include "mcrl2/utilities/hash_utility.h"
+#include "mcrl2/utilities/parallel.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief A store in which sets of states are hash-consed. Every distinct set is
+/// stored once and is identified by its index; indices are handed out consecutively.
+/// \details A set is stored in a byte arena as a sorted sequence of differences
+/// between consecutive elements, each encoded with a variable number of bytes. For
+/// the dense sets that occur in subset constructions this takes one or two bytes per
+/// element. The hash of a set is computed while it is encoded, and the sets are
+/// interned using an open addressing hash table on the indices.
+class subset_store
+{
+  public:
+    typedef std::size_t state_type;
+
+  protected:
+    std::vector<unsigned char> m_bytes;
+    std::vector<std::size_t> m_begin;  // Set i is encoded in m_bytes[m_begin[i], m_begin[i + 1]).
+    std::vector<std::size_t> m_size;
+    std::vector<std::size_t> m_hash;
+    std::vector<std::size_t> m_table;  // A hash table with linear probing; empty_slot() marks an empty slot.
+
+    static std::size_t empty_slot()
+    {
+      return std::size_t(-1);
+    }
+
+    static std::size_t table_position(std::size_t hash, std::size_t table_size)
+    {
+      return (hash * 0x9E3779B97F4A7C15ULL >> 7) & (table_size - 1);
+    }
+
+    bool equal_encoding(std::size_t i, std::size_t j) const
+    {
+      const std::size_t length = m_begin[i + 1] - m_begin[i];
+      return m_hash[i] == m_hash[j]
+             && length == m_begin[j + 1] - m_begin[j]
+             && std::memcmp(m_bytes.data() + m_begin[i], m_bytes.data() + m_begin[j], length) == 0;
+    }
+
+    void resize_table()
+    {
+      std::vector<std::size_t> table(std::max(std::size_t(1024), 2 * m_table.size()), empty_slot());
+      for (std::size_t i: m_table)
+      {
+        if (i != empty_slot())
+        {
+          std::size_t k = table_position(m_hash[i], table.size());
+          while (table[k] != empty_slot())
+          {
+            k = (k + 1) & (table.size() - 1);
+          }
+          table[k] = i;
+        }
+      }
+      m_table.swap(table);
+    }
+
+  public:
+    subset_store()
+      : m_begin(1, 0)
+    {
+      resize_table();
+    }
+
+    /// \brief Inserts the set [first, last), which must be sorted and may not contain duplicates.
+    /// \return The index of the set, and a boolean that is true if the set was not yet present.
+    std::pair<std::size_t, bool> insert(const state_type* first, const state_type* last)
+    {
+      // Encode the set at the end of the arena, and compute its hash.
+      std::size_t hash = last - first;
+      state_type previous = 0;
+      for (const state_type* i = first; i != last; ++i)
+      {
+        assert(i == first || *i > previous);
+        std::size_t delta = *i - previous;
+        previous = *i;
+        hash = utilities::detail::hash_combine(hash, delta);
+        while (delta >= 0x80)
+        {
+          m_bytes.push_back(static_cast<unsigned char>(delta | 0x80));
+          delta >>= 7;
+        }
+        m_bytes.push_back(static_cast<unsigned char>(delta));
+      }
+      const std::size_t index = m_size.size();
+      m_begin.push_back(m_bytes.size());
+      m_size.push_back(last - first);
+      m_hash.push_back(hash);
+
+      std::size_t k = table_position(hash, m_table.size());
+      while (m_table[k] != empty_slot())
+      {
+        if (equal_encoding(m_table[k], index))
+        {
+          // The set is already present; remove the new encoding.
+          m_bytes.resize(m_begin[index]);
+          m_begin.pop_back();
+          m_size.pop_back();
+          m_hash.pop_back();
+          return std::make_pair(m_table[k], false);
+        }
+        k = (k + 1) & (m_table.size() - 1);
+      }
+      m_table[k] = index;
+      if (2 * m_size.size() > m_table.size())
+      {
+        resize_table();
+      }
+      return std::make_pair(index, true);
+    }
+
+    /// \brief Inserts the set s, which must be sorted and may not contain duplicates.
+    std::pair<std::size_t, bool> insert(const std::vector<state_type>& s)
+    {
+      return insert(s.data(), s.data() + s.size());
+    }
+
+    /// \brief Appends the elements of set i in increasing order to result.
+    void get(std::size_t i, std::vector<state_type>& result) const
+    {
+      const unsigned char* p = m_bytes.data() + m_begin[i];
+      state_type value = 0;
+      for (std::size_t k = 0; k < m_size[i]; ++k)
+      {
+        std::size_t delta = 0;
+        std::size_t shift = 0;
+        while (*p & 0x80)
+        {
+          delta |= std::size_t(*p++ & 0x7F) << shift;
+          shift += 7;
+        }
+        delta |= std::size_t(*p++) << shift;
+        value += delta;
+        result.push_back(value);
+      }
+    }
+
+    /// \brief Returns the elements of set i.
+    std::vector<state_type> get(std::size_t i) const
+    {
+      std::vector<state_type> result;
+      result.reserve(m_size[i]);
+      get(i, result);
+      return result;
+    }
+
+    /// \brief Returns the number of distinct sets in the store.
+    std::size_t size() const
+    {
+      return m_size.size();
+    }
+
+    /// \brief Returns the number of elements of set i.
+    std::size_t size(std::size_t i) const
+    {
+      return m_size[i];
+    }
+
+    /// \brief Returns true if set i is empty.
+    bool empty(std::size_t i) const
+    {
+      return m_size[i] == 0;
+    }
+
+    /// \brief Returns the number of bytes used by the encoded sets.
+    std::size_t encoded_bytes() const
+    {
+      return m_bytes.size();
+    }
+};
+
+/// \brief The subset construction. Starting with the sets that are already in the store,
+/// for every set S and label a the set {t | s -a-> t for some s in S} is added to the store,
+/// until no new sets are found. For each non empty successor set a transition (S, a, T)
+/// is added to result, in the order of the indices of S and the labels.
+/// \details The sets are expanded in breadth first order. The successors of a chunk of
+/// the frontier are computed in parallel, after which they are interned by a single thread
+/// in order, so the numbering of the sets does not depend on the number of threads.
+/// \param transitions The outgoing transitions per state
+/// \param store A subset store that contains the initial sets
+/// \param result The vector to which the transitions between sets are added
+/// \param number_of_threads The number of threads; 0 means the number of hardware threads
+inline void subset_construction(const adjacency_index& transitions,
+                                subset_store& store,
+                                std::vector<transition>& result,
+                                std::size_t number_of_threads = 0
+                               )
+{
+  typedef std::pair<std::size_t, std::size_t> label_state_pair;
+  const std::size_t chunk_size = 4096;
+  number_of_threads = utilities::number_of_threads(number_of_threads);
+
+  // For the sets in the current chunk, successors[i] contains the pairs (a, t) of the
+  // i-th set, sorted on label and then on state, without duplicates.
+  std::vector<std::vector<label_state_pair> > successors;
+  std::vector<std::vector<subset_store::state_type> > members(number_of_threads);
+  std::vector<subset_store::state_type> target;
+
+  for (std::size_t first = 0, last = 0; first < store.size(); first = last)
+  {
+    last = std::min(store.size(), first + chunk_size);
+    successors.resize(last - first);
+    utilities::parallel_for(last - first, number_of_threads, [&](std::size_t thread, std::size_t begin, std::size_t end)
+    {
+      std::vector<subset_store::state_type>& states = members[thread];
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        std::vector<label_state_pair>& succ = successors[i];
+        succ.clear();
+        states.clear();
+        store.get(first + i, states);
+        for (subset_store::state_type s: states)
+        {
+          for (const adjacent_transition& t: transitions.transitions(s))
+          {
+            succ.push_back(label_state_pair(t.label, t.state));
+          }
+        }
+        std::sort(succ.begin(), succ.end());
+        succ.erase(std::unique(succ.begin(), succ.end()), succ.end());
+      }
+    }, 16);
+
+    for (std::size_t i = 0; i < last - first; ++i)
+    {
+      const std::vector<label_state_pair>& succ = successors[i];
+      for (std::size_t j = 0; j < succ.size(); )
+      {
+        const std::size_t label = succ[j].first;
+        target.clear();
+        for (; j < succ.size() && succ[j].first == label; ++j)
+        {
+          target.push_back(succ[j].second);
+        }
+        result.push_back(transition(first + i, label, store.insert(target).first));
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_SUBSET_STORE_H
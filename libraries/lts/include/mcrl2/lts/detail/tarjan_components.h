@@ -0,0 +1,111 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/tarjan_components.h
+/// \brief Strongly connected components of a graph in compressed adjacency format.
+
+#ifndef MCRL2_LTS_DETAIL_TARJAN_COMPONENTS_H
+#define MCRL2_LTS_DETAIL_TARJAN_COMPONENTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+/// \brief Computes the strongly connected components of a graph with an iterative
+///        version of Tarjan's algorithm.
+/// \param successor_begin The successors of state s are successors[successor_begin[s], successor_begin[s+1]).
+/// \param successors The successors of all states.
+/// \param component On return, the component of each state. Components are numbered in the
+///        order in which they are found, so the successors of a component have a smaller
+///        or equal number.
+/// \return The number of components.
+inline std::size_t tarjan_components(const std::vector<std::size_t>& successor_begin,
+                                     const std::vector<std::size_t>& successors,
+                                     std::vector<std::size_t>& component)
+{
+  const std::size_t n=successor_begin.size()-1;
+  const std::size_t undefined=std::size_t(-1);
+  std::vector<std::size_t> index(n, undefined);
+  std::vector<std::size_t> low(n, 0);
+  std::vector<bool> on_stack(n, false);
+  std::vector<std::size_t> scc_stack;
+  std::vector<std::pair<std::size_t, std::size_t> > call_stack; // (state, position of the next successor)
+  std::size_t counter=0;
+  std::size_t number_of_components=0;
+  component.assign(n, undefined);
+
+  for(std::size_t root=0; root<n; ++root)
+  {
+    if (index[root]!=undefined)
+    {
+      continue;
+    }
+    index[root]=low[root]=counter++;
+    scc_stack.push_back(root);
+    on_stack[root]=true;
+    call_stack.push_back(std::make_pair(root, successor_begin[root]));
+    while (!call_stack.empty())
+    {
+      const std::size_t s=call_stack.back().first;
+      const std::size_t i=call_stack.back().second;
+      if (i!=successor_begin[s+1])
+      {
+        call_stack.back().second++;
+        const std::size_t t=successors[i];
+        if (index[t]==undefined)
+        {
+          index[t]=low[t]=counter++;
+          scc_stack.push_back(t);
+          on_stack[t]=true;
+          call_stack.push_back(std::make_pair(t, successor_begin[t]));
+        }
+        else if (on_stack[t])
+        {
+          low[s]=std::min(low[s], index[t]);
+        }
+      }
+      else
+      {
+        call_stack.pop_back();
+        if (!call_stack.empty())
+        {
+          const std::size_t parent=call_stack.back().first;
+          low[parent]=std::min(low[parent], low[s]);
+        }
+        if (low[s]==index[s])
+        {
+          std::size_t u;
+          do
+          {
+            u=scc_stack.back();
+            scc_stack.pop_back();
+            on_stack[u]=false;
+            component[u]=number_of_components;
+          }
+          while (u!=s);
+          number_of_components++;
+        }
+      }
+    }
+  }
+  return number_of_components;
+}
+
+} // namespace detail
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_TARJAN_COMPONENTS_H
@@ -0,0 +1,509 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/detail/worker_processes.h
+/// \brief Support for running a computation in a number of cooperating worker processes
+///        that exchange messages over UNIX sockets.
+
+#ifndef MCRL2_LTS_DETAIL_WORKER_PROCESSES_H
+#define MCRL2_LTS_DETAIL_WORKER_PROCESSES_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/logger.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief The types of messages that are exchanged by worker processes.
+enum class worker_message_type: unsigned char
+{
+  states,    // A batch of states, with a payload that is defined by the application.
+  token,     // The token of the termination detection.
+  terminate  // All workers are passive and no messages are in transit.
+};
+
+/// \brief The token of Safra's termination detection algorithm. It is passed around in a ring
+/// of workers, and accumulates the number of messages that were sent minus the number of
+/// messages that were received. A worker that received a message since it last passed the
+/// token makes the token black, which means that another round is needed.
+struct termination_token
+{
+  std::int64_t count = 0;
+  bool black = false;
+
+  std::vector<unsigned char> encode() const
+  {
+    std::vector<unsigned char> result(9);
+    std::uint64_t c = static_cast<std::uint64_t>(count);
+    for (std::size_t i = 0; i < 8; i++)
+    {
+      result[i] = static_cast<unsigned char>(c >> (8 * i));
+    }
+    result[8] = black ? 1 : 0;
+    return result;
+  }
+
+  static termination_token decode(const unsigned char* data, std::size_t size)
+  {
+    if (size != 9)
+    {
+      throw mcrl2::runtime_error("received an invalid termination token");
+    }
+    std::uint64_t c = 0;
+    for (std::size_t i = 0; i < 8; i++)
+    {
+      c |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+    }
+    termination_token result;
+    result.count = static_cast<std::int64_t>(c);
+    result.black = data[8] != 0;
+    return result;
+  }
+};
+
+#ifndef _WIN32
+
+/// \brief A connection between two worker processes over a non blocking UNIX socket. Messages
+/// are appended to a send buffer, that is written whenever the socket accepts data. So two
+/// workers that send each other large amounts of data cannot block each other.
+/// \details A message consists of its type (one byte), the size of its payload (eight bytes)
+/// and the payload.
+class worker_channel
+{
+  protected:
+    int m_socket;
+    std::vector<unsigned char> m_send_buffer;
+    std::size_t m_send_position = 0;
+    std::vector<unsigned char> m_receive_buffer;
+
+    static const std::size_t header_size = 9;
+
+    static void system_error(const std::string& message)
+    {
+      throw mcrl2::runtime_error(message + ": " + std::strerror(errno));
+    }
+
+  public:
+    explicit worker_channel(int socket = -1)
+      : m_socket(socket)
+    {
+      if (m_socket >= 0 && ::fcntl(m_socket, F_SETFL, ::fcntl(m_socket, F_GETFL) | O_NONBLOCK) < 0)
+      {
+        system_error("could not configure a socket");
+      }
+    }
+
+    int socket() const
+    {
+      return m_socket;
+    }
+
+    /// \brief Appends a message to the send buffer.
+    void send(worker_message_type type, const unsigned char* data, std::size_t size)
+    {
+      m_send_buffer.push_back(static_cast<unsigned char>(type));
+      for (std::size_t i = 0; i < 8; i++)
+      {
+        m_send_buffer.push_back(static_cast<unsigned char>(static_cast<std::uint64_t>(size) >> (8 * i)));
+      }
+      m_send_buffer.insert(m_send_buffer.end(), data, data + size);
+    }
+
+    void send(worker_message_type type, const std::vector<unsigned char>& payload = std::vector<unsigned char>())
+    {
+      send(type, payload.data(), payload.size());
+    }
+
+    /// \brief Returns true if the send buffer contains data that has not been written yet.
+    bool has_pending_output() const
+    {
+      return m_send_position < m_send_buffer.size();
+    }
+
+    /// \brief Writes as much of the send buffer as possible without blocking.
+    void flush()
+    {
+      while (has_pending_output())
+      {
+        ssize_t n = ::write(m_socket, m_send_buffer.data() + m_send_position, m_send_buffer.size() - m_send_position);
+        if (n < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+          {
+            break;
+          }
+          system_error("could not send a message to another worker process");
+        }
+        m_send_position += n;
+      }
+      if (!has_pending_output())
+      {
+        m_send_buffer.clear();
+        m_send_position = 0;
+      }
+    }
+
+    /// \brief Writes the send buffer, and blocks until this is done.
+    void flush_blocking()
+    {
+      flush();
+      while (has_pending_output())
+      {
+        pollfd p = { m_socket, POLLOUT, 0 };
+        ::poll(&p, 1, -1);
+        flush();
+      }
+    }
+
+    /// \brief Reads the data that is available without blocking, and calls f(type, data, size)
+    /// for every message that has been received completely.
+    /// \return False if the connection was closed by the other side.
+    template <typename Function>
+    bool receive(Function f)
+    {
+      bool is_open = true;
+      unsigned char buffer[1 << 16];
+      for (;;)
+      {
+        ssize_t n = ::read(m_socket, buffer, sizeof(buffer));
+        if (n > 0)
+        {
+          m_receive_buffer.insert(m_receive_buffer.end(), buffer, buffer + n);
+          continue;
+        }
+        if (n == 0)
+        {
+          is_open = false;
+          break;
+        }
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+          break;
+        }
+        system_error("could not receive a message from another worker process");
+      }
+
+      std::size_t position = 0;
+      while (m_receive_buffer.size() - position >= header_size)
+      {
+        const unsigned char* p = m_receive_buffer.data() + position;
+        std::uint64_t size = 0;
+        for (std::size_t i = 0; i < 8; i++)
+        {
+          size |= static_cast<std::uint64_t>(p[1 + i]) << (8 * i);
+        }
+        if (m_receive_buffer.size() - position - header_size < size)
+        {
+          break;
+        }
+        f(static_cast<worker_message_type>(p[0]), p + header_size, static_cast<std::size_t>(size));
+        position += header_size + size;
+      }
+      m_receive_buffer.erase(m_receive_buffer.begin(), m_receive_buffer.begin() + position);
+      return is_open;
+    }
+};
+
+/// \brief Waits until one of the open channels, other than channels[self], has received data
+/// or can write pending output, or until timeout milliseconds have passed.
+inline void wait_for_channels(const std::vector<worker_channel>& channels, const std::vector<bool>& is_open, std::size_t self, int timeout)
+{
+  std::vector<pollfd> sockets;
+  for (std::size_t j = 0; j < channels.size(); j++)
+  {
+    if (j != self && is_open[j])
+    {
+      sockets.push_back(pollfd{ channels[j].socket(), static_cast<short>(channels[j].has_pending_output() ? POLLIN | POLLOUT : POLLIN), 0 });
+    }
+  }
+  ::poll(sockets.data(), sockets.size(), timeout);
+}
+
+/// \brief Runs f(i, channels) in worker processes i = 0, ..., n-1, where channels[j] is the
+/// connection to worker j (channels[i] is unused). Every worker is a forked copy of the current
+/// process, so the workers do not share memory. The function f returns a string, that is passed
+/// back to the calling process.
+/// \return The strings that were returned by the workers.
+template <typename Function>
+std::vector<std::string> run_worker_processes(std::size_t n, Function f)
+{
+  std::vector<std::vector<int>> sockets(n, std::vector<int>(n, -1));
+  std::vector<int> result_pipes(2 * n, -1);
+  auto close_all = [&]()
+  {
+    for (std::vector<int>& v: sockets)
+    {
+      for (int& s: v)
+      {
+        if (s >= 0)
+        {
+          ::close(s);
+          s = -1;
+        }
+      }
+    }
+  };
+  auto close_pipes = [&]()
+  {
+    for (int& p: result_pipes)
+    {
+      if (p >= 0)
+      {
+        ::close(p);
+        p = -1;
+      }
+    }
+  };
+
+  for (std::size_t i = 0; i < n; i++)
+  {
+    for (std::size_t j = i + 1; j < n; j++)
+    {
+      int sv[2];
+      if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+      {
+        close_all();
+        throw mcrl2::runtime_error(std::string("could not create a socket: ") + std::strerror(errno));
+      }
+      sockets[i][j] = sv[0];
+      sockets[j][i] = sv[1];
+    }
+    if (::pipe(&result_pipes[2 * i]) < 0)
+    {
+      close_all();
+      close_pipes();
+      throw mcrl2::runtime_error(std::string("could not create a pipe: ") + std::strerror(errno));
+    }
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+  std::vector<pid_t> pids(n, 0); // The value 0 marks a worker that is not running.
+  auto stop_workers = [&]()
+  {
+    for (pid_t p: pids)
+    {
+      if (p > 0)
+      {
+        ::kill(p, SIGTERM);
+      }
+    }
+  };
+  for (std::size_t i = 0; i < n; i++)
+  {
+    pids[i] = ::fork();
+    if (pids[i] < 0)
+    {
+      // The workers that were started cannot finish without this one. Stop them, and wait for them.
+      const int error = errno;
+      pids[i] = 0;
+      close_all();
+      close_pipes();
+      stop_workers();
+      for (pid_t p: pids)
+      {
+        if (p > 0)
+        {
+          while (::waitpid(p, nullptr, 0) < 0 && errno == EINTR)
+          {
+          }
+        }
+      }
+      throw mcrl2::runtime_error(std::string("could not create a worker process: ") + std::strerror(error));
+    }
+    if (pids[i] == 0)
+    {
+      // The worker process. It keeps only its own sockets and the write end of its own pipe.
+      ::signal(SIGPIPE, SIG_IGN);
+      int exit_status = EXIT_SUCCESS;
+      try
+      {
+        std::vector<worker_channel> channels;
+        for (std::size_t k = 0; k < n; k++)
+        {
+          for (std::size_t j = 0; j < n; j++)
+          {
+            if (k != i && sockets[k][j] >= 0)
+            {
+              ::close(sockets[k][j]);
+            }
+          }
+          ::close(result_pipes[2 * k]);
+          if (k != i)
+          {
+            ::close(result_pipes[2 * k + 1]);
+          }
+          channels.emplace_back(sockets[i][k]);
+        }
+        const std::string result = f(i, channels);
+        for (std::size_t written = 0; written < result.size(); )
+        {
+          ssize_t m = ::write(result_pipes[2 * i + 1], result.data() + written, result.size() - written);
+          if (m < 0 && errno != EINTR)
+          {
+            throw mcrl2::runtime_error(std::string("could not write the result of a worker: ") + std::strerror(errno));
+          }
+          written += m < 0 ? 0 : m;
+        }
+      }
+      catch (std::exception& e)
+      {
+        mCRL2log(log::error) << "worker process " << i << ": " << e.what() << std::endl;
+        exit_status = EXIT_FAILURE;
+      }
+      std::cout.flush();
+      std::cerr.flush();
+      ::_exit(exit_status);
+    }
+  }
+
+  // The calling process collects the results, and waits until all workers have finished.
+  close_all();
+  std::vector<pollfd> pipes;
+  for (std::size_t i = 0; i < n; i++)
+  {
+    ::close(result_pipes[2 * i + 1]);
+    pipes.push_back(pollfd{ result_pipes[2 * i], POLLIN, 0 });
+  }
+  std::vector<std::string> results(n);
+  auto read_result = [&](std::size_t i)
+  {
+    char buffer[4096];
+    ssize_t m = ::read(pipes[i].fd, buffer, sizeof(buffer));
+    if (m > 0)
+    {
+      results[i].append(buffer, m);
+    }
+    else if (m == 0 || errno != EINTR)
+    {
+      ::close(pipes[i].fd);
+      pipes[i].fd = -1;
+    }
+  };
+  std::size_t running = n;
+  bool failed = false;
+  while (running > 0)
+  {
+    ::poll(pipes.data(), pipes.size(), 100);
+    for (std::size_t i = 0; i < n; i++)
+    {
+      if (pipes[i].fd >= 0 && (pipes[i].revents & (POLLIN | POLLHUP)))
+      {
+        read_result(i);
+      }
+    }
+
+    // Only the workers are waited for, since the calling process may have other children.
+    for (pid_t& p: pids)
+    {
+      int status;
+      if (p > 0 && ::waitpid(p, &status, WNOHANG) > 0)
+      {
+        running--;
+        p = 0;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        {
+          // A worker failed, so the other workers cannot finish. Stop them.
+          failed = true;
+          stop_workers();
+        }
+      }
+    }
+  }
+
+  // All workers have finished, so reading the remaining results does not block.
+  for (std::size_t i = 0; i < n; i++)
+  {
+    while (pipes[i].fd >= 0)
+    {
+      read_result(i);
+    }
+  }
+  if (failed)
+  {
+    throw mcrl2::runtime_error("a worker process terminated unsuccessfully");
+  }
+  return results;
+}
+
+#else
+
+/// \brief Worker processes are not supported on this platform, so there are no channels.
+class worker_channel
+{
+  public:
+    void send(worker_message_type, const std::vector<unsigned char>& = std::vector<unsigned char>())
+    {}
+
+    bool has_pending_output() const
+    {
+      return false;
+    }
+
+    void flush()
+    {}
+
+    void flush_blocking()
+    {}
+
+    template <typename Function>
+    bool receive(Function)
+    {
+      return false;
+    }
+};
+
+inline void wait_for_channels(const std::vector<worker_channel>&, const std::vector<bool>&, std::size_t, int)
+{}
+
+/// \brief Worker processes are not supported on this platform.
+template <typename Function>
+std::vector<std::string> run_worker_processes(std::size_t, Function)
+{
+  throw mcrl2::runtime_error("worker processes are not supported on this platform");
+}
+
+#endif // _WIN32
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_DETAIL_WORKER_PROCESSES_H
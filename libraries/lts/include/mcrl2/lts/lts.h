@@ -24,6 +24,8 @@
 #include <cstdio>
 #include <algorithm>
 #include <cassert>
+#include <functional>
+#include "mcrl2/lts/adjacency_index.h"
 #include "mcrl2/lts/transition.h"
 #include "mcrl2/lts/lts_type.h"
 
@@ -87,11 +89,32 @@ class lts: public LTS_BASE
     states_size_type m_init_state;
     std::vector<transition> m_transitions;
     std::vector<STATE_LABEL_T> m_state_labels;
+    // If set, the state labels are not stored in m_state_labels, but are obtained from this
+    // function when they are requested. They are copied into m_state_labels when they are changed.
+    std::function<STATE_LABEL_T(states_size_type)> m_state_label_source;
     std::vector<ACTION_LABEL_T> m_action_labels; // At position 0 we always find the label that corresponds to tau.
     // The following map indicates for every label index, which label is obtained after hiding
     // actions. This is the identity map by default, and it is filled using a call to the
     // function hide_actions. 
     std::map<labels_size_type,labels_size_type> m_hidden_label_map; 
+    // The indices of the outgoing and incoming transitions, that are computed on demand.
+    mutable detail::adjacency_cache m_adjacency;
+
+    // Copies the state labels from the state label source into m_state_labels.
+    void load_state_labels()
+    {
+      if (m_state_label_source)
+      {
+        std::vector<STATE_LABEL_T> labels;
+        labels.reserve(m_nstates);
+        for (states_size_type i = 0; i < m_nstates; i++)
+        {
+          labels.push_back(m_state_label_source(i));
+        }
+        m_state_labels.swap(labels);
+        m_state_label_source = nullptr;
+      }
+    }
 
   public:
 
@@ -111,6 +134,7 @@ class lts: public LTS_BASE
       m_init_state(l.m_init_state),
       m_transitions(l.m_transitions),
       m_state_labels(l.m_state_labels),
+      m_state_label_source(l.m_state_label_source),
       m_action_labels(l.m_action_labels),
       m_hidden_label_map(l.m_hidden_label_map)
     {
@@ -134,10 +158,13 @@ class lts: public LTS_BASE
       }
       m_transitions.swap(l.m_transitions);
       m_state_labels.swap(l.m_state_labels);
+      m_state_label_source.swap(l.m_state_label_source);
       m_action_labels.swap(l.m_action_labels);
       assert(m_action_labels.size()>0 && m_action_labels[0]==ACTION_LABEL_T::tau_action());
       assert(l.m_action_labels.size()>0 && l.m_action_labels[0]==ACTION_LABEL_T::tau_action());
       m_hidden_label_map.swap(l.m_hidden_label_map);
+      m_adjacency.invalidate();
+      l.m_adjacency.invalidate();
     }
 
     /** \brief Gets the number of states of this LTS.
@@ -154,7 +181,7 @@ class lts: public LTS_BASE
      *  \return The number of state labels of this LTS. */
     states_size_type num_state_labels() const
     {
-      return m_state_labels.size();
+      return m_state_label_source ? m_nstates : m_state_labels.size();
     }
 
     /** \brief Sets the number of states of this LTS.
@@ -163,7 +190,14 @@ class lts: public LTS_BASE
      */
     void set_num_states(const states_size_type n, const bool has_state_labels = true)
     {
+      detail::check_transition_index_capacity<transition::index_type>(n, "states");
+      if (has_state_labels)
+      {
+        load_state_labels();
+      }
+      m_state_label_source = nullptr;
       m_nstates = n;
+      m_adjacency.invalidate();
       if (has_state_labels)
       {
         if (m_state_labels.size() > 0)
@@ -193,6 +227,7 @@ class lts: public LTS_BASE
      *          these are set to the default action label. */
     void set_num_action_labels(const labels_size_type n)
     {
+      detail::check_transition_index_capacity<transition::index_type>(n, "action labels");
       m_action_labels.resize(n);
       assert(m_action_labels.size()>0 && m_action_labels[0]==ACTION_LABEL_T::tau_action());
     } 
@@ -230,6 +265,8 @@ class lts: public LTS_BASE
      * \return The number of the added state label. */
     states_size_type add_state(const STATE_LABEL_T& label=STATE_LABEL_T())
     {
+      detail::check_transition_index_capacity<transition::index_type>(m_nstates + 1, "states");
+      load_state_labels();
       if (label!=STATE_LABEL_T())
       {
         m_state_labels.resize(m_nstates);
@@ -249,6 +286,7 @@ class lts: public LTS_BASE
         return 0;
       }
       const labels_size_type label_index=m_action_labels.size();
+      detail::check_transition_index_capacity<transition::index_type>(label_index + 1, "action labels");
       m_action_labels.push_back(label);
       return label_index;
     }
@@ -268,10 +306,22 @@ class lts: public LTS_BASE
     void set_state_label(const states_size_type state, const STATE_LABEL_T& label)
     {
       assert(state<m_nstates);
+      load_state_labels();
       assert(m_nstates==m_state_labels.size());
       m_state_labels[state] = label;
     }
 
+    /** \brief Sets a function from which the labels of the states are obtained when they
+     *         are requested, such that they do not have to be computed in advance.
+     *  \details The labels are copied into the lts as soon as a state is added or a state
+     *           label is changed. The function must remain valid until then.
+     *  \param[in] source A function that returns the label of a state. */
+    void set_state_label_source(const std::function<STATE_LABEL_T(states_size_type)>& source)
+    {
+      m_state_labels = std::vector<STATE_LABEL_T>();
+      m_state_label_source = source;
+    }
+
     /** \brief The action labels in this lts. 
         \return The action labels of this lts.  **/
     const std::vector<ACTION_LABEL_T>& action_labels() const
@@ -303,6 +353,7 @@ class lts: public LTS_BASE
         \return The hidden action map */
     std::map<labels_size_type,labels_size_type>& hidden_label_map() 
     {
+      m_adjacency.invalidate();
       return m_hidden_label_map;
     }
 
@@ -312,6 +363,7 @@ class lts: public LTS_BASE
     void set_hidden_label_map(const std::map<labels_size_type,labels_size_type>& m)
     {
       m_hidden_label_map=m;
+      m_adjacency.invalidate();
     }
 
     /** \brief Gives for an action label its corresponding hidden action label.
@@ -333,6 +385,10 @@ class lts: public LTS_BASE
     STATE_LABEL_T state_label(const states_size_type state) const
     {
       assert(state<m_nstates);
+      if (m_state_label_source)
+      {
+        return m_state_label_source(state);
+      }
       assert(m_nstates==m_state_labels.size());
       return m_state_labels[state];
     }
@@ -367,6 +423,7 @@ class lts: public LTS_BASE
     {
       m_transitions = std::vector<transition>();
       m_transitions.reserve(n);
+      m_adjacency.invalidate();
     }
 
     /** \brief Clear the action labels of an lts.
@@ -379,6 +436,7 @@ class lts: public LTS_BASE
       m_action_labels.clear();
       m_action_labels.push_back(ACTION_LABEL_T::tau_action());
       m_hidden_label_map.clear();
+      m_adjacency.invalidate();
     }
 
     /** \brief Clear the labels of an lts.
@@ -388,6 +446,7 @@ class lts: public LTS_BASE
     void clear_state_labels()
     {
       m_state_labels.clear();
+      m_state_label_source = nullptr;
     }
 
     /** \brief Clear the transitions system.
@@ -412,10 +471,14 @@ class lts: public LTS_BASE
 
     /** \brief Gets a reference to the vector of transitions of the current lts.
      *  \details As this vector can be huge, it is adviced to avoid
-     *           to copy this vector.
+     *           to copy this vector. The indices of outgoing and incoming transitions
+     *           that are requested afterwards are computed again. If the transitions are
+     *           changed via the reference after one of these indices has been requested
+     *           again, the function invalidate_transition_indices must be called.
      * \return   A reference to the vector. */
     std::vector<transition>& get_transitions()
     {
+      m_adjacency.invalidate();
       return m_transitions;
     }
 
@@ -426,6 +489,65 @@ class lts: public LTS_BASE
     void add_transition(const transition& t)
     {
       m_transitions.push_back(t);
+      m_adjacency.invalidate();
+    }
+
+    /** \brief Gives an index of the outgoing transitions of each state, that is shared with the lts.
+     *  \details The transitions of a state are grouped by label, and the hidden label
+     *           map has been applied to the labels. The index is computed on demand,
+     *           and it is reused until the transitions, the number of states or the
+     *           hidden label map are changed. The returned index remains valid when the
+     *           lts changes, but it then describes the lts before the change. Note that
+     *           this is not thread safe. */
+    std::shared_ptr<const adjacency_index> shared_outgoing_transition_index() const
+    {
+      if (!m_adjacency.outgoing_is_valid())
+      {
+        m_adjacency.outgoing = std::make_shared<const adjacency_index>(m_nstates, m_transitions, true, [&](labels_size_type a) { return apply_hidden_label_map(a); });
+        m_adjacency.outgoing_generation = m_adjacency.generation;
+      }
+      return m_adjacency.outgoing;
+    }
+
+    /** \brief Gives an index of the incoming transitions of each state, that is shared with the lts.
+     *  \details See shared_outgoing_transition_index. For each transition the index
+     *           contains its label and its source state. */
+    std::shared_ptr<const adjacency_index> shared_incoming_transition_index() const
+    {
+      if (!m_adjacency.incoming_is_valid())
+      {
+        m_adjacency.incoming = std::make_shared<const adjacency_index>(m_nstates, m_transitions, false, [&](labels_size_type a) { return apply_hidden_label_map(a); });
+        m_adjacency.incoming_generation = m_adjacency.generation;
+      }
+      return m_adjacency.incoming;
+    }
+
+    /** \brief Gives an index of the outgoing transitions of each state.
+     *  \details See shared_outgoing_transition_index.
+     *  \return  A reference to the index. It remains valid after the lts has changed, until
+     *           the index is requested again after the change. Use shared_outgoing_transition_index to keep
+     *           an index for a longer time. */
+    const adjacency_index& outgoing_transition_index() const
+    {
+      return *shared_outgoing_transition_index();
+    }
+
+    /** \brief Gives an index of the incoming transitions of each state.
+     *  \details See shared_incoming_transition_index.
+     *  \return  A reference to the index. It remains valid after the lts has changed, until
+     *           the index is requested again after the change. */
+    const adjacency_index& incoming_transition_index() const
+    {
+      return *shared_incoming_transition_index();
+    }
+
+    /** \brief Marks the indices of outgoing and incoming transitions as stale, such that
+     *         they are computed again when they are requested. This is needed if the
+     *         transitions were changed via a reference obtained by get_transitions
+     *         after the indices were requested. */
+    void invalidate_transition_indices()
+    {
+      m_adjacency.invalidate();
     }
 
     /** \brief Checks whether an action is a tau action.
@@ -451,6 +573,7 @@ class lts: public LTS_BASE
       {
         return;
       }
+      m_adjacency.invalidate();
 
       for (labels_size_type i=0; i< num_action_labels(); ++i)
       {
@@ -486,7 +609,7 @@ class lts: public LTS_BASE
     */
     bool has_state_info() const
     {
-      return m_state_labels.size() > 0;
+      return m_state_label_source || m_state_labels.size() > 0;
     }
 
     /** \brief Checks whether this LTS has labels associated with its actions, which are numbers.
@@ -503,6 +626,13 @@ class lts: public LTS_BASE
      * \note Deprecated */
     inline void sort_transitions(transition_sort_style ts = src_lbl_tgt)
     {
+      m_adjacency.invalidate();
+      // For large LTSs without hidden labels a radix sort is used, which is much faster.
+      if (m_hidden_label_map.empty() && m_transitions.size() > 65536)
+      {
+        detail::radix_sort_transitions(m_transitions, ts);
+        return;
+      }
       switch (ts)
       {
         case lbl_tgt_src:
@@ -34,6 +34,7 @@
 #include "mcrl2/lts/lts_utilities.h"
 #include "mcrl2/lts/detail/liblts_bisim.h"
 #include "mcrl2/lts/detail/liblts_bisim_gjkw.h"
+#include "mcrl2/lts/detail/liblts_bisim_dnj.h"
 #include "mcrl2/lts/detail/liblts_weak_bisim.h"
 #include "mcrl2/lts/detail/liblts_add_an_action_loop.h"
 #include "mcrl2/lts/detail/liblts_scc.h"
@@ -42,7 +43,7 @@
 #include "mcrl2/lts/detail/liblts_failures_refinement.h"
 #include "mcrl2/lts/detail/liblts_tau_star_reduce.h"
 #include "mcrl2/utilities/exception.h"
-#include "mcrl2/lts/detail/tree_set.h"
+#include "mcrl2/lts/detail/subset_store.h"
 #include "mcrl2/lts/lts_equivalence.h"
 #include "mcrl2/lts/lts_preorder.h"
 #include "mcrl2/lts/sigref.h"
@@ -105,6 +106,15 @@ bool destructive_compare(LTS_TYPE& l1,
       }
       return detail::destructive_bisimulation_compare_gjkw(l1,l2, false,false,generate_counter_examples);
     }
+    case lts_eq_bisim_dnj:
+    {
+      if (generate_counter_examples)
+      {
+        mCRL2log(mcrl2::log::warning) << "The dnj bisimulation comparison algorithm cannot generate counter examples. Therefore the slower gv algorithm is used instead.\n";
+        return detail::destructive_bisimulation_compare(l1,l2, false,false,generate_counter_examples);
+      }
+      return detail::destructive_bisimulation_compare_dnj(l1,l2, false,false,generate_counter_examples);
+    }
     case lts_eq_bisim_gv:
     {
       return detail::destructive_bisimulation_compare(l1,l2, false,false,generate_counter_examples);
@@ -118,6 +128,15 @@ bool destructive_compare(LTS_TYPE& l1,
       }
       return detail::destructive_bisimulation_compare_gjkw(l1,l2, true,false,generate_counter_examples);
     }
+    case lts_eq_branching_bisim_dnj:
+    {
+      if (generate_counter_examples)
+      {
+        mCRL2log(mcrl2::log::warning) << "The dnj branching bisimulation comparison algorithm cannot generate counter examples. Therefore the slower gv algorithm is used instead.\n";
+        return detail::destructive_bisimulation_compare(l1,l2, true,false,generate_counter_examples);
+      }
+      return detail::destructive_bisimulation_compare_dnj(l1,l2, true,false,generate_counter_examples);
+    }
     case lts_eq_branching_bisim_gv:
     {
       return detail::destructive_bisimulation_compare(l1,l2, true,false,generate_counter_examples);
@@ -131,6 +150,15 @@ bool destructive_compare(LTS_TYPE& l1,
       }
       return detail::destructive_bisimulation_compare_gjkw(l1,l2, true,true,generate_counter_examples);
     }
+    case lts_eq_divergence_preserving_branching_bisim_dnj:
+    {
+      if (generate_counter_examples)
+      {
+        mCRL2log(mcrl2::log::warning) << "The dnj divergence preserving branching bisimulation comparison algorithm cannot generate counter examples. Therefore the slower gv algorithm is used instead.\n";
+        return detail::destructive_bisimulation_compare(l1,l2, true,true,generate_counter_examples);
+      }
+      return detail::destructive_bisimulation_compare_dnj(l1,l2, true,true,generate_counter_examples);
+    }
     case lts_eq_divergence_preserving_branching_bisim_gv:
     {
       return detail::destructive_bisimulation_compare(l1,l2, true,true,generate_counter_examples);
@@ -157,14 +185,7 @@ bool destructive_compare(LTS_TYPE& l1,
       {
         mCRL2log(log::warning) << "Cannot generate counter example traces for simulation equivalence\n";
       }
-      // Run the partitioning algorithm on this merged LTS
-      std::size_t init_l2 = l2.initial_state() + l1.num_states();
-      detail::merge(l1,l2);
-      l2.clear(); // l2 is not needed anymore.
-      detail::sim_partitioner<LTS_TYPE> sp(l1);
-      sp.partitioning_algorithm();
-
-      return sp.in_same_class(l1.initial_state(),init_l2);
+      return detail::destructive_simulation_compare(l1,l2,false,true);
     }
     case lts_eq_ready_sim:
     {
@@ -172,14 +193,7 @@ bool destructive_compare(LTS_TYPE& l1,
       {
         mCRL2log(log::warning) << "Cannot generate counter example traces for ready-simulation equivalence\n";
       }
-      // Run the partitioning algorithm on this merged LTS
-      std::size_t init_l2 = l2.initial_state() + l1.num_states();
-      detail::merge(l1,l2);
-      l2.clear(); // l2 is not needed anymore.
-      detail::ready_sim_partitioner<LTS_TYPE> rsp(l1);
-      rsp.partitioning_algorithm();
-
-      return rsp.in_same_class(l1.initial_state(),init_l2);
+      return detail::destructive_simulation_compare(l1,l2,true,true);
     }    
     case lts_eq_trace:
     {
@@ -295,7 +309,7 @@ template <class SL, class AL, class BASE>
 bool reachability_check(lts < SL, AL, BASE>& l, bool remove_unreachable = false)
 {
   // First calculate which states can be reached, and store this in the array visited.
-  const outgoing_transitions_per_state_t out_trans=transitions_per_outgoing_state(l.get_transitions());
+  const adjacency_index& out_trans=l.outgoing_transition_index();
 
   std::vector < bool > visited(l.num_states(),false);
   std::stack<std::size_t> todo;
@@ -307,14 +321,13 @@ bool reachability_check(lts < SL, AL, BASE>& l, bool remove_unreachable = false)
   {
     std::size_t state_to_consider=todo.top();
     todo.pop();
-    for (outgoing_transitions_per_state_t::const_iterator i=out_trans.lower_bound(state_to_consider);
-         i!=out_trans.upper_bound(state_to_consider); ++i)
+    for (const adjacent_transition& t: out_trans.transitions(state_to_consider))
     {
-      assert(visited[from(i)] && from(i)<l.num_states() && to(i)<l.num_states());
-      if (!visited[to(i)])
+      assert(t.state<l.num_states());
+      if (!visited[t.state])
       {
-        visited[to(i)]=true;
-        todo.push(to(i));
+        visited[t.state]=true;
+        todo.push(t.state);
       }
     }
   }
@@ -544,6 +557,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       detail::bisimulation_reduce_gjkw(l,false,false);
       return;
     }
+    case lts_eq_bisim_dnj:
+    {
+      detail::bisimulation_reduce_dnj(l,false,false);
+      return;
+    }
     case lts_eq_bisim_gv:
     {
       detail::bisimulation_reduce(l,false,false);
@@ -560,6 +578,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       detail::bisimulation_reduce_gjkw(l,true,false);
       return;
     }
+    case lts_eq_branching_bisim_dnj:
+    {
+      detail::bisimulation_reduce_dnj(l,true,false);
+      return;
+    }
     case lts_eq_branching_bisim_gv:
     {
       detail::bisimulation_reduce(l,true,false);
@@ -576,6 +599,11 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
       detail::bisimulation_reduce_gjkw(l,true,true);
       return;
     }
+    case lts_eq_divergence_preserving_branching_bisim_dnj:
+    {
+      detail::bisimulation_reduce_dnj(l,true,true);
+      return;
+    }
     case lts_eq_divergence_preserving_branching_bisim_gv:
     {
       detail::bisimulation_reduce(l,true,true);
@@ -633,54 +661,18 @@ void reduce(LTS_TYPE& l,lts_equivalence eq)
     */
     case lts_eq_sim:
     {
-      // Run the partitioning algorithm on this LTS
-      detail::sim_partitioner<LTS_TYPE> sp(l);
-      sp.partitioning_algorithm();
-
-      // Clear this LTS, but keep the labels
-      // l.clear_type();
-      l.clear_state_labels();
-      l.clear_transitions();
-
-      // Assign the reduced LTS
-      l.set_num_states(sp.num_eq_classes());
-      l.set_initial_state(sp.get_eq_class(l.initial_state()));
+      detail::simulation_reduce(l,false);
 
-      const std::vector <transition> trans=sp.get_transitions();
-      l.clear_transitions();
-      for (std::vector <transition>::const_iterator i=trans.begin(); i!=trans.end(); ++i)
-      {
-        l.add_transition(*i);
-      }
       // Remove unreachable parts
-
       reachability_check(l,true);
 
       return;
     }
     case lts_eq_ready_sim:
     {
-      // Run the partitioning algorithm on this LTS
-      detail::ready_sim_partitioner<LTS_TYPE> rsp(l);
-      rsp.partitioning_algorithm();
-
-      // Clear this LTS, but keep the labels
-      // l.clear_type();
-      l.clear_state_labels();
-      l.clear_transitions();
-
-      // Assign the reduced LTS
-      l.set_num_states(rsp.num_eq_classes());
-      l.set_initial_state(rsp.get_eq_class(l.initial_state()));
+      detail::simulation_reduce(l,true);
 
-      const std::vector <transition> trans=rsp.get_transitions();
-      l.clear_transitions();
-      for (std::vector <transition>::const_iterator i=trans.begin(); i!=trans.end(); ++i)
-      {
-        l.add_transition(*i);
-      }
       // Remove unreachable parts
-
       reachability_check(l,true);
 
       return;      
@@ -746,39 +738,11 @@ bool destructive_compare(LTS_TYPE& l1, LTS_TYPE& l2, const lts_preorder pre, con
   {
     case lts_pre_sim:
     {
-      // Merge this LTS and l and store the result in this LTS.
-      // In the resulting LTS, the initial state i of l will have the
-      // state number i + N where N is the number of states in this
-      // LTS (before the merge).
-      const std::size_t init_l2 = l2.initial_state() + l1.num_states();
-      detail::merge(l1,l2);
-
-      // We no longer need l, so clear it to save memory
-      l2.clear();
-
-      // Run the partitioning algorithm on this merged LTS
-      detail::sim_partitioner<LTS_TYPE> sp(l1);
-      sp.partitioning_algorithm();
-
-      return sp.in_preorder(l1.initial_state(),init_l2);
+      return detail::destructive_simulation_compare(l1,l2,false,false);
     }
     case lts_pre_ready_sim:
     {
-      // Merge this LTS and l and store the result in this LTS.
-      // In the resulting LTS, the initial state i of l will have the
-      // state number i + N where N is the number of states in this
-      // LTS (before the merge).
-      const std::size_t init_l2 = l2.initial_state() + l1.num_states();
-      detail::merge(l1,l2);
-
-      // We no longer need l, so clear it to save memory
-      l2.clear();
-
-      // Run the partitioning algorithm on this prepropcessed LTS
-      detail::ready_sim_partitioner<LTS_TYPE> rsp(l1);      
-      rsp.partitioning_algorithm();
-
-      return rsp.in_preorder(l1.initial_state(),init_l2);
+      return detail::destructive_simulation_compare(l1,l2,true,false);
     }    
     case lts_pre_trace:
     {
@@ -869,129 +833,43 @@ bool destructive_compare(LTS_TYPE& l1, LTS_TYPE& l2, const lts_preorder pre, con
 template <class LTS_TYPE>
 bool is_deterministic(const LTS_TYPE& l)
 {
-  outgoing_transitions_per_state_action_t trans_lut=
-                  transitions_per_outgoing_state_action_pair(l.get_transitions(),l.hidden_label_map());
+  const adjacency_index& trans_lut=l.outgoing_transition_index();
 
-  for(outgoing_transitions_per_state_action_t::const_iterator i=trans_lut.begin(); i!=trans_lut.end(); ++i)
+  for(std::size_t s=0; s<trans_lut.num_states(); ++s)
   {
-    outgoing_transitions_per_state_action_t::const_iterator i_next=i;
-    i_next++;
-    if (i_next!=trans_lut.end() && 
-                  from(i)==from(i_next) && 
-                  label(i)==label(i_next) &&
-                  to(i)!=to(i_next))
-    {
-      // found a pair <s,l,t> and <s,l,t'> with t!=t', so l is not deterministic.
-      return false;
-    }
-  }
-  return true;
-}
-
-
-namespace detail
-{
-inline
-void get_trans(std::multimap < transition::size_type, std::pair < transition::size_type, transition::size_type > > &begin,
-                      tree_set_store& tss,
-                      std::size_t d,
-                      std::vector<transition> &d_trans)
-{
-  if (!tss.is_set_empty(d))
-  {
-    if (tss.is_set_empty(tss.get_set_child_right(d)))
+    // The transitions of s are sorted on label and target.
+    const adjacent_transition_range r=trans_lut.transitions(s);
+    for(std::size_t i=1; i<r.size(); ++i)
     {
-      for (std::multimap < transition::size_type, std::pair < transition::size_type, transition::size_type > > :: const_iterator
-           j=begin.lower_bound(tss.get_set_child_left(d)); j!=begin.upper_bound(tss.get_set_child_left(d)); ++j)
+      if (r[i-1].label==r[i].label && r[i-1].state!=r[i].state)
       {
-        d_trans.push_back(transition(j->first,j->second.first,j->second.second));
+        // found a pair <s,l,t> and <s,l,t'> with t!=t', so l is not deterministic.
+        return false;
       }
     }
-    else
-    {
-      get_trans(begin,tss,tss.get_set_child_left(d),d_trans);
-      get_trans(begin,tss,tss.get_set_child_right(d),d_trans);
-    }
   }
+  return true;
 }
-} // namespace detail
 
 
 template <class LTS_TYPE>
 void determinise(LTS_TYPE& l)
 {
-  tree_set_store tss;
-
-  std::vector<transition> d_transs;
-  std::vector<std::ptrdiff_t> d_states;
-
-  // create the initial state of the DLTS
-  d_states.push_back(l.initial_state());
-  std::ptrdiff_t d_id = tss.set_set_tag(tss.create_set(d_states));
-  d_states.clear();
-
-  std::multimap < transition::size_type, std::pair < transition::size_type, transition::size_type > >
-  begin=transitions_per_outgoing_state(l.get_transitions(),l.hidden_label_map());
+  // The states of the DLTS are the sets of states in the store, and the initial
+  // set is the first one.
+  detail::subset_store store;
+  std::vector<std::size_t> initial_state(1, l.initial_state());
+  store.insert(initial_state);
+
+  std::vector<transition> d_transitions;
+  detail::subset_construction(l.outgoing_transition_index(), store, d_transitions);
+  mCRL2log(log::debug) << "determinisation generated " << store.size() << " states and "
+                       << d_transitions.size() << " transitions, using " << store.encoded_bytes()
+                       << " bytes for the subsets" << std::endl;
 
   l.clear_transitions();
   l.clear_state_labels();
-  std::size_t d_ntransitions = 0;
-  std::vector < transition > d_transitions;
-
-  std::size_t s;
-  std::size_t i,to,lbl,n_t;
-
-  while (d_id < tss.get_next_tag())
-  {
-    // collect the outgoing transitions of every state of DLTS state d_id in
-    // the vector d_transs
-    detail::get_trans(begin,tss,tss.get_set(d_id),d_transs);
-
-    // sort d_transs by label and (if labels are equal) by destination
-    const detail::compare_transitions_lts compare(l.hidden_label_map());
-    sort(d_transs.begin(),d_transs.end(),compare);
-
-    n_t = d_transs.size();
-    i = 0;
-    for (lbl = 0; lbl < l.num_action_labels(); ++lbl)
-    {
-      // compute the destination of the transition with label lbl
-      while (i < n_t && l.apply_hidden_label_map(d_transs[i].label()) < lbl)
-      {
-        ++i;
-      }
-      while (i < n_t && l.apply_hidden_label_map(d_transs[i].label()) == lbl)
-      {
-        to = d_transs[i].to();
-        d_states.push_back(to);
-        while (i < n_t && l.apply_hidden_label_map(d_transs[i].label()) == lbl &&
-               d_transs[i].to() == to)
-        {
-          ++i;
-        }
-      }
-      s = tss.create_set(d_states);
-
-      // generate the transitions to each of the next states
-      if (!tss.is_set_empty(s))
-      {
-        d_transitions.push_back(transition(d_id,lbl,tss.set_set_tag(s)));
-
-        if (d_ntransitions%10000 == 0)
-        {
-          mCRL2log(log::debug) <<
-            "generated " << tss.get_next_tag() << " states and " << d_ntransitions
-                         << " transitions; explored " << d_id << " states" << std::endl;
-        }
-      }
-      d_states.clear();
-    }
-    d_transs.clear();
-    ++d_id;
-  }
-
-
-  l.set_num_states(d_id,false); // remove the state values, and reset the number of states.
+  l.set_num_states(store.size(),false); // remove the state values, and reset the number of states.
   l.set_initial_state(0);
 
   for (const transition& t: d_transitions)
@@ -33,12 +33,15 @@ enum lts_equivalence
 {
   lts_eq_none,             /**< Unknown or no equivalence */
   lts_eq_bisim,            /**< Strong bisimulation equivalence using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017] */
+  lts_eq_bisim_dnj,        /**< Strong bisimulation equivalence using the O(m log n) algorithm on labelled transitions */
   lts_eq_bisim_gv,         /**< Strong bisimulation equivalence using the O(mn) algorithm [Groote/Vaandrager 1990] */
   lts_eq_bisim_sigref,     /**< Strong bisimulation equivalence using the signature refinement algorithm [Blom/Orzan 2003] */
   lts_eq_branching_bisim,  /**< Branching bisimulation equivalence using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017] */
+  lts_eq_branching_bisim_dnj, /**< Branching bisimulation equivalence using the O(m log n) algorithm on labelled transitions */
   lts_eq_branching_bisim_gv,     /**< Branching bisimulation equivalence using the O(mn) algorithm [Groote/Vaandrager 1990] */
   lts_eq_branching_bisim_sigref, /**< Branching bisimulation equivalence using the signature refinement algorithm [Blom/Orzan 2003] */
   lts_eq_divergence_preserving_branching_bisim, /**< Divergence-preserving branching bisimulation equivalence using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017] */
+  lts_eq_divergence_preserving_branching_bisim_dnj, /**< Divergence-preserving branching bisimulation equivalence using the O(m log n) algorithm on labelled transitions */
   lts_eq_divergence_preserving_branching_bisim_gv,    /**< Divergence-preserving branching bisimulation equivalence using the O(mn) algorithm [Groote/Vaandrager 1990] */
   lts_eq_divergence_preserving_branching_bisim_sigref, /** Divergence-preserving branching bisimulation equivalence using the signature refinement algorithm [Blom/Orzan 2003] */
   lts_eq_weak_bisim,  /**< Weak bisimulation equivalence */
@@ -56,18 +59,25 @@ enum lts_equivalence
  * \li "none" for identity equivalence;
  * \li "bisim" for strong bisimilarity using the O(m log n) algorithm
  *          [Groote/Jansen/Keiren/Wijs 2017];
+ * \li "bisim-dnj" for strong bisimilarity using the O(m log n) algorithm that
+ *          works directly on the labelled transitions;
  * \li "bisim-gv" for strong bisimilarity using the O(mn) algorithm
  *          [Groote/Vaandrager 1990];
  * \li "bisim-sig" for strong bisimilarity using the signature refinement
  *          algorithm [Blom/Orzan 2003];
  * \li "branching-bisim" for branching bisimilarity using the O(m log n)
  *          algorithm [Groote/Jansen/Keiren/Wijs 2017];
+ * \li "branching-bisim-dnj" for branching bisimilarity using the O(m log n)
+ *          algorithm that works directly on the labelled transitions;
  * \li "branching-bisim-gv" for branching bisimilarity using the O(mn)
  *          algorithm [Groote/Vaandrager 1990];
  * \li "branching-bisim-sig" for branching bisimilarity using the signature
  *          refinement algorithm [Blom/Orzan 2003];
  * \li "dpbranching-bisim" for divergence-preserving branching bisimilarity
  *          using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017];
+ * \li "dpbranching-bisim-dnj" for divergence-preserving branching
+ *          bisimilarity using the O(m log n) algorithm that works directly on
+ *          the labelled transitions;
  * \li "dpbranching-bisim-gv" for divergence-preserving branching bisimilarity
  *          using the O(mn) algorithm [Groote/Vaandrager 1990];
  * \li "dpbranching-bisim-sig" for divergence-preserving branching bisimilarity
@@ -93,6 +103,10 @@ lts_equivalence parse_equivalence(std::string const& s)
   {
     return lts_eq_bisim;
   }
+  else if (s == "bisim-dnj")
+  {
+    return lts_eq_bisim_dnj;
+  }
   else if (s == "bisim-gv")
   {
     return lts_eq_bisim_gv;
@@ -105,6 +119,10 @@ lts_equivalence parse_equivalence(std::string const& s)
   {
     return lts_eq_branching_bisim;
   }
+  else if (s == "branching-bisim-dnj")
+  {
+    return lts_eq_branching_bisim_dnj;
+  }
   else if (s == "branching-bisim-gv")
   {
       return lts_eq_branching_bisim_gv;
@@ -117,6 +135,10 @@ lts_equivalence parse_equivalence(std::string const& s)
   {
     return lts_eq_divergence_preserving_branching_bisim;
   }
+  else if (s == "dpbranching-bisim-dnj")
+  {
+    return lts_eq_divergence_preserving_branching_bisim_dnj;
+  }
   else if (s == "dpbranching-bisim-gv")
   {
     return lts_eq_divergence_preserving_branching_bisim_gv;
@@ -193,18 +215,24 @@ inline std::string print_equivalence(const lts_equivalence eq)
       return "none";
     case lts_eq_bisim:
       return "bisim";
+    case lts_eq_bisim_dnj:
+      return "bisim-dnj";
     case lts_eq_bisim_gv:
       return "bisim-gv";
     case lts_eq_bisim_sigref:
       return "bisim-sig";
     case lts_eq_branching_bisim:
       return "branching-bisim";
+    case lts_eq_branching_bisim_dnj:
+      return "branching-bisim-dnj";
     case lts_eq_branching_bisim_gv:
       return "branching-bisim-gv";
     case lts_eq_branching_bisim_sigref:
       return "branching-bisim-sig";
     case lts_eq_divergence_preserving_branching_bisim:
       return "dpbranching-bisim";
+    case lts_eq_divergence_preserving_branching_bisim_dnj:
+      return "dpbranching-bisim-dnj";
     case lts_eq_divergence_preserving_branching_bisim_gv:
       return "dpbranching-bisim-gv";
     case lts_eq_divergence_preserving_branching_bisim_sigref:
@@ -250,18 +278,24 @@ inline std::string description(const lts_equivalence eq)
       return "identity equivalence";
     case lts_eq_bisim:
       return "strong bisimilarity using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017]";
+    case lts_eq_bisim_dnj:
+      return "strong bisimilarity using the O(m log n) algorithm on labelled transitions";
     case lts_eq_bisim_gv:
       return "strong bisimilarity using the O(mn) algorithm [Groote/Vaandrager 1990]";
     case lts_eq_bisim_sigref:
       return "strong bisimilarity using the signature refinement algorithm [Blom/Orzan 2003]";
     case lts_eq_branching_bisim:
       return "branching bisimilarity using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017]";
+    case lts_eq_branching_bisim_dnj:
+      return "branching bisimilarity using the O(m log n) algorithm on labelled transitions";
     case lts_eq_branching_bisim_gv:
       return "branching bisimilarity using the O(mn) algorithm [Groote/Vaandrager 1990]";
     case lts_eq_branching_bisim_sigref:
       return "branching bisimilarity using the signature refinement algorithm [Blom/Orzan 2003]";
     case lts_eq_divergence_preserving_branching_bisim:
       return "divergence-preserving branching bisimilarity using the O(m log n) algorithm [Groote/Jansen/Keiren/Wijs 2017]";
+    case lts_eq_divergence_preserving_branching_bisim_dnj:
+      return "divergence-preserving branching bisimilarity using the O(m log n) algorithm on labelled transitions";
     case lts_eq_divergence_preserving_branching_bisim_gv:
       return "divergence-preserving branching bisimilarity using the O(mn) algorithm [Groote/Vaandrager 1990]";
     case lts_eq_divergence_preserving_branching_bisim_sigref:
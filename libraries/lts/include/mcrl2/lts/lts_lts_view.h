@@ -0,0 +1,288 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+/** \file lts_lts_view.h
+ *
+ * \brief A read-only view on an LTS that is stored in the indexed .lts layout.
+ * \details The indexed layout consists of a fixed size header, a section with
+ * transitions of fixed width, a table with action labels and an optional
+ * section with state labels. The file is memory mapped. Transitions are decoded
+ * directly from the mapping, and state labels are only decoded when they are
+ * requested. An LTS can be written in this layout using save_indexed_lts, and
+ * lts_lts_t::load recognizes both the indexed and the aterm based layout.
+ */
+
+#ifndef MCRL2_LTS_LTS_LTS_VIEW_H
+#define MCRL2_LTS_LTS_LTS_VIEW_H
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mcrl2/lts/lts_lts.h"
+#include "mcrl2/utilities/memory_mapped_file.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+
+namespace detail
+{
+
+/// \brief The header of an LTS in the indexed .lts layout. All numbers are
+/// stored as 64 bit little endian integers. Offsets are relative to the start
+/// of the file.
+struct indexed_lts_header
+{
+  std::uint64_t version = 0;
+  std::uint64_t number_of_states = 0;
+  std::uint64_t number_of_transitions = 0;
+  std::uint64_t number_of_action_labels = 0;
+  std::uint64_t initial_state = 0;
+  std::uint64_t transition_width = 0;       // The number of bytes of a source, label or target field.
+  std::uint64_t transitions_offset = 0;
+  std::uint64_t meta_data_offset = 0;       // The data specification, process parameters and action declarations.
+  std::uint64_t meta_data_size = 0;
+  std::uint64_t action_labels_offset = 0;
+  std::uint64_t action_labels_size = 0;
+  std::uint64_t state_labels_offset = 0;    // An index with the offsets of blocks of state labels, followed by the blocks.
+  std::uint64_t state_labels_size = 0;      // Equal to zero if there are no state labels.
+  std::uint64_t state_label_block_size = 0; // The number of state labels in a block.
+};
+
+/// \brief Decodes a little endian integer of the given width.
+inline
+std::uint64_t read_little_endian(const unsigned char* p, const std::size_t width)
+{
+  std::uint64_t result = 0;
+  for (std::size_t i = width; i > 0; )
+  {
+    --i;
+    result = (result << 8) | p[i];
+  }
+  return result;
+}
+
+} // namespace detail
+
+/// \brief A read-only view on a file in the indexed .lts layout.
+/// \details The view is not thread safe, as decoded state labels are cached.
+class lts_lts_view
+{
+  public:
+    typedef std::size_t states_size_type;
+    typedef std::size_t labels_size_type;
+    typedef std::size_t transitions_size_type;
+
+    /// \brief Random access iterator over the transitions of the view.
+    class transition_iterator
+    {
+      protected:
+        const unsigned char* m_position;
+        std::size_t m_width;
+
+      public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef transition value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const transition* pointer;
+        typedef transition reference;
+
+        transition_iterator(const unsigned char* position, std::size_t width)
+          : m_position(position), m_width(width)
+        {}
+
+        transition operator*() const
+        {
+          return transition(detail::read_little_endian(m_position, m_width),
+                            detail::read_little_endian(m_position + m_width, m_width),
+                            detail::read_little_endian(m_position + 2 * m_width, m_width));
+        }
+
+        transition operator[](difference_type n) const
+        {
+          return *(*this + n);
+        }
+
+        transition_iterator& operator++()
+        {
+          m_position += 3 * m_width;
+          return *this;
+        }
+
+        transition_iterator operator++(int)
+        {
+          transition_iterator result = *this;
+          ++(*this);
+          return result;
+        }
+
+        transition_iterator& operator--()
+        {
+          m_position -= 3 * m_width;
+          return *this;
+        }
+
+        transition_iterator& operator+=(difference_type n)
+        {
+          m_position += n * 3 * static_cast<difference_type>(m_width);
+          return *this;
+        }
+
+        transition_iterator operator+(difference_type n) const
+        {
+          transition_iterator result = *this;
+          result += n;
+          return result;
+        }
+
+        difference_type operator-(const transition_iterator& other) const
+        {
+          return (m_position - other.m_position) / static_cast<difference_type>(3 * m_width);
+        }
+
+        bool operator==(const transition_iterator& other) const
+        {
+          return m_position == other.m_position;
+        }
+
+        bool operator!=(const transition_iterator& other) const
+        {
+          return m_position != other.m_position;
+        }
+
+        bool operator<(const transition_iterator& other) const
+        {
+          return m_position < other.m_position;
+        }
+    };
+
+  protected:
+    std::string m_filename;
+    utilities::memory_mapped_file m_file;
+    detail::indexed_lts_header m_header;
+    data::data_specification m_data_spec;
+    data::variable_list m_parameters;
+    process::action_label_list m_action_decls;
+    std::vector<action_label_lts> m_action_labels;
+
+    // The most recently decoded block of state labels.
+    mutable std::size_t m_cached_block = std::size_t(-1);
+    mutable std::vector<state_label_lts> m_cached_state_labels;
+
+    void decode_state_label_block(std::size_t block) const;
+
+  public:
+    /// \brief Opens the file with the given name, which must be in the indexed .lts layout.
+    explicit lts_lts_view(const std::string& filename);
+
+    lts_lts_view(const lts_lts_view&) = delete;
+    lts_lts_view& operator=(const lts_lts_view&) = delete;
+
+    states_size_type num_states() const
+    {
+      return m_header.number_of_states;
+    }
+
+    states_size_type initial_state() const
+    {
+      return m_header.initial_state;
+    }
+
+    transitions_size_type num_transitions() const
+    {
+      return m_header.number_of_transitions;
+    }
+
+    labels_size_type num_action_labels() const
+    {
+      return m_action_labels.size();
+    }
+
+    /// \brief Returns the i-th transition.
+    transition get_transition(const transitions_size_type i) const
+    {
+      assert(i < num_transitions());
+      return begin()[i];
+    }
+
+    transition_iterator begin() const
+    {
+      return transition_iterator(m_file.data() + m_header.transitions_offset, m_header.transition_width);
+    }
+
+    transition_iterator end() const
+    {
+      return begin() + num_transitions();
+    }
+
+    const action_label_lts& action_label(const labels_size_type action) const
+    {
+      assert(action < m_action_labels.size());
+      return m_action_labels[action];
+    }
+
+    bool is_tau(const labels_size_type action) const
+    {
+      return action == 0;
+    }
+
+    const data::data_specification& data() const
+    {
+      return m_data_spec;
+    }
+
+    const data::variable_list& process_parameters() const
+    {
+      return m_parameters;
+    }
+
+    const process::action_label_list& action_label_declarations() const
+    {
+      return m_action_decls;
+    }
+
+    bool has_state_info() const
+    {
+      return m_header.state_labels_size > 0;
+    }
+
+    /// \brief Returns the label of a state. The block of state labels containing
+    /// it is decoded if it is not the most recently decoded block.
+    state_label_lts state_label(const states_size_type state) const
+    {
+      assert(has_state_info() && state < num_states());
+      const std::size_t block = state / m_header.state_label_block_size;
+      if (block != m_cached_block)
+      {
+        decode_state_label_block(block);
+      }
+      return m_cached_state_labels[state % m_header.state_label_block_size];
+    }
+};
+
+/// \brief Returns true if the file with the given name is in the indexed .lts layout.
+bool is_indexed_lts_file(const std::string& filename);
+
+/// \brief Saves an LTS in the indexed .lts layout.
+/// \param l The LTS to be saved.
+/// \param filename The name of the file.
+void save_indexed_lts(const lts_lts_t& l, const std::string& filename);
+
+/// \brief Copies the contents of a view into an LTS. The state labels are not copied, but
+/// are decoded from the view when they are requested. For this purpose the LTS shares the
+/// ownership of the view.
+void load_lts_from_view(const std::shared_ptr<const lts_lts_view>& view, lts_lts_t& l);
+
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_LTS_LTS_VIEW_H
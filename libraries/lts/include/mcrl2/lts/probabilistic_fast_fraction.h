@@ -0,0 +1,405 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/probabilistic_fast_fraction.h
+/// \brief A fraction with a 64 bit representation that falls back to arbitrary
+///        precision when the enumerator or denominator does not fit.
+
+#ifndef MCRL2_LTS_PROBABILISTIC_FAST_FRACTION_H
+#define MCRL2_LTS_PROBABILISTIC_FAST_FRACTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "mcrl2/lts/probabilistic_arbitrary_precision_fraction.h"
+
+namespace mcrl2
+{
+
+namespace lts
+{
+
+/// \brief A fraction between 0 and 1 that is exact. As long as the enumerator and the
+/// denominator fit in 64 bits they are stored as machine words, and the arithmetic and
+/// comparisons are done with overflow checked word operations. Otherwise the value is
+/// stored as a probabilistic_arbitrary_precision_fraction.
+/// \details Values are kept in a canonical form: the enumerator and denominator have no
+/// common factors, and a value is only stored with arbitrary precision if it cannot be
+/// stored in words. Hence equality and hashing do not need any arithmetic.
+class probabilistic_fast_fraction
+{
+  public:
+    typedef std::uint64_t word;
+
+  protected:
+    word m_enumerator;
+    word m_denominator;
+    std::shared_ptr<const probabilistic_arbitrary_precision_fraction> m_big; // Only set if the value does not fit in words.
+
+    static word max_word()
+    {
+      return std::numeric_limits<word>::max();
+    }
+
+    static word gcd(word x, word y)
+    {
+      while (y != 0)
+      {
+        word r = x % y;
+        x = y;
+        y = r;
+      }
+      return x;
+    }
+
+    // Sets result to x * y, and returns false if this overflows.
+    static bool multiply(word x, word y, word& result)
+    {
+      if (x != 0 && y > max_word() / x)
+      {
+        return false;
+      }
+      result = x * y;
+      return true;
+    }
+
+    // Sets result to x + y, and returns false if this overflows.
+    static bool add(word x, word y, word& result)
+    {
+      if (y > max_word() - x)
+      {
+        return false;
+      }
+      result = x + y;
+      return true;
+    }
+
+    static utilities::big_natural_number to_big_natural_number(word x)
+    {
+      return utilities::big_natural_number(static_cast<std::size_t>(x));
+    }
+
+    static bool fits_in_word(const utilities::big_natural_number& x)
+    {
+      static const utilities::big_natural_number max = to_big_natural_number(max_word());
+      return x <= max;
+    }
+
+    // Sets the value to enumerator/denominator, where the arguments may have common factors.
+    void set(word enumerator, word denominator)
+    {
+      assert(denominator != 0);
+      word d = gcd(enumerator, denominator);
+      m_enumerator = enumerator / d;
+      m_denominator = denominator / d;
+      m_big.reset();
+    }
+
+    // Sets the value to x, which must have no common factors in its enumerator and denominator.
+    void set(const probabilistic_arbitrary_precision_fraction& x)
+    {
+      if (fits_in_word(x.enumerator()) && fits_in_word(x.denominator()))
+      {
+        m_enumerator = static_cast<std::size_t>(x.enumerator());
+        m_denominator = static_cast<std::size_t>(x.denominator());
+        m_big.reset();
+      }
+      else
+      {
+        m_big = std::make_shared<const probabilistic_arbitrary_precision_fraction>(x);
+      }
+    }
+
+    probabilistic_fast_fraction(const probabilistic_arbitrary_precision_fraction& x, bool /* is_reduced */)
+    {
+      set(x);
+    }
+
+  public:
+    /// \brief Constant zero.
+    static const probabilistic_fast_fraction& zero()
+    {
+      static probabilistic_fast_fraction zero(0, 1);
+      return zero;
+    }
+
+    /// \brief Constant one.
+    static const probabilistic_fast_fraction& one()
+    {
+      static probabilistic_fast_fraction one(1, 1);
+      return one;
+    }
+
+    /// \brief Default constructor. The fraction is zero.
+    probabilistic_fast_fraction()
+      : m_enumerator(0),
+        m_denominator(1)
+    {}
+
+    /// \brief Constructor of the fraction enumerator/denominator.
+    probabilistic_fast_fraction(word enumerator, word denominator)
+    {
+      assert(enumerator <= denominator);
+      set(enumerator, denominator);
+    }
+
+    /// \brief Constructor from strings of digits for the enumerator and denominator.
+    explicit probabilistic_fast_fraction(const std::string& enumerator, const std::string& denominator)
+      : probabilistic_fast_fraction(probabilistic_arbitrary_precision_fraction(enumerator, denominator))
+    {}
+
+    /// \brief Constructor from an arbitrary precision fraction.
+    explicit probabilistic_fast_fraction(const probabilistic_arbitrary_precision_fraction& x)
+    {
+      utilities::big_natural_number enumerator = x.enumerator();
+      utilities::big_natural_number denominator = x.denominator();
+      probabilistic_arbitrary_precision_fraction::remove_common_factors(enumerator, denominator);
+      set(probabilistic_arbitrary_precision_fraction(enumerator, denominator));
+    }
+
+    /// \brief Returns true if the fraction is stored in machine words.
+    bool is_small() const
+    {
+      return !m_big;
+    }
+
+    /// \brief Returns the fraction with arbitrary precision.
+    probabilistic_arbitrary_precision_fraction to_arbitrary_precision() const
+    {
+      if (m_big)
+      {
+        return *m_big;
+      }
+      return probabilistic_arbitrary_precision_fraction(to_big_natural_number(m_enumerator), to_big_natural_number(m_denominator));
+    }
+
+    /// \brief Conversion to an arbitrary precision fraction.
+    explicit operator probabilistic_arbitrary_precision_fraction() const
+    {
+      return to_arbitrary_precision();
+    }
+
+    /// \brief Returns the enumerator.
+    utilities::big_natural_number enumerator() const
+    {
+      return m_big ? m_big->enumerator() : to_big_natural_number(m_enumerator);
+    }
+
+    /// \brief Returns the denominator.
+    utilities::big_natural_number denominator() const
+    {
+      return m_big ? m_big->denominator() : to_big_natural_number(m_denominator);
+    }
+
+    /// \brief Standard comparison operator.
+    bool operator==(const probabilistic_fast_fraction& other) const
+    {
+      if (is_small() && other.is_small())
+      {
+        return m_enumerator == other.m_enumerator && m_denominator == other.m_denominator;
+      }
+      if (is_small() != other.is_small())
+      {
+        return false;
+      }
+      return m_big == other.m_big || (m_big->enumerator() == other.m_big->enumerator() && m_big->denominator() == other.m_big->denominator());
+    }
+
+    /// \brief Standard comparison operator.
+    bool operator!=(const probabilistic_fast_fraction& other) const
+    {
+      return !(*this == other);
+    }
+
+    /// \brief Standard comparison operator. The fractions are compared by cross multiplication.
+    bool operator<(const probabilistic_fast_fraction& other) const
+    {
+      word x;
+      word y;
+      if (is_small() && other.is_small()
+          && multiply(m_enumerator, other.m_denominator, x)
+          && multiply(other.m_enumerator, m_denominator, y))
+      {
+        return x < y;
+      }
+      return to_arbitrary_precision() < other.to_arbitrary_precision();
+    }
+
+    /// \brief Standard comparison operator.
+    bool operator<=(const probabilistic_fast_fraction& other) const
+    {
+      return !(other < *this);
+    }
+
+    /// \brief Standard comparison operator.
+    bool operator>(const probabilistic_fast_fraction& other) const
+    {
+      return other < *this;
+    }
+
+    /// \brief Standard comparison operator.
+    bool operator>=(const probabilistic_fast_fraction& other) const
+    {
+      return !(*this < other);
+    }
+
+    /// \brief Standard addition operator.
+    probabilistic_fast_fraction operator+(const probabilistic_fast_fraction& other) const
+    {
+      if (is_small() && other.is_small())
+      {
+        // a/b + c/d = (a*(d/g) + c*(b/g)) / (b*(d/g)) with g = gcd(b, d).
+        const word g = gcd(m_denominator, other.m_denominator);
+        word x;
+        word y;
+        word enumerator;
+        word denominator;
+        if (multiply(m_enumerator, other.m_denominator / g, x)
+            && multiply(other.m_enumerator, m_denominator / g, y)
+            && add(x, y, enumerator)
+            && multiply(m_denominator, other.m_denominator / g, denominator))
+        {
+          probabilistic_fast_fraction result;
+          result.set(enumerator, denominator);
+          return result;
+        }
+      }
+      return probabilistic_fast_fraction(to_arbitrary_precision() + other.to_arbitrary_precision(), true);
+    }
+
+    /// \brief Standard subtraction operator.
+    probabilistic_fast_fraction operator-(const probabilistic_fast_fraction& other) const
+    {
+      assert(other <= *this);
+      if (is_small() && other.is_small())
+      {
+        const word g = gcd(m_denominator, other.m_denominator);
+        word x;
+        word y;
+        word denominator;
+        if (multiply(m_enumerator, other.m_denominator / g, x)
+            && multiply(other.m_enumerator, m_denominator / g, y)
+            && multiply(m_denominator, other.m_denominator / g, denominator))
+        {
+          probabilistic_fast_fraction result;
+          result.set(x - y, denominator);
+          return result;
+        }
+      }
+      return probabilistic_fast_fraction(to_arbitrary_precision() - other.to_arbitrary_precision(), true);
+    }
+
+    /// \brief Standard multiplication operator.
+    probabilistic_fast_fraction operator*(const probabilistic_fast_fraction& other) const
+    {
+      if (is_small() && other.is_small())
+      {
+        // Cancel crosswise first, such that the result is reduced and overflows are less likely.
+        const word g1 = gcd(m_enumerator, other.m_denominator);
+        const word g2 = gcd(other.m_enumerator, m_denominator);
+        word enumerator;
+        word denominator;
+        if (multiply(m_enumerator / g1, other.m_enumerator / g2, enumerator)
+            && multiply(m_denominator / g2, other.m_denominator / g1, denominator))
+        {
+          probabilistic_fast_fraction result;
+          result.m_enumerator = enumerator;
+          result.m_denominator = denominator;
+          return result;
+        }
+      }
+      return probabilistic_fast_fraction(to_arbitrary_precision() * other.to_arbitrary_precision(), true);
+    }
+
+    /// \brief Standard division operator.
+    probabilistic_fast_fraction operator/(const probabilistic_fast_fraction& other) const
+    {
+      assert(other > zero());
+      if (is_small() && other.is_small())
+      {
+        word enumerator;
+        word denominator;
+        if (multiply(m_enumerator, other.m_denominator, enumerator)
+            && multiply(m_denominator, other.m_enumerator, denominator))
+        {
+          probabilistic_fast_fraction result;
+          result.set(enumerator, denominator);
+          return result;
+        }
+      }
+      return probabilistic_fast_fraction(to_arbitrary_precision() / other.to_arbitrary_precision(), true);
+    }
+
+    /// \brief Returns a hash value of the fraction.
+    std::size_t hash() const
+    {
+      if (m_big)
+      {
+        return std::hash<probabilistic_arbitrary_precision_fraction>()(*m_big);
+      }
+      return utilities::detail::hash_combine(static_cast<std::size_t>(m_enumerator), static_cast<std::size_t>(m_denominator));
+    }
+};
+
+/// \brief Pretty prints a fraction.
+inline std::string pp(const probabilistic_fast_fraction& x)
+{
+  std::stringstream s;
+  s << x.enumerator() << "/" << x.denominator();
+  return s.str();
+}
+
+inline
+std::ostream& operator<<(std::ostream& out, const probabilistic_fast_fraction& x)
+{
+  return out << pp(x);
+}
+
+namespace detail
+{
+
+/// \brief Selects the type in which the probabilistic bisimulation algorithms compute
+/// with probabilities of type PROBABILITY. Arbitrary precision fractions are replaced
+/// by fast fractions, and all other types are used as they are.
+template <typename PROBABILITY>
+struct fast_probability_fraction
+{
+  typedef PROBABILITY type;
+};
+
+template <>
+struct fast_probability_fraction<probabilistic_arbitrary_precision_fraction>
+{
+  typedef probabilistic_fast_fraction type;
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+namespace std
+{
+
+/// \brief specialization of the standard std::hash function.
+template <>
+struct hash<mcrl2::lts::probabilistic_fast_fraction>
+{
+  std::size_t operator()(const mcrl2::lts::probabilistic_fast_fraction& x) const
+  {
+    return x.hash();
+  }
+};
+
+} // namespace std
+
+#endif // MCRL2_LTS_PROBABILISTIC_FAST_FRACTION_H
@@ -1,4 +1,4 @@
-// Author(s): Jeroen Keiren
+// Author(s): Jeroen Keiren, Wieger Wesselink
 // Copyright: see the accompanying file COPYING or copy at
 // https://github.com/mCRL2org/mCRL2/blob/master/COPYING
 //
@@ -14,22 +14,39 @@
 #ifndef MCRL2_LTS_SIGREF_H
 #define MCRL2_LTS_SIGREF_H
 
-#include <set>
-#include <map>
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "mcrl2/atermpp/concurrent_indexed_set.h"
 #include "mcrl2/lts/lts.h"
-#include "mcrl2/lts/lts_utilities.h"
+#include "mcrl2/lts/detail/tarjan_components.h"
+#include "mcrl2/utilities/hash_utility.h"
 #include "mcrl2/utilities/logger.h"
+#include "mcrl2/utilities/parallel.h"
 
 namespace mcrl2
 {
 namespace lts
 {
 
-/** \brief A signature is a pair of an action label and a block */
-typedef std::set<std::pair<std::size_t, std::size_t> > signature_t;
+/** \brief An element of a signature, i.e. a pair of an action label and a block.
+  * A signature is a sorted sequence of such pairs without duplicates. */
+typedef std::pair<std::size_t, std::size_t> signature_entry;
 
-/** \brief Base class for signature computation */
+/** \brief Base class for signature computation.
+  *
+  * The states of the LTS are grouped into components that always end up in the
+  * same block. For strong bisimulation every state is a component on its own.
+  * The signatures of the components are computed layer by layer: the signature
+  * of a component may only depend on the signatures of components in earlier
+  * layers. Within a layer the signatures are computed in parallel.
+  *
+  * All data structures that are used during the computation are plain arrays
+  * of integers, so no terms are touched by the worker threads.
+  */
 template < class LTS_T >
 class signature
 {
@@ -37,40 +54,341 @@ protected:
   /** \brief The labelled transition system for which the signature is computed */
   const LTS_T& m_lts;
 
-  /** \brief Signature stored per state */
-  std::vector<signature_t> m_sig;
+  /** \brief The number of threads that is used to compute signatures */
+  std::size_t m_number_of_threads;
+
+  /** \brief The outgoing transitions per state, with the hidden label map applied
+             to the labels. This is the index that is cached by the LTS. It is shared
+             with the LTS, so it remains valid if the LTS is changed, e.g. when it is
+             replaced by its quotient. */
+  const std::shared_ptr<const adjacency_index> m_transition_index;
+  const adjacency_index& m_transitions;
+
+  /** \brief Records for each label whether it is a tau label */
+  std::vector<bool> m_is_tau;
+
+  /** \brief The component of each state */
+  std::vector<std::size_t> m_component;
+
+  /** \brief The states of component c are m_members[m_member_begin[c], m_member_begin[c + 1]) */
+  std::vector<std::size_t> m_member_begin;
+  std::vector<std::size_t> m_members;
+
+  /** \brief The components of layer i are m_layers[m_layer_begin[i], m_layer_begin[i + 1]) */
+  std::vector<std::size_t> m_layer_begin;
+  std::vector<std::size_t> m_layers;
+
+  /** \brief The signature of component c is stored in m_entries[m_signature_begin[c], m_signature_end[c]) */
+  std::vector<signature_entry> m_entries;
+  std::vector<std::size_t> m_signature_begin;
+  std::vector<std::size_t> m_signature_end;
+  std::vector<std::size_t> m_signature_hash;
+
+  /** \brief An index of the sets in an arena, from their hash value to their position */
+  typedef std::unordered_multimap<std::size_t, std::pair<std::size_t, std::size_t> > set_index;
+
+  /** \brief If true, equal signatures are stored only once in m_entries; m_signature_sets
+             is the index of the signatures in m_entries */
+  bool m_share_signatures = false;
+  set_index m_signature_sets;
+
+  /** \brief Per thread buffers for the computation of signatures */
+  std::vector<std::vector<signature_entry> > m_buffers;
+  std::vector<std::vector<signature_entry> > m_scratch;
+  std::vector<set_index> m_buffer_sets;
+  std::vector<std::size_t> m_owner;
+
+  /** \brief Adds the entries of the signature of component c to result; the entries
+    *        need not be sorted and may contain duplicates.
+    * \param[in] c A component
+    * \param[in] partition The current partition
+    * \param[out] result The vector to which the entries are added
+    */
+  virtual void add_entries(std::size_t c, const std::vector<std::size_t>& partition, std::vector<signature_entry>& result) const = 0;
+
+  bool is_inert(std::size_t from, std::size_t label, std::size_t to, const std::vector<std::size_t>& partition) const
+  {
+    return m_is_tau[label] && partition[from] == partition[to];
+  }
+
+  /** \brief Makes every state a component on its own, in a single layer */
+  void set_trivial_components()
+  {
+    const std::size_t n = m_lts.num_states();
+    m_component.resize(n);
+    m_member_begin.resize(n + 1);
+    m_members.resize(n);
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      m_component[s] = s;
+      m_member_begin[s] = s;
+      m_members[s] = s;
+    }
+    m_member_begin[n] = n;
+    m_layers = m_members;
+    m_layer_begin = { 0, n };
+  }
+
+  /** \brief Returns the position of the set [first, last) in \a arena. The set is
+    *        appended to the arena if the index does not contain it yet.
+    */
+  static std::pair<std::size_t, std::size_t> insert_set(std::vector<signature_entry>& arena,
+                                                        set_index& index,
+                                                        const signature_entry* first,
+                                                        const signature_entry* last)
+  {
+    std::hash<signature_entry> hash_entry;
+    std::size_t h = 0;
+    for (const signature_entry* i = first; i != last; ++i)
+    {
+      h = utilities::detail::hash_combine(h, hash_entry(*i));
+    }
+    const std::size_t size = last - first;
+    const auto range = index.equal_range(h);
+    for (auto i = range.first; i != range.second; ++i)
+    {
+      const std::pair<std::size_t, std::size_t>& position = i->second;
+      if (position.second - position.first == size && std::equal(first, last, arena.begin() + position.first))
+      {
+        return position;
+      }
+    }
+    const std::pair<std::size_t, std::size_t> position(arena.size(), arena.size() + size);
+    arena.insert(arena.end(), first, last);
+    index.emplace(h, position);
+    return position;
+  }
+
+  /** \brief Computes sets of entries for the components of one layer, and stores
+    *        them sorted and without duplicates in an arena.
+    * \param[in] layer The index of a layer
+    * \param[in] add A function add(c, result) that adds the entries of component c to result
+    * \param[out] entries The arena to which the sets are appended
+    * \param[out] first_entry The position of the set of each component in the arena
+    * \param[out] last_entry The end position of the set of each component in the arena
+    * \param[in/out] sets If not null, the index of the sets in the arena. Equal sets are
+    *        then stored only once, both in the buffers of the threads and in the arena.
+    */
+  template <typename AddEntries>
+  void compute_layer(std::size_t layer,
+                     AddEntries add,
+                     std::vector<signature_entry>& entries,
+                     std::vector<std::size_t>& first_entry,
+                     std::vector<std::size_t>& last_entry,
+                     set_index* sets = nullptr
+                    )
+  {
+    const std::size_t* components = m_layers.data() + m_layer_begin[layer];
+    const std::size_t size = m_layer_begin[layer + 1] - m_layer_begin[layer];
+
+    utilities::parallel_for(size, m_number_of_threads, [&](std::size_t thread, std::size_t first, std::size_t last)
+    {
+      std::vector<signature_entry>& buffer = m_buffers[thread];
+      std::vector<signature_entry>& scratch = m_scratch[thread];
+      for (std::size_t i = first; i < last; ++i)
+      {
+        const std::size_t c = components[i];
+        scratch.clear();
+        add(c, scratch);
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+        if (sets != nullptr)
+        {
+          const std::pair<std::size_t, std::size_t> position = insert_set(buffer, m_buffer_sets[thread], scratch.data(), scratch.data() + scratch.size());
+          first_entry[c] = position.first;
+          last_entry[c] = position.second;
+        }
+        else
+        {
+          first_entry[c] = buffer.size();
+          buffer.insert(buffer.end(), scratch.begin(), scratch.end());
+          last_entry[c] = buffer.size();
+        }
+        m_owner[c] = thread;
+      }
+    });
+
+    if (sets != nullptr)
+    {
+      // Move the distinct sets of the threads to the arena, and translate the positions.
+      // An empty set may start at the same position as another set, so empty sets are
+      // not translated.
+      std::vector<std::vector<std::size_t> > translation(m_buffers.size());
+      for (std::size_t thread = 0; thread < m_buffers.size(); ++thread)
+      {
+        translation[thread].resize(m_buffers[thread].size());
+        for (const auto& set: m_buffer_sets[thread])
+        {
+          const std::pair<std::size_t, std::size_t>& position = set.second;
+          if (position.first == position.second)
+          {
+            continue;
+          }
+          translation[thread][position.first] = insert_set(entries, *sets, m_buffers[thread].data() + position.first, m_buffers[thread].data() + position.second).first;
+        }
+        m_buffers[thread].clear();
+        m_buffer_sets[thread].clear();
+      }
+      utilities::parallel_for(size, m_number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+      {
+        for (std::size_t i = first; i < last; ++i)
+        {
+          const std::size_t c = components[i];
+          const std::size_t position = first_entry[c] == last_entry[c] ? 0 : translation[m_owner[c]][first_entry[c]];
+          last_entry[c] = position + (last_entry[c] - first_entry[c]);
+          first_entry[c] = position;
+        }
+      }, 4096);
+      return;
+    }
+
+    // Move the buffers of the threads to the end of entries.
+    std::vector<std::size_t> offset(m_buffers.size());
+    for (std::size_t thread = 0; thread < m_buffers.size(); ++thread)
+    {
+      offset[thread] = entries.size();
+      entries.insert(entries.end(), m_buffers[thread].begin(), m_buffers[thread].end());
+      m_buffers[thread].clear();
+    }
+    utilities::parallel_for(size, m_number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+    {
+      for (std::size_t i = first; i < last; ++i)
+      {
+        const std::size_t c = components[i];
+        first_entry[c] += offset[m_owner[c]];
+        last_entry[c] += offset[m_owner[c]];
+      }
+    }, 4096);
+  }
+
+  /** \brief Computes the signatures of the components of one layer */
+  void compute_layer(std::size_t layer, const std::vector<std::size_t>& partition)
+  {
+    compute_layer(layer,
+                  [&](std::size_t c, std::vector<signature_entry>& result) { add_entries(c, partition, result); },
+                  m_entries, m_signature_begin, m_signature_end,
+                  m_share_signatures ? &m_signature_sets : nullptr
+                 );
+  }
+
+  /** \brief Is called before the signatures are computed with respect to \a partition.
+    *        It can be used to compute auxiliary information on which the signatures depend. */
+  virtual void prepare_signature(const std::vector<std::size_t>& /* partition */)
+  {}
 
 public:
   /** \brief Constructor
+    * \param[in] lts_ The LTS
+    * \param[in] number_of_threads The number of threads; 0 means the number of hardware threads
     */
-  signature(const LTS_T& lts_)
-    : m_lts(lts_), m_sig(m_lts.num_states(), signature_t())
-  {}
+  signature(const LTS_T& lts_, std::size_t number_of_threads = 0)
+    : m_lts(lts_),
+      m_number_of_threads(utilities::number_of_threads(number_of_threads)),
+      m_transition_index(lts_.shared_outgoing_transition_index()),
+      m_transitions(*m_transition_index),
+      m_buffers(m_number_of_threads),
+      m_scratch(m_number_of_threads),
+      m_buffer_sets(m_number_of_threads)
+  {
+    m_is_tau.resize(m_lts.num_action_labels());
+    for (std::size_t a = 0; a < m_lts.num_action_labels(); ++a)
+    {
+      m_is_tau[a] = m_lts.is_tau(a);
+    }
+  }
+
+  virtual ~signature() = default;
 
   /** \brief Compute a new signature based on \a partition.
     * \param[in] partition The current partition
     */
-  virtual void compute_signature(const std::vector<std::size_t>& partition) = 0;
+  void compute_signature(const std::vector<std::size_t>& partition)
+  {
+    const std::size_t n = number_of_components();
+    m_entries.clear();
+    m_signature_sets.clear();
+    m_signature_begin.resize(n);
+    m_signature_end.resize(n);
+    m_signature_hash.resize(n);
+    m_owner.resize(n);
+    prepare_signature(partition);
+    for (std::size_t layer = 0; layer + 1 < m_layer_begin.size(); ++layer)
+    {
+      compute_layer(layer, partition);
+    }
+
+    utilities::parallel_for(n, m_number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+    {
+      std::hash<signature_entry> hash_entry;
+      for (std::size_t c = first; c < last; ++c)
+      {
+        std::size_t h = 0;
+        for (std::size_t i = m_signature_begin[c]; i != m_signature_end[c]; ++i)
+        {
+          h = utilities::detail::hash_combine(h, hash_entry(m_entries[i]));
+        }
+        m_signature_hash[c] = h;
+      }
+    });
+  }
 
   /** \brief Compute the transitions for the quotient according to \a partition.
     * \param[in] partition The partition that is used to compute the quotient
-    * \param[out] transitions A set to which the transitions of the quotient are written
+    * \param[out] transitions A vector to which the transitions of the quotient are
+    *             written; it may contain duplicates
     */
-  virtual void quotient_transitions(std::set<transition>& transitions, const std::vector<std::size_t>& partition)
+  virtual void quotient_transitions(std::vector<transition>& transitions, const std::vector<std::size_t>& partition) const
   {
-    for(std::vector<transition>::const_iterator i = m_lts.get_transitions().begin(); i != m_lts.get_transitions().end(); ++i)
+    for (std::size_t s = 0; s < m_lts.num_states(); ++s)
     {
-      transitions.insert(transition(partition[i->from()], i->label(), partition[i->to()]));
+      for (const adjacent_transition& i: m_transitions.transitions(s))
+      {
+        transitions.push_back(transition(partition[s], i.label, partition[i.state]));
+      }
     }
   }
 
-  /** \brief Return the signature for state \a i.
-    * \param[in] i The state for which to return the signature.
-    * \pre i < m_lts.num_states().
-    */
-  virtual const signature_t& get_signature(std::size_t i) const
+  /** \brief Returns the number of components */
+  std::size_t number_of_components() const
+  {
+    return m_member_begin.size() - 1;
+  }
+
+  /** \brief Returns the component of state \a s */
+  std::size_t component(std::size_t s) const
+  {
+    return m_component[s];
+  }
+
+  /** \brief Returns the threads that are used for the computation */
+  std::size_t number_of_threads() const
+  {
+    return m_number_of_threads;
+  }
+
+  /** \brief Returns a pointer to the first entry of the signature of component \a c */
+  const signature_entry* begin(std::size_t c) const
+  {
+    return m_entries.data() + m_signature_begin[c];
+  }
+
+  /** \brief Returns a pointer past the last entry of the signature of component \a c */
+  const signature_entry* end(std::size_t c) const
+  {
+    return m_entries.data() + m_signature_end[c];
+  }
+
+  /** \brief Returns the hash value of the signature of component \a c */
+  std::size_t hash(std::size_t c) const
+  {
+    return m_signature_hash[c];
+  }
+
+  /** \brief Returns true if the components \a c1 and \a c2 have the same signature */
+  bool equal(std::size_t c1, std::size_t c2) const
   {
-    return m_sig[i];
+    return m_signature_end[c1] - m_signature_begin[c1] == m_signature_end[c2] - m_signature_begin[c2]
+           && std::equal(begin(c1), end(c1), begin(c2));
   }
 };
 
@@ -79,104 +397,191 @@ template < class LTS_T >
 class signature_bisim: public signature<LTS_T>
 {
 protected:
-  using signature<LTS_T>::m_lts;
-  using signature<LTS_T>::m_sig;
-
-public:
-  /** \brief Constructor */
-  signature_bisim(const LTS_T& lts_)
-    : signature<LTS_T>(lts_)
-  {
-    mCRL2log(log::verbose, "sigref") << "initialising signature computation for strong bisimulation" << std::endl;
-  }
+  using signature<LTS_T>::m_transitions;
 
   /** \overload */
-  virtual void
-  compute_signature(const std::vector<std::size_t>& partition)
+  void add_entries(std::size_t s, const std::vector<std::size_t>& partition, std::vector<signature_entry>& result) const
   {
-    // compute signatures
-    m_sig = std::vector<signature_t>(m_lts.num_states(), signature_t());
-    for(std::vector<transition>::const_iterator i = m_lts.get_transitions().begin(); i != m_lts.get_transitions().end(); ++i)
+    for (const adjacent_transition& i: m_transitions.transitions(s))
     {
-      m_sig[i->from()].insert(std::make_pair(m_lts.apply_hidden_label_map(i->label()), partition[i->to()]));
+      result.push_back(signature_entry(i.label, partition[i.state]));
     }
   }
 
+public:
+  /** \brief Constructor */
+  signature_bisim(const LTS_T& lts_, std::size_t number_of_threads = 0)
+    : signature<LTS_T>(lts_, number_of_threads)
+  {
+    mCRL2log(log::verbose, "sigref") << "initialising signature computation for strong bisimulation" << std::endl;
+    signature<LTS_T>::set_trivial_components();
+  }
 };
 
-/** \brief Class for computing the signature for branching bisimulation */
+/** \brief Class for computing the signature for branching bisimulation
+  *
+  * The signature of a state consists of its non-inert transitions, together with
+  * the signatures of the states that it can reach by an inert tau transition, as
+  * described in S. Blom, S. Orzan, "Distributed Branching Bisimulation Reduction of
+  * State Spaces", Proc. PDMC 2003.
+  *
+  * The states of a tau strongly connected component always end up in the same
+  * block, so they share a signature. These components form an acyclic graph, and
+  * the layer of a component is the length of the longest tau path to a component
+  * without outgoing tau transitions. Hence the signature of a state only depends
+  * on signatures in earlier layers.
+  */
 template < class LTS_T >
 class signature_branching_bisim: public signature<LTS_T>
 {
 protected:
-  using signature<LTS_T>::m_lts;
-  using signature<LTS_T>::m_sig;
-
-  /** \brief Store the incoming transitions per state */
-  outgoing_transitions_per_state_t m_prev_transitions;
+  typedef signature<LTS_T> super;
+  using super::m_lts;
+  using super::m_transitions;
+  using super::m_is_tau;
+  using super::m_component;
+  using super::m_member_begin;
+  using super::m_members;
+  using super::m_layer_begin;
+  using super::m_layers;
+  using super::m_entries;
+  using super::m_signature_begin;
+  using super::m_signature_end;
+  using super::is_inert;
 
-  /** \brief Insert function
-    * \param[in] partition The current partition
-    * \param[in] t source state
-    * \param[in] label_ transition label
-    * \param[in] block target block
-    *
-    * Insert function as described in S. Blom, S. Orzan,
-    * "Distributed Branching Bisimulation Reduction of State Spaces",
-    * Proc. PDMC 2003.
-    *
-    * Inserts the pair (label_, block) in the signature of t, as well as
-    * the signatures of all tau-predecessors of t within the same block.
-    */
-  void insert(const std::vector<std::size_t>& partition, const std::size_t t, const std::size_t label_, const std::size_t block)
+  /** \brief Adds the entries of component c for the non-inert transitions and the
+             signatures of the components reachable by an inert transition. */
+  void add_branching_entries(std::size_t c, const std::vector<std::size_t>& partition, std::vector<signature_entry>& result) const
   {
-    if(m_sig[t].insert(std::make_pair(label_, block)).second)
+    std::size_t previous = c;
+    for (std::size_t j = m_member_begin[c]; j != m_member_begin[c + 1]; ++j)
     {
-      std::pair<outgoing_transitions_per_state_t::const_iterator, outgoing_transitions_per_state_t::const_iterator> pred_range
-          = m_prev_transitions.equal_range(t);
-
-      for(outgoing_transitions_per_state_t::const_iterator i = pred_range.first; i != pred_range.second; ++i)
+      const std::size_t s = m_members[j];
+      for (const adjacent_transition& i: m_transitions.transitions(s))
       {
-        assert(from(i) == t);
-        if(m_lts.is_tau(label(i)) && partition[from(i)] == partition[to(i)])
+        const std::size_t label = i.label;
+        const std::size_t t = i.state;
+        if (!is_inert(s, label, t, partition))
+        {
+          result.push_back(signature_entry(label, partition[t]));
+        }
+        else if (m_component[t] != c && m_component[t] != previous)
         {
-          insert(partition, to(i), label_, block);
+          previous = m_component[t];
+          result.insert(result.end(), m_entries.begin() + m_signature_begin[previous], m_entries.begin() + m_signature_end[previous]);
         }
       }
     }
   }
 
-public:
-  /** \brief Constructor  */
-  signature_branching_bisim(const LTS_T& lts_)
-    : signature<LTS_T>(lts_),
-      m_prev_transitions(transitions_per_outgoing_state_reversed(lts_.get_transitions(),lts_.hidden_label_map()))
+  /** \overload */
+  void add_entries(std::size_t c, const std::vector<std::size_t>& partition, std::vector<signature_entry>& result) const
   {
-    mCRL2log(log::verbose, "sigref") << "initialising signature computation for branching bisimulation" << std::endl;
+    add_branching_entries(c, partition, result);
   }
 
-  /** \overload */
-  virtual void compute_signature(const std::vector<std::size_t>& partition)
+  /** \brief Computes the tau strongly connected components, and assigns them to layers.
+    *
+    * Components are numbered in the order in which Tarjan's algorithm finds them,
+    * so a component is numbered after all components that are reachable from it.
+    */
+  void compute_tau_components()
   {
-    // compute signatures
-    m_sig = std::vector<signature_t>(m_lts.num_states(), signature_t());
-    for(std::vector<transition>::const_iterator i = m_lts.get_transitions().begin(); i != m_lts.get_transitions().end(); ++i)
+    const std::size_t n = m_lts.num_states();
+    std::vector<std::size_t> tau_begin(n + 1, 0);
+    std::vector<std::size_t> tau_successors;
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      tau_begin[s] = tau_successors.size();
+      for (const adjacent_transition& i: m_transitions.transitions(s))
+      {
+        if (m_is_tau[i.label])
+        {
+          tau_successors.push_back(i.state);
+        }
+      }
+    }
+    tau_begin[n] = tau_successors.size();
+    const std::size_t number_of_components = detail::tarjan_components(tau_begin, tau_successors, m_component);
+
+    // Group the states per component.
+    m_member_begin.assign(number_of_components + 1, 0);
+    for (std::size_t s = 0; s < n; ++s)
     {
-      if (!(m_lts.is_tau(m_lts.apply_hidden_label_map(i->label())) && (partition[i->from()] == partition[i->to()])))
+      m_member_begin[m_component[s] + 1]++;
+    }
+    for (std::size_t c = 0; c < number_of_components; ++c)
+    {
+      m_member_begin[c + 1] += m_member_begin[c];
+    }
+    m_members.resize(n);
+    std::vector<std::size_t> position(m_member_begin.begin(), m_member_begin.end() - 1);
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      m_members[position[m_component[s]]++] = s;
+    }
+
+    // Compute the layers. The tau successors of a component have a smaller number.
+    std::vector<std::size_t> layer(number_of_components, 0);
+    std::size_t number_of_layers = number_of_components == 0 ? 0 : 1;
+    for (std::size_t c = 0; c < number_of_components; ++c)
+    {
+      for (std::size_t j = m_member_begin[c]; j != m_member_begin[c + 1]; ++j)
       {
-        insert(partition, i->from(), m_lts.apply_hidden_label_map(i->label()), partition[i->to()]);
+        const std::size_t s = m_members[j];
+        for (const adjacent_transition& i: m_transitions.transitions(s))
+        {
+          const std::size_t d = m_component[i.state];
+          if (m_is_tau[i.label] && d != c)
+          {
+            assert(d < c);
+            layer[c] = std::max(layer[c], layer[d] + 1);
+          }
+        }
       }
+      number_of_layers = std::max(number_of_layers, layer[c] + 1);
+    }
+    m_layer_begin.assign(number_of_layers + 1, 0);
+    for (std::size_t c = 0; c < number_of_components; ++c)
+    {
+      m_layer_begin[layer[c] + 1]++;
+    }
+    for (std::size_t l = 0; l < number_of_layers; ++l)
+    {
+      m_layer_begin[l + 1] += m_layer_begin[l];
+    }
+    m_layers.resize(number_of_components);
+    position.assign(m_layer_begin.begin(), m_layer_begin.end() - 1);
+    for (std::size_t c = 0; c < number_of_components; ++c)
+    {
+      m_layers[position[layer[c]]++] = c;
     }
+
+    mCRL2log(log::verbose, "sigref") << "found " << number_of_components << " tau components in " << number_of_layers << " layers" << std::endl;
+  }
+
+public:
+  /** \brief Constructor  */
+  signature_branching_bisim(const LTS_T& lts_, std::size_t number_of_threads = 0)
+    : signature<LTS_T>(lts_, number_of_threads)
+  {
+    mCRL2log(log::verbose, "sigref") << "initialising signature computation for branching bisimulation" << std::endl;
+    compute_tau_components();
   }
 
   /** \overload */
-  virtual void quotient_transitions(std::set<transition>& transitions, const std::vector<std::size_t>& partition)
+  void quotient_transitions(std::vector<transition>& transitions, const std::vector<std::size_t>& partition) const
   {
-    for(std::vector<transition>::const_iterator i = m_lts.get_transitions().begin(); i != m_lts.get_transitions().end(); ++i)
+    for (std::size_t s = 0; s < m_lts.num_states(); ++s)
     {
-      if(partition[i->from()] != partition[i->to()] || !m_lts.is_tau(m_lts.apply_hidden_label_map(i->label())))
+      for (const adjacent_transition& i: m_transitions.transitions(s))
       {
-        transitions.insert(transition(partition[i->from()], m_lts.apply_hidden_label_map(i->label()), partition[i->to()]));
+        const std::size_t label = i.label;
+        const std::size_t t = i.state;
+        if (!is_inert(s, label, t, partition))
+        {
+          transitions.push_back(transition(partition[s], label, partition[t]));
+        }
       }
     }
   }
@@ -187,100 +592,58 @@ template < class LTS_T >
 class signature_divergence_preserving_branching_bisim: public signature_branching_bisim<LTS_T>
 {
 protected:
-  using signature_branching_bisim<LTS_T>::m_lts;
-  using signature_branching_bisim<LTS_T>::m_sig;
-  using signature_branching_bisim<LTS_T>::insert;
+  typedef signature_branching_bisim<LTS_T> super;
+  using super::m_lts;
+  using super::m_transitions;
+  using super::m_component;
+  using super::m_member_begin;
+  using super::m_members;
+  using super::m_is_tau;
+  using super::is_inert;
+  using super::add_branching_entries;
 
-  /** \brief Record for each vertex whether it is in a tau-scc */
+  /** \brief Record for each state whether it is in a tau-scc, i.e. a tau component
+             with more than one state, or a single state with a tau-loop */
   std::vector<bool> m_divergent;
 
-  /** \brief Iterative implementation of Tarjan's SCC algorithm.
-   *
-   * based on an earlier implementation by Sjoerd Cranen
-   *
-   * For the non-trivial tau-sccs (i.e. SCCs with more than one state, or
-   * single-state SCCs with a tau-loop, we set \a m_divergent to true.
-   */
-  void compute_tau_sccs()
-  {
-    std::size_t unused = 1, lastscc = 1;
-    std::vector<std::size_t> scc(m_lts.num_states(), 0);
-	  std::vector<std::size_t> low(m_lts.num_states(), 0);
-	  std::stack<std::size_t> stack;
-	  std::stack<std::size_t> sccstack;
-
-    // Record forward transition relation sorted by state.
-	  outgoing_transitions_per_state_t m_lts_succ_transitions(transitions_per_outgoing_state(m_lts.get_transitions(),m_lts.hidden_label_map()));
-
-	  for (std::size_t i = 0; i < m_lts.num_states(); ++i)
-	  {
-		  if (scc[i] == 0)
-			  stack.push(i);
-		  while (!stack.empty())
-		  {
-			  std::size_t vi = stack.top();
-
-        // Outgoing transitions of vi.
-        std::pair<outgoing_transitions_per_state_t::const_iterator, outgoing_transitions_per_state_t::const_iterator> succ_range
-          = m_lts_succ_transitions.equal_range(vi);
-
-			  if (low[vi] == 0 && scc[vi] == 0)
-			  {
-				  scc[vi] = unused;
-				  low[vi] = unused++;
-				  sccstack.push(vi);
-
-				  for (outgoing_transitions_per_state_t::const_iterator t = succ_range.first; t != succ_range.second; ++t)
-				  {
-            if ((low[to(t)] == 0) && (scc[to(t)] == 0) && (m_lts.is_tau(label(t))))
-					  {
-						  stack.push(to(t));
-						}
-				  }
-			  }
-			  else
-			  {
-				  for (outgoing_transitions_per_state_t::const_iterator t = succ_range.first; t != succ_range.second; ++t)
-				  {
-					  if ((low[to(t)] != 0) && (m_lts.is_tau(label(t))))
-						  low[vi] = low[vi] < low[to(t)] ? low[vi] : low[to(t)];
-				  }
-				  if (low[vi] == scc[vi])
-				  {
-					  std::size_t tos, scc_id = lastscc++;
-            std::vector<std::size_t> this_scc;
-					  do
-					  {
-						  tos = sccstack.top();
-						  low[tos] = 0;
-						  scc[tos] = scc_id;
-						  sccstack.pop();
-              this_scc.push_back(tos);
-					  }
-					  while (tos != vi);
-
-            // We only consider non-trivial sccs, hence
-            // if the scc consists of a single schate, check whether it has a tau-loop
-            if(this_scc.size() == 1)
-            {
-              for(outgoing_transitions_per_state_t::const_iterator i = succ_range.first; i != succ_range.second; ++i)
-              {
-                if(from(i) == to(i) && m_lts.is_tau(label(i)))
-                {
-                  m_divergent[tos] = true;
-                  break;
-                }
-              }
-            }
-            else
-            {
-              m_divergent[tos] = true;
-            }
-				  }
-				  stack.pop();
-			  }
-		  }
-	  }
+  void compute_divergent_states()
+  {
+    for (std::size_t c = 0; c + 1 < m_member_begin.size(); ++c)
+    {
+      bool divergent = m_member_begin[c + 1] - m_member_begin[c] > 1;
+      const std::size_t s = m_members[m_member_begin[c]];
+      for (const adjacent_transition& i: m_transitions.transitions(s))
+      {
+        divergent = divergent || (m_is_tau[i.label] && i.state == s);
+      }
+      for (std::size_t j = m_member_begin[c]; j != m_member_begin[c + 1]; ++j)
+      {
+        m_divergent[m_members[j]] = divergent;
+      }
+    }
+  }
+
+  /** \overload
+    *
+    * Compute the signature as in branching bisimulation. In addition, add the
+    * (tau, B) for edges s -tau-> t for which s,t in B and m_divergent[t]
+    */
+  void add_entries(std::size_t c, const std::vector<std::size_t>& partition, std::vector<signature_entry>& result) const
+  {
+    add_branching_entries(c, partition, result);
+    for (std::size_t j = m_member_begin[c]; j != m_member_begin[c + 1]; ++j)
+    {
+      const std::size_t s = m_members[j];
+      for (const adjacent_transition& i: m_transitions.transitions(s))
+      {
+        const std::size_t label = i.label;
+        const std::size_t t = i.state;
+        if (m_divergent[t] && is_inert(s, label, t, partition))
+        {
+          result.push_back(signature_entry(label, partition[t]));
+        }
+      }
+    }
   }
 
 public:
@@ -289,47 +652,287 @@ public:
     * This initialises \a m_divergent to record for each vertex whether it is
     * in a tau-scc.
     */
-  signature_divergence_preserving_branching_bisim(const LTS_T& lts_)
-    : signature_branching_bisim<LTS_T>(lts_),
+  signature_divergence_preserving_branching_bisim(const LTS_T& lts_, std::size_t number_of_threads = 0)
+    : signature_branching_bisim<LTS_T>(lts_, number_of_threads),
       m_divergent(lts_.num_states(), false)
   {
     mCRL2log(log::verbose, "sigref") << "initialising signature computation for divergence preserving branching bisimulation" << std::endl;
-    compute_tau_sccs();
+    compute_divergent_states();
   }
 
-  /** \overload
-    *
-    * Compute the signature as in branching bisimulation. In addition, add the
-    * (tau, B) for edges s -tau-> t for which s,t in B and m_divergent[t]
-    */
-  virtual void compute_signature(const std::vector<std::size_t>& partition)
+  /** \overload */
+  void quotient_transitions(std::vector<transition>& transitions, const std::vector<std::size_t>& partition) const
   {
-    // compute signatures
-    m_sig = std::vector<signature_t>(m_lts.num_states(), signature_t());
-    for(std::vector<transition>::const_iterator i = m_lts.get_transitions().begin(); i != m_lts.get_transitions().end(); ++i)
+    for (std::size_t s = 0; s < m_lts.num_states(); ++s)
     {
-      if(!(partition[i->from()] == partition[i->to()] && m_lts.is_tau(m_lts.apply_hidden_label_map(i->label())))
-         || m_divergent[i->to()])
+      const std::size_t c = m_component[s];
+      for (const adjacent_transition& i: m_transitions.transitions(s))
       {
-        insert(partition, i->from(), m_lts.apply_hidden_label_map(i->label()), partition[i->to()]);
+        const std::size_t label = i.label;
+        const std::size_t t = i.state;
+        if (!is_inert(s, label, t, partition)
+            || std::binary_search(this->begin(c), this->end(c), signature_entry(label, partition[t])))
+        {
+          transitions.push_back(transition(partition[s], label, partition[t]));
+        }
+      }
+    }
+  }
+};
+
+/** \brief Class for computing the signature for weak bisimulation
+  *
+  * The weak signature of a state s consists of the pairs (tau, B) such that s can
+  * reach block B by zero or more tau steps, and the pairs (a, B) such that s can
+  * reach block B by a weak a-step. It is computed on the fly from the tau graph,
+  * so the reflexive transitive tau closure of the LTS is never stored.
+  *
+  * The tau strongly connected components are handled as in branching bisimulation.
+  * Before the signatures are computed, the set of blocks that is reachable by tau
+  * steps is computed for every component, layer by layer. The weak signature of a
+  * component then consists of its own reachable blocks, the pairs (a, B) for its
+  * visible transitions to a component from which B is reachable, and the signatures
+  * of its tau successors.
+  *
+  * Both the reachable blocks and the signatures are shared by all components with
+  * the same set, see compute_layer. The reachable blocks of a component are the tau
+  * entries of its signature, and the components with the same signature form one
+  * block of the next partition. So at most b sets of each kind are stored, where b
+  * is the number of blocks of the result, and every set has at most L*b entries, where
+  * L is the number of labels. Including the buffers of t threads, the memory use is
+  * O(n + m + t*L*b*b), independent of the product of the numbers of states and blocks.
+  */
+template < class LTS_T >
+class signature_weak_bisim: public signature_branching_bisim<LTS_T>
+{
+protected:
+  typedef signature_branching_bisim<LTS_T> super;
+  using super::m_lts;
+  using super::m_transitions;
+  using super::m_is_tau;
+  using super::m_component;
+  using super::m_member_begin;
+  using super::m_members;
+  using super::m_layer_begin;
+  using super::m_entries;
+  using super::m_signature_begin;
+  using super::m_signature_end;
+  using super::is_inert;
+  using super::compute_layer;
+
+  /** \brief The tau label */
+  std::size_t m_tau;
+
+  /** \brief The pairs (tau, B) for the blocks B that are reachable from component c by
+             tau steps are stored in m_reachable[m_reachable_begin[c], m_reachable_end[c]) */
+  std::vector<signature_entry> m_reachable;
+  std::vector<std::size_t> m_reachable_begin;
+  std::vector<std::size_t> m_reachable_end;
+  typename super::set_index m_reachable_sets;
+
+  void add_reachable_entries(std::size_t c, const std::vector<std::size_t>& partition, std::vector<signature_entry>& result) const
+  {
+    result.push_back(signature_entry(m_tau, partition[m_members[m_member_begin[c]]]));
+    std::size_t previous = c;
+    for (std::size_t j = m_member_begin[c]; j != m_member_begin[c + 1]; ++j)
+    {
+      for (const adjacent_transition& i: m_transitions.transitions(m_members[j]))
+      {
+        const std::size_t d = m_component[i.state];
+        if (m_is_tau[i.label] && d != c && d != previous)
+        {
+          previous = d;
+          result.insert(result.end(), m_reachable.begin() + m_reachable_begin[d], m_reachable.begin() + m_reachable_end[d]);
+        }
       }
     }
   }
 
   /** \overload */
-  virtual void quotient_transitions(std::set<transition>& transitions, const std::vector<std::size_t>& partition)
+  void prepare_signature(const std::vector<std::size_t>& partition)
+  {
+    const std::size_t n = this->number_of_components();
+    m_reachable.clear();
+    m_reachable_sets.clear();
+    m_reachable_begin.resize(n);
+    m_reachable_end.resize(n);
+    for (std::size_t layer = 0; layer + 1 < m_layer_begin.size(); ++layer)
+    {
+      compute_layer(layer,
+                    [&](std::size_t c, std::vector<signature_entry>& result) { add_reachable_entries(c, partition, result); },
+                    m_reachable, m_reachable_begin, m_reachable_end, &m_reachable_sets
+                   );
+    }
+  }
+
+  /** \brief Adds the entries (label, B) for all blocks B that are reachable by tau steps from state t */
+  void add_weak_step(std::size_t label, std::size_t t, std::vector<signature_entry>& result) const
   {
-    for(std::vector<transition>::const_iterator i = m_lts.get_transitions().begin(); i != m_lts.get_transitions().end(); ++i)
+    const std::size_t d = m_component[t];
+    for (std::size_t k = m_reachable_begin[d]; k != m_reachable_end[d]; ++k)
     {
-      if(!(partition[i->from()] == partition[i->to()] && m_lts.is_tau(m_lts.apply_hidden_label_map(i->label())))
-         || m_sig[i->from()].find(std::make_pair(m_lts.apply_hidden_label_map(i->label()), partition[i->to()])) != m_sig[i->from()].end())
+      result.push_back(signature_entry(label, m_reachable[k].second));
+    }
+  }
+
+  /** \brief Adds the entries of the weak signature of component c */
+  void add_weak_entries(std::size_t c, std::vector<signature_entry>& result) const
+  {
+    result.insert(result.end(), m_reachable.begin() + m_reachable_begin[c], m_reachable.begin() + m_reachable_end[c]);
+    std::size_t previous = c;
+    for (std::size_t j = m_member_begin[c]; j != m_member_begin[c + 1]; ++j)
+    {
+      for (const adjacent_transition& i: m_transitions.transitions(m_members[j]))
       {
-        transitions.insert(transition(partition[i->from()], m_lts.apply_hidden_label_map(i->label()), partition[i->to()]));
+        const std::size_t d = m_component[i.state];
+        if (!m_is_tau[i.label])
+        {
+          add_weak_step(i.label, i.state, result);
+        }
+        else if (d != c && d != previous)
+        {
+          previous = d;
+          result.insert(result.end(), m_entries.begin() + m_signature_begin[d], m_entries.begin() + m_signature_end[d]);
+        }
       }
     }
   }
+
+  /** \overload */
+  void add_entries(std::size_t c, const std::vector<std::size_t>& /* partition */, std::vector<signature_entry>& result) const
+  {
+    add_weak_entries(c, result);
+  }
+
+public:
+  /** \brief Constructor  */
+  signature_weak_bisim(const LTS_T& lts_, std::size_t number_of_threads = 0)
+    : signature_branching_bisim<LTS_T>(lts_, number_of_threads),
+      m_tau(lts_.tau_label_index())
+  {
+    mCRL2log(log::verbose, "sigref") << "initialising signature computation for weak bisimulation" << std::endl;
+    this->m_share_signatures = true;
+  }
+};
+
+/** \brief Class for computing the signature for divergence preserving weak bisimulation
+  *
+  * A component is divergent if it contains a tau cycle. For the blocks B that are
+  * reachable by tau steps from a divergent component, the pair (divergence, B) is
+  * added to its signature, where divergence is a label that does not occur in the LTS.
+  * Via the signatures of tau successors these pairs also end up in the signatures of
+  * all components that can reach a divergent component.
+  */
+template < class LTS_T >
+class signature_divergence_preserving_weak_bisim: public signature_weak_bisim<LTS_T>
+{
+protected:
+  typedef signature_weak_bisim<LTS_T> super;
+  using super::m_lts;
+  using super::m_transitions;
+  using super::m_is_tau;
+  using super::m_component;
+  using super::m_member_begin;
+  using super::m_members;
+  using super::m_tau;
+  using super::is_inert;
+  using super::add_weak_step;
+  using super::add_weak_entries;
+
+  /** \brief The label that is used for divergence in signatures */
+  std::size_t m_divergence_label;
+
+  /** \brief Records for each component whether it contains a tau cycle */
+  std::vector<bool> m_divergent;
+
+  void compute_divergent_components()
+  {
+    m_divergent.resize(this->number_of_components());
+    for (std::size_t c = 0; c < m_divergent.size(); ++c)
+    {
+      bool divergent = m_member_begin[c + 1] - m_member_begin[c] > 1;
+      const std::size_t s = m_members[m_member_begin[c]];
+      for (const adjacent_transition& i: m_transitions.transitions(s))
+      {
+        divergent = divergent || (m_is_tau[i.label] && i.state == s);
+      }
+      m_divergent[c] = divergent;
+    }
+  }
+
+  /** \overload */
+  void add_entries(std::size_t c, const std::vector<std::size_t>& /* partition */, std::vector<signature_entry>& result) const
+  {
+    add_weak_entries(c, result);
+    if (m_divergent[c])
+    {
+      add_weak_step(m_divergence_label, m_members[m_member_begin[c]], result);
+    }
+  }
+
+public:
+  /** \brief Constructor  */
+  signature_divergence_preserving_weak_bisim(const LTS_T& lts_, std::size_t number_of_threads = 0)
+    : signature_weak_bisim<LTS_T>(lts_, number_of_threads),
+      m_divergence_label(lts_.num_action_labels())
+  {
+    mCRL2log(log::verbose, "sigref") << "initialising signature computation for divergence preserving weak bisimulation" << std::endl;
+    compute_divergent_components();
+  }
+
+  /** \overload
+    *
+    * A tau loop is added to the blocks that contain a divergent component.
+    */
+  void quotient_transitions(std::vector<transition>& transitions, const std::vector<std::size_t>& partition) const
+  {
+    super::quotient_transitions(transitions, partition);
+    for (std::size_t s = 0; s < m_lts.num_states(); ++s)
+    {
+      if (m_divergent[m_component[s]])
+      {
+        transitions.push_back(transition(partition[s], m_tau, partition[s]));
+      }
+    }
+  }
+};
+
+namespace detail
+{
+
+/** \brief Hash function on components, that uses the hash of their signatures */
+template < typename Signature >
+struct signature_hash
+{
+  const Signature* m_signature;
+
+  explicit signature_hash(const Signature* signature_ = nullptr)
+    : m_signature(signature_)
+  {}
+
+  std::size_t operator()(std::size_t c) const
+  {
+    return m_signature->hash(c);
+  }
+};
+
+/** \brief Equality on components, that compares their signatures */
+template < typename Signature >
+struct signature_equal
+{
+  const Signature* m_signature;
+
+  explicit signature_equal(const Signature* signature_ = nullptr)
+    : m_signature(signature_)
+  {}
+
+  bool operator()(std::size_t c1, std::size_t c2) const
+  {
+    return m_signature->equal(c1, c2);
+  }
 };
 
+} // namespace detail
 
 /** \brief Signature based reductions for labelled transition systems.
   *
@@ -337,13 +940,19 @@ public:
   * S. Blom, S. Orzan. "Distributed Branching Bisimulation Reduction of State
   * Spaces", in Proc. PDMC 2003.
   *
-  * The specific signature is a parameter of the algorithm.
+  * The specific signature is a parameter of the algorithm. In each iteration
+  * the signatures are computed in parallel, and are inserted by all threads
+  * into a concurrent hash table that assigns an index to every distinct
+  * signature. The blocks are numbered in the order in which they first occur
+  * in the states, so the result does not depend on the number of threads.
   */
 template < class LTS_T, typename Signature >
 class sigref
 {
 
 protected:
+  typedef atermpp::concurrent_indexed_set<std::size_t, detail::signature_hash<Signature>, detail::signature_equal<Signature> > signature_table;
+
   /** \brief Current partition; for each state (std::size_t) the block in which
              it resides is recorded. */
   std::vector<std::size_t> m_partition;
@@ -358,14 +967,14 @@ protected:
              current equivalence */
   Signature m_signature;
 
-  /** \brief Print a signature (for debugging purposes) */
-  std::string print_sig(const signature_t& sig)
+  /** \brief Print the signature of component c (for debugging purposes) */
+  std::string print_sig(std::size_t c)
   {
     std::stringstream os;
     os << "{ ";
-    for(signature_t::const_iterator i = sig.begin(); i != sig.end() ; ++i)
+    for (const signature_entry* i = m_signature.begin(c); i != m_signature.end(c); ++i)
     {
-      os << " (" << pp(m_lts.action_label(i->first)) << ", " << i->second << ") ";
+      os << " (" << (i->first < m_lts.num_action_labels() ? pp(m_lts.action_label(i->first)) : std::string("divergence")) << ", " << i->second << ") ";
     }
     os << " }";
     return os.str();
@@ -377,8 +986,8 @@ protected:
   {
     std::size_t count_prev = m_count;
     std::size_t iterations = 0;
-
-    m_lts.sort_transitions(mcrl2::lts::lbl_tgt_src);
+    const std::size_t n = m_signature.number_of_components();
+    std::vector<std::size_t> index(n);
 
     do
     {
@@ -389,22 +998,29 @@ protected:
 
       count_prev = m_count;
 
-      // Map signatures to block numbers
-      std::map<signature_t, std::size_t> hashtable;
-      m_count = 0;
-      for(std::size_t i = 0; i < m_lts.num_states(); ++i)
+      // Map signatures to indices
+      signature_table table(n, 50, detail::signature_hash<Signature>(&m_signature), detail::signature_equal<Signature>(&m_signature));
+      utilities::parallel_for(n, m_signature.number_of_threads(), [&](std::size_t, std::size_t first, std::size_t last)
       {
-        if(hashtable.find(m_signature.get_signature(i)) == hashtable.end())
+        for (std::size_t c = first; c < last; ++c)
         {
-          mCRL2log(log::debug, "sigref") << "Adding block for signature " << print_sig(m_signature.get_signature(i)) << std::endl;
-          hashtable[m_signature.get_signature(i)] = m_count++;
+          index[c] = table.put(c).first;
         }
-      }
+      });
 
-      // Map states to block numbers
-      for(std::size_t i = 0; i < m_lts.num_states(); ++i)
+      // Map states to block numbers, in the order of their first occurrence
+      std::vector<std::size_t> block(table.size(), signature_table::npos);
+      m_count = 0;
+      for (std::size_t i = 0; i < m_lts.num_states(); ++i)
       {
-        m_partition[i] = hashtable[m_signature.get_signature(i)];
+        const std::size_t c = m_signature.component(i);
+        std::size_t& b = block[index[c]];
+        if (b == signature_table::npos)
+        {
+          mCRL2log(log::debug, "sigref") << "Adding block for signature " << print_sig(c) << std::endl;
+          b = m_count++;
+        }
+        m_partition[i] = b;
       }
 
       ++iterations;
@@ -418,32 +1034,36 @@ protected:
              been computed */
   void quotient()
   {
-    // Assign the reduced LTS
-    m_lts.set_num_states(m_count);
-    m_lts.set_initial_state(m_partition[m_lts.initial_state()]);
-
     // Compute quotient transitions
     // implemented in the signature class because it differs per equivalence.
-    std::set<transition> transitions;
+    std::vector<transition> transitions;
     m_signature.quotient_transitions(transitions, m_partition);
+    std::sort(transitions.begin(), transitions.end());
+    transitions.erase(std::unique(transitions.begin(), transitions.end()), transitions.end());
+
+    // Assign the reduced LTS
+    m_lts.set_num_states(m_count);
+    m_lts.set_initial_state(m_partition[m_lts.initial_state()]);
 
     // Set quotient transitions
     m_lts.clear_transitions();
-    for(std::set<transition>::const_iterator i = transitions.begin(); i != transitions.end(); ++i)
+    for (const transition& t: transitions)
     {
-      m_lts.add_transition(*i);
+      m_lts.add_transition(t);
     }
   }
 
 public:
   /** \brief Constructor
     * \param[in] lts_ The LTS that is being reduced
+    * \param[in] number_of_threads The number of threads that is used; 0 means the
+    *            number of hardware threads
     */
-  sigref(LTS_T& lts_)
+  sigref(LTS_T& lts_, std::size_t number_of_threads = 0)
     : m_partition(std::vector<std::size_t>(lts_.num_states(), 0)),
       m_count(0),
       m_lts(lts_),
-      m_signature(lts_)
+      m_signature(lts_, number_of_threads)
   {}
 
   /** \brief Perform the reduction, modulo the equivalence for which the
@@ -0,0 +1,34 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts/transition_index_type.h
+/// \brief The type of the state and label numbers in transitions.
+
+#ifndef MCRL2_LTS_TRANSITION_INDEX_TYPE_H
+#define MCRL2_LTS_TRANSITION_INDEX_TYPE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mcrl2
+{
+namespace lts
+{
+
+/// \brief The type that is used to store the elements of transitions. By default this is a
+/// 32 bit type. Define MCRL2_LTS_WIDE_TRANSITIONS for LTSs with 2^32 or more states or labels.
+#ifdef MCRL2_LTS_WIDE_TRANSITIONS
+typedef std::size_t transition_index_type;
+#else
+typedef std::uint32_t transition_index_type;
+#endif
+
+} // namespace lts
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_TRANSITION_INDEX_TYPE_H
@@ -96,7 +96,7 @@ signed_state_type check_complexity::sensible_work = 0;
 /// in the pseudocode in the article [Groote/Jansen/Keiren/Wijs: An O(m log n)
 /// algorithm for computing stuttering equivalence and branching bisimulation.
 /// Accepted for publication in ACM TOCL 2017].
-const char *check_complexity::work_names[TRANS_MAX - BLOCK_MIN + 1] =
+const char *check_complexity::work_names[DNJ_TRANS_MAX - BLOCK_MIN + 1] =
 {
     // block counters
     "2.4: while C contains a nontrivial constellation",
@@ -160,7 +160,21 @@ const char *check_complexity::work_names[TRANS_MAX - BLOCK_MIN + 1] =
                                                                   "(a priori)",
     "4.12: for all blocks B with transitions to SpC that need postprocessing "
                                                               "(a posteriori)",
-    "4.15: for all old bottom states s in RedB"
+    "4.15: for all old bottom states s in RedB",
+
+    // DNJ state counters
+    "split constellation: for all states s in SpB",
+    "refine: for all states in the smaller subblock",
+    "postprocess: for all new bottom states",
+
+    // DNJ transition counters
+    "split constellation: for all incoming transitions of SpB",
+    "split constellation: mark the sources of a splitter slice",
+    "split constellation: find the tau-slice from SpB to the rest of C",
+    "split constellation: mark the sources of the tau-slice from SpB",
+    "refine: for all outgoing transitions of the smaller subblock",
+    "refine: for all incoming inert transitions of the smaller subblock",
+    "postprocess: skip an out-slice of a new bottom state"
 };
 
 
@@ -265,6 +279,24 @@ void check_complexity::test_work_names()
     test_work_name(i, for_all_old_bottom_states_s_in_RedB_4_15);
     assert(check_complexity::TRANS_MAX + 1 == i);
 
+    // DNJ state counters
+    assert(check_complexity::DNJ_STATE_MIN == i);
+    test_work_name(i, dnj_for_all_states_in_SpB);
+    test_work_name(i, dnj_small_subblock_state);
+    test_work_name(i, dnj_new_bottom_state);
+    assert(check_complexity::DNJ_STATE_MAX + 1 == i);
+
+    // DNJ transition counters
+    assert(check_complexity::DNJ_TRANS_MIN == i);
+    test_work_name(i, dnj_for_all_incoming_transitions_of_SpB);
+    test_work_name(i, dnj_mark_sources_of_splitter_slice);
+    test_work_name(i, dnj_find_tau_slice_of_splitter);
+    test_work_name(i, dnj_mark_tau_sources_in_splitter);
+    test_work_name(i, dnj_small_subblock_outgoing_transition);
+    test_work_name(i, dnj_small_subblock_incoming_inert_transition);
+    test_work_name(i, dnj_postprocess_out_slice);
+    assert(check_complexity::DNJ_TRANS_MAX + 1 == i);
+
     exit(EXIT_SUCCESS);
 }
 #endif // #if 0
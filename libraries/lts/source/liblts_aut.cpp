@@ -13,7 +13,10 @@
 #include <fstream>
 #include <unordered_map>
 #include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/detail/aut_parser.h"
 #include "mcrl2/lts/detail/liblts_swap_to_from_probabilistic_lts.h"
+#include "mcrl2/utilities/memory_mapped_file.h"
+#include "mcrl2/utilities/text_utility.h"
 
 
 using namespace mcrl2::lts;
@@ -315,32 +318,6 @@ static bool read_aut_transition(
   return true;
 }
 
-static bool read_aut_transition(
-  istream& is,
-  std::size_t& from,
-  string& label,
-  std::size_t& to,
-  const std::size_t line_no)
-{
-  if (!read_initial_part_of_an_aut_transition(is,from,label,line_no))
-  {
-    return false;
-  }
-
-  is >> skipws >> to;
-
-  char ch;
-  is >> ch;
-  if (ch != ')')
-  {
-    throw mcrl2::runtime_error("Expect a closing bracket at the end of the transition at line " + std::to_string(line_no) + ".");
-  }
-
-  read_newline(is,line_no);
-  return true;
-}
-
-
 static void read_from_aut(probabilistic_lts_aut_t& l, istream& is)
 {
   std::size_t line_no = 1;
@@ -421,56 +398,25 @@ static void read_from_aut(probabilistic_lts_aut_t& l, istream& is)
   }
 }
 
-static void read_from_aut(lts_aut_t& l, istream& is)
+static void read_from_aut(lts_aut_t& l, const char* first, const char* last)
 {
-  std::size_t line_no = 1;
-  std::size_t ntrans=0, nstate=0;
-
-  detail::lts_aut_base::probabilistic_state initial_probabilistic_state;
-  read_aut_header(is,initial_probabilistic_state,ntrans,nstate);
-  
-  if (initial_probabilistic_state.size()>1)
-  {
-    throw mcrl2::runtime_error("Encountered an initial probability distribution while reading an non probabilistic .aut file.");
-  }
-
-  check_states(initial_probabilistic_state, nstate, line_no);
-
-  if (nstate==0)
-  {
-    throw mcrl2::runtime_error("cannot parse AUT input that has no states; at least an initial state is required.");
-  }
-
-  l.set_num_states(nstate,false);
-  l.clear_transitions(ntrans); // Reserve enough space for the transitions.
-  
-  unordered_map < string, std::size_t > action_labels;
-  action_labels[action_label_string::tau_action()]=0; // A tau action is always stored at position 0.
-  l.set_initial_state(initial_probabilistic_state.begin()->state()); 
-
-  std::size_t from, to;
-  string s;
-  while (!is.eof())
-  {
-    line_no++;
-
-    if (!read_aut_transition(is,from,s,to,line_no))
-    {
-      break; // eof encountered
-    }
-
-    check_state(from, nstate, line_no);
-    check_state(to, nstate, line_no);
-    l.add_transition(transition(from,find_label_index(s,action_labels,l),to));
-  }
-
-  if (ntrans != l.num_transitions())
-  {
-    throw mcrl2::runtime_error("number of transitions read (" + std::to_string(l.num_transitions()) +
-                               ") does not correspond to the number of transition given in the header (" + std::to_string(ntrans) + ").");
-  }
+  detail::aut_parser parser(first, last);
+  l.set_num_states(parser.number_of_states(), false);
+  l.clear_transitions(parser.number_of_transitions()); // Reserve enough space for the transitions.
+  l.set_initial_state(parser.initial_state());
+
+  // A tau action is always stored at position 0.
+  parser.parse_transitions(
+    [&](const std::string& name) { return l.add_action(action_label_string(name)); },
+    [&](std::size_t from, std::size_t label, std::size_t to) { l.add_transition(transition(from, label, to)); }
+  );
 }
 
+static void read_from_aut(lts_aut_t& l, istream& is)
+{
+  std::string text = mcrl2::utilities::read_text(is);
+  read_from_aut(l, text.data(), text.data() + text.size());
+}
 
 static void write_probabilistic_state(const detail::lts_aut_base::probabilistic_state& prob_state, ostream& os)
 {
@@ -579,15 +525,21 @@ void lts_aut_t::load(const string& filename)
   }
   else
   {
-    ifstream is(filename.c_str());
-
-    if (!is.is_open())
+    utilities::memory_mapped_file file;
+    try
+    {
+      file = utilities::memory_mapped_file(filename);
+    }
+    catch (const mcrl2::runtime_error&)
     {
       throw mcrl2::runtime_error("cannot open .aut file '" + filename + ".");
     }
-
-    read_from_aut(*this,is);
-    is.close();
+    if (file.empty())
+    {
+      throw mcrl2::runtime_error("the .aut file '" + filename + "' is empty.");
+    }
+    const char* text = reinterpret_cast<const char*>(file.data());
+    read_from_aut(*this, text, text + file.size());
   }
 }
 
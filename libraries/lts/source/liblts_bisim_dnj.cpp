@@ -0,0 +1,1529 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+/// \file liblts_bisim_dnj.cpp
+///
+/// \brief O(m log n)-time branching bisimulation algorithm on labelled
+/// transition systems
+///
+/// \details See liblts_bisim_dnj.h for an overview.  The numbering of the
+/// steps follows the structure of Algorithms 2, 3 and 4 of GJKW: a round of
+/// the main loop splits a constellation, the blocks are refined under the
+/// splitter and its counterpart, and new bottom states are stabilised under
+/// all slices of their block.
+
+#include "mcrl2/lts/detail/liblts_bisim_dnj.h"
+#include "mcrl2/lts/lts_lts.h"
+#include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/lts_fsm.h"
+#include "mcrl2/lts/transition.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+namespace bisim_dnj
+{
+
+#ifndef NDEBUG
+    // This variable is only accessed in debug mode.
+    const state_info_entry* state_info_entry::s_i_begin = nullptr;
+
+    std::string succ_entry::debug_id() const
+    {
+        return "transition with label " + std::to_string(label) + " to " +
+                                                            target->debug_id();
+    }
+#endif
+
+} // end namespace bisim_dnj
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                            I N I T I A L I S E                            */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+/// \brief the label under which a transition is stored
+/// \details Returns false if the transition is a tau-self-loop that is
+/// removed because divergence is not preserved.
+template <class LTS_TYPE>
+bool bisim_partitioner_dnj<LTS_TYPE>::transition_label(const LTS_TYPE& l,
+        bool branching, bool preserve_divergence, const transition& t,
+                                                            label_type& label)
+{
+    label = l.apply_hidden_label_map(t.label());
+    if (branching && l.is_tau(label) && t.from() == t.to())
+    {
+        if (!preserve_divergence)
+        {
+            return false;
+        }
+        label = l.num_action_labels();
+    }
+    return true;
+}
+
+
+template <class LTS_TYPE>
+trans_type bisim_partitioner_dnj<LTS_TYPE>::count_transitions(
+                const LTS_TYPE& l, bool branching, bool preserve_divergence)
+{
+    trans_type result = 0;
+    label_type label;
+    for (const transition& t: l.get_transitions())
+    {
+        if (transition_label(l, branching, preserve_divergence, t, label))
+        {
+            ++result;
+        }
+    }
+    return result;
+}
+
+
+template <class LTS_TYPE>
+bisim_partitioner_dnj<LTS_TYPE>::bisim_partitioner_dnj(LTS_TYPE& l,
+                                bool branching, bool preserve_divergence)
+  : aut(l),
+    m_branching(branching),
+    m_preserve_divergence(branching && preserve_divergence),
+    m_tau_label(branching ? l.tau_label_index() : (label_type) -1),
+    m_divergence_label(l.num_action_labels()),
+    m_nr_of_transitions(count_transitions(l, branching, preserve_divergence)),
+    m_states(l.num_states() + 1),
+    m_permutation(l.num_states()),
+    m_succ(m_nr_of_transitions + 1),
+    m_pred(m_nr_of_transitions + 1),
+    m_block_bunch(m_nr_of_transitions + 1),
+    m_epoch(0),
+    m_splitter_first(false)
+{
+    mCRL2log(log::verbose) << "O(m log n) "
+                  << (m_preserve_divergence ? "Divergence preserving b" : "B")
+                  << (branching ? "ranching b" : "")
+                  << "isimulation partitioner created for " << l.num_states()
+                  << " states and " << m_nr_of_transitions
+                  << " transitions (without Kripke structure)\n";
+    #ifndef NDEBUG
+        state_info_entry::s_i_begin = &*m_states.begin();
+    #endif
+    create_initial_partition();
+    refine_partition_until_it_becomes_stable();
+    #ifndef NDEBUG
+        assert_stability();
+    #endif
+}
+
+
+/// \brief builds the data structures for the partition with a single block
+/// \details The outgoing transitions of every state are sorted by label, the
+/// incoming transitions of every state are sorted into non-inert and inert
+/// ones, and there is one block-bunch slice per label.
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::create_initial_partition()
+{
+    const state_type n = aut.num_states();
+    const label_type nr_of_labels = m_divergence_label + 1;
+    succ_entry* const succ_base = &*m_succ.begin();
+    pred_entry* const pred_base = &*m_pred.begin();
+    block_bunch_entry* const block_bunch_base = &*m_block_bunch.begin();
+
+    // count the transitions per label, per source and per target
+    std::vector<trans_type> per_label(nr_of_labels + 1, 0);
+    std::vector<trans_type> out_count(n, 0);
+    std::vector<trans_type> in_count(n, 0);
+    std::vector<trans_type> inert_in_count(n, 0);
+    for (state_type s = 0; s < n; ++s)
+    {
+        m_states[s].inert_out = 0;
+    }
+    label_type label;
+    for (const transition& t: aut.get_transitions())
+    {
+        if (!transition_label(aut, m_branching, m_preserve_divergence, t,
+                                                                        label))
+        {
+            continue;
+        }
+        ++per_label[label + 1];
+        ++out_count[t.from()];
+        ++in_count[t.to()];
+        if (m_tau_label == label)
+        {
+            ++m_states[t.from()].inert_out;
+            ++inert_in_count[t.to()];
+        }
+    }
+
+    // sort the transitions by label (counting sort)
+    for (label_type a = 1; a <= nr_of_labels; ++a)
+    {
+        per_label[a] += per_label[a - 1];
+    }
+    std::vector<const transition*> sorted(m_nr_of_transitions);
+    for (const transition& t: aut.get_transitions())
+    {
+        if (transition_label(aut, m_branching, m_preserve_divergence, t,
+                                                                        label))
+        {
+            sorted[per_label[label]++] = &t;
+        }
+    }
+
+    // assign the ranges of outgoing and incoming transitions to the states
+    std::vector<succ_entry*> succ_fill(n);
+    std::vector<pred_entry*> pred_fill(n);
+    std::vector<pred_entry*> inert_fill(n);
+    succ_entry* succ_iter = succ_base;
+    pred_entry* pred_iter = pred_base;
+    state_type nr_of_nonbottom_states = 0;
+    for (state_type s = 0; s < n; ++s)
+    {
+        state_info_entry& state = m_states[s];
+        state.succ_begin = succ_fill[s] = succ_iter;
+        succ_iter += out_count[s];
+        state.pred_begin = pred_fill[s] = pred_iter;
+        pred_iter += in_count[s];
+        state.pred_inert_begin = inert_fill[s] = pred_iter - inert_in_count[s];
+        state.current_out_slice = nullptr;
+        state.epoch = 0;
+        state.notblue = 0;
+        state.colour = uncoloured;
+        if (0 != state.inert_out)
+        {
+            ++nr_of_nonbottom_states;
+        }
+    }
+    m_states[n].succ_begin = succ_iter;
+    m_states[n].pred_begin = pred_iter;
+    assert(succ_base + m_nr_of_transitions == succ_iter);
+    assert(pred_base + m_nr_of_transitions == pred_iter);
+
+    // create the initial constellation and block
+    permutation_iter_t const perm_begin = &*m_permutation.begin();
+    m_constlns.emplace_back();
+    constln_t* const C0 = &m_constlns.back();
+    C0->begin = perm_begin;
+    C0->end = perm_begin + n;
+    C0->listed = false;
+    block_t* const B0 = new_block(perm_begin, perm_begin + n, C0);
+    B0->bottom_begin = perm_begin + nr_of_nonbottom_states;
+    B0->marked_bottom_begin = B0->bottom_begin;
+    permutation_iter_t nonbottom_iter = perm_begin;
+    permutation_iter_t bottom_iter = B0->bottom_begin;
+    for (state_type s = 0; s < n; ++s)
+    {
+        state_info_entry* const state = &m_states[s];
+        state->block = B0;
+        permutation_iter_t& pos = 0 != state->inert_out ? nonbottom_iter
+                                                        : bottom_iter;
+        state->pos = pos;
+        *pos = state;
+        ++pos;
+    }
+
+    // fill in the transitions in the order of their labels
+    bunch_slice_t* slice = nullptr;
+    for (trans_type i = 0; i < m_nr_of_transitions; ++i)
+    {
+        const transition& t = *sorted[i];
+        transition_label(aut, m_branching, m_preserve_divergence, t, label);
+        succ_entry* const succ = succ_fill[t.from()]++;
+        pred_entry* const pred = m_tau_label == label
+                                                ? inert_fill[t.to()]++
+                                                : pred_fill[t.to()]++;
+        block_bunch_entry* const block_bunch = block_bunch_base + i;
+        succ->target = &m_states[t.to()];
+        succ->label = label;
+        succ->block_bunch = block_bunch;
+        pred->source = &m_states[t.from()];
+        pred->succ = succ;
+        block_bunch->pred = pred;
+        if (nullptr == slice || slice->label != label)
+        {
+            slice = new_slice(B0, label, C0);
+            slice->begin = block_bunch;
+        }
+        slice->end = block_bunch + 1;
+        block_bunch->slice = slice;
+    }
+
+    // create the out-slices: per state, the transitions with the same label
+    for (state_type s = 0; s < n; ++s)
+    {
+        succ_entry* const end = m_states[s].succ_end();
+        for (succ_entry* begin = m_states[s].succ_begin; end != begin; )
+        {
+            succ_entry* slice_end = begin + 1;
+            while (end != slice_end && slice_end->label == begin->label)
+            {
+                ++slice_end;
+            }
+            out_descriptor* const D = new_out_descriptor(begin, slice_end);
+            for (; slice_end != begin; ++begin)
+            {
+                begin->out_slice = D;
+            }
+        }
+    }
+}
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                             H E L P E R S                                 */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+template <class LTS_TYPE>
+bisim_dnj::block_t* bisim_partitioner_dnj<LTS_TYPE>::new_block(
+            permutation_iter_t begin, permutation_iter_t end, constln_t* constln)
+{
+    m_blocks.emplace_back();
+    block_t* const B = &m_blocks.back();
+    B->begin = begin;
+    B->bottom_begin = end;
+    B->marked_bottom_begin = end;
+    B->end = end;
+    B->constln = constln;
+    B->slices = nullptr;
+    B->seqnr = m_blocks.size() - 1;
+    return B;
+}
+
+
+template <class LTS_TYPE>
+bisim_dnj::bunch_slice_t* bisim_partitioner_dnj<LTS_TYPE>::new_slice(
+                        block_t* B, label_type label, constln_t* target_constln)
+{
+    bunch_slice_t* S;
+    if (m_free_slices.empty())
+    {
+        m_slices.emplace_back();
+        S = &m_slices.back();
+    }
+    else
+    {
+        S = m_free_slices.back();
+        m_free_slices.pop_back();
+    }
+    S->begin = nullptr;
+    S->end = nullptr;
+    S->source_block = B;
+    S->label = label;
+    S->target_constln = target_constln;
+    S->prev = nullptr;
+    S->next = B->slices;
+    if (nullptr != B->slices)
+    {
+        B->slices->prev = S;
+    }
+    B->slices = S;
+    S->split = nullptr;
+    S->counterpart = nullptr;
+    S->pending = false;
+    S->needs_postprocessing = false;
+    S->dead = false;
+    return S;
+}
+
+
+/// \brief removes an empty slice from the list of its source block
+/// \details The memory of the slice is only reused at the end of the current
+/// round of the main loop, because other data structures may still point to
+/// it.
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::kill_slice(bunch_slice_t* S)
+{
+    assert(S->begin == S->end);
+    assert(!S->dead);
+    if (nullptr != S->prev)
+    {
+        S->prev->next = S->next;
+    }
+    else
+    {
+        S->source_block->slices = S->next;
+    }
+    if (nullptr != S->next)
+    {
+        S->next->prev = S->prev;
+    }
+    S->dead = true;
+    m_dead_slices.push_back(S);
+}
+
+
+template <class LTS_TYPE>
+bisim_dnj::out_descriptor* bisim_partitioner_dnj<LTS_TYPE>::
+                    new_out_descriptor(succ_entry* begin, succ_entry* end)
+{
+    out_descriptor* D;
+    if (m_free_out_descriptors.empty())
+    {
+        m_out_descriptors.emplace_back();
+        D = &m_out_descriptors.back();
+    }
+    else
+    {
+        D = m_free_out_descriptors.back();
+        m_free_out_descriptors.pop_back();
+    }
+    D->begin = begin;
+    D->end = end;
+    return D;
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::make_nontrivial(constln_t* C)
+{
+    if (!C->listed && (*C->begin)->block != C->end[-1]->block)
+    {
+        C->listed = true;
+        m_nontrivial_constlns.push_back(C);
+    }
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::swap_permutation(permutation_iter_t p1,
+                                                        permutation_iter_t p2)
+{
+    std::swap(*p1, *p2);
+    (*p1)->pos = p1;
+    (*p2)->pos = p2;
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::swap_succ(succ_entry* t1, succ_entry* t2)
+{
+    if (t1 == t2)
+    {
+        return;
+    }
+    std::swap(*t1, *t2);
+    t1->block_bunch->pred->succ = t1;
+    t2->block_bunch->pred->succ = t2;
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::swap_pred(pred_entry* t1, pred_entry* t2)
+{
+    if (t1 == t2)
+    {
+        return;
+    }
+    std::swap(*t1, *t2);
+    t1->succ->block_bunch->pred = t1;
+    t2->succ->block_bunch->pred = t2;
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::swap_block_bunch(block_bunch_entry* t1,
+                                                        block_bunch_entry* t2)
+{
+    if (t1 == t2)
+    {
+        return;
+    }
+    std::swap(*t1, *t2);
+    t1->pred->succ->block_bunch = t1;
+    t2->pred->succ->block_bunch = t2;
+}
+
+
+/// \brief checks whether a state has a transition with the given key
+/// \details The outgoing transitions of every state are sorted by key, so a
+/// binary search suffices.  `refine()` interleaves the same search with its
+/// other steps; this function is only used to check it in assertions.
+template <class LTS_TYPE>
+bool bisim_partitioner_dnj<LTS_TYPE>::has_transition(
+                        const state_info_entry* s, const key_type& key) const
+{
+    const succ_entry* begin = s->succ_begin;
+    const succ_entry* end = s->succ_end();
+    while (begin < end)
+    {
+        const succ_entry* const mid = begin + (end - begin) / 2;
+        if (out_key(mid) < key)
+        {
+            begin = mid + 1;
+        }
+        else
+        {
+            end = mid;
+        }
+    }
+    return s->succ_end() != begin && out_key(begin) == key;
+}
+
+
+/// \brief checks whether a new bottom state has a transition with the given
+/// key during postprocessing
+/// \details The keys are handled in increasing order, so the out-slices of
+/// `s` with smaller keys can be skipped once and for all.
+template <class LTS_TYPE>
+bool bisim_partitioner_dnj<LTS_TYPE>::bottom_state_in_slice(
+                                    state_info_entry* s, const key_type& key)
+{
+    succ_entry* t = s->current_out_slice;
+    while (s->succ_end() != t && out_key(t) < key)
+    {
+        assert(t->out_slice->begin == t);
+        mCRL2complexity(t, add_work(bisim_gjkw::check_complexity::
+                                                  dnj_postprocess_out_slice, 1));
+        t = t->out_slice->end;
+    }
+    s->current_out_slice = t;
+    return s->succ_end() != t && out_key(t) == key;
+}
+
+
+/// \brief checks whether a bottom state, which is a source of the current
+/// splitter, also has a transition in the counterpart of the splitter
+/// \details The out-slice into the splitter constellation has been placed
+/// just before or after the out-slice into the remainder of the old
+/// constellation, so this only needs to look at one transition.
+template <class LTS_TYPE>
+bool bisim_partitioner_dnj<LTS_TYPE>::has_counterpart_transition(
+                        const state_info_entry* s, const bunch_slice_t* FromRed)
+{
+    const out_descriptor* const D = s->current_out_slice->out_slice;
+    const succ_entry* t;
+    if (m_splitter_first)
+    {
+        t = D->end;
+        if (s->succ_end() == t)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (s->succ_begin == D->begin)
+        {
+            return false;
+        }
+        t = D->begin - 1;
+    }
+    return t->label == FromRed->label &&
+                      t->target->block->constln == FromRed->target_constln;
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::begin_refine()
+{
+    ++m_epoch;
+    m_red.clear();
+    m_blue.clear();
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::mark_red(state_info_entry* s)
+{
+    assert(m_epoch != s->epoch || uncoloured == s->colour);
+    s->epoch = m_epoch;
+    s->colour = red;
+    m_red.push_back(s);
+}
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                              R E F I N E                                  */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+/// \brief splits a block into the states that can inertly reach a red seed
+/// and the others
+/// \details Two searches run in lockstep: the red one starts at the red seeds
+/// and follows inert transitions backwards; the blue one starts at the bottom
+/// states that are not red and adds a non-bottom state as soon as all its
+/// inert successors are blue and it is not a seed itself.  As soon as one of
+/// the two has finished, its states are moved to a new block, so the work is
+/// proportional to the smaller subblock.  (Unlike GJKW, the work of the other
+/// search is not recorded in temporary counters; it is at most one step more
+/// than that of the search that finishes.)
+///
+/// For this argument every step has to take constant time.  Checking whether
+/// a blue seed is red looks at a single transition (or, during
+/// postprocessing, skips out-slices that are charged to
+/// `dnj_postprocess_out_slice`).  Checking whether a non-bottom state is a
+/// source of FromRed needs a binary search over its outgoing transitions;
+/// that search is spread over several steps, one probe each.  If the blue
+/// subblock is the smaller one, each probe looks at a different outgoing
+/// transition of a moved state, so it is covered by the work `split()`
+/// charges to `dnj_small_subblock_outgoing_transition`.
+/// \param B        the block to be refined
+/// \param mode     determines the red seeds: the states marked before the
+///                 call, the old bottom states, or the sources of FromRed
+/// \param FromRed  slice with red source states, for the last two modes
+/// \returns the block containing the red states, or nullptr if there are no
+/// red states
+template <class LTS_TYPE>
+bisim_dnj::block_t* bisim_partitioner_dnj<LTS_TYPE>::refine(block_t* B,
+                            refine_mode mode, const bunch_slice_t* FromRed)
+{
+    assert(1 < B->size());
+    assert(refine_old_bottom == mode || !B->has_new_bottom_states());
+    assert((nullptr != FromRed) == (refine_counterpart == mode ||
+                                              refine_postprocessing == mode));
+    if (refine_marked != mode)
+    {
+        begin_refine();
+    }
+    const state_type max_size = B->size() / 2;
+    key_type key;
+    if (nullptr != FromRed)
+    {
+        assert(FromRed->source_block == B);
+        key = slice_key(FromRed);
+    }
+
+    // state of the red search
+    bool red_active = m_red.size() <= max_size;
+    permutation_iter_t red_seed_state = B->marked_bottom_begin;
+    block_bunch_entry* red_seed_trans = nullptr == FromRed ? nullptr
+                                                           : FromRed->begin;
+    std::size_t red_visited = 0;
+    pred_entry* red_pred = nullptr;
+    pred_entry* red_pred_end = nullptr;
+
+    // state of the blue search
+    bool blue_active = true;
+    permutation_iter_t blue_seed = B->bottom_begin;
+    permutation_iter_t const blue_seed_end = refine_old_bottom == mode
+                                                  ? B->marked_bottom_begin
+                                                  : B->end;
+    std::size_t blue_visited = 0;
+    pred_entry* blue_pred = nullptr;
+    pred_entry* blue_pred_end = nullptr;
+    // a non-bottom state all of whose inert successors are blue; the blue
+    // search checks whether it is a source of FromRed by a binary search over
+    // its outgoing transitions, one probe per step
+    state_info_entry* blue_candidate = nullptr;
+    const succ_entry* blue_search_begin = nullptr;
+    const succ_entry* blue_search_end = nullptr;
+
+    bool red_is_smaller;
+    for (;;)
+    {
+        if (red_active)
+        {
+            // one step of the red search
+            if (refine_old_bottom == mode && B->end != red_seed_state)
+            {
+                mark_red(*red_seed_state);
+                ++red_seed_state;
+            }
+            else if (nullptr != FromRed && FromRed->end != red_seed_trans)
+            {
+                state_info_entry* const s = red_seed_trans->pred->source;
+                ++red_seed_trans;
+                if (!is_red(s))
+                {
+                    mark_red(s);
+                }
+            }
+            else if (red_pred_end != red_pred)
+            {
+                state_info_entry* const s = red_pred->source;
+                ++red_pred;
+                if (!is_red(s))
+                {
+                    mark_red(s);
+                }
+            }
+            else if (m_red.size() != red_visited)
+            {
+                state_info_entry* const s = m_red[red_visited++];
+                red_pred = s->pred_inert_begin;
+                red_pred_end = s->pred_end();
+            }
+            else
+            {
+                red_is_smaller = true;
+                break;
+            }
+            if (m_red.size() > max_size)
+            {
+                red_active = false;
+            }
+        }
+        if (blue_active)
+        {
+            // one step of the blue search
+            if (nullptr != blue_candidate)
+            {
+                if (blue_search_begin < blue_search_end)
+                {
+                    const succ_entry* const mid = blue_search_begin +
+                                    (blue_search_end - blue_search_begin) / 2;
+                    if (out_key(mid) < key)
+                    {
+                        blue_search_begin = mid + 1;
+                    }
+                    else
+                    {
+                        blue_search_end = mid;
+                    }
+                }
+                else
+                {
+                    assert(has_transition(blue_candidate, key) ==
+                            (blue_candidate->succ_end() != blue_search_begin &&
+                                         out_key(blue_search_begin) == key));
+                    if (uncoloured == blue_candidate->colour &&
+                            (blue_candidate->succ_end() == blue_search_begin ||
+                                        !(out_key(blue_search_begin) == key)))
+                    {
+                        blue_candidate->colour = blue;
+                        m_blue.push_back(blue_candidate);
+                    }
+                    blue_candidate = nullptr;
+                }
+            }
+            else if (blue_seed_end != blue_seed)
+            {
+                state_info_entry* const s = *blue_seed;
+                ++blue_seed;
+                bool seed_is_red;
+                switch (mode)
+                {
+                    case refine_marked:
+                        seed_is_red = is_red(s);
+                        break;
+                    case refine_counterpart:
+                        seed_is_red = has_counterpart_transition(s, FromRed);
+                        break;
+                    case refine_postprocessing:
+                        seed_is_red = bottom_state_in_slice(s, key);
+                        break;
+                    default:
+                        seed_is_red = false;
+                        break;
+                }
+                if (!seed_is_red)
+                {
+                    assert(!is_red(s));
+                    s->epoch = m_epoch;
+                    s->colour = blue;
+                    m_blue.push_back(s);
+                }
+            }
+            else if (blue_pred_end != blue_pred)
+            {
+                state_info_entry* const s = blue_pred->source;
+                ++blue_pred;
+                assert(s->block == B);
+                if (m_epoch != s->epoch)
+                {
+                    s->epoch = m_epoch;
+                    s->colour = uncoloured;
+                    s->notblue = s->inert_out;
+                }
+                if (uncoloured == s->colour && 0 == --s->notblue)
+                {
+                    if (nullptr == FromRed)
+                    {
+                        s->colour = blue;
+                        m_blue.push_back(s);
+                    }
+                    else
+                    {
+                        blue_candidate = s;
+                        blue_search_begin = s->succ_begin;
+                        blue_search_end = s->succ_end();
+                    }
+                }
+            }
+            else if (m_blue.size() != blue_visited)
+            {
+                state_info_entry* const s = m_blue[blue_visited++];
+                blue_pred = s->pred_inert_begin;
+                blue_pred_end = s->pred_end();
+            }
+            else
+            {
+                red_is_smaller = false;
+                break;
+            }
+            if (m_blue.size() > max_size)
+            {
+                blue_active = false;
+            }
+        }
+    }
+
+    if (red_is_smaller)
+    {
+        if (m_red.empty())
+        {
+            B->marked_bottom_begin = B->bottom_begin;
+            return nullptr;
+        }
+        return split(B, m_red, true);
+    }
+    if (m_blue.empty())
+    {
+        B->marked_bottom_begin = B->bottom_begin;
+        return B;
+    }
+    return split(B, m_blue, false);
+}
+
+
+/// \brief moves the states in `moved` to a new block
+/// \details The new block is placed before the remainder of `B` in the
+/// permutation array.  All outgoing transitions and all incoming inert
+/// transitions of the moved states are visited.  Inert transitions that
+/// cross the boundary between the two blocks become non-inert; if a state
+/// loses its last inert transition, it becomes a new bottom state.  New
+/// bottom states are placed at the beginning of the bottom states of their
+/// block, i. e. in [bottom_begin, marked_bottom_begin).
+/// \returns the block containing the red states
+template <class LTS_TYPE>
+bisim_dnj::block_t* bisim_partitioner_dnj<LTS_TYPE>::split(block_t* B,
+                const std::vector<state_info_entry*>& moved, bool moved_red)
+{
+    const state_type k = moved.size();
+    assert(0 < k);
+    assert(k <= B->size() / 2);
+    #ifndef NDEBUG
+        const unsigned char max_NewB = bisim_gjkw::check_complexity::log_n -
+                                   bisim_gjkw::check_complexity::ilog2(k);
+    #endif
+
+    // move the non-bottom states to the front of the block and the bottom
+    // states to the front of the bottom states
+    permutation_iter_t nonbottom_dest = B->begin;
+    permutation_iter_t bottom_dest = B->bottom_begin;
+    for (state_info_entry* s: moved)
+    {
+        mCRL2complexity(s, add_work(bisim_gjkw::check_complexity::
+                                          dnj_small_subblock_state, max_NewB));
+        if (s->pos < B->bottom_begin)
+        {
+            swap_permutation(s->pos, nonbottom_dest);
+            ++nonbottom_dest;
+        }
+        else
+        {
+            swap_permutation(s->pos, bottom_dest);
+            ++bottom_dest;
+        }
+    }
+    // exchange the remaining non-bottom states and the moved bottom states
+    const state_type moved_bottom = bottom_dest - B->bottom_begin;
+    const state_type remaining_nonbottom = B->bottom_begin - nonbottom_dest;
+    if (remaining_nonbottom >= moved_bottom)
+    {
+        for (state_type i = 0; i < moved_bottom; ++i)
+        {
+            swap_permutation(nonbottom_dest + i, B->bottom_begin + i);
+        }
+    }
+    else
+    {
+        for (state_type i = 0; i < remaining_nonbottom; ++i)
+        {
+            swap_permutation(nonbottom_dest + i,
+                                       bottom_dest - remaining_nonbottom + i);
+        }
+    }
+
+    block_t* const NewB = new_block(B->begin, B->begin + k, B->constln);
+    NewB->bottom_begin = nonbottom_dest;
+    NewB->marked_bottom_begin = nonbottom_dest;
+    B->begin = NewB->end;
+    B->bottom_begin = bottom_dest;
+    B->marked_bottom_begin = bottom_dest;
+    for (state_info_entry* s: moved)
+    {
+        s->block = NewB;
+    }
+    make_nontrivial(B->constln);
+
+    // move the transitions
+    for (state_info_entry* s: moved)
+    {
+        for (succ_entry* t = s->succ_begin; s->succ_end() != t; ++t)
+        {
+            mCRL2complexity(t, add_work(bisim_gjkw::check_complexity::
+                            dnj_small_subblock_outgoing_transition, max_NewB));
+            bunch_slice_t* const O = t->block_bunch->slice;
+            bunch_slice_t* N = O->split;
+            if (nullptr == N)
+            {
+                N = new_slice(NewB, O->label, O->target_constln);
+                N->begin = O->end;
+                N->end = O->end;
+                O->split = N;
+                m_touched_slices.push_back(O);
+                if (O->pending)
+                {
+                    N->pending = true;
+                    m_pending.push_back(N);
+                }
+                if (O->needs_postprocessing)
+                {
+                    N->needs_postprocessing = true;
+                    m_postprocess[slice_key(N)].push_back(N);
+                }
+            }
+            --O->end;
+            swap_block_bunch(t->block_bunch, O->end);
+            N->begin = O->end;
+            O->end->slice = N;
+
+            if (m_tau_label == t->label && B == t->target->block)
+            {
+                // an inert transition from NewB to B becomes non-inert
+                state_info_entry* const target = t->target;
+                swap_pred(t->block_bunch->pred, target->pred_inert_begin);
+                ++target->pred_inert_begin;
+                if (0 == --s->inert_out)
+                {
+                    m_new_bottom.push_back(s);
+                }
+            }
+        }
+        for (pred_entry* p = s->pred_inert_begin; s->pred_end() != p; ++p)
+        {
+            mCRL2complexity(p->succ, add_work(bisim_gjkw::check_complexity::
+                      dnj_small_subblock_incoming_inert_transition, max_NewB));
+            state_info_entry* const source = p->source;
+            if (B == source->block)
+            {
+                // an inert transition from B to NewB becomes non-inert
+                swap_pred(p, s->pred_inert_begin);
+                ++s->pred_inert_begin;
+                if (0 == --source->inert_out)
+                {
+                    m_new_bottom.push_back(source);
+                }
+            }
+        }
+    }
+
+    // the counterpart of a split slice is the split of the old counterpart
+    for (bunch_slice_t* O: m_touched_slices)
+    {
+        const bunch_slice_t* const counterpart = O->counterpart;
+        if (nullptr != counterpart && !counterpart->dead &&
+                                                nullptr != counterpart->split)
+        {
+            O->split->counterpart = counterpart->split;
+            m_counterparts.push_back(O->split);
+        }
+    }
+    for (bunch_slice_t* O: m_touched_slices)
+    {
+        O->split = nullptr;
+        if (O->begin == O->end)
+        {
+            kill_slice(O);
+        }
+    }
+    m_touched_slices.clear();
+
+    // place the new bottom states
+    for (state_info_entry* s: m_new_bottom)
+    {
+        block_t* const X = s->block;
+        assert(s->pos < X->bottom_begin);
+        --X->bottom_begin;
+        swap_permutation(s->pos, X->bottom_begin);
+    }
+    m_new_bottom.clear();
+
+    block_t* const RedB = moved_red ? NewB : B;
+    assert(!(moved_red ? B : NewB)->has_new_bottom_states());
+    return RedB;
+}
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                    P O S T P R O C E S S I N G                            */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+/// \brief registers the slices of a block that contains new bottom states
+/// \details All bottom states of `RfnB` are regarded as new.  Their
+/// current_out_slice pointers are reset, and all non-exempt slices of RfnB
+/// are inserted into the search tree of slices that need postprocessing.
+/// (The registration of a slice is paid for by the transitions of new bottom
+/// states in the slice once it has become stable, like the a posteriori
+/// counters of GJKW; this is not checked separately.)
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::register_for_postprocessing(
+                                                                block_t* RfnB)
+{
+    for (bunch_slice_t* S = RfnB->slices; nullptr != S; S = S->next)
+    {
+        if (S->needs_postprocessing ||
+                (m_tau_label == S->label && RfnB->constln == S->target_constln))
+        {
+            continue;
+        }
+        S->needs_postprocessing = true;
+        m_postprocess[slice_key(S)].push_back(S);
+    }
+    for (permutation_iter_t s_iter = RfnB->bottom_begin; RfnB->end != s_iter;
+                                                                     ++s_iter)
+    {
+        state_info_entry* const s = *s_iter;
+        mCRL2complexity(s, add_work(bisim_gjkw::check_complexity::
+                                                     dnj_new_bottom_state, 1));
+        s->current_out_slice = s->succ_begin;
+    }
+    RfnB->marked_bottom_begin = RfnB->bottom_begin;
+}
+
+
+/// \brief refines a block, all of whose bottom states are new, until it is
+/// stable under all its slices
+/// \details The slices are handled in the order of their keys.  If a
+/// refinement creates new bottom states again, these are separated from the
+/// old ones and the part with new bottom states is registered anew.
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::stabilise_new_bottom(block_t* RfnB)
+{
+    register_for_postprocessing(RfnB);
+    while (!m_postprocess.empty())
+    {
+        auto const first = m_postprocess.begin();
+        if (first->second.empty())
+        {
+            m_postprocess.erase(first);
+            continue;
+        }
+        bunch_slice_t* const S = first->second.back();
+        first->second.pop_back();
+        if (S->dead || !S->needs_postprocessing)
+        {
+            continue;
+        }
+        S->needs_postprocessing = false;
+        block_t* const X = S->source_block;
+        if (1 == X->size())
+        {
+            continue;
+        }
+        block_t* const RedX = refine(X, refine_postprocessing, S);
+        if (nullptr == RedX || !RedX->has_new_bottom_states())
+        {
+            continue;
+        }
+        block_t* RfnX = RedX;
+        if (RedX->end != RedX->marked_bottom_begin)
+        {
+            state_info_entry* const new_bottom_state = *RedX->bottom_begin;
+            refine(RedX, refine_old_bottom, nullptr);
+            RfnX = new_bottom_state->block;
+        }
+        register_for_postprocessing(RfnX);
+    }
+}
+
+
+/// \brief stabilises a block that has new bottom states
+/// \details The old bottom states are separated from the new ones; the part
+/// with new bottom states is then stabilised under all its slices.
+/// \returns the part that contains the old bottom states, or nullptr if there
+/// were no old bottom states
+template <class LTS_TYPE>
+bisim_dnj::block_t* bisim_partitioner_dnj<LTS_TYPE>::postprocess_new_bottom(
+                                                                 block_t* RedB)
+{
+    assert(RedB->has_new_bottom_states());
+    block_t* ResultB = nullptr;
+    block_t* RfnB = RedB;
+    if (RedB->end != RedB->marked_bottom_begin)
+    {
+        state_info_entry* const new_bottom_state = *RedB->bottom_begin;
+        ResultB = refine(RedB, refine_old_bottom, nullptr);
+        RfnB = new_bottom_state->block;
+        assert(nullptr != ResultB);
+        assert(ResultB != RfnB);
+    }
+    stabilise_new_bottom(RfnB);
+    return ResultB;
+}
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                            M A I N   L O O P                              */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+/// \brief splits a nontrivial constellation and stabilises the partition
+/// under the two parts
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::split_constellation(constln_t* C)
+{
+    // choose the splitter: the smaller one of the first and last block
+    block_t* const first = (*C->begin)->block;
+    block_t* const last = C->end[-1]->block;
+    assert(first != last);
+    m_splitter_first = first->size() <= last->size();
+    block_t* const SpB = m_splitter_first ? first : last;
+    m_constlns.emplace_back();
+    constln_t* const NewC = &m_constlns.back();
+    NewC->begin = SpB->begin;
+    NewC->end = SpB->end;
+    NewC->listed = false;
+    if (m_splitter_first)
+    {
+        C->begin = SpB->end;
+    }
+    else
+    {
+        C->end = SpB->begin;
+    }
+    SpB->constln = NewC;
+    make_nontrivial(C);
+    #ifndef NDEBUG
+        const unsigned char max_NewC = bisim_gjkw::check_complexity::log_n -
+                        bisim_gjkw::check_complexity::ilog2(NewC->size());
+    #endif
+
+    // move the transitions into SpB to new out-slices and new block-bunch
+    // slices
+    for (permutation_iter_t s_iter = SpB->begin; SpB->end != s_iter; ++s_iter)
+    {
+        state_info_entry* const s = *s_iter;
+        mCRL2complexity(s, add_work(bisim_gjkw::check_complexity::
+                                         dnj_for_all_states_in_SpB, max_NewC));
+        for (pred_entry* p = s->pred_begin; s->pred_end() != p; ++p)
+        {
+            mCRL2complexity(p->succ, add_work(bisim_gjkw::check_complexity::
+                           dnj_for_all_incoming_transitions_of_SpB, max_NewC));
+            state_info_entry* const u = p->source;
+            succ_entry* t = p->succ;
+            const label_type a = t->label;
+
+            // out-slices: the transitions to NewC are placed next to those to
+            // C, such that the order of keys is preserved
+            out_descriptor* const D = t->out_slice;
+            out_descriptor* NewD = nullptr;
+            if (m_splitter_first)
+            {
+                succ_entry* const pos = D->begin;
+                swap_succ(t, pos);
+                t = pos;
+                ++D->begin;
+                if (u->succ_begin != pos && a == pos[-1].label &&
+                                     NewC == pos[-1].target->block->constln)
+                {
+                    NewD = pos[-1].out_slice;
+                    NewD->end = pos + 1;
+                }
+            }
+            else
+            {
+                succ_entry* const pos = D->end - 1;
+                swap_succ(t, pos);
+                t = pos;
+                --D->end;
+                if (u->succ_end() != pos + 1 && a == pos[1].label &&
+                                      NewC == pos[1].target->block->constln)
+                {
+                    NewD = pos[1].out_slice;
+                    NewD->begin = pos;
+                }
+            }
+            if (D->begin == D->end)
+            {
+                m_free_out_descriptors.push_back(D);
+            }
+            if (nullptr == NewD)
+            {
+                NewD = new_out_descriptor(t, t + 1);
+            }
+            t->out_slice = NewD;
+
+            // block-bunch slices
+            block_bunch_entry* const block_bunch = t->block_bunch;
+            bunch_slice_t* const S = block_bunch->slice;
+            bunch_slice_t* NS = S->split;
+            if (nullptr == NS)
+            {
+                NS = new_slice(S->source_block, a, NewC);
+                NS->begin = S->end;
+                NS->end = S->end;
+                S->split = NS;
+                NS->counterpart = S;
+                m_touched_slices.push_back(S);
+                m_counterparts.push_back(NS);
+                if (m_tau_label != a || SpB != S->source_block)
+                {
+                    NS->pending = true;
+                    m_pending.push_back(NS);
+                }
+            }
+            --S->end;
+            swap_block_bunch(block_bunch, S->end);
+            NS->begin = S->end;
+            S->end->slice = NS;
+        }
+    }
+    for (bunch_slice_t* S: m_touched_slices)
+    {
+        S->split = nullptr;
+        if (S->begin == S->end)
+        {
+            kill_slice(S);
+        }
+    }
+    m_touched_slices.clear();
+
+    // The tau-transitions from SpB to C were exempt before, but now they have
+    // to be stable.
+    if (m_branching && 1 < SpB->size())
+    {
+        bunch_slice_t* S = SpB->slices;
+        for (; nullptr != S; S = S->next)
+        {
+            mCRL2complexity(S->begin->pred->succ, add_work(bisim_gjkw::
+              check_complexity::dnj_find_tau_slice_of_splitter, max_NewC));
+            if (m_tau_label == S->label && C == S->target_constln)
+            {
+                break;
+            }
+        }
+        if (nullptr != S)
+        {
+            begin_refine();
+            for (block_bunch_entry* bb = S->begin; S->end != bb; ++bb)
+            {
+                mCRL2complexity(bb->pred->succ, add_work(bisim_gjkw::
+                      check_complexity::dnj_mark_tau_sources_in_splitter,
+                                                                   max_NewC));
+                state_info_entry* const s = bb->pred->source;
+                if (!is_red(s))
+                {
+                    mark_red(s);
+                }
+            }
+            block_t* const RedB = refine(SpB, refine_marked, nullptr);
+            if (nullptr != RedB && RedB->has_new_bottom_states())
+            {
+                postprocess_new_bottom(RedB);
+            }
+        }
+    }
+
+    // refine the blocks under the splitter slices and their counterparts
+    for (std::size_t i = 0; i < m_pending.size(); ++i)
+    {
+        bunch_slice_t* const P = m_pending[i];
+        if (P->dead || !P->pending)
+        {
+            continue;
+        }
+        P->pending = false;
+        block_t* B = P->source_block;
+        if (1 == B->size())
+        {
+            continue;
+        }
+        // mark the sources of the splitter
+        begin_refine();
+        for (block_bunch_entry* bb = P->begin; P->end != bb; ++bb)
+        {
+            mCRL2complexity(bb->pred->succ, add_work(bisim_gjkw::
+                check_complexity::dnj_mark_sources_of_splitter_slice, max_NewC));
+            state_info_entry* const s = bb->pred->source;
+            if (!is_red(s))
+            {
+                mark_red(s);
+                s->current_out_slice = bb->pred->succ;
+            }
+        }
+        B = refine(B, refine_marked, nullptr);
+        assert(nullptr != B);
+        if (B->has_new_bottom_states())
+        {
+            B = postprocess_new_bottom(B);
+        }
+        if (nullptr == B || 1 == B->size() ||
+                           (m_tau_label == P->label && C == B->constln))
+        {
+            // The counterpart is exempt (or the block is trivially stable).
+            continue;
+        }
+        // every bottom state of B is a source of the splitter
+        const succ_entry* const t = B->end[-1]->current_out_slice;
+        assert(t->label == P->label);
+        assert(t->target->block->constln == NewC);
+        const bunch_slice_t* const FromRed =
+                                       t->block_bunch->slice->counterpart;
+        if (nullptr == FromRed || FromRed->dead)
+        {
+            continue;
+        }
+        assert(FromRed->source_block == B);
+        B = refine(B, refine_counterpart, FromRed);
+        if (nullptr != B && B->has_new_bottom_states())
+        {
+            postprocess_new_bottom(B);
+        }
+    }
+
+    // destroy the temporary data of this round
+    for (bunch_slice_t* S: m_counterparts)
+    {
+        S->counterpart = nullptr;
+    }
+    m_counterparts.clear();
+    m_pending.clear();
+    m_free_slices.insert(m_free_slices.end(), m_dead_slices.begin(),
+                                                         m_dead_slices.end());
+    m_dead_slices.clear();
+}
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::refine_partition_until_it_becomes_stable()
+{
+    const state_type n = aut.num_states();
+    if (n <= 1)
+    {
+        return;
+    }
+    #ifndef NDEBUG
+        bisim_gjkw::check_complexity::init(n);
+    #endif
+
+    // stabilise the initial block under all labels
+    stabilise_new_bottom(&m_blocks.front());
+    m_free_slices.insert(m_free_slices.end(), m_dead_slices.begin(),
+                                                         m_dead_slices.end());
+    m_dead_slices.clear();
+
+    while (!m_nontrivial_constlns.empty())
+    {
+        constln_t* const C = m_nontrivial_constlns.back();
+        m_nontrivial_constlns.pop_back();
+        C->listed = false;
+        split_constellation(C);
+    }
+    mCRL2log(log::verbose) << "number of equivalence classes: "
+                                                  << m_blocks.size() << '\n';
+}
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                              Q U O T I E N T                              */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::replace_transition_system()
+{
+    const label_type tau_label = aut.tau_label_index();
+    aut.clear_transitions();
+    // Every slice is a transition of the quotient: when the partition is
+    // stable, every constellation consists of a single block.
+    for (const block_t& B: m_blocks)
+    {
+        for (const bunch_slice_t* S = B.slices; nullptr != S; S = S->next)
+        {
+            const block_t* const T = (*S->target_constln->begin)->block;
+            assert(T->begin == S->target_constln->begin);
+            assert(T->end == S->target_constln->end);
+            if (m_tau_label == S->label && &B == T)
+            {
+                // inert transitions are removed
+                continue;
+            }
+            const label_type label = m_preserve_divergence &&
+                       m_divergence_label == S->label ? tau_label : S->label;
+            aut.add_transition(transition(B.seqnr, label, T->seqnr));
+        }
+    }
+
+    // Merge the states, by setting the state labels of each state to the
+    // concatenation of the state labels of its equivalence class.
+    if (aut.has_state_info())
+    {
+        std::vector<typename LTS_TYPE::state_label_t>
+                                                  new_labels(num_eq_classes());
+        for (std::size_t i = aut.num_states(); i > 0; )
+        {
+            --i;
+            const std::size_t new_index = get_eq_class(i);
+            new_labels[new_index] = aut.state_label(i) + new_labels[new_index];
+        }
+        aut.set_num_states(num_eq_classes());
+        for (std::size_t i = 0; i < num_eq_classes(); ++i)
+        {
+            aut.set_state_label(i, new_labels[i]);
+        }
+    }
+    else
+    {
+        aut.set_num_states(num_eq_classes());
+    }
+    aut.set_initial_state(get_eq_class(aut.initial_state()));
+}
+
+
+
+
+
+/* ************************************************************************* */
+/*                                                                           */
+/*                                D E B U G                                  */
+/*                                                                           */
+/* ************************************************************************* */
+
+
+
+
+
+#ifndef NDEBUG
+
+/// \brief checks that the final partition is stable
+/// \details Every constellation consists of a single block, the inert
+/// transitions are registered correctly, and every bottom state of a block
+/// has a transition in every non-exempt slice of the block.
+template <class LTS_TYPE>
+void bisim_partitioner_dnj<LTS_TYPE>::assert_stability() const
+{
+    if (aut.num_states() <= 1)
+    {
+        return;
+    }
+    assert(m_nontrivial_constlns.empty());
+    assert(m_postprocess.empty());
+    assert(m_pending.empty());
+    for (const block_t& B: m_blocks)
+    {
+        assert(B.constln->begin == B.begin);
+        assert(B.constln->end == B.end);
+        assert(!B.has_new_bottom_states());
+        for (permutation_iter_t s_iter = B.begin; B.end != s_iter; ++s_iter)
+        {
+            const state_info_entry* const s = *s_iter;
+            assert(s->pos == s_iter);
+            assert(s->block == &B);
+            assert((0 == s->inert_out) == (s_iter >= B.bottom_begin));
+            trans_type inert_out = 0;
+            for (const succ_entry* t = s->succ_begin; s->succ_end() != t; ++t)
+            {
+                assert(t->block_bunch->pred->succ == t);
+                assert(t->block_bunch->pred->source == s);
+                assert(t->out_slice->begin <= t && t < t->out_slice->end);
+                assert(s->succ_begin == t || !(out_key(t) < out_key(t - 1)));
+                if (m_tau_label == t->label && &B == t->target->block)
+                {
+                    ++inert_out;
+                    assert(t->block_bunch->pred >= t->target->pred_inert_begin);
+                }
+                else
+                {
+                    assert(t->block_bunch->pred < t->target->pred_inert_begin);
+                }
+            }
+            assert(inert_out == s->inert_out);
+        }
+        for (const bunch_slice_t* S = B.slices; nullptr != S; S = S->next)
+        {
+            assert(!S->dead);
+            assert(!S->pending);
+            assert(!S->needs_postprocessing);
+            assert(nullptr == S->counterpart);
+            assert(S->source_block == &B);
+            assert(S->begin < S->end);
+            const key_type key = slice_key(S);
+            for (const block_bunch_entry* bb = S->begin; S->end != bb; ++bb)
+            {
+                assert(bb->slice == S);
+                assert(bb->pred->source->block == &B);
+                assert(out_key(bb->pred->succ) == key);
+            }
+            if (m_tau_label == S->label && B.constln == S->target_constln)
+            {
+                continue;
+            }
+            for (permutation_iter_t s_iter = B.bottom_begin; B.end != s_iter;
+                                                                     ++s_iter)
+            {
+                assert(has_transition(*s_iter, key));
+            }
+        }
+    }
+}
+
+#endif // ifndef NDEBUG
+
+
+template class bisim_partitioner_dnj<lts_lts_t>;
+template class bisim_partitioner_dnj<lts_aut_t>;
+template class bisim_partitioner_dnj<lts_fsm_t>;
+
+} // end namespace detail
+} // end namespace lts
+} // end namespace mcrl2
@@ -16,6 +16,7 @@
 #include "mcrl2/data/detail/io.h"
 #include "mcrl2/lps/multi_action.h"
 #include "mcrl2/lts/lts_lts.h"
+#include "mcrl2/lts/lts_lts_view.h"
 #include "mcrl2/lts/detail/liblts_swap_to_from_probabilistic_lts.h"
 
 namespace mcrl2
@@ -298,41 +299,14 @@ static void read_from_lts(probabilistic_lts_lts_t& l, const std::string& filenam
   }
   else 
   {
-    std::ifstream stream;
-    stream.exceptions ( std::ifstream::failbit | std::ifstream::badbit );
     try
-    {  
-      stream.open(filename, std::ifstream::in | std::ifstream::binary);
-    }
-    catch (std::ifstream::failure)
     {
-      if (filename=="")
-      {
-        throw mcrl2::runtime_error("Fail to open standard input to read an lts.");
-      }
-      else 
-      {
-        throw mcrl2::runtime_error("Fail to open file " + filename + " to read an lts.");
-      }
+      input=atermpp::read_term_from_binary_file(filename);
     }
-
-    try
+    catch (std::runtime_error& e)
     {
-      input=atermpp::read_term_from_binary_stream(stream);
-      stream.close();
+      throw mcrl2::runtime_error("Fail to correctly read an lts from the file " + filename + ".\n" + e.what());
     }
-    catch (std::ifstream::failure)
-    {
-      if (filename=="")
-      {
-        throw mcrl2::runtime_error("Fail to correctly read an lts from standard input.");
-      }
-      else
-      {
-        throw mcrl2::runtime_error("Fail to correctly read an lts from the file " + filename + ".");
-      }
-    }
-    
   }
 
   if (!input.type_is_appl() || down_cast<aterm_appl>(input).function()!=lts_header())
@@ -478,11 +452,25 @@ void probabilistic_lts_lts_t::save(const std::string& filename) const
 void probabilistic_lts_lts_t::load(const std::string& filename)
 {
   mCRL2log(log::verbose) << "Starting to load file " << filename << "\n";
+  if (!filename.empty() && is_indexed_lts_file(filename))
+  {
+    lts_lts_t l;
+    load_lts_from_view(std::make_shared<const lts_lts_view>(filename), l);
+    *this = probabilistic_lts_lts_t();
+    detail::translate_to_probabilistic_lts(l,*this);
+    return;
+  }
   detail::read_from_lts(*this,filename);
 }
 
 void lts_lts_t::load(const std::string& filename)
 {
+  if (!filename.empty() && is_indexed_lts_file(filename))
+  {
+    mCRL2log(log::verbose) << "Starting to load indexed file " << filename << "\n";
+    load_lts_from_view(std::make_shared<const lts_lts_view>(filename), *this);
+    return;
+  }
   probabilistic_lts_lts_t l;
   l.load(filename);
   detail::swap_to_non_probabilistic_lts
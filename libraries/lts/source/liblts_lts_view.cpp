@@ -0,0 +1,350 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file liblts_lts_view.cpp
+
+#include <cstring>
+#include <fstream>
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/atermpp/aterm_io.h"
+#include "mcrl2/data/detail/io.h"
+#include "mcrl2/lts/lts_lts_view.h"
+
+namespace mcrl2
+{
+namespace lts
+{
+namespace detail
+{
+
+using namespace atermpp;
+
+static const char indexed_lts_magic[8] = { 'm', 'C', 'R', 'L', '2', 'L', 'T', 'S' };
+static const std::uint64_t indexed_lts_version = 1;
+static const std::size_t indexed_lts_header_size = sizeof(indexed_lts_magic) + 14 * 8;
+static const std::size_t default_state_label_block_size = 1024;
+
+static atermpp::function_symbol indexed_meta_data_header()
+{
+  static atermpp::function_symbol mdh("indexed_lts_meta_data", 3);
+  return mdh;
+}
+
+static atermpp::function_symbol indexed_multi_action_header()
+{
+  static atermpp::function_symbol mdh("multi_action", 2);
+  return mdh;
+}
+
+static void append_little_endian(std::vector<unsigned char>& buffer, std::uint64_t value, const std::size_t width)
+{
+  for (std::size_t i = 0; i < width; i++)
+  {
+    buffer.push_back(static_cast<unsigned char>(value & 0xff));
+    value >>= 8;
+  }
+}
+
+static std::vector<std::uint64_t> header_fields(const indexed_lts_header& h)
+{
+  return { h.version, h.number_of_states, h.number_of_transitions, h.number_of_action_labels, h.initial_state,
+           h.transition_width, h.transitions_offset, h.meta_data_offset, h.meta_data_size,
+           h.action_labels_offset, h.action_labels_size, h.state_labels_offset, h.state_labels_size,
+           h.state_label_block_size };
+}
+
+static std::vector<unsigned char> encode_header(const indexed_lts_header& h)
+{
+  std::vector<unsigned char> result(indexed_lts_magic, indexed_lts_magic + sizeof(indexed_lts_magic));
+  for (std::uint64_t field: header_fields(h))
+  {
+    append_little_endian(result, field, 8);
+  }
+  assert(result.size() == indexed_lts_header_size);
+  return result;
+}
+
+static indexed_lts_header decode_header(const unsigned char* p)
+{
+  indexed_lts_header h;
+  std::uint64_t* fields[] = { &h.version, &h.number_of_states, &h.number_of_transitions, &h.number_of_action_labels, &h.initial_state,
+                              &h.transition_width, &h.transitions_offset, &h.meta_data_offset, &h.meta_data_size,
+                              &h.action_labels_offset, &h.action_labels_size, &h.state_labels_offset, &h.state_labels_size,
+                              &h.state_label_block_size };
+  p += sizeof(indexed_lts_magic);
+  for (std::uint64_t* field: fields)
+  {
+    *field = read_little_endian(p, 8);
+    p += 8;
+  }
+  return h;
+}
+
+static bool has_indexed_lts_magic(const unsigned char* data, std::size_t size)
+{
+  return size >= indexed_lts_header_size && std::memcmp(data, indexed_lts_magic, sizeof(indexed_lts_magic)) == 0;
+}
+
+static void write_bytes(std::ofstream& stream, const std::vector<unsigned char>& buffer)
+{
+  stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+
+static aterm decode_term(const unsigned char* data, std::size_t size, std::unordered_map<aterm_appl, aterm>& cache)
+{
+  return data::detail::add_index(read_term_from_binary_buffer(data, size), cache);
+}
+
+static void check_section(const std::string& filename, std::size_t file_size, std::uint64_t offset, std::uint64_t size)
+{
+  if (offset > file_size || size > file_size - offset)
+  {
+    throw mcrl2::runtime_error("The file " + filename + " is not a proper indexed .lts file; a section exceeds the end of the file.");
+  }
+}
+
+} // namespace detail
+
+lts_lts_view::lts_lts_view(const std::string& filename)
+  : m_filename(filename),
+    m_file(filename, false)
+{
+  using namespace atermpp;
+  if (!detail::has_indexed_lts_magic(m_file.data(), m_file.size()))
+  {
+    throw mcrl2::runtime_error("The file " + filename + " is not an indexed .lts file.");
+  }
+  m_header = detail::decode_header(m_file.data());
+  if (m_header.version != detail::indexed_lts_version)
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + filename + " has an unsupported version (" + std::to_string(m_header.version) + ").");
+  }
+  if (m_header.transition_width != 4 && m_header.transition_width != 8)
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + filename + " has an unsupported transition width.");
+  }
+  detail::check_section(filename, m_file.size(), m_header.transitions_offset, m_header.number_of_transitions * 3 * m_header.transition_width);
+  detail::check_section(filename, m_file.size(), m_header.meta_data_offset, m_header.meta_data_size);
+  detail::check_section(filename, m_file.size(), m_header.action_labels_offset, m_header.action_labels_size);
+  detail::check_section(filename, m_file.size(), m_header.state_labels_offset, m_header.state_labels_size);
+  if (m_header.number_of_states > 0 && m_header.initial_state >= m_header.number_of_states)
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + filename + " has an initial state that does not exist.");
+  }
+  if (m_header.state_labels_size > 0)
+  {
+    if (m_header.state_label_block_size == 0)
+    {
+      throw mcrl2::runtime_error("The indexed .lts file " + filename + " has an invalid state label block size.");
+    }
+    const std::uint64_t number_of_blocks = (m_header.number_of_states + m_header.state_label_block_size - 1) / m_header.state_label_block_size;
+    if (number_of_blocks >= m_header.state_labels_size / 8)
+    {
+      throw mcrl2::runtime_error("The indexed .lts file " + filename + " has an incomplete index of state labels.");
+    }
+  }
+
+  std::unordered_map<aterm_appl, aterm> cache;
+  const aterm_appl meta_data = down_cast<aterm_appl>(detail::decode_term(m_file.data() + m_header.meta_data_offset, m_header.meta_data_size, cache));
+  if (meta_data.function() != detail::indexed_meta_data_header())
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + filename + " does not contain proper meta data.");
+  }
+  m_data_spec = data::data_specification(down_cast<aterm_appl>(meta_data[0]));
+  m_parameters = down_cast<data::variable_list>(meta_data[1]);
+  m_action_decls = down_cast<process::action_label_list>(meta_data[2]);
+
+  const aterm_list action_labels = down_cast<aterm_list>(detail::decode_term(m_file.data() + m_header.action_labels_offset, m_header.action_labels_size, cache));
+  m_action_labels.reserve(action_labels.size());
+  for (const aterm& a: action_labels)
+  {
+    const aterm_appl& t = down_cast<aterm_appl>(a);
+    assert(t.function() == detail::indexed_multi_action_header());
+    m_action_labels.emplace_back(lps::multi_action(process::action_list(t[0]), data::data_expression(t[1])));
+  }
+  if (m_action_labels.empty() || m_action_labels.size() != m_header.number_of_action_labels || m_action_labels[0] != action_label_lts::tau_action())
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + filename + " does not contain proper action labels.");
+  }
+}
+
+void lts_lts_view::decode_state_label_block(std::size_t block) const
+{
+  using namespace atermpp;
+  const unsigned char* index = m_file.data() + m_header.state_labels_offset;
+  const std::uint64_t begin = detail::read_little_endian(index + 8 * block, 8);
+  const std::uint64_t end = detail::read_little_endian(index + 8 * (block + 1), 8);
+  if (begin > end || end > m_header.state_labels_size)
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + m_filename + " is corrupt; block " + std::to_string(block) + " of the state labels exceeds the section of state labels.");
+  }
+
+  std::unordered_map<aterm_appl, aterm> cache;
+  const aterm_list labels = down_cast<aterm_list>(detail::decode_term(index + begin, end - begin, cache));
+  const std::size_t first = block * m_header.state_label_block_size;
+  if (labels.size() != std::min<std::uint64_t>(m_header.state_label_block_size, m_header.number_of_states - first))
+  {
+    throw mcrl2::runtime_error("The indexed .lts file " + m_filename + " is corrupt; block " + std::to_string(block) + " of the state labels has the wrong size.");
+  }
+  m_cached_state_labels.clear();
+  for (const aterm& label: labels)
+  {
+    m_cached_state_labels.emplace_back(down_cast<state_label_lts>(label));
+  }
+  m_cached_block = block;
+}
+
+bool is_indexed_lts_file(const std::string& filename)
+{
+  std::ifstream stream(filename, std::ios_base::in | std::ios_base::binary);
+  unsigned char magic[sizeof(detail::indexed_lts_magic)];
+  stream.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  return stream.gcount() == sizeof(magic) && std::memcmp(magic, detail::indexed_lts_magic, sizeof(magic)) == 0;
+}
+
+void save_indexed_lts(const lts_lts_t& l, const std::string& filename)
+{
+  using namespace atermpp;
+  using detail::append_little_endian;
+
+  std::ofstream stream(filename, std::ofstream::out | std::ofstream::binary);
+  if (!stream)
+  {
+    throw mcrl2::runtime_error("Fail to open file " + filename + " for writing.");
+  }
+
+  detail::indexed_lts_header header;
+  header.version = detail::indexed_lts_version;
+  header.number_of_states = l.num_states();
+  header.number_of_transitions = l.num_transitions();
+  header.number_of_action_labels = l.num_action_labels();
+  header.initial_state = l.initial_state();
+  header.transition_width = (std::max(l.num_states(), l.num_action_labels()) >> 32) == 0 ? 4 : 8;
+  header.state_label_block_size = detail::default_state_label_block_size;
+
+  // The header is written again when all offsets are known.
+  std::uint64_t offset = detail::indexed_lts_header_size;
+  detail::write_bytes(stream, detail::encode_header(header));
+
+  // Transitions
+  header.transitions_offset = offset;
+  std::vector<unsigned char> buffer;
+  const std::size_t max_buffer_size = 1 << 20;
+  for (const transition& t: l.get_transitions())
+  {
+    append_little_endian(buffer, t.from(), header.transition_width);
+    append_little_endian(buffer, l.apply_hidden_label_map(t.label()), header.transition_width);
+    append_little_endian(buffer, t.to(), header.transition_width);
+    if (buffer.size() >= max_buffer_size)
+    {
+      detail::write_bytes(stream, buffer);
+      buffer.clear();
+    }
+  }
+  detail::write_bytes(stream, buffer);
+  offset += l.num_transitions() * 3 * header.transition_width;
+
+  // Meta data
+  std::unordered_map<aterm_appl, aterm> cache;
+  buffer.clear();
+  write_term_to_binary_buffer(data::detail::remove_index(aterm_appl(detail::indexed_meta_data_header(),
+                                                                    data::detail::data_specification_to_aterm(l.data()),
+                                                                    l.process_parameters(),
+                                                                    l.action_label_declarations()), cache), buffer);
+  header.meta_data_offset = offset;
+  header.meta_data_size = buffer.size();
+  detail::write_bytes(stream, buffer);
+  offset += buffer.size();
+
+  // Action labels
+  aterm_list action_labels;
+  for (std::size_t i = l.num_action_labels(); i > 0; )
+  {
+    --i;
+    action_labels.push_front(aterm_appl(detail::indexed_multi_action_header(), l.action_label(i).actions(), l.action_label(i).time()));
+  }
+  buffer.clear();
+  write_term_to_binary_buffer(data::detail::remove_index(action_labels, cache), buffer);
+  header.action_labels_offset = offset;
+  header.action_labels_size = buffer.size();
+  detail::write_bytes(stream, buffer);
+  offset += buffer.size();
+
+  // State labels, in blocks that are encoded separately.
+  if (l.has_state_info())
+  {
+    const std::size_t block_size = header.state_label_block_size;
+    const std::size_t number_of_blocks = (l.num_state_labels() + block_size - 1) / block_size;
+    std::vector<unsigned char> blocks;
+    std::vector<std::uint64_t> block_offsets;
+    const std::uint64_t index_size = 8 * (number_of_blocks + 1);
+    for (std::size_t block = 0; block < number_of_blocks; block++)
+    {
+      block_offsets.push_back(index_size + blocks.size());
+      aterm_list labels;
+      for (std::size_t i = std::min((block + 1) * block_size, l.num_state_labels()); i > block * block_size; )
+      {
+        --i;
+        labels.push_front(l.state_label(i));
+      }
+      write_term_to_binary_buffer(data::detail::remove_index(labels, cache), blocks);
+    }
+    block_offsets.push_back(index_size + blocks.size());
+
+    buffer.clear();
+    for (std::uint64_t block_offset: block_offsets)
+    {
+      append_little_endian(buffer, block_offset, 8);
+    }
+    header.state_labels_offset = offset;
+    header.state_labels_size = index_size + blocks.size();
+    detail::write_bytes(stream, buffer);
+    detail::write_bytes(stream, blocks);
+  }
+
+  stream.seekp(0);
+  detail::write_bytes(stream, detail::encode_header(header));
+  stream.close();
+  if (stream.fail())
+  {
+    throw mcrl2::runtime_error("Fail to write lts correctly to the file " + filename + ".");
+  }
+}
+
+void load_lts_from_view(const std::shared_ptr<const lts_lts_view>& view, lts_lts_t& l)
+{
+  l.clear();
+  l.set_data(view->data());
+  l.set_process_parameters(view->process_parameters());
+  l.set_action_label_declarations(view->action_label_declarations());
+  for (std::size_t i = 1; i < view->num_action_labels(); i++)
+  {
+    l.add_action(view->action_label(i));
+  }
+  l.set_num_states(view->num_states(), false);
+  if (view->has_state_info())
+  {
+    l.set_state_label_source([view](std::size_t i) { return view->state_label(i); });
+  }
+  if (view->num_states() > 0)
+  {
+    l.set_initial_state(view->initial_state());
+  }
+  std::vector<transition>& transitions = l.get_transitions();
+  transitions.assign(view->begin(), view->end());
+  for (const transition& t: transitions)
+  {
+    if (t.from() >= view->num_states() || t.to() >= view->num_states() || t.label() >= view->num_action_labels())
+    {
+      throw mcrl2::runtime_error("The indexed .lts file contains a transition with a state or label that does not exist.");
+    }
+  }
+}
+
+} // namespace lts
+} // namespace mcrl2
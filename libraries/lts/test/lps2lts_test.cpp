@@ -16,11 +16,13 @@
 #include <iostream>
 #include <sstream>
 #include <cstdio>
+#include <fstream>
 #include "mcrl2/data/detail/rewrite_strategies.h"
 #include "mcrl2/lps/specification.h"
 #include "mcrl2/lps/parse.h"
 #include "mcrl2/lts/detail/exploration.h"
 #include "mcrl2/lts/detail/exploration_strategy.h"
+#include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/lts_aut.h"
 #include "mcrl2/lts/lts_fsm.h"
 #include "mcrl2/lts/lts_lts.h"
@@ -447,6 +449,322 @@ BOOST_AUTO_TEST_CASE(test_max_states)
   BOOST_CHECK_LT(result.num_states(), 10u);
 }
 
+BOOST_AUTO_TEST_CASE(test_external_memory)
+{
+  std::string spec(
+          "act a, b;\n"
+          "proc P(s: Nat, t: Bool, u: List(Bool)) =\n"
+          "  (s < 12) -> a . P(s + 3, !t, [t] ++ u)\n"
+          "+ (s > 1 && #u > 0) -> b . P(Int2Nat(s - 2), t, tail(u));\n"
+          "init P(0, true, []);\n");
+
+  lps::specification specification;
+  parse_lps(spec, specification);
+
+  lts_generation_options options;
+  options.specification = specification;
+  lps2lts_algorithm<lps::next_state_generator> lps2lts;
+  lps2lts.generate_lts(options);
+
+  // A tiny buffer forces the successors of a level to be written in many runs.
+  options.external_memory_directory = ".";
+  options.external_memory_buffer_size = 100;
+  lps2lts_algorithm<lps::next_state_generator> external_lps2lts;
+  external_lps2lts.generate_lts(options);
+
+  BOOST_CHECK_EQUAL(lps2lts.number_of_states(), external_lps2lts.number_of_states());
+  BOOST_CHECK_EQUAL(lps2lts.number_of_transitions(), external_lps2lts.number_of_transitions());
+
+  // Encoding and decoding a state gives back the same state.
+  lps::next_state_generator generator(specification, data::rewriter(specification.data()));
+  detail::state_encoder encoder;
+  std::string s;
+  encoder.encode(generator.initial_state(), s);
+  BOOST_CHECK(encoder.decode(s) == generator.initial_state());
+}
+
+BOOST_AUTO_TEST_CASE(test_transition_caching)
+{
+  std::string spec(
+          "act a, b: Nat;\n"
+          "proc P(s, t: Nat, u: List(Bool)) =\n"
+          "  (s < 5) -> a(s) . P(s = s + 1)\n"
+          "+ (t < 4 && #u < 3) -> b(t) . P(t = t + 1, u = [true] ++ u)\n"
+          "+ sum n: Nat . (n < 3 && s > 2 && #u < 3) -> a(n) . P(s = Int2Nat(s - 1), u = [n > 1] ++ u)\n"
+          "+ (#u > 2) -> b(0) . P(u = [])\n"
+          "+ (s == 4 && t == 2) -> a(s + t) . P(0, 0, [false]);\n"
+          "init P(0, 0, []);\n");
+
+  lps::specification specification;
+  parse_lps(spec, specification);
+
+  lts_generation_options options;
+  options.specification = specification;
+  options.outformat = lts_aut;
+  options.filename = utilities::temporary_filename("lps2lts_test_file");
+  lps2lts_algorithm<lps::next_state_generator> lps2lts;
+  lps2lts.generate_lts(options);
+  lts_aut_t result1;
+  result1.load(options.filename);
+
+  options.use_transition_caching = true;
+  lps2lts_algorithm<lps::next_state_generator> cached_lps2lts;
+  cached_lps2lts.generate_lts(options);
+  lts_aut_t result2;
+  result2.load(options.filename);
+
+  // A cache that is too small to hold any entry must give the same result.
+  options.transition_cache_size = 1;
+  lps2lts_algorithm<lps::next_state_generator> full_cache_lps2lts;
+  full_cache_lps2lts.generate_lts(options);
+  lts_aut_t result3;
+  result3.load(options.filename);
+  std::remove(options.filename.c_str());
+
+  BOOST_CHECK_EQUAL(lps2lts.number_of_states(), cached_lps2lts.number_of_states());
+  BOOST_CHECK_EQUAL(lps2lts.number_of_transitions(), cached_lps2lts.number_of_transitions());
+  BOOST_CHECK_EQUAL(lps2lts.number_of_states(), full_cache_lps2lts.number_of_states());
+  BOOST_CHECK_EQUAL(lps2lts.number_of_transitions(), full_cache_lps2lts.number_of_transitions());
+  lts_aut_t result1_copy = result1;
+  BOOST_CHECK(destructive_compare(result1, result2, lts_eq_bisim));
+  BOOST_CHECK(destructive_compare(result1_copy, result3, lts_eq_bisim));
+
+  // The cache is used: each summand reads only part of the state.
+  lps::next_state_generator generator(specification, data::rewriter(specification.data()));
+  generator.enable_transition_caching(std::size_t(1) << 20);
+  lps::next_state_generator::enumerator_queue queue;
+  for (auto i = generator.begin(generator.initial_state(), &queue); i != generator.end(); ++i) { }
+  for (auto i = generator.begin(generator.initial_state(), &queue); i != generator.end(); ++i) { }
+  BOOST_CHECK_GT(generator.transition_cache_statistics().hits, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_confluence_reduction)
+{
+  std::string spec(
+          "act a, b;\n"
+          "proc P(s, t: Nat) =\n"
+          "  (s < 4) -> tau . P(s = s + 1)\n"
+          "+ (s == 4) -> a . P(s = 0)\n"
+          "+ (t < 3) -> b . P(t = t + 1)\n"
+          "+ (t == 3) -> b . P(t = 0);\n"
+          "init P(0, 0);\n");
+
+  lps::specification specification;
+  parse_lps(spec, specification);
+
+  lts_generation_options options;
+  options.specification = specification;
+  options.outformat = lts_aut;
+  options.filename = utilities::temporary_filename("lps2lts_test_file");
+  lps2lts_algorithm<lps::next_state_generator> lps2lts;
+  lps2lts.generate_lts(options);
+  lts_aut_t result1;
+  result1.load(options.filename);
+
+  options.confluence_action = "tau";
+  lps2lts_algorithm<lps::next_state_generator> confluence_lps2lts;
+  confluence_lps2lts.generate_lts(options);
+  lts_aut_t result2;
+  result2.load(options.filename);
+  std::remove(options.filename.c_str());
+
+  BOOST_CHECK_EQUAL(lps2lts.number_of_states(), 20u);
+  BOOST_CHECK_EQUAL(confluence_lps2lts.number_of_states(), 4u);
+  BOOST_CHECK(destructive_compare(result1, result2, lts_eq_branching_bisim));
+}
+
+BOOST_AUTO_TEST_CASE(test_confluence_reduction_cycle)
+{
+  // The confluent tau cycle P(0) -> P(1) -> P(2) -> P(0) is entered in two places, and
+  // must get the same representative in both cases.
+  std::string spec(
+          "act a, b;\n"
+          "proc P(s: Nat) =\n"
+          "  (s < 3) -> tau . P((s + 1) mod 3)\n"
+          "+ (s == 3) -> a . P(0)\n"
+          "+ (s == 3) -> b . P(1);\n"
+          "init P(3);\n");
+
+  lps::specification specification;
+  parse_lps(spec, specification);
+
+  lts_generation_options options;
+  options.specification = specification;
+  options.outformat = lts_aut;
+  options.filename = utilities::temporary_filename("lps2lts_test_file");
+  options.confluence_action = "tau";
+  lps2lts_algorithm<lps::next_state_generator> confluence_lps2lts;
+  confluence_lps2lts.generate_lts(options);
+  std::remove(options.filename.c_str());
+
+  BOOST_CHECK_EQUAL(confluence_lps2lts.number_of_states(), 2u);
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(test_multiple_processes)
+{
+  std::string spec(
+          "act a, b;\n"
+          "proc P(s: Nat, t: Bool, u: List(Bool)) =\n"
+          "  (s < 12) -> a . P(s + 3, !t, [t] ++ u)\n"
+          "+ (s > 1 && #u > 0) -> b . P(Int2Nat(s - 2), t, tail(u));\n"
+          "init P(0, true, []);\n");
+
+  lps::specification specification;
+  parse_lps(spec, specification);
+
+  lts_generation_options options;
+  options.specification = specification;
+  options.outformat = lts_aut;
+  options.filename = utilities::temporary_filename("lps2lts_test_file");
+  lps2lts_algorithm<lps::next_state_generator> lps2lts;
+  lps2lts.generate_lts(options);
+  lts_aut_t result1;
+  result1.load(options.filename);
+
+  options.number_of_processes = 3;
+  lps2lts_algorithm<lps::next_state_generator> multi_process_lps2lts;
+  multi_process_lps2lts.generate_lts(options);
+  lts_aut_t result2;
+  result2.load(options.filename);
+  std::remove(options.filename.c_str());
+
+  BOOST_CHECK_EQUAL(lps2lts.number_of_states(), multi_process_lps2lts.number_of_states());
+  BOOST_CHECK_EQUAL(lps2lts.number_of_transitions(), multi_process_lps2lts.number_of_transitions());
+  BOOST_CHECK(destructive_compare(result1, result2, lts_eq_bisim));
+}
+
+BOOST_AUTO_TEST_CASE(test_worker_processes_leave_other_children)
+{
+  // A child of the calling process that is not a worker must not be reaped.
+  const pid_t child = ::fork();
+  if (child == 0)
+  {
+    ::_exit(EXIT_SUCCESS);
+  }
+  BOOST_REQUIRE(child > 0);
+  const std::vector<std::string> results = detail::run_worker_processes(2, [](std::size_t i, std::vector<detail::worker_channel>&)
+  {
+    ::usleep(200000);
+    return std::to_string(i);
+  });
+  BOOST_CHECK(results == std::vector<std::string>({ "0", "1" }));
+  int status;
+  BOOST_CHECK_EQUAL(::waitpid(child, &status, 0), child);
+}
+#endif // _WIN32
+
+// Returns true if the states of the trace form a path of the LPS that starts in the initial state.
+static bool is_path(trace::Trace& trace, const lps::specification& specification)
+{
+  lps::next_state_generator generator(specification, data::rewriter(specification.data()));
+  lps::next_state_generator::enumerator_queue queue;
+  trace.resetPosition();
+  if (trace.currentState() != generator.initial_state())
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < trace.number_of_actions(); i++)
+  {
+    const lps::state source = trace.currentState();
+    trace.increasePosition();
+    bool found = false;
+    for (auto j = generator.begin(source, &queue); j != generator.end(); ++j)
+    {
+      found = found || j->target_state == trace.currentState();
+    }
+    if (!found)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE(test_traces)
+{
+  std::string spec(
+          "act a, b, c;\n"
+          "proc P(s: Nat, t: Bool) =\n"
+          "  (s < 6) -> a . P(s + 1, t)\n"
+          "+ (s > 2 && t) -> b . P(s, false)\n"
+          "+ (s == 5 && !t) -> c . P(7, t)\n"
+          "+ (s == 3) -> tau . P(s + 1, !t);\n"
+          "init P(0, true);\n");
+
+  lps::specification specification;
+  parse_lps(spec, specification);
+
+  lts_generation_options options;
+  options.specification = specification;
+  options.detect_deadlock = true;
+  options.save_traces = true;
+  options.trace_prefix = utilities::temporary_filename("lps2lts_test_trace");
+  options.trace_memory_limit = 1;
+  lps2lts_algorithm<lps::next_state_generator> lps2lts;
+  lps2lts.generate_lts(options);
+
+  // The deadlocks P(6, true) and P(7, false) are both reached in six steps.
+  for (const std::string& filename: { options.trace_prefix + "_dlk_0.trc", options.trace_prefix + "_dlk_1.trc" })
+  {
+    trace::Trace trace(filename);
+    BOOST_CHECK_EQUAL(trace.number_of_actions(), 6u);
+    BOOST_CHECK(is_path(trace, specification));
+    std::remove(filename.c_str());
+  }
+
+  // With confluence reduction the confluent tau transitions are added to the trace.
+  options.confluence_action = "tau";
+  options.max_traces = 1;
+  lps2lts_algorithm<lps::next_state_generator> confluence_lps2lts;
+  confluence_lps2lts.generate_lts(options);
+  const std::string filename = options.trace_prefix + "_dlk_0.trc";
+  trace::Trace trace(filename);
+  BOOST_CHECK(is_path(trace, specification));
+  std::remove(filename.c_str());
+  BOOST_CHECK(!std::ifstream(options.trace_prefix + "_dlk_1.trc"));
+
+  // The parents are written to disk if they do not fit in memory.
+  detail::parent_store parents(300, 1, ".");
+  for (std::size_t i = 0; i < 1000000; i++)
+  {
+    parents.push_back(i / 2, i % 300);
+  }
+  BOOST_CHECK_EQUAL(parents.record_size(), 6u);
+  BOOST_CHECK_GT(parents.bytes_written(), 0u);
+  BOOST_CHECK(parents[12345] == std::make_pair(std::size_t(6172), std::size_t(45)));
+  BOOST_CHECK(parents[999999] == std::make_pair(std::size_t(499999), std::size_t(99)));
+}
+
+BOOST_AUTO_TEST_CASE(test_parent_store_wide_parents)
+{
+  // The parents start with 4 bytes, and get 5 bytes from the first parent beyond 2^32 on,
+  // also in the middle of a block. The earlier blocks keep their width, in memory and on disk.
+  const std::size_t large = std::size_t(1) << 32;
+  detail::parent_store parents(300, 1, ".");
+  for (std::size_t i = 0; i < 200000; i++)
+  {
+    parents.push_back(i < 100000 ? i / 2 : large + i, i % 300);
+  }
+  BOOST_CHECK_EQUAL(parents.record_size(), 7u);
+  BOOST_CHECK_GT(parents.bytes_written(), 0u);
+  BOOST_CHECK(parents[12345] == std::make_pair(std::size_t(6172), std::size_t(45)));
+  BOOST_CHECK(parents[99999] == std::make_pair(std::size_t(49999), std::size_t(99)));
+  BOOST_CHECK(parents[100000] == std::make_pair(large + 100000, std::size_t(100)));
+  BOOST_CHECK(parents[199999] == std::make_pair(large + 199999, std::size_t(199)));
+
+  detail::parent_store in_memory(300, std::size_t(1) << 30, ".");
+  for (std::size_t i = 0; i < 100; i++)
+  {
+    in_memory.push_back(i == 50 ? large : i, i);
+  }
+  BOOST_CHECK_EQUAL(in_memory.bytes_written(), 0u);
+  BOOST_CHECK_EQUAL(in_memory.record_size(), 7u);
+  BOOST_CHECK(in_memory[49] == std::make_pair(std::size_t(49), std::size_t(49)));
+  BOOST_CHECK(in_memory[50] == std::make_pair(large, std::size_t(50)));
+  BOOST_CHECK(in_memory[99] == std::make_pair(std::size_t(99), std::size_t(99)));
+}
+
 BOOST_AUTO_TEST_CASE(test_interaction_sum_and_assignment_notation1)
 {
   std::string spec(
@@ -0,0 +1,144 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file lts_lts_view_test.cpp
+/// \brief Tests for the indexed .lts layout.
+
+#define BOOST_TEST_MODULE lts_lts_view_test
+#include <boost/test/included/unit_test_framework.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include "mcrl2/lps/parse.h"
+#include "mcrl2/lts/detail/exploration.h"
+#include "mcrl2/lts/lts_lts_view.h"
+#include "mcrl2/utilities/test_utilities.h"
+
+using namespace mcrl2;
+using namespace mcrl2::lts;
+
+static lts_lts_t generate_lts(const std::string& text, bool outinfo)
+{
+  lts_generation_options options;
+  options.specification = lps::parse_linear_process_specification(text);
+  options.filename = utilities::temporary_filename("lts_lts_view_test_file") + ".lts";
+  options.outformat = lts_lts;
+  options.outinfo = outinfo;
+  lps2lts_algorithm<lps::next_state_generator> algorithm;
+  algorithm.generate_lts(options);
+  lts_lts_t result;
+  result.load(options.filename);
+  std::remove(options.filename.c_str());
+  return result;
+}
+
+static void check_view(const std::string& text, bool outinfo)
+{
+  lts_lts_t l = generate_lts(text, outinfo);
+  const std::string filename = utilities::temporary_filename("lts_lts_view_test_file") + ".lts";
+  save_indexed_lts(l, filename);
+  BOOST_CHECK(is_indexed_lts_file(filename));
+
+  {
+    lts_lts_view view(filename);
+    BOOST_CHECK_EQUAL(view.num_states(), l.num_states());
+    BOOST_CHECK_EQUAL(view.num_transitions(), l.num_transitions());
+    BOOST_CHECK_EQUAL(view.num_action_labels(), l.num_action_labels());
+    BOOST_CHECK_EQUAL(view.initial_state(), l.initial_state());
+    BOOST_CHECK(view.has_state_info() == l.has_state_info());
+    BOOST_CHECK(std::equal(view.begin(), view.end(), l.get_transitions().begin()));
+    for (std::size_t i = 0; i < l.num_action_labels(); i++)
+    {
+      BOOST_CHECK(view.action_label(i) == l.action_label(i));
+    }
+    if (l.has_state_info())
+    {
+      for (std::size_t i = l.num_states(); i > 0; )
+      {
+        --i;
+        BOOST_CHECK(view.state_label(i) == l.state_label(i));
+      }
+    }
+  }
+
+  lts_lts_t l1;
+  l1.load(filename);
+  BOOST_CHECK(l1.get_transitions() == l.get_transitions());
+  BOOST_CHECK(l1.action_labels() == l.action_labels());
+  BOOST_CHECK_EQUAL(l1.num_state_labels(), l.num_state_labels());
+  BOOST_CHECK(l1.has_state_info() == l.has_state_info());
+  if (l.has_state_info())
+  {
+    BOOST_CHECK(l1.state_label(l.num_states() - 1) == l.state_label(l.num_states() - 1));
+
+    // Changing a state label causes all state labels to be copied from the file.
+    l1.set_state_label(0, l.state_label(1));
+    BOOST_CHECK(l1.state_label(0) == l.state_label(1));
+    BOOST_CHECK(l1.state_label(1) == l.state_label(1));
+  }
+  std::remove(filename.c_str());
+}
+
+// Overwrites the 64 bit little endian number at the given position of a file.
+static void overwrite_number(const std::string& filename, std::size_t position, std::uint64_t value)
+{
+  std::fstream stream(filename, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+  stream.seekp(position);
+  for (std::size_t i = 0; i < 8; i++)
+  {
+    stream.put(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+// Reads the 64 bit little endian number at the given position of a file.
+static std::uint64_t read_number(const std::string& filename, std::size_t position)
+{
+  std::ifstream stream(filename, std::ios_base::in | std::ios_base::binary);
+  stream.seekg(position);
+  unsigned char buffer[8];
+  stream.read(reinterpret_cast<char*>(buffer), 8);
+  return detail::read_little_endian(buffer, 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_lts)
+{
+  std::string text =
+    "act a: Nat;                                  \n"
+    "    b;                                       \n"
+    "proc P(n: Nat) = (n < 1500) -> a(n) . P(n + 1)\n"
+    "               + (n > 0) -> b . P(Int2Nat(n - 1))\n"
+    "               + tau . P(n);                  \n"
+    "init P(0);                                   \n"
+    ;
+  check_view(text, true);
+  check_view(text, false);
+}
+
+// A corrupt index of state labels is detected when the state labels are decoded.
+BOOST_AUTO_TEST_CASE(test_corrupt_state_label_index)
+{
+  std::string text =
+    "act a: Nat;                                  \n"
+    "proc P(n: Nat) = (n < 10) -> a(n) . P(n + 1);\n"
+    "init P(0);                                   \n"
+    ;
+  lts_lts_t l = generate_lts(text, true);
+  const std::string filename = utilities::temporary_filename("lts_lts_view_test_file") + ".lts";
+  save_indexed_lts(l, filename);
+
+  // The header consists of 8 magic bytes, followed by 64 bit fields. The offset of the
+  // state labels is the twelfth field.
+  const std::uint64_t state_labels_offset = read_number(filename, 8 + 11 * 8);
+  overwrite_number(filename, state_labels_offset + 8, std::uint64_t(1) << 40);
+
+  lts_lts_t l1;
+  l1.load(filename);
+  BOOST_CHECK_EQUAL(l1.num_states(), l.num_states());
+  BOOST_CHECK_THROW(l1.state_label(0), mcrl2::runtime_error);
+  std::remove(filename.c_str());
+}
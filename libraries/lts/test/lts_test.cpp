@@ -14,6 +14,9 @@
 #include <boost/test/minimal.hpp>
 #include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/lts_aut.h"
+#include "mcrl2/lts/sigref.h"
+#include "mcrl2/lts/detail/bithashtable.h"
+#include "mcrl2/atermpp/aterm_io.h"
 
 using namespace mcrl2;
 
@@ -70,6 +73,9 @@ static void reduce_lts_in_various_ways(const std::string& test_description,
   reduce(l,lts::lts_eq_none);
   test_lts(test_description + " (no reduction)",l, expected.labels_plain,expected.states_plain, expected.transitions_plain);
   l=l_in;
+  reduce(l,lts::lts_eq_bisim_dnj);
+  test_lts(test_description + " (bisimulation on labelled transitions)",l, expected.labels_bisimulation,expected.states_bisimulation, expected.transitions_bisimulation);
+  l=l_in;
   reduce(l,lts::lts_eq_bisim);
   test_lts(test_description + " (bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l, expected.labels_bisimulation,expected.states_bisimulation, expected.transitions_bisimulation);
   l=l_in;
@@ -79,6 +85,9 @@ static void reduce_lts_in_various_ways(const std::string& test_description,
   reduce(l,lts::lts_eq_bisim_sigref);
   test_lts(test_description + " (bisimulation signature [Blom/Orzan 2003])",l, expected.labels_bisimulation,expected.states_bisimulation, expected.transitions_bisimulation);
   l=l_in;
+  reduce(l,lts::lts_eq_branching_bisim_dnj);
+  test_lts(test_description + " (branching bisimulation on labelled transitions)",l, expected.labels_branching_bisimulation,expected.states_branching_bisimulation, expected.transitions_branching_bisimulation);
+  l=l_in;
   reduce(l,lts::lts_eq_branching_bisim);
   test_lts(test_description + " (branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l, expected.labels_branching_bisimulation,expected.states_branching_bisimulation, expected.transitions_branching_bisimulation);
   l=l_in;
@@ -88,6 +97,12 @@ static void reduce_lts_in_various_ways(const std::string& test_description,
   reduce(l,lts::lts_eq_branching_bisim_sigref);
   test_lts(test_description + " (branching bisimulation signature [Blom/Orzan 2003])",l, expected.labels_branching_bisimulation,expected.states_branching_bisimulation, expected.transitions_branching_bisimulation);
   l=l_in;
+  reduce(l,lts::lts_eq_divergence_preserving_branching_bisim_dnj);
+  test_lts(test_description + " (divergence-preserving branching bisimulation on labelled transitions)",l,
+                                      expected.labels_divergence_preserving_branching_bisimulation,
+                                      expected.states_divergence_preserving_branching_bisimulation,
+                                      expected.transitions_divergence_preserving_branching_bisimulation);
+  l=l_in;
   reduce(l,lts::lts_eq_divergence_preserving_branching_bisim);
   test_lts(test_description + " (divergence-preserving branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l,
                                       expected.labels_divergence_preserving_branching_bisimulation,
@@ -481,6 +496,9 @@ static void failing_test_groote_wijs_algorithm()
   lts::lts_aut_t l_gw;
   l_gw.load(is);
   lts::lts_aut_t l=l_gw;
+  reduce(l,lts::lts_eq_branching_bisim_dnj);
+  test_lts("gw problem (branching bisimulation on labelled transitions)",l,expected_label_count, expected_state_count, expected_transition_count);
+  l=l_gw;
   reduce(l,lts::lts_eq_branching_bisim);
   test_lts("gw problem (branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l,expected_label_count, expected_state_count, expected_transition_count);
   l=l_gw;
@@ -533,6 +551,9 @@ static void counterexample_jk_1(std::size_t k)
     lts::lts_aut_t l_cjk1;
     l_cjk1.load(is);
     lts::lts_aut_t l=l_cjk1;
+    reduce(l,lts::lts_eq_branching_bisim_dnj);
+    test_lts("counterexample JK 1 (branching bisimulation on labelled transitions)",l,expected_label_count, expected_state_count, expected_transition_count);
+    l=l_cjk1;
     reduce(l,lts::lts_eq_branching_bisim);
     test_lts("counterexample JK 1 (branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l,expected_label_count, expected_state_count, expected_transition_count);
     l=l_cjk1;
@@ -607,6 +628,9 @@ static void counterexample_postprocessing()
   lts::lts_aut_t l_gw;
   l_gw.load(is);
   lts::lts_aut_t l=l_gw;
+  reduce(l,lts::lts_eq_branching_bisim_dnj);
+  test_lts("postprocessing problem (branching bisimulation on labelled transitions)",l,expected_label_count, expected_state_count, expected_transition_count);
+  l=l_gw;
   reduce(l,lts::lts_eq_branching_bisim);
   test_lts("postprocessing problem (branching bisimulation [Groote/Jansen/Keiren/Wijs 2017])",l,expected_label_count, expected_state_count, expected_transition_count);
   l=l_gw;
@@ -617,6 +641,500 @@ static void counterexample_postprocessing()
   test_lts("postprocessing problem (branching bisimulation signature [Blom/Orzan 2003])",l,expected_label_count, expected_state_count, expected_transition_count);
 }
 
+// Returns a pseudo random LTS in which about half of the transitions are tau
+// transitions, such that there are many tau cycles and long tau paths.
+static lts::lts_aut_t random_lts(std::size_t number_of_states, std::size_t number_of_transitions, std::size_t seed = 12345)
+{
+  lts::lts_aut_t l;
+  l.add_action(lts::action_label_string("a"));
+  l.add_action(lts::action_label_string("b"));
+  l.set_num_states(number_of_states, false);
+  l.set_initial_state(0);
+  std::size_t x = seed;
+  for (std::size_t i = 0; i < number_of_transitions; ++i)
+  {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    const std::size_t from = (x >> 33) % number_of_states;
+    const std::size_t label = (x >> 20) % 4 == 0 ? 1 + (x >> 24) % 2 : 0;
+    const std::size_t to = (x >> 40) % 16 == 0 ? (x >> 12) % number_of_states : (from + 1 + (x >> 8) % 3) % number_of_states;
+    l.add_transition(lts::transition(from, label, to));
+  }
+  return l;
+}
+
+template <typename Signature>
+static void test_sigref_threads(lts::lts_equivalence eq, std::size_t number_of_states, std::size_t number_of_transitions)
+{
+  const lts::lts_aut_t l_in = random_lts(number_of_states, number_of_transitions);
+  lts::lts_aut_t l1 = l_in;
+  lts::sigref<lts::lts_aut_t, Signature>(l1, 1).run();
+  lts::lts_aut_t l4 = l_in;
+  lts::sigref<lts::lts_aut_t, Signature>(l4, 4).run();
+  lts::lts_aut_t l = l_in;
+  reduce(l, eq);
+
+  // The result must not depend on the number of threads.
+  BOOST_CHECK(l1.num_states() == l4.num_states());
+  BOOST_CHECK(l1.get_transitions() == l4.get_transitions());
+  BOOST_CHECK(l1.initial_state() == l4.initial_state());
+
+  BOOST_CHECK(l1.num_states() == l.num_states());
+  BOOST_CHECK(l1.num_transitions() == l.num_transitions());
+}
+
+void test_parallel_sigref()
+{
+  for (std::size_t n: { 10, 100, 2000 })
+  {
+    test_sigref_threads<lts::signature_bisim<lts::lts_aut_t> >(lts::lts_eq_bisim, n, 3 * n);
+    test_sigref_threads<lts::signature_branching_bisim<lts::lts_aut_t> >(lts::lts_eq_branching_bisim, n, 3 * n);
+    test_sigref_threads<lts::signature_divergence_preserving_branching_bisim<lts::lts_aut_t> >(lts::lts_eq_divergence_preserving_branching_bisim, n, 3 * n);
+  }
+}
+
+// The weak signatures share equal sets, also when they are computed by several threads.
+template <typename Signature>
+static void test_weak_sigref_threads(lts::lts_equivalence eq, std::size_t number_of_states, std::size_t number_of_transitions)
+{
+  const lts::lts_aut_t l_in = random_lts(number_of_states, number_of_transitions);
+  lts::lts_aut_t l1 = l_in;
+  lts::sigref<lts::lts_aut_t, Signature>(l1, 1).run();
+  lts::lts_aut_t l4 = l_in;
+  lts::sigref<lts::lts_aut_t, Signature>(l4, 4).run();
+  lts::lts_aut_t l = l_in;
+  reduce(l, eq);
+
+  BOOST_CHECK(l1.num_states() == l4.num_states());
+  BOOST_CHECK(l1.get_transitions() == l4.get_transitions());
+  BOOST_CHECK(l1.initial_state() == l4.initial_state());
+  BOOST_CHECK(l1.num_states() == l.num_states());
+}
+
+void test_parallel_weak_sigref()
+{
+  for (std::size_t n: { 10, 100, 2000 })
+  {
+    test_weak_sigref_threads<lts::signature_weak_bisim<lts::lts_aut_t> >(lts::lts_eq_weak_bisim, n, 3 * n);
+    test_weak_sigref_threads<lts::signature_divergence_preserving_weak_bisim<lts::lts_aut_t> >(lts::lts_eq_divergence_preserving_weak_bisim, n, 3 * n);
+  }
+}
+
+// The algorithm on labelled transitions and the one on Kripke structures must
+// give the same quotient (up to the numbering of the states).
+void test_bisimulation_without_kripke_structure()
+{
+  for (std::size_t n: { 10, 100, 2000 })
+  {
+    for (int mode = 0; mode < 3; ++mode)
+    {
+      const bool branching = mode > 0;
+      const bool preserve_divergence = mode > 1;
+      const lts::lts_aut_t l = random_lts(n, 3 * n, n);
+      lts::lts_aut_t l1 = l;
+      lts::detail::bisimulation_reduce_dnj(l1, branching, preserve_divergence);
+      lts::lts_aut_t l2 = l;
+      lts::detail::bisimulation_reduce_gjkw(l2, branching, preserve_divergence);
+      BOOST_CHECK(l1.num_states() == l2.num_states());
+      BOOST_CHECK(l1.num_transitions() == l2.num_transitions());
+      BOOST_CHECK(lts::detail::destructive_bisimulation_compare_gjkw(l1, l2));
+
+      lts::lts_aut_t l3 = l;
+      l3.set_initial_state(n - 1);
+      BOOST_CHECK(lts::detail::bisimulation_compare_dnj(l, l3, branching, preserve_divergence) ==
+                  lts::detail::bisimulation_compare_gjkw(l, l3, branching, preserve_divergence));
+    }
+  }
+}
+
+// Weak bisimulation reduction via the reflexive transitive tau closure, which was used
+// before the weak signatures were introduced.
+static void closure_weak_bisimulation_reduce(lts::lts_aut_t& l, bool preserve_divergences)
+{
+  lts::detail::bisimulation_reduce_gjkw(l, true, preserve_divergences);
+  std::size_t divergence_label = 0;
+  if (preserve_divergences)
+  {
+    divergence_label = lts::detail::mark_explicit_divergence_transitions(l);
+  }
+  lts::detail::reflexive_transitive_tau_closure(l);
+  lts::detail::bisimulation_reduce_gjkw(l, false, false);
+  lts::scc_reduce(l);
+  lts::detail::remove_redundant_transitions(l);
+  if (preserve_divergences)
+  {
+    lts::detail::unmark_explicit_divergence_transitions(l, divergence_label);
+  }
+}
+
+void test_weak_bisimulation_without_closure()
+{
+  for (std::size_t n: { 10, 100, 500 })
+  {
+    for (bool preserve_divergences: { false, true })
+    {
+      const lts::lts_aut_t l = random_lts(n, 2 * n);
+      lts::lts_aut_t l1 = l;
+      lts::detail::weak_bisimulation_reduce(l1, preserve_divergences);
+      lts::lts_aut_t l2 = l;
+      closure_weak_bisimulation_reduce(l2, preserve_divergences);
+      BOOST_CHECK(l1.num_states() == l2.num_states());
+
+      // The closure based reduction of equivalent LTSs gives strongly bisimilar results.
+      closure_weak_bisimulation_reduce(l1, preserve_divergences);
+      BOOST_CHECK(lts::detail::destructive_bisimulation_compare_gjkw(l1, l2));
+    }
+  }
+}
+
+// The tau star reduction as it was implemented with a closure of sets of states.
+static void closure_tau_star_reduce(lts::lts_aut_t& l)
+{
+  std::map<std::size_t, std::set<std::size_t> > backward_tau_closure = lts::detail::calculate_non_reflexive_transitive_tau_closure(l, false);
+  std::set<lts::transition> new_transitions;
+  for (const lts::transition& t: l.get_transitions())
+  {
+    if (!l.is_tau(l.apply_hidden_label_map(t.label())))
+    {
+      new_transitions.insert(t);
+      for (std::size_t from: backward_tau_closure[t.from()])
+      {
+        new_transitions.insert(lts::transition(from, t.label(), t.to()));
+      }
+    }
+  }
+  l.clear_transitions();
+  for (const lts::transition& t: new_transitions)
+  {
+    l.add_transition(t);
+  }
+  reachability_check(l, true);
+}
+
+void test_tau_star_reduce()
+{
+  for (std::size_t n: { 10, 100, 500 })
+  {
+    const lts::lts_aut_t l = random_lts(n, 2 * n);
+    lts::lts_aut_t l1 = l;
+    lts::detail::tau_star_reduce(l1);
+    lts::lts_aut_t l2 = l;
+    closure_tau_star_reduce(l2);
+    BOOST_CHECK(l1.num_states() == l2.num_states());
+    BOOST_CHECK(l1.initial_state() == l2.initial_state());
+    BOOST_CHECK(l1.get_transitions() == l2.get_transitions());
+  }
+}
+
+// Compares the anti-chain based trace refinement checks with the checks via determinisation.
+void test_antichain_trace_refinement()
+{
+  std::size_t included = 0;
+  for (std::size_t seed = 0; seed < 40; ++seed)
+  {
+    const lts::lts_aut_t l1 = random_lts(4, 6, seed);
+    const lts::lts_aut_t l2 = random_lts(5, 10, seed + 1000);
+    const bool expected = lts::compare(l1, l2, lts::lts_pre_trace, false);
+    BOOST_CHECK(lts::compare(l1, l2, lts::lts_pre_trace_anti_chain, false) == expected);
+    BOOST_CHECK(lts::compare(l1, l2, lts::lts_pre_weak_trace_anti_chain, false) == lts::compare(l1, l2, lts::lts_pre_weak_trace, false));
+    BOOST_CHECK(lts::compare(l1, l1, lts::lts_pre_failures_refinement, false));
+    BOOST_CHECK(lts::compare(l2, l2, lts::lts_pre_failures_divergence_refinement, false));
+    included += expected ? 1 : 0;
+  }
+  // Both outcomes must occur, otherwise the test is meaningless.
+  BOOST_CHECK(0 < included && included < 40);
+}
+
+void test_subset_store()
+{
+  lts::detail::subset_store store;
+  const std::vector<std::size_t> s1 = { 0, 1, 2, 1000, 1000000000 };
+  const std::vector<std::size_t> s2 = { 3 };
+  const std::vector<std::size_t> s3;
+  BOOST_CHECK(store.insert(s1) == std::make_pair(std::size_t(0), true));
+  BOOST_CHECK(store.insert(s2) == std::make_pair(std::size_t(1), true));
+  BOOST_CHECK(store.insert(s3) == std::make_pair(std::size_t(2), true));
+  BOOST_CHECK(store.insert(s1) == std::make_pair(std::size_t(0), false));
+  BOOST_CHECK(store.insert(s3) == std::make_pair(std::size_t(2), false));
+  BOOST_CHECK(store.size() == 3);
+  BOOST_CHECK(store.get(0) == s1);
+  BOOST_CHECK(store.get(1) == s2);
+  BOOST_CHECK(store.empty(2));
+
+  // Force a few resizes of the hash table.
+  for (std::size_t i = 0; i < 5000; ++i)
+  {
+    store.insert(std::vector<std::size_t>({ i, i + 7, 3 * i + 10 }));
+  }
+  for (std::size_t i = 0; i < 5000; ++i)
+  {
+    BOOST_CHECK(!store.insert(std::vector<std::size_t>({ i, i + 7, 3 * i + 10 })).second);
+  }
+  BOOST_CHECK(store.get(0) == s1);
+}
+
+// Checks that the result of determinisation is deterministic, trace equivalent to the
+// original, and independent of the number of threads.
+void test_determinise()
+{
+  for (std::size_t seed = 0; seed < 20; ++seed)
+  {
+    const lts::lts_aut_t l = random_lts(8, 20, seed);
+    lts::lts_aut_t l1 = l;
+    determinise(l1);
+    BOOST_CHECK(is_deterministic(l1));
+    BOOST_CHECK(lts::compare(l, l1, lts::lts_pre_trace_anti_chain, false));
+    BOOST_CHECK(lts::compare(l1, l, lts::lts_pre_trace_anti_chain, false));
+  }
+
+  const lts::lts_aut_t l = random_lts(200, 400);
+  std::vector<lts::transition> transitions1;
+  lts::detail::subset_store store1;
+  store1.insert(std::vector<std::size_t>(1, l.initial_state()));
+  lts::detail::subset_construction(l.outgoing_transition_index(), store1, transitions1, 1);
+  std::vector<lts::transition> transitions4;
+  lts::detail::subset_store store4;
+  store4.insert(std::vector<std::size_t>(1, l.initial_state()));
+  lts::detail::subset_construction(l.outgoing_transition_index(), store4, transitions4, 4);
+  BOOST_CHECK(store1.size() == store4.size());
+  BOOST_CHECK(transitions1 == transitions4);
+}
+
+// Computes the simulation preorder by removing pairs until a fixpoint is reached.
+static std::vector<std::vector<bool> > naive_simulation(const lts::lts_aut_t& l, bool ready)
+{
+  const lts::adjacency_index& out = l.outgoing_transition_index();
+  const std::size_t n = l.num_states();
+  std::vector<std::set<std::size_t> > enabled(n);
+  for (std::size_t s = 0; s < n; ++s)
+  {
+    for (const lts::adjacent_transition& t: out.transitions(s))
+    {
+      enabled[s].insert(t.label);
+    }
+  }
+  std::vector<std::vector<bool> > R(n, std::vector<bool>(n, true));
+  for (std::size_t s = 0; s < n; ++s)
+  {
+    for (std::size_t t = 0; t < n; ++t)
+    {
+      R[s][t] = !ready || enabled[s] == enabled[t];
+    }
+  }
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    for (std::size_t s = 0; s < n; ++s)
+    {
+      for (std::size_t t = 0; t < n; ++t)
+      {
+        if (!R[s][t])
+        {
+          continue;
+        }
+        for (const lts::adjacent_transition& a: out.transitions(s))
+        {
+          bool found = false;
+          for (const lts::adjacent_transition& b: out.transitions(t, a.label))
+          {
+            found = found || R[a.state][b.state];
+          }
+          if (!found)
+          {
+            R[s][t] = false;
+            changed = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+  return R;
+}
+
+void test_simulation_preorder()
+{
+  for (std::size_t seed = 0; seed < 10; ++seed)
+  {
+    const lts::lts_aut_t l = random_lts(150, 200, seed);
+    for (bool ready: { false, true })
+    {
+      const std::vector<std::vector<bool> > expected = naive_simulation(l, ready);
+      for (std::size_t threads: { 1, 4 })
+      {
+        lts::detail::sim_partitioner<lts::lts_aut_t> sp(l, ready, threads);
+        sp.partitioning_algorithm();
+        bool equal = true;
+        for (std::size_t s = 0; s < l.num_states(); ++s)
+        {
+          for (std::size_t t = 0; t < l.num_states(); ++t)
+          {
+            equal = equal && sp.in_preorder(s, t) == expected[s][t];
+            equal = equal && sp.in_same_class(s, t) == (expected[s][t] && expected[t][s]);
+          }
+        }
+        BOOST_CHECK(equal);
+      }
+    }
+  }
+}
+
+// The simulation subsumption of refinement checking is limited by the number of blocks, not states.
+void test_refinement_simulation_limit()
+{
+  const std::size_t n = 20000;
+  lts::lts_aut_t l;
+  l.add_action(lts::action_label_string("a"));
+  l.set_num_states(n, false);
+  for (std::size_t s = 0; s < n; ++s)
+  {
+    l.add_transition(lts::transition(s, 1, (s + 1) % n));
+  }
+  const lts::detail::lts_cache<lts::lts_aut_t> cache(l, false);
+  const lts::detail::refinement_simulation<lts::lts_aut_t> simulation(l, cache, lts::failures);
+  BOOST_CHECK(simulation.available());
+  BOOST_CHECK(simulation.simulated_by(0, n - 1));
+  const lts::detail::refinement_simulation<lts::lts_aut_t> limited(l, cache, lts::failures, 0);
+  BOOST_CHECK(!limited.available());
+  BOOST_CHECK(!limited.simulated_by(0, n - 1));
+}
+
+// The labels of the transitions that are kept by remove_redundant_transitions must
+// not be renamed by the hidden label map.
+void test_remove_redundant_transitions_hidden_labels()
+{
+  std::string automaton =
+    "des(0,4,3)\n"
+    "(0,\"a\",1)\n"
+    "(0,\"a\",2)\n"
+    "(1,\"h\",2)\n"
+    "(2,\"h\",0)\n";
+
+  std::istringstream is(automaton);
+  lts::lts_aut_t l;
+  l.load(is);
+  std::size_t h = 0;
+  for (std::size_t a = 0; a < l.num_action_labels(); ++a)
+  {
+    if (l.action_label(a) == lts::action_label_string("h"))
+    {
+      h = a;
+    }
+  }
+  BOOST_CHECK(h != l.tau_label_index());
+  std::map<std::size_t, std::size_t> hidden_label_map;
+  hidden_label_map[h] = l.tau_label_index();
+  l.set_hidden_label_map(hidden_label_map);
+
+  // 0 -a-> 2 is redundant, as there is also 0 -a-> 1 -h-> 2 and h is hidden.
+  lts::detail::remove_redundant_transitions(l);
+  BOOST_CHECK(l.num_transitions() == 3);
+  for (const lts::transition& t: l.get_transitions())
+  {
+    BOOST_CHECK(!(t.from() == 0 && t.to() == 2));
+    BOOST_CHECK(t.label() != l.tau_label_index());
+    BOOST_CHECK(t.label() == h || t.from() == 0);
+  }
+}
+
+void test_transition_indices()
+{
+  std::string automaton =
+    "des(0,4,3)\n"
+    "(0,\"b\",2)\n"
+    "(0,\"a\",1)\n"
+    "(0,\"a\",0)\n"
+    "(1,\"tau\",0)\n";
+
+  std::istringstream is(automaton);
+  lts::lts_aut_t l;
+  l.load(is);
+
+  const lts::adjacency_index& out = l.outgoing_transition_index();
+  BOOST_CHECK(out.transitions(0).size() == 3);
+  BOOST_CHECK(out.transitions(2).empty());
+  std::size_t a = 0;
+  while (l.action_label(a) != lts::action_label_string("a"))
+  {
+    a++;
+  }
+  BOOST_CHECK(out.transitions(0, a).size() == 2);
+  BOOST_CHECK(out.transitions(0, a)[0].state == 0 && out.transitions(0, a)[1].state == 1);
+  BOOST_CHECK(&l.outgoing_transition_index() == &out);
+
+  const lts::adjacency_index& in = l.incoming_transition_index();
+  BOOST_CHECK(in.transitions(0).size() == 2);
+  BOOST_CHECK(in.transitions(0, l.tau_label_index()).size() == 1);
+
+  // Adding a transition invalidates the indices.
+  l.add_transition(lts::transition(2, l.tau_label_index(), 0));
+  BOOST_CHECK(l.outgoing_transition_index().transitions(2).size() == 1);
+  BOOST_CHECK(l.incoming_transition_index().transitions(0, l.tau_label_index()).size() == 2);
+
+  // Hiding actions changes the labels in the indices.
+  l.hide_actions({ "b" });
+  BOOST_CHECK(l.outgoing_transition_index().transitions(0, l.tau_label_index()).size() == 1);
+
+  // Changing a transition in place, without changing the number of transitions, also
+  // invalidates the indices. An index that is shared remains valid, and describes the
+  // transitions before the change.
+  std::shared_ptr<const lts::adjacency_index> shared_out = l.shared_outgoing_transition_index();
+  for (lts::transition& t: l.get_transitions())
+  {
+    if (t.from() == 2)
+    {
+      t = lts::transition(1, t.label(), t.to());
+    }
+  }
+  BOOST_CHECK(l.outgoing_transition_index().transitions(2).empty());
+  BOOST_CHECK(shared_out->transitions(2).size() == 1);
+  l.sort_transitions();
+  BOOST_CHECK(l.outgoing_transition_index().transitions(1).size() == 2);
+}
+
+void test_compact_transitions()
+{
+#ifndef MCRL2_LTS_WIDE_TRANSITIONS
+  BOOST_CHECK(sizeof(lts::transition) == 12);
+  bool overflow = false;
+  try
+  {
+    lts::transition t(std::size_t(1) << 32, 0, 0);
+  }
+  catch (mcrl2::runtime_error&)
+  {
+    overflow = true;
+  }
+  BOOST_CHECK(overflow);
+
+  // An LTS that is too large is rejected when it is loaded, with a hint to the build option.
+  std::string message;
+  try
+  {
+    std::istringstream is("des (0,0,4294967297)\n");
+    lts::lts_aut_t l;
+    l.load(is);
+  }
+  catch (mcrl2::runtime_error& e)
+  {
+    message = e.what();
+  }
+  BOOST_CHECK(message.find("MCRL2_LTS_WIDE_TRANSITIONS") != std::string::npos);
+#endif
+
+  // The radix sort must give the same order as the comparison based sort.
+  const std::map<std::size_t, std::size_t> no_hidden_labels;
+  std::vector<lts::transition> transitions = random_lts(100000, 300000).get_transitions();
+  transitions.push_back(lts::transition(70000, 3, 1 << 17));
+  std::vector<lts::transition> expected = transitions;
+  std::sort(expected.begin(), expected.end(), lts::detail::compare_transitions_slt(no_hidden_labels));
+  lts::detail::radix_sort_transitions(transitions, lts::src_lbl_tgt);
+  BOOST_CHECK(transitions == expected);
+  std::sort(expected.begin(), expected.end(), lts::detail::compare_transitions_lts(no_hidden_labels));
+  lts::detail::radix_sort_transitions(transitions, lts::lbl_tgt_src);
+  BOOST_CHECK(transitions == expected);
+}
+
 void is_deterministic_test1()
 {
   std::string automaton =
@@ -649,6 +1167,60 @@ void test_is_deterministic()
   is_deterministic_test2();
 }
 
+void test_state_fingerprints()
+{
+  atermpp::aterm t1 = atermpp::read_term_from_string("f(a,g(1,b))");
+  atermpp::aterm t2 = atermpp::read_term_from_string("f(a,g(1,b))");
+  atermpp::aterm t3 = atermpp::read_term_from_string("f(a,g(2,b))");
+  atermpp::aterm t4 = atermpp::read_term_from_string("f(g(1,b),a)");
+  BOOST_CHECK(lts::detail::fingerprint(t1) == lts::detail::fingerprint(t2));
+  BOOST_CHECK(lts::detail::fingerprint(t1) != lts::detail::fingerprint(t3));
+  BOOST_CHECK(lts::detail::fingerprint(t1) != lts::detail::fingerprint(t4));
+
+  // Deeply nested terms do not overflow the stack, and shared subterms are traversed once.
+  const atermpp::function_symbol f1("f", 1);
+  const atermpp::function_symbol g2("g", 2);
+  atermpp::aterm deep1 = atermpp::read_term_from_string("a");
+  atermpp::aterm deep2 = deep1;
+  atermpp::aterm dag = deep1;
+  for (std::size_t i = 0; i < 1000000; ++i)
+  {
+    deep1 = atermpp::aterm_appl(f1, deep1);
+    deep2 = atermpp::aterm_appl(f1, deep2);
+  }
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    dag = atermpp::aterm_appl(g2, dag, dag);
+  }
+  BOOST_CHECK(lts::detail::fingerprint(deep1) == lts::detail::fingerprint(deep2));
+  BOOST_CHECK(lts::detail::fingerprint(deep1) != lts::detail::fingerprint(dag));
+
+  lts::detail::hash_compaction_table hc(16);
+  lts::detail::bit_hash_table bh(1 << 20);
+  for (std::uint64_t i = 0; i < 5000; i++)
+  {
+    BOOST_CHECK(hc.insert(lts::detail::mix_fingerprint(i)));
+    BOOST_CHECK(bh.insert(lts::detail::mix_fingerprint(i)));
+  }
+  for (std::uint64_t i = 0; i < 5000; i++)
+  {
+    BOOST_CHECK(!hc.insert(lts::detail::mix_fingerprint(i)));
+    BOOST_CHECK(!bh.insert(lts::detail::mix_fingerprint(i)));
+  }
+  BOOST_CHECK(hc.expected_omissions() < 1e-10);
+  BOOST_CHECK(bh.expected_omissions() > 0 && bh.expected_omissions() < 0.01);
+
+  // A table that is far too small omits states.
+  lts::detail::bit_hash_table small(64);
+  std::size_t inserted = 0;
+  for (std::uint64_t i = 0; i < 1000; i++)
+  {
+    inserted += small.insert(lts::detail::mix_fingerprint(i)) ? 1 : 0;
+  }
+  BOOST_CHECK(inserted < 1000);
+  BOOST_CHECK(lts::detail::omission_probability(small.expected_omissions()) > 0.99);
+}
+
 int test_main(int /* argc*/, char** /* argv */)
 {
   reduce_simple_loop();
@@ -661,6 +1233,20 @@ int test_main(int /* argc*/, char** /* argv */)
   failing_test_groote_wijs_algorithm();
   counterexample_jk_1(3);
   counterexample_postprocessing();
+  test_parallel_sigref();
+  test_parallel_weak_sigref();
+  test_bisimulation_without_kripke_structure();
+  test_weak_bisimulation_without_closure();
+  test_tau_star_reduce();
+  test_antichain_trace_refinement();
+  test_subset_store();
+  test_determinise();
+  test_simulation_preorder();
+  test_refinement_simulation_limit();
+  test_remove_redundant_transitions_hidden_labels();
+  test_transition_indices();
+  test_compact_transitions();
+  test_state_fingerprints();
   // TODO: Add groote wijs branching bisimulation and add weak bisimulation tests. For the last Peterson is a good candidate.
   return 0;
 }
@@ -0,0 +1,79 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file probabilistic_fast_fraction_test.cpp
+/// \brief Test whether the class probabilistic_fast_fraction agrees with probabilistic_arbitrary_precision_fraction.
+
+#include <boost/test/included/unit_test_framework.hpp>
+#include "mcrl2/lts/probabilistic_fast_fraction.h"
+
+using namespace mcrl2;
+using namespace mcrl2::lts;
+
+// Checks that x and y represent the same value.
+void check_equal(const probabilistic_fast_fraction& x, const probabilistic_arbitrary_precision_fraction& y)
+{
+  BOOST_CHECK(x.to_arbitrary_precision() == y);
+  BOOST_CHECK(x == probabilistic_fast_fraction(y));
+  BOOST_CHECK(std::hash<probabilistic_fast_fraction>()(x) == std::hash<probabilistic_fast_fraction>()(probabilistic_fast_fraction(y)));
+}
+
+void test(const std::string& xs, const std::string& ys, const std::string& us, const std::string& vs)
+{
+  std::cerr << "Check " << xs << "/" << ys << " and " << us << "/" << vs << "\n";
+  const probabilistic_arbitrary_precision_fraction x(xs, ys);
+  const probabilistic_arbitrary_precision_fraction y(us, vs);
+  const probabilistic_fast_fraction fx(xs, ys);
+  const probabilistic_fast_fraction fy(us, vs);
+
+  check_equal(fx, x);
+  check_equal(fy, y);
+  check_equal(fx * fy, x * y);
+  BOOST_CHECK((fx < fy) == (x < y));
+  BOOST_CHECK((fx == fy) == (x == y));
+  BOOST_CHECK((fx <= fy) == (x <= y));
+  if (x + y <= probabilistic_arbitrary_precision_fraction::one())
+  {
+    check_equal(fx + fy, x + y);
+  }
+  if (y <= x)
+  {
+    check_equal(fx - fy, x - y);
+  }
+  if (y > probabilistic_arbitrary_precision_fraction::zero() && x <= y)
+  {
+    check_equal(fx / fy, x / y);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cumulative_tests)
+{
+  test("1", "2", "1", "3");
+  test("2", "4", "1", "2");
+  test("0", "90", "15", "90");
+  test("1", "1", "0", "1");
+  test("1", "4294967311", "1", "4294967357");
+  test("3", "18446744073709551557", "5", "18446744073709551533");
+  test("1", "123987498734298734987", "2", "123987498734298734987");
+  test("12000000000000000000123", "1400000000000000000021498639574985789345798", "1", "7");
+
+  // A sum of big fractions that is small again.
+  const probabilistic_fast_fraction x("1", "18446744073709551557");
+  const probabilistic_fast_fraction y("1", "18446744073709551533");
+  const probabilistic_fast_fraction xy = x * y;
+  BOOST_CHECK(!xy.is_small());
+  BOOST_CHECK((xy / y) == x);
+  BOOST_CHECK((xy / y).is_small());
+  BOOST_CHECK(probabilistic_fast_fraction("2", "4") == probabilistic_fast_fraction(1, 2));
+  BOOST_CHECK(probabilistic_fast_fraction(1, 3) + probabilistic_fast_fraction(2, 3) == probabilistic_fast_fraction::one());
+}
+
+boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
+{
+  return nullptr;
+}
@@ -0,0 +1,198 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts_new/detail/parallel_algorithms.h
+/// \brief Parallel sort, filter and unique on flat arrays.
+
+#ifndef MCRL2_LTS_NEW_DETAIL_PARALLEL_ALGORITHMS_H
+#define MCRL2_LTS_NEW_DETAIL_PARALLEL_ALGORITHMS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "mcrl2/utilities/parallel.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+/// \brief Splits the range [0, n) into number_of_blocks consecutive blocks of (almost)
+/// equal size, and applies f(block, first, last) to each of them in parallel.
+/// \details Unlike utilities::parallel_for, the division into blocks is fixed, so
+/// algorithms can first compute something per block, and then use the results of
+/// all blocks in a second pass over the same blocks.
+template <typename Function>
+void for_each_block(std::size_t n, std::size_t number_of_blocks, std::size_t number_of_threads, Function f)
+{
+  utilities::parallel_for(number_of_blocks, number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+  {
+    for (std::size_t b = first; b < last; ++b)
+    {
+      f(b, b * n / number_of_blocks, (b + 1) * n / number_of_blocks);
+    }
+  }, 1);
+}
+
+/// \brief Returns the number of blocks that is used to process n elements with the given
+/// number of threads. Small inputs are processed in a single block.
+inline
+std::size_t number_of_blocks(std::size_t n, std::size_t number_of_threads)
+{
+  const std::size_t minimum_block_size = 1 << 16;
+  return std::max(std::size_t(1), std::min(number_of_threads, n / minimum_block_size));
+}
+
+/// \brief Returns the number of bits that is needed to represent n.
+inline
+std::size_t bit_width(std::size_t n)
+{
+  std::size_t result = 0;
+  while (n > 0)
+  {
+    result++;
+    n >>= 1;
+  }
+  return result;
+}
+
+/// \brief Sorts v on the unsigned key k(x) with a stable, least significant digit first,
+/// radix sort. All keys must be at most max_key; only the bytes that are needed to
+/// represent max_key are processed.
+/// \details Each pass counts the digits per block in parallel, computes the offsets of
+/// the blocks within the buckets, and then scatters the blocks in parallel. Passes in
+/// which all elements have the same digit are skipped.
+template <typename T, typename Key>
+void parallel_radix_sort(std::vector<T>& v, Key k, std::size_t max_key, std::size_t number_of_threads = 0)
+{
+  typedef std::array<std::size_t, 256> histogram;
+
+  number_of_threads = utilities::number_of_threads(number_of_threads);
+  const std::size_t n = v.size();
+  const std::size_t number_of_passes = (bit_width(max_key) + 7) / 8;
+  if (n <= 1 || number_of_passes == 0)
+  {
+    return;
+  }
+  const std::size_t B = number_of_blocks(n, number_of_threads);
+  std::vector<histogram> count(B);
+  std::vector<T> buffer;
+
+  for (std::size_t pass = 0; pass < number_of_passes; pass++)
+  {
+    const std::size_t shift = 8 * pass;
+    for_each_block(n, B, number_of_threads, [&](std::size_t b, std::size_t first, std::size_t last)
+    {
+      histogram& c = count[b];
+      c.fill(0);
+      for (std::size_t i = first; i < last; ++i)
+      {
+        c[(static_cast<std::size_t>(k(v[i])) >> shift) & 0xff]++;
+      }
+    });
+
+    // Replace the counts by the positions where the blocks start writing.
+    std::size_t offset = 0;
+    bool trivial = false;
+    for (std::size_t digit = 0; digit < 256; digit++)
+    {
+      const std::size_t start = offset;
+      for (std::size_t b = 0; b < B; b++)
+      {
+        const std::size_t m = count[b][digit];
+        count[b][digit] = offset;
+        offset += m;
+      }
+      trivial = trivial || offset - start == n;
+    }
+    if (trivial)
+    {
+      continue;
+    }
+
+    if (buffer.empty())
+    {
+      buffer.resize(n);
+    }
+    for_each_block(n, B, number_of_threads, [&](std::size_t b, std::size_t first, std::size_t last)
+    {
+      histogram& c = count[b];
+      for (std::size_t i = first; i < last; ++i)
+      {
+        buffer[c[(static_cast<std::size_t>(k(v[i])) >> shift) & 0xff]++] = v[i];
+      }
+    });
+    v.swap(buffer);
+  }
+}
+
+/// \brief Removes the elements v[i] for which keep(i) is false, while preserving the order
+/// of the other elements.
+/// \details The predicate is evaluated twice for each element: once to count the
+/// elements that are kept per block, and once to copy them.
+template <typename T, typename Predicate>
+void parallel_filter(std::vector<T>& v, Predicate keep, std::size_t number_of_threads = 0)
+{
+  number_of_threads = utilities::number_of_threads(number_of_threads);
+  const std::size_t n = v.size();
+  const std::size_t B = number_of_blocks(n, number_of_threads);
+  std::vector<std::size_t> offset(B + 1, 0);
+
+  for_each_block(n, B, number_of_threads, [&](std::size_t b, std::size_t first, std::size_t last)
+  {
+    std::size_t m = 0;
+    for (std::size_t i = first; i < last; ++i)
+    {
+      if (keep(i))
+      {
+        m++;
+      }
+    }
+    offset[b + 1] = m;
+  });
+  for (std::size_t b = 0; b < B; b++)
+  {
+    offset[b + 1] += offset[b];
+  }
+  if (offset[B] == n)
+  {
+    return;
+  }
+
+  std::vector<T> result(offset[B]);
+  for_each_block(n, B, number_of_threads, [&](std::size_t b, std::size_t first, std::size_t last)
+  {
+    std::size_t j = offset[b];
+    for (std::size_t i = first; i < last; ++i)
+    {
+      if (keep(i))
+      {
+        result[j++] = v[i];
+      }
+    }
+  });
+  v.swap(result);
+}
+
+/// \brief Removes consecutive duplicate elements from v. If v is sorted, all duplicates are removed.
+template <typename T>
+void parallel_unique(std::vector<T>& v, std::size_t number_of_threads = 0)
+{
+  parallel_filter(v, [&](std::size_t i) { return i == 0 || !(v[i] == v[i - 1]); }, number_of_threads);
+}
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_NEW_DETAIL_PARALLEL_ALGORITHMS_H
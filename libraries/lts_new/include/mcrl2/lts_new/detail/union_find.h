@@ -0,0 +1,82 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts_new/detail/union_find.h
+/// \brief Union-find on the states of an LTS.
+
+#ifndef MCRL2_LTS_NEW_DETAIL_UNION_FIND_H
+#define MCRL2_LTS_NEW_DETAIL_UNION_FIND_H
+
+#include <numeric>
+#include <vector>
+#include "mcrl2/lts_new/lts.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+/// \brief Disjoint sets of the numbers [0, n), with path halving.
+/// \details The root of a set is always its smallest element, so every parent
+/// pointer points to a smaller number. This makes the result independent of the
+/// order of the unions, and allows flatten() to compute all roots in one pass.
+class union_find
+{
+  protected:
+    std::vector<transition_index_type> m_parent;
+
+  public:
+    explicit union_find(std::size_t n)
+      : m_parent(n)
+    {
+      std::iota(m_parent.begin(), m_parent.end(), transition_index_type(0));
+    }
+
+    transition_index_type find(transition_index_type x)
+    {
+      while (m_parent[x] != x)
+      {
+        m_parent[x] = m_parent[m_parent[x]];
+        x = m_parent[x];
+      }
+      return x;
+    }
+
+    void unite(transition_index_type x, transition_index_type y)
+    {
+      x = find(x);
+      y = find(y);
+      if (x < y)
+      {
+        m_parent[y] = x;
+      }
+      else if (y < x)
+      {
+        m_parent[x] = y;
+      }
+    }
+
+    /// \brief Makes every element point directly to the root of its set, and returns the result.
+    const std::vector<transition_index_type>& flatten()
+    {
+      for (transition_index_type& p: m_parent)
+      {
+        p = m_parent[p];
+      }
+      return m_parent;
+    }
+};
+
+} // namespace detail
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_NEW_DETAIL_UNION_FIND_H
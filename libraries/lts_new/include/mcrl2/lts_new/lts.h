@@ -13,9 +13,15 @@
 #define MCRL2_LTS_LTS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
+#include "mcrl2/lts/transition_index_type.h"
+#include "mcrl2/utilities/exception.h"
 
 namespace mcrl2
 {
@@ -23,16 +29,34 @@ namespace mcrl2
 namespace lts
 {
 
+inline
+transition_index_type make_transition_index(std::size_t n)
+{
+  if (n > std::numeric_limits<transition_index_type>::max())
+  {
+    throw mcrl2::runtime_error("the state or label number " + std::to_string(n) + " does not fit in a transition; to handle LTSs with 2^32 or more states or "
+                               "action labels, rebuild the toolset with the CMake option -DMCRL2_LTS_WIDE_TRANSITIONS=ON");
+  }
+  return static_cast<transition_index_type>(n);
+}
+
 struct transition
 {
-  std::size_t from;
-  std::size_t label;
-  std::size_t to;
+  transition_index_type from;
+  transition_index_type label;
+  transition_index_type to;
+
+  transition() = default;
 
   transition(std::size_t from_, std::size_t label_, std::size_t to_)
-    : from(from_), label(label_), to(to_)
+    : from(make_transition_index(from_)), label(make_transition_index(label_)), to(make_transition_index(to_))
   {}
 
+  bool operator==(const transition& other) const
+  {
+    return from == other.from && label == other.label && to == other.to;
+  }
+
   bool operator<(const transition& other) const
   {
     return std::tie(from, label, to) < std::tie(other.from, other.label, other.to);
@@ -0,0 +1,120 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts_new/outgoing_transitions.h
+/// \brief The outgoing transitions of an LTS in compressed sparse row format.
+
+#ifndef MCRL2_LTS_NEW_OUTGOING_TRANSITIONS_H
+#define MCRL2_LTS_NEW_OUTGOING_TRANSITIONS_H
+
+#include "mcrl2/lts_new/detail/parallel_algorithms.h"
+#include "mcrl2/lts_new/lts.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+/// \brief Stores the outgoing transitions of an LTS in compressed sparse row format. The
+/// labels and targets of the outgoing transitions of state s are at the positions
+/// [begin(s), end(s)) of the arrays labels and targets.
+/// \details Within a state, the transitions are in the same order as in the LTS.
+struct outgoing_transitions
+{
+  std::vector<std::size_t> offsets;
+  std::vector<transition_index_type> labels;
+  std::vector<transition_index_type> targets;
+
+  outgoing_transitions(const labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
+  {
+    number_of_threads = utilities::number_of_threads(number_of_threads);
+    const std::size_t n = ltsspec.number_of_states;
+    const std::vector<transition>& transitions = ltsspec.transitions;
+
+    if (is_sorted_on_source(transitions, number_of_threads))
+    {
+      build(transitions, n, number_of_threads);
+    }
+    else
+    {
+      std::vector<transition> sorted = transitions;
+      detail::parallel_radix_sort(sorted, [](const transition& t) { return t.from; }, n == 0 ? 0 : n - 1, number_of_threads);
+      build(sorted, n, number_of_threads);
+    }
+  }
+
+  std::size_t number_of_states() const
+  {
+    return offsets.size() - 1;
+  }
+
+  std::size_t begin(std::size_t s) const
+  {
+    return offsets[s];
+  }
+
+  std::size_t end(std::size_t s) const
+  {
+    return offsets[s + 1];
+  }
+
+  protected:
+    static bool is_sorted_on_source(const std::vector<transition>& transitions, std::size_t number_of_threads)
+    {
+      const std::size_t m = transitions.size();
+      const std::size_t B = detail::number_of_blocks(m, number_of_threads);
+      std::vector<char> sorted(B, 1);
+      detail::for_each_block(m, B, number_of_threads, [&](std::size_t b, std::size_t first, std::size_t last)
+      {
+        for (std::size_t i = std::max(first, std::size_t(1)); i < last; ++i)
+        {
+          if (transitions[i].from < transitions[i - 1].from)
+          {
+            sorted[b] = 0;
+            return;
+          }
+        }
+      });
+      return std::find(sorted.begin(), sorted.end(), 0) == sorted.end();
+    }
+
+    // Precondition: transitions is sorted on the source state.
+    void build(const std::vector<transition>& transitions, std::size_t n, std::size_t number_of_threads)
+    {
+      const std::size_t m = transitions.size();
+      offsets.resize(n + 1);
+      labels.resize(m);
+      targets.resize(m);
+
+      // The offsets of the states in (transitions[i - 1].from, transitions[i].from] are all
+      // equal to i, so every offset is written exactly once.
+      utilities::parallel_for(m, number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+      {
+        for (std::size_t i = first; i < last; ++i)
+        {
+          const transition& t = transitions[i];
+          labels[i] = t.label;
+          targets[i] = t.to;
+          const std::size_t s0 = i == 0 ? 0 : transitions[i - 1].from + 1;
+          for (std::size_t s = s0; s <= t.from; ++s)
+          {
+            offsets[s] = i;
+          }
+        }
+      }, 1 << 16);
+      for (std::size_t s = m == 0 ? 0 : transitions[m - 1].from + 1; s <= n; ++s)
+      {
+        offsets[s] = m;
+      }
+    }
+};
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_NEW_OUTGOING_TRANSITIONS_H
@@ -12,12 +12,10 @@
 #ifndef MCRL2_LTS_PARSE_H
 #define MCRL2_LTS_PARSE_H
 
-#include <boost/spirit/home/x3.hpp>
-#include <iostream>
-#include <map>
 #include <string>
+#include "mcrl2/lts/detail/aut_parser.h"
 #include "mcrl2/lts_new/lts.h"
-#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/memory_mapped_file.h"
 #include "mcrl2/utilities/text_utility.h"
 
 namespace mcrl2 {
@@ -26,126 +24,62 @@ namespace lts {
 
 namespace detail {
 
-template <typename Iterator>
-labeled_transition_system parse_lts(Iterator first, Iterator last)
+inline
+labeled_transition_system parse_lts(const char* first, const char* last, std::size_t number_of_threads = 0)
 {
-  namespace x3 = boost::spirit::x3;
-  namespace ascii = boost::spirit::x3::ascii;
-
-  using x3::_attr;
-  using x3::char_;
-  using x3::int_;
-  using x3::double_;
-  using x3::lexeme;
-  using x3::lit;
-  using x3::ulong_;
-  using ascii::space;
-
-  std::map<std::string, std::size_t> label_map;
   labeled_transition_system result;
+  aut_parser parser(first, last);
+  result.initial_state = parser.initial_state();
+  result.number_of_states = parser.number_of_states();
+  if (result.number_of_states > 0)
+  {
+    make_transition_index(result.number_of_states - 1); // reject a too large LTS before reading its transitions
+  }
+  result.transitions.reserve(parser.number_of_transitions());
 
   // the special action "tau" has always label 0
-  label_map["tau"] = 0;
-
-  std::size_t from;
-  std::size_t label;
-  std::size_t to;
-
-  auto const quoted_string = lexeme['"' >> +(char_ - '"') >> '"'];
-
-  auto assign_initial_state = [&](auto& ctx)
-    {
-      result.initial_state = _attr(ctx);
-    };
+  result.action_labels.push_back("tau");
 
-  auto assign_number_of_transitions = [&](auto& ctx)
+  parser.parse_transitions(
+    [&](const std::string& name)
     {
-      std::size_t number_of_transitions = _attr(ctx);
-      result.transitions.reserve(number_of_transitions);
-    };
-
-  auto assign_number_of_states = [&](auto& ctx)
-    {
-      result.number_of_states = _attr(ctx);
-    };
-
-  auto assign_from = [&](auto& ctx)
-    {
-      from = _attr(ctx);
-    };
-
-  auto assign_label = [&](auto& ctx)
+      result.action_labels.push_back(name);
+      return result.action_labels.size() - 1;
+    },
+    [&](std::size_t from, std::size_t label, std::size_t to)
     {
-      std::string name = _attr(ctx);
-      auto i = label_map.find(name);
-      if (i == label_map.end())
-      {
-        std::size_t n = label_map.size();
-        label_map[name] = n;
-        label = n;
-        result.action_labels.push_back(name);
-      }
-      else
-      {
-        label = i->second;
-      }
-    };
-
-  auto assign_to = [&](auto& ctx)
-    {
-      to = _attr(ctx);
       result.transitions.emplace_back(from, label, to);
-    };
-
-  bool r = x3::phrase_parse(first, last,
-
-      //  Begin grammar
-      (
-        // header
-        lit("des")
-        >> '('
-        >> ulong_              [assign_initial_state]
-        >> ','
-        >> ulong_              [assign_number_of_transitions]
-        >> ','
-        >> ulong_              [assign_number_of_states]
-        >> ')'
-
-        // transitions
-        >> *(
-              '('
-              >> ulong_        [assign_from]
-              >> ','
-              >> quoted_string [assign_label]
-              >> ','
-              >> ulong_        [assign_to]
-              >> ')'
-            )
-      )
-      ,
-      //  End grammar
-
-      space);
-
-  if (!r)
-  {
-    throw mcrl2::runtime_error("parsing failed");
-  }
-
-  if (first != last)
-  {
-    throw mcrl2::runtime_error("did not get a full match");
-  }
-
+    },
+    number_of_threads
+  );
   return result;
 }
 
 } // namespace detail
 
+/// \brief Parses an LTS in .aut format.
 inline
-labeled_transition_system parse_lts(const std::string& text)
+labeled_transition_system parse_lts(const std::string& text, std::size_t number_of_threads = 0)
 {
-  return detail::parse_lts(text.begin(), text.end());
+  return detail::parse_lts(text.data(), text.data() + text.size(), number_of_threads);
+}
+
+/// \brief Reads an LTS in .aut format from a file, which is mapped into memory. If filename
+/// is empty, the LTS is read from standard input.
+inline
+labeled_transition_system load_lts(const std::string& filename, std::size_t number_of_threads = 0)
+{
+  if (filename.empty())
+  {
+    return parse_lts(utilities::read_text(std::cin), number_of_threads);
+  }
+  utilities::memory_mapped_file file(filename);
+  if (file.empty())
+  {
+    throw mcrl2::runtime_error("The .aut file " + filename + " is empty.");
+  }
+  const char* text = reinterpret_cast<const char*>(file.data());
+  return detail::parse_lts(text, text + file.size(), number_of_threads);
 }
 
 } // namespace lts
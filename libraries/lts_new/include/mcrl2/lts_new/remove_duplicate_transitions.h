@@ -12,18 +12,20 @@
 #ifndef MCRL2_LTS_REMOVE_DUPLICATE_TRANSITIONS_H
 #define MCRL2_LTS_REMOVE_DUPLICATE_TRANSITIONS_H
 
-#include <set>
+#include "mcrl2/lts_new/detail/parallel_algorithms.h"
 #include "mcrl2/lts_new/lts.h"
+#include "mcrl2/lts_new/sort_transitions.h"
 
 namespace mcrl2 {
 
 namespace lts {
 
+/// \brief Removes duplicate transitions. Afterwards the transitions are sorted on (from, label, to).
 inline
-void remove_duplicate_transitions(labeled_transition_system& ltsspec)
+void remove_duplicate_transitions(labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
 {
-  std::set<transition> transitions(ltsspec.transitions.begin(), ltsspec.transitions.end());
-  ltsspec.transitions.assign(transitions.begin(), transitions.end());
+  sort_transitions(ltsspec, number_of_threads);
+  detail::parallel_unique(ltsspec.transitions, number_of_threads);
 }
 
 } // namespace lts
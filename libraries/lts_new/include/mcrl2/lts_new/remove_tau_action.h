@@ -12,7 +12,8 @@
 #ifndef MCRL2_LTS_REMOVE_TAU_ACTION_H
 #define MCRL2_LTS_REMOVE_TAU_ACTION_H
 
-#include <map>
+#include "mcrl2/lts_new/detail/parallel_algorithms.h"
+#include "mcrl2/lts_new/detail/union_find.h"
 #include "mcrl2/lts_new/lts.h"
 #include "mcrl2/lts_new/remove_duplicate_transitions.h"
 #include "mcrl2/lts_new/remove_unused_states.h"
@@ -23,57 +24,42 @@ namespace lts {
 
 // Joins states that are connected using a transition with label tau_label.
 inline
-void remove_tau_action(labeled_transition_system& ltsspec, std::size_t tau_label = 0)
+void remove_tau_action(labeled_transition_system& ltsspec, std::size_t tau_label = 0, std::size_t number_of_threads = 0)
 {
-  // compute a map of replacements
-  std::map<std::size_t, std::size_t> replacements;
-  for (const transition& t: ltsspec.transitions)
+  number_of_threads = utilities::number_of_threads(number_of_threads);
+  std::vector<transition>& transitions = ltsspec.transitions;
+
+  // compute the sets of states that are connected by tau transitions
+  detail::union_find sets(ltsspec.number_of_states);
+  for (const transition& t: transitions)
   {
-    if (t.label != tau_label)
-    {
-      continue;
-    }
-    auto i = replacements.find(t.to);
-    if (i == replacements.end())
-    {
-      replacements[t.to] = t.from;
-    }
-    else
+    if (t.label == tau_label)
     {
-      replacements[t.to] = i->second;
+      sets.unite(t.from, t.to);
     }
   }
-
-  auto replace = [&](std::size_t n)
-    {
-      auto i = replacements.find(n);
-      if (i == replacements.end())
-      {
-        return n;
-      }
-      return i->second;
-    };
+  const std::vector<transition_index_type>& replace = sets.flatten();
 
   // compute new transitions
-  std::vector<transition> transitions;
-  for (const transition& t: ltsspec.transitions)
+  detail::parallel_filter(transitions, [&](std::size_t i) { return transitions[i].label != tau_label; }, number_of_threads);
+  utilities::parallel_for(transitions.size(), number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
   {
-    if (t.label == tau_label)
+    for (std::size_t i = first; i < last; ++i)
     {
-      continue;
+      transition& t = transitions[i];
+      t.from = replace[t.from];
+      t.to = replace[t.to];
     }
-    transitions.emplace_back(replace(t.from), t.label, replace(t.to));
-  }
-  std::swap(ltsspec.transitions, transitions);
+  }, 1 << 16);
 
   // update initial state
-  ltsspec.initial_state = replace(ltsspec.initial_state);
+  ltsspec.initial_state = replace[ltsspec.initial_state];
 
   // there may be duplicate transitions, so remove them.
-  remove_duplicate_transitions(ltsspec);
+  remove_duplicate_transitions(ltsspec, number_of_threads);
 
   // make sure the states are in a contiguous interval
-  remove_unused_states(ltsspec);
+  remove_unused_states(ltsspec, number_of_threads);
 }
 
 } // namespace lts
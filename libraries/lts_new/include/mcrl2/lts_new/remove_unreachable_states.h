@@ -0,0 +1,94 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts_new/remove_unreachable_states.h
+/// \brief Algorithm for removing the states that are not reachable from the initial state.
+
+#ifndef MCRL2_LTS_NEW_REMOVE_UNREACHABLE_STATES_H
+#define MCRL2_LTS_NEW_REMOVE_UNREACHABLE_STATES_H
+
+#include "mcrl2/lts_new/detail/parallel_algorithms.h"
+#include "mcrl2/lts_new/lts.h"
+#include "mcrl2/lts_new/outgoing_transitions.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+/// \brief Returns a vector that contains true for the states that are reachable from the initial state.
+inline
+std::vector<bool> reachable_states(const labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
+{
+  std::vector<bool> result(ltsspec.number_of_states, false);
+  if (ltsspec.number_of_states == 0)
+  {
+    return result;
+  }
+  outgoing_transitions out(ltsspec, number_of_threads);
+  std::vector<transition_index_type> todo;
+  todo.push_back(make_transition_index(ltsspec.initial_state));
+  result[ltsspec.initial_state] = true;
+  while (!todo.empty())
+  {
+    const std::size_t s = todo.back();
+    todo.pop_back();
+    for (std::size_t i = out.begin(s); i != out.end(s); ++i)
+    {
+      const transition_index_type t = out.targets[i];
+      if (!result[t])
+      {
+        result[t] = true;
+        todo.push_back(t);
+      }
+    }
+  }
+  return result;
+}
+
+/// \brief Removes the states that are not reachable from the initial state, and the
+/// transitions between them. The remaining states keep their relative order.
+inline
+void remove_unreachable_states(labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
+{
+  number_of_threads = utilities::number_of_threads(number_of_threads);
+  std::vector<transition>& transitions = ltsspec.transitions;
+  std::vector<bool> reachable = reachable_states(ltsspec, number_of_threads);
+
+  std::vector<transition_index_type> replace(ltsspec.number_of_states, 0);
+  std::size_t index = 0;
+  for (std::size_t s = 0; s < ltsspec.number_of_states; s++)
+  {
+    if (reachable[s])
+    {
+      replace[s] = index++;
+    }
+  }
+
+  // The target of a transition with a reachable source is reachable too.
+  detail::parallel_filter(transitions, [&](std::size_t i) { return reachable[transitions[i].from]; }, number_of_threads);
+  utilities::parallel_for(transitions.size(), number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+  {
+    for (std::size_t i = first; i < last; ++i)
+    {
+      transition& t = transitions[i];
+      t.from = replace[t.from];
+      t.to = replace[t.to];
+    }
+  }, 1 << 16);
+  if (ltsspec.number_of_states > 0)
+  {
+    ltsspec.initial_state = replace[ltsspec.initial_state];
+  }
+  ltsspec.number_of_states = index;
+}
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_NEW_REMOVE_UNREACHABLE_STATES_H
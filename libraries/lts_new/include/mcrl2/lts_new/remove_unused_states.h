@@ -13,6 +13,7 @@
 #define MCRL2_LTS_REMOVE_UNUSED_STATES_H
 
 #include "mcrl2/lts_new/lts.h"
+#include "mcrl2/utilities/parallel.h"
 
 namespace mcrl2 {
 
@@ -20,9 +21,9 @@ namespace lts {
 
 // Renames states such that they are in a contiguous interval [0, ..., N)
 inline
-void remove_unused_states(labeled_transition_system& ltsspec, std::size_t tau_label = 0)
+void remove_unused_states(labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
 {
-  std::vector<std::size_t> replace(ltsspec.number_of_states, 0);
+  std::vector<transition_index_type> replace(ltsspec.number_of_states, 0);
 
   // put a 1 in each position of replace that is the source or target of a transition, and the initial state
   for (const transition& t: ltsspec.transitions)
@@ -44,11 +45,15 @@ void remove_unused_states(labeled_transition_system& ltsspec, std::size_t tau_la
 
   // apply replace to ltsspec
   ltsspec.initial_state = replace[ltsspec.initial_state];
-  for (transition& t: ltsspec.transitions)
+  utilities::parallel_for(ltsspec.transitions.size(), utilities::number_of_threads(number_of_threads), [&](std::size_t, std::size_t first, std::size_t last)
   {
-    t.from = replace[t.from];
-    t.to = replace[t.to];
-  }
+    for (std::size_t i = first; i < last; ++i)
+    {
+      transition& t = ltsspec.transitions[i];
+      t.from = replace[t.from];
+      t.to = replace[t.to];
+    }
+  }, 1 << 16);
   ltsspec.number_of_states = index;
 }
 
@@ -0,0 +1,57 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts_new/sort_transitions.h
+/// \brief Parallel radix sort of the transitions of an LTS.
+
+#ifndef MCRL2_LTS_NEW_SORT_TRANSITIONS_H
+#define MCRL2_LTS_NEW_SORT_TRANSITIONS_H
+
+#include "mcrl2/lts_new/detail/parallel_algorithms.h"
+#include "mcrl2/lts_new/lts.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+/// \brief Sorts the transitions of ltsspec on (from, label, to).
+/// \details If the three fields fit together in 64 bits, the transitions are sorted
+/// on the packed key, which needs the least number of passes. Otherwise they are
+/// sorted on to, label and from successively, which gives the same result since the
+/// radix sort is stable.
+inline
+void sort_transitions(labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
+{
+  const std::size_t max_state = ltsspec.number_of_states == 0 ? 0 : ltsspec.number_of_states - 1;
+  const std::size_t max_label = ltsspec.action_labels.empty() ? 0 : ltsspec.action_labels.size() - 1;
+  const std::size_t state_bits = detail::bit_width(max_state);
+  const std::size_t label_bits = detail::bit_width(max_label);
+  std::vector<transition>& transitions = ltsspec.transitions;
+
+  if (2 * state_bits + label_bits <= 64)
+  {
+    auto key = [&](const transition& t)
+    {
+      return (static_cast<std::uint64_t>(t.from) << (label_bits + state_bits)) | (static_cast<std::uint64_t>(t.label) << state_bits) | t.to;
+    };
+    const std::uint64_t max_key = 2 * state_bits + label_bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << (2 * state_bits + label_bits)) - 1;
+    detail::parallel_radix_sort(transitions, key, max_key, number_of_threads);
+  }
+  else
+  {
+    detail::parallel_radix_sort(transitions, [](const transition& t) { return t.to; }, max_state, number_of_threads);
+    detail::parallel_radix_sort(transitions, [](const transition& t) { return t.label; }, max_label, number_of_threads);
+    detail::parallel_radix_sort(transitions, [](const transition& t) { return t.from; }, max_state, number_of_threads);
+  }
+}
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_NEW_SORT_TRANSITIONS_H
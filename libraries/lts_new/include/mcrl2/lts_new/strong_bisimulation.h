@@ -0,0 +1,236 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lts_new/strong_bisimulation.h
+/// \brief Strong bisimulation reduction by parallel partition refinement.
+
+#ifndef MCRL2_LTS_NEW_STRONG_BISIMULATION_H
+#define MCRL2_LTS_NEW_STRONG_BISIMULATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "mcrl2/lts_new/detail/parallel_algorithms.h"
+#include "mcrl2/lts_new/lts.h"
+#include "mcrl2/lts_new/outgoing_transitions.h"
+#include "mcrl2/lts_new/remove_duplicate_transitions.h"
+#include "mcrl2/utilities/hash_utility.h"
+
+namespace mcrl2 {
+
+namespace lts {
+
+namespace detail {
+
+/// \brief Computes the coarsest strong bisimulation of an LTS by signature refinement.
+/// \details In each round the signature of a state s is the set of pairs (a, block[t])
+/// for the transitions s -a-> t. States with the same block and the same signature
+/// remain together, and all other states are separated. The signatures are stored in
+/// one flat array in the layout of outgoing_transitions, and are computed in parallel.
+/// States are grouped by sorting them on a hash of their block and signature; the
+/// signatures within a group are compared exactly, so hash collisions are harmless.
+/// The refinement stops as soon as a round does not increase the number of blocks.
+class strong_bisimulation_algorithm
+{
+  protected:
+    struct signature_entry
+    {
+      transition_index_type label;
+      transition_index_type block;
+
+      bool operator<(const signature_entry& other) const
+      {
+        return label < other.label || (label == other.label && block < other.block);
+      }
+
+      bool operator==(const signature_entry& other) const
+      {
+        return label == other.label && block == other.block;
+      }
+    };
+
+    struct hashed_state
+    {
+      std::uint64_t hash;
+      transition_index_type state;
+    };
+
+    const outgoing_transitions m_out;
+    std::size_t m_number_of_threads;
+    std::vector<transition_index_type> m_block;
+    std::size_t m_number_of_blocks = 0;
+
+    std::vector<signature_entry> m_signatures;
+    std::vector<std::size_t> m_signature_end;
+    std::vector<hashed_state> m_states;
+
+    std::size_t signature_begin(std::size_t s) const
+    {
+      return m_out.begin(s);
+    }
+
+    std::size_t signature_end(std::size_t s) const
+    {
+      return m_signature_end[s];
+    }
+
+    bool equal_signatures(std::size_t s, std::size_t t) const
+    {
+      return m_block[s] == m_block[t] &&
+             std::equal(m_signatures.begin() + signature_begin(s), m_signatures.begin() + signature_end(s),
+                        m_signatures.begin() + signature_begin(t), m_signatures.begin() + signature_end(t));
+    }
+
+    void compute_signatures()
+    {
+      const std::size_t n = m_out.number_of_states();
+      utilities::parallel_for(n, m_number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+      {
+        for (std::size_t s = first; s < last; ++s)
+        {
+          const std::size_t begin = m_out.begin(s);
+          const std::size_t end = m_out.end(s);
+          for (std::size_t i = begin; i < end; ++i)
+          {
+            m_signatures[i] = signature_entry{ m_out.labels[i], m_block[m_out.targets[i]] };
+          }
+          std::sort(m_signatures.begin() + begin, m_signatures.begin() + end);
+          m_signature_end[s] = std::unique(m_signatures.begin() + begin, m_signatures.begin() + end) - m_signatures.begin();
+
+          std::size_t h = m_block[s];
+          for (std::size_t i = begin; i < m_signature_end[s]; ++i)
+          {
+            h = utilities::detail::hash_combine(h, utilities::detail::hash_combine(m_signatures[i].label, m_signatures[i].block));
+          }
+          m_states[s] = hashed_state{ h, static_cast<transition_index_type>(s) };
+        }
+      }, 4096);
+    }
+
+    // Assigns new block numbers to the states; returns the number of blocks.
+    std::size_t split_blocks(std::vector<transition_index_type>& new_block)
+    {
+      detail::parallel_radix_sort(m_states, [](const hashed_state& x) { return x.hash; }, ~std::uint64_t(0), m_number_of_threads);
+
+      std::size_t count = 0;
+      std::vector<transition_index_type> representatives;
+      for (auto i = m_states.begin(); i != m_states.end(); )
+      {
+        auto j = i;
+        representatives.clear();
+        for (; j != m_states.end() && j->hash == i->hash; ++j)
+        {
+          const transition_index_type s = j->state;
+          auto r = std::find_if(representatives.begin(), representatives.end(), [&](transition_index_type t) { return equal_signatures(s, t); });
+          if (r == representatives.end())
+          {
+            representatives.push_back(s);
+            new_block[s] = static_cast<transition_index_type>(count++);
+          }
+          else
+          {
+            new_block[s] = new_block[*r];
+          }
+        }
+        i = j;
+      }
+      return count;
+    }
+
+    // Renumbers the blocks in the order of their first occurrence.
+    void normalize_blocks()
+    {
+      const transition_index_type undefined = std::numeric_limits<transition_index_type>::max();
+      std::vector<transition_index_type> index(m_number_of_blocks, undefined);
+      transition_index_type count = 0;
+      for (transition_index_type& b: m_block)
+      {
+        if (index[b] == undefined)
+        {
+          index[b] = count++;
+        }
+        b = index[b];
+      }
+    }
+
+  public:
+    strong_bisimulation_algorithm(const labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
+      : m_out(ltsspec, number_of_threads),
+        m_number_of_threads(utilities::number_of_threads(number_of_threads)),
+        m_block(ltsspec.number_of_states, 0),
+        m_number_of_blocks(ltsspec.number_of_states == 0 ? 0 : 1),
+        m_signatures(ltsspec.transitions.size()),
+        m_signature_end(ltsspec.number_of_states),
+        m_states(ltsspec.number_of_states)
+    {}
+
+    void run()
+    {
+      std::vector<transition_index_type> new_block(m_block.size());
+      for (;;)
+      {
+        compute_signatures();
+        const std::size_t count = split_blocks(new_block);
+        m_block.swap(new_block);
+        if (count == m_number_of_blocks)
+        {
+          break;
+        }
+        m_number_of_blocks = count;
+      }
+      normalize_blocks();
+    }
+
+    /// \brief Returns the block number of each state.
+    const std::vector<transition_index_type>& blocks() const
+    {
+      return m_block;
+    }
+
+    std::size_t number_of_blocks() const
+    {
+      return m_number_of_blocks;
+    }
+};
+
+} // namespace detail
+
+/// \brief Replaces ltsspec by its quotient modulo strong bisimulation. The states of
+/// the result are numbered in the order of the first state of each equivalence class,
+/// and the transitions are sorted on (from, label, to).
+inline
+void strong_bisimulation_reduce(labeled_transition_system& ltsspec, std::size_t number_of_threads = 0)
+{
+  number_of_threads = utilities::number_of_threads(number_of_threads);
+  detail::strong_bisimulation_algorithm algorithm(ltsspec, number_of_threads);
+  algorithm.run();
+  const std::vector<transition_index_type>& block = algorithm.blocks();
+
+  std::vector<transition>& transitions = ltsspec.transitions;
+  utilities::parallel_for(transitions.size(), number_of_threads, [&](std::size_t, std::size_t first, std::size_t last)
+  {
+    for (std::size_t i = first; i < last; ++i)
+    {
+      transition& t = transitions[i];
+      t.from = block[t.from];
+      t.to = block[t.to];
+    }
+  }, 1 << 16);
+  if (ltsspec.number_of_states > 0)
+  {
+    ltsspec.initial_state = block[ltsspec.initial_state];
+  }
+  ltsspec.number_of_states = algorithm.number_of_blocks();
+  remove_duplicate_transitions(ltsspec, number_of_threads);
+}
+
+} // namespace lts
+
+} // namespace mcrl2
+
+#endif // MCRL2_LTS_NEW_STRONG_BISIMULATION_H
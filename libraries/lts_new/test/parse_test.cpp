@@ -7,19 +7,115 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 //
 /// \file parse_test.cpp
-/// \brief Add your file description here.
+/// \brief Tests for the .aut parser.
 
 #define BOOST_TEST_MODULE parse_test
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <boost/test/included/unit_test_framework.hpp>
 #include "mcrl2/lts_new/parse.h"
 
 using namespace mcrl2;
 
+std::string print(const lts::labeled_transition_system& x)
+{
+  std::ostringstream out;
+  out << x;
+  return out.str();
+}
+
+// Parses text with the given number of threads and chunk size.
+lts::labeled_transition_system parse_chunked(const std::string& text, std::size_t number_of_threads, std::size_t chunk_size)
+{
+  lts::labeled_transition_system result;
+  lts::detail::aut_parser parser(text.data(), text.data() + text.size());
+  result.initial_state = parser.initial_state();
+  result.number_of_states = parser.number_of_states();
+  result.action_labels.push_back("tau");
+  parser.parse_transitions(
+    [&](const std::string& name) { result.action_labels.push_back(name); return result.action_labels.size() - 1; },
+    [&](std::size_t from, std::size_t label, std::size_t to) { result.transitions.emplace_back(from, label, to); },
+    number_of_threads,
+    chunk_size
+  );
+  return result;
+}
+
+void check_error(const std::string& text, const std::string& expected_message)
+{
+  try
+  {
+    lts::parse_lts(text);
+    BOOST_CHECK(false);
+  }
+  catch (const mcrl2::runtime_error& e)
+  {
+    std::string message = e.what();
+    BOOST_CHECK(message.find(expected_message) != std::string::npos);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(parse_test1)
 {
   std::string text = "des ( 2, 3, 4 ) (0,\"a\",1) (1,\"b\",2) (2,\"c\",3)";
   lts::labeled_transition_system lts1 = lts::parse_lts(text);
   std::cout << lts1 << std::endl;
+  BOOST_CHECK(lts1.action_labels == std::vector<std::string>({ "tau", "a", "b", "c" }));
+  BOOST_CHECK(lts1.transitions.size() == 3);
+  BOOST_CHECK(print(lts1) == "des (2,3,4)\n(0,\"a\",1)\n(1,\"b\",2)\n(2,\"c\",3)\n");
+}
+
+BOOST_AUTO_TEST_CASE(parse_test2)
+{
+  std::string text =
+    "des (0,6,3)\r\n"
+    "(0,\"b(1, 2)\",1)\r\n"
+    "(1, tau ,2)\n"
+    "\n"
+    "( 2 , \"a\" , 0 )\n"
+    "(0,a,0)\n"
+    "(2,\"tau\",1) (1,\"b(1, 2)\",2)";
+  lts::labeled_transition_system lts1 = lts::parse_lts(text);
+  BOOST_CHECK(lts1.action_labels == std::vector<std::string>({ "tau", "b(1, 2)", "a" }));
+  BOOST_CHECK(print(lts1) == "des (0,6,3)\n(0,\"b(1, 2)\",1)\n(1,\"tau\",2)\n(2,\"a\",0)\n(0,\"a\",0)\n(2,\"tau\",1)\n(1,\"b(1, 2)\",2)\n");
+
+  // The result may not depend on the chunk size and the number of threads.
+  for (std::size_t chunk_size: { 1, 5, 1000 })
+  {
+    for (std::size_t number_of_threads: { 1, 4 })
+    {
+      BOOST_CHECK(print(parse_chunked(text, number_of_threads, chunk_size)) == print(lts1));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parse_errors)
+{
+  check_error("", "empty");
+  check_error("  \n", "empty");
+  check_error("(0,1,2)", "start with 'des'");
+  check_error("des (0,1,1)\n(0,\"a\",1)\n", "higher than the number of states");
+  check_error("des (0,2,2)\n(0,\"a\",1)\n(1,\"a\"\n,0)\n", "at line 3");
+  check_error("des (0,1,2)\n\n(0,\"a\",1 1/2 0)\n", "probabilistic target state");
+  check_error("des (0,1,2)\n(0,\"a\",1)\n(1,\"a\",0)\n", "number of transitions read (2)");
+  check_error("des (0 1/2 1,1,2)\n(0,\"a\",1)\n", "initial probability distribution");
+}
+
+BOOST_AUTO_TEST_CASE(load_empty_file)
+{
+  const std::string filename = "parse_test_empty.aut";
+  std::ofstream(filename).close();
+  try
+  {
+    lts::load_lts(filename);
+    BOOST_CHECK(false);
+  }
+  catch (const mcrl2::runtime_error& e)
+  {
+    BOOST_CHECK(std::string(e.what()).find("empty") != std::string::npos);
+  }
+  std::remove(filename.c_str());
 }
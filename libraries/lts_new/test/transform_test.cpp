@@ -0,0 +1,144 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file transform_test.cpp
+/// \brief Tests for the transformations on flat LTSs.
+
+#define BOOST_TEST_MODULE transform_test
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <boost/test/included/unit_test_framework.hpp>
+#include "mcrl2/lts_new/parse.h"
+#include "mcrl2/lts_new/remove_duplicate_transitions.h"
+#include "mcrl2/lts_new/remove_tau_action.h"
+#include "mcrl2/lts_new/remove_unreachable_states.h"
+#include "mcrl2/lts_new/strong_bisimulation.h"
+
+using namespace mcrl2;
+
+std::string print(const lts::labeled_transition_system& x)
+{
+  std::ostringstream out;
+  out << x;
+  return out.str();
+}
+
+lts::labeled_transition_system random_lts(std::size_t number_of_states, std::size_t number_of_transitions, std::size_t number_of_labels, unsigned seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<std::size_t> state(0, number_of_states - 1);
+  std::uniform_int_distribution<std::size_t> label(0, number_of_labels - 1);
+  lts::labeled_transition_system result;
+  result.initial_state = 0;
+  result.number_of_states = number_of_states;
+  result.action_labels.push_back("tau");
+  for (std::size_t i = 1; i < number_of_labels; i++)
+  {
+    result.action_labels.push_back("a" + std::to_string(i));
+  }
+  for (std::size_t i = 0; i < number_of_transitions; i++)
+  {
+    result.transitions.emplace_back(state(generator), label(generator), state(generator));
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_radix_sort)
+{
+  std::mt19937 generator(42);
+  std::vector<std::size_t> v(300000);
+  for (std::size_t& x: v)
+  {
+    x = generator() % 1000000;
+  }
+  std::vector<std::size_t> expected = v;
+  std::sort(expected.begin(), expected.end());
+  std::vector<std::size_t> expected_unique = expected;
+  expected_unique.erase(std::unique(expected_unique.begin(), expected_unique.end()), expected_unique.end());
+  for (std::size_t number_of_threads: { 1, 4 })
+  {
+    std::vector<std::size_t> w = v;
+    lts::detail::parallel_radix_sort(w, [](std::size_t x) { return x; }, 999999, number_of_threads);
+    BOOST_CHECK(w == expected);
+    lts::detail::parallel_unique(w, number_of_threads);
+    BOOST_CHECK(w == expected_unique);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_remove_duplicate_transitions)
+{
+  for (std::size_t number_of_threads: { 1, 4 })
+  {
+    lts::labeled_transition_system ltsspec = random_lts(1000, 200000, 5, 7);
+    std::set<lts::transition> expected(ltsspec.transitions.begin(), ltsspec.transitions.end());
+    lts::remove_duplicate_transitions(ltsspec, number_of_threads);
+    BOOST_CHECK(std::equal(ltsspec.transitions.begin(), ltsspec.transitions.end(), expected.begin(), expected.end()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_remove_tau_action)
+{
+  // The states 1, 2 and 3 are connected by tau transitions; state 5 is not used.
+  std::string text =
+    "des (0,6,6)\n"
+    "(0,\"a\",1)\n"
+    "(2,\"tau\",1)\n"
+    "(3,\"tau\",2)\n"
+    "(3,\"b\",4)\n"
+    "(1,\"b\",4)\n"
+    "(4,\"a\",0)\n";
+  lts::labeled_transition_system ltsspec = lts::parse_lts(text);
+  lts::remove_tau_action(ltsspec);
+  BOOST_CHECK_EQUAL(print(ltsspec), "des (0,3,3)\n(0,\"a\",1)\n(1,\"b\",2)\n(2,\"a\",0)\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_remove_unreachable_states)
+{
+  std::string text =
+    "des (1,4,4)\n"
+    "(0,\"a\",1)\n"
+    "(1,\"b\",2)\n"
+    "(2,\"c\",1)\n"
+    "(3,\"a\",0)\n";
+  lts::labeled_transition_system ltsspec = lts::parse_lts(text);
+  lts::remove_unreachable_states(ltsspec);
+  BOOST_CHECK_EQUAL(print(ltsspec), "des (0,2,2)\n(0,\"b\",1)\n(1,\"c\",0)\n");
+}
+
+BOOST_AUTO_TEST_CASE(test_strong_bisimulation)
+{
+  // a.b + a.b + a.c is reduced to a.b + a.c
+  std::string text =
+    "des (0,6,7)\n"
+    "(0,\"a\",1)\n"
+    "(0,\"a\",2)\n"
+    "(0,\"a\",3)\n"
+    "(1,\"b\",4)\n"
+    "(2,\"b\",5)\n"
+    "(3,\"c\",6)\n";
+  lts::labeled_transition_system ltsspec = lts::parse_lts(text);
+  lts::strong_bisimulation_reduce(ltsspec);
+  BOOST_CHECK_EQUAL(print(ltsspec), "des (0,4,4)\n(0,\"a\",1)\n(0,\"a\",2)\n(1,\"b\",3)\n(2,\"c\",3)\n");
+
+  // The result does not depend on the number of threads, and the quotient is minimal.
+  lts::labeled_transition_system lts1 = random_lts(20000, 40000, 3, 11);
+  lts::strong_bisimulation_reduce(lts1, 1);
+  BOOST_CHECK(lts1.number_of_states < 20000);
+  for (std::size_t number_of_threads: { 2, 4 })
+  {
+    lts::labeled_transition_system lts2 = random_lts(20000, 40000, 3, 11);
+    lts::strong_bisimulation_reduce(lts2, number_of_threads);
+    BOOST_CHECK(print(lts1) == print(lts2));
+  }
+  std::string before = print(lts1);
+  lts::strong_bisimulation_reduce(lts1);
+  BOOST_CHECK(print(lts1) == before);
+}
@@ -1665,6 +1665,28 @@ struct process_identifier_builder: public add_process_identifiers<core::builder,
 };
 //--- end generated add_process_identifiers code ---//
 
+/// \brief Data expression builder that memoizes its results for shared data expressions
+template <typename Derived>
+struct cached_data_expression_builder: public data::add_data_expression_cache<process::data_expression_builder, Derived>
+{
+  typedef data::add_data_expression_cache<process::data_expression_builder, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+};
+
+/// \brief Variable builder that memoizes its results for shared data expressions
+template <typename Derived>
+struct cached_variable_builder: public data::add_data_expression_cache<process::variable_builder, Derived>
+{
+  typedef data::add_data_expression_cache<process::variable_builder, Derived> super;
+  using super::enter;
+  using super::leave;
+  using super::update;
+  using super::apply;
+};
+
 } // namespace process
 
 } // namespace mcrl2
@@ -140,7 +140,7 @@ template <typename T>
 std::set<data::variable> find_all_variables(const T& x)
 {
   std::set<data::variable> result;
-  process::find_all_variables(x, std::inserter(result, result.end()));
+  data::detail::make_find_all_variables_traverser<process::cached_variable_traverser>(std::inserter(result, result.end())).apply(x);
   return result;
 }
 
@@ -172,7 +172,7 @@ template <typename T>
 std::set<data::variable> find_free_variables(const T& x)
 {
   std::set<data::variable> result;
-  process::find_free_variables(x, std::inserter(result, result.end()));
+  data::detail::make_cached_find_free_variables_traverser<process::data_expression_traverser, process::add_data_variable_binding>(std::inserter(result, result.end())).apply(x);
   return result;
 }
 
@@ -184,7 +184,7 @@ template <typename T, typename VariableContainer>
 std::set<data::variable> find_free_variables_with_bound(const T& x, VariableContainer const& bound)
 {
   std::set<data::variable> result;
-  process::find_free_variables_with_bound(x, std::inserter(result, result.end()), bound);
+  data::detail::make_cached_find_free_variables_traverser<process::data_expression_traverser, process::add_data_variable_binding>(std::inserter(result, result.end()), bound).apply(x);
   return result;
 }
 
@@ -247,7 +247,7 @@ template <typename T>
 std::set<data::function_symbol> find_function_symbols(const T& x)
 {
   std::set<data::function_symbol> result;
-  process::find_function_symbols(x, std::inserter(result, result.end()));
+  data::detail::make_find_function_symbols_traverser<process::cached_data_expression_traverser>(std::inserter(result, result.end())).apply(x);
   return result;
 }
 //--- end generated process find code ---//
@@ -160,7 +160,7 @@ void replace_variables(T& x,
                        typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                       )
 {
-  core::make_update_apply_builder<process::data_expression_builder>(sigma).update(x);
+  core::make_update_apply_builder<process::cached_data_expression_builder>(sigma).update(x);
 }
 
 template <typename T, typename Substitution>
@@ -169,7 +169,7 @@ T replace_variables(const T& x,
                     typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                    )
 {
-  return core::make_update_apply_builder<process::data_expression_builder>(sigma).apply(x);
+  return core::make_update_apply_builder<process::cached_data_expression_builder>(sigma).apply(x);
 }
 
 template <typename T, typename Substitution>
@@ -178,7 +178,7 @@ void replace_all_variables(T& x,
                            typename std::enable_if<!std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                           )
 {
-  core::make_update_apply_builder<process::variable_builder>(sigma).update(x);
+  core::make_update_apply_builder<process::cached_variable_builder>(sigma).update(x);
 }
 
 template <typename T, typename Substitution>
@@ -187,7 +187,7 @@ T replace_all_variables(const T& x,
                         typename std::enable_if<std::is_base_of<atermpp::aterm, T>::value>::type* = nullptr
                        )
 {
-  return core::make_update_apply_builder<process::variable_builder>(sigma).apply(x);
+  return core::make_update_apply_builder<process::cached_variable_builder>(sigma).apply(x);
 }
 
 /// \brief Applies the substitution sigma to x.
@@ -0,0 +1,173 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/memory_mapped_file.h
+/// \brief Read-only access to the contents of a file via a memory mapping.
+
+#ifndef MCRL2_UTILITIES_MEMORY_MAPPED_FILE_H
+#define MCRL2_UTILITIES_MEMORY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mcrl2/utilities/exception.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mcrl2 {
+
+namespace utilities {
+
+/// \brief Gives read-only access to the contents of a file. On POSIX systems the
+/// file is mapped into memory, such that only the pages that are actually used
+/// are loaded. On other systems the contents are read into a buffer.
+class memory_mapped_file
+{
+  protected:
+    const unsigned char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<unsigned char> m_buffer; // used if mapping is not possible
+
+    void read_into_buffer(const std::string& filename)
+    {
+      std::ifstream from(filename, std::ios_base::in | std::ios_base::binary);
+      if (!from)
+      {
+        throw mcrl2::runtime_error("Could not open file " + filename + " for reading.");
+      }
+      m_buffer.assign(std::istreambuf_iterator<char>(from), std::istreambuf_iterator<char>());
+      m_data = m_buffer.data();
+      m_size = m_buffer.size();
+    }
+
+    void unmap()
+    {
+#ifndef _WIN32
+      if (m_mapped)
+      {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+      }
+#endif
+      m_data = nullptr;
+      m_size = 0;
+      m_mapped = false;
+      m_buffer.clear();
+    }
+
+  public:
+    memory_mapped_file() = default;
+
+    /// \brief Opens the file with the given name.
+    /// \param sequential If true, the operating system is advised that the file is read sequentially.
+    explicit memory_mapped_file(const std::string& filename, bool sequential = true)
+    {
+#ifndef _WIN32
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+        throw mcrl2::runtime_error("Could not open file " + filename + " for reading.");
+      }
+      struct stat info;
+      if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+      {
+        ::close(fd);
+        read_into_buffer(filename);
+        return;
+      }
+      m_size = static_cast<std::size_t>(info.st_size);
+      if (m_size > 0)
+      {
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+          ::close(fd);
+          m_size = 0;
+          read_into_buffer(filename);
+          return;
+        }
+        if (sequential)
+        {
+          ::madvise(p, m_size, MADV_SEQUENTIAL);
+        }
+        m_data = static_cast<const unsigned char*>(p);
+        m_mapped = true;
+      }
+      ::close(fd);
+#else
+      (void)sequential;
+      read_into_buffer(filename);
+#endif
+    }
+
+    memory_mapped_file(const memory_mapped_file&) = delete;
+    memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+
+    memory_mapped_file(memory_mapped_file&& other)
+    {
+      *this = std::move(other);
+    }
+
+    memory_mapped_file& operator=(memory_mapped_file&& other)
+    {
+      if (this != &other)
+      {
+        unmap();
+        m_buffer = std::move(other.m_buffer);
+        m_mapped = other.m_mapped;
+        m_size = other.m_size;
+        m_data = m_mapped ? other.m_data : m_buffer.data();
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_mapped = false;
+      }
+      return *this;
+    }
+
+    ~memory_mapped_file()
+    {
+      unmap();
+    }
+
+    /// \brief Returns a pointer to the first byte of the file.
+    const unsigned char* data() const
+    {
+      return m_data;
+    }
+
+    /// \brief Returns the size of the file in bytes.
+    std::size_t size() const
+    {
+      return m_size;
+    }
+
+    bool empty() const
+    {
+      return m_size == 0;
+    }
+
+    /// \brief Returns true if the file contents are mapped into memory.
+    bool is_mapped() const
+    {
+      return m_mapped;
+    }
+};
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_MEMORY_MAPPED_FILE_H
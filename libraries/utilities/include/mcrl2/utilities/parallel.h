@@ -0,0 +1,117 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://svn.win.tue.nl/trac/MCRL2/browser/trunk/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/utilities/parallel.h
+/// \brief Simple data parallel loops on top of std::thread.
+
+#ifndef MCRL2_UTILITIES_PARALLEL_H
+#define MCRL2_UTILITIES_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mcrl2
+{
+
+namespace utilities
+{
+
+/// \brief Returns the number of threads that is used if 0 threads are requested,
+/// i.e. the number of hardware threads, or 1 if that is unknown.
+inline std::size_t number_of_threads(std::size_t requested = 0)
+{
+  if (requested > 0)
+  {
+    return requested;
+  }
+  const std::size_t n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+/// \brief Applies f(thread_index, first, last) to consecutive chunks [first, last)
+/// of the range [0, n), using the given number of threads.
+/// \details The chunks are handed out dynamically, so the work need not be evenly
+/// distributed over the range. Each call of f receives the index of the thread
+/// that executes it, which lies in [0, number_of_threads); this can be used to
+/// let threads write to their own buffers. If the range contains fewer than
+/// grain_size elements, or if only one thread is requested, f is applied to the
+/// whole range by the calling thread, with thread index 0. An exception that is
+/// thrown by f is rethrown in the calling thread after all threads are joined.
+template <typename Function>
+void parallel_for(std::size_t n, std::size_t number_of_threads, Function f, std::size_t grain_size = 1024)
+{
+  grain_size = std::max(grain_size, std::size_t(1));
+  if (number_of_threads <= 1 || n <= grain_size)
+  {
+    if (n > 0)
+    {
+      f(std::size_t(0), std::size_t(0), n);
+    }
+    return;
+  }
+
+  // Use a few chunks per thread, to compensate for chunks that take longer than others.
+  const std::size_t chunk_size = std::max(grain_size, n / (8 * number_of_threads) + 1);
+  number_of_threads = std::min(number_of_threads, (n + chunk_size - 1) / chunk_size);
+
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto work = [&](std::size_t thread_index)
+  {
+    try
+    {
+      for (;;)
+      {
+        const std::size_t first = next.fetch_add(chunk_size);
+        if (first >= n)
+        {
+          break;
+        }
+        f(thread_index, first, std::min(n, first + chunk_size));
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+      next.store(n);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(number_of_threads - 1);
+  for (std::size_t i = 1; i < number_of_threads; i++)
+  {
+    threads.emplace_back(work, i);
+  }
+  work(0);
+  for (std::thread& t: threads)
+  {
+    t.join();
+  }
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_PARALLEL_H
@@ -13,7 +13,10 @@
 
 #include "mcrl2/core/detail/print_utility.h"
 #include "mcrl2/lts_new/parse.h"
+#include "mcrl2/lts_new/remove_duplicate_transitions.h"
 #include "mcrl2/lts_new/remove_tau_action.h"
+#include "mcrl2/lts_new/remove_unreachable_states.h"
+#include "mcrl2/lts_new/strong_bisimulation.h"
 #include "mcrl2/utilities/detail/command.h"
 #include "mcrl2/utilities/detail/io.h"
 #include "mcrl2/utilities/detail/transform_tool.h"
@@ -23,22 +26,28 @@ using namespace mcrl2;
 using utilities::detail::transform_tool;
 using utilities::tools::input_output_tool;
 
+using utilities::command_line_parser;
+using utilities::interface_description;
+using utilities::make_mandatory_argument;
+
 struct lts_command: public utilities::detail::command
 {
   lts::labeled_transition_system ltsspec;
+  const std::size_t& number_of_threads;
 
   lts_command(const std::string& name,
               const std::string& input_filename,
               const std::string& output_filename,
-              const std::vector<std::string>& options
+              const std::vector<std::string>& options,
+              const std::size_t& number_of_threads_
              )
-    : utilities::detail::command(name, input_filename, output_filename, options)
+    : utilities::detail::command(name, input_filename, output_filename, options),
+      number_of_threads(number_of_threads_)
   {}
 
   void execute() override
   {
-    std::string text = utilities::detail::read_text(input_filename);
-    ltsspec = lts::parse_lts(text);
+    ltsspec = lts::load_lts(input_filename, number_of_threads);
   }
 
   void save()
@@ -49,17 +58,77 @@ struct lts_command: public utilities::detail::command
   }
 };
 
-/// \brief Eliminates trivial process equations of the shape P = Q
+/// \brief Joins the states that are connected by tau transitions, and removes the tau transitions
 struct remove_tau_action_command: public lts_command
 {
-  remove_tau_action_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options)
-    : lts_command("remove-tau", input_filename, output_filename, options)
+  remove_tau_action_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const std::size_t& number_of_threads)
+    : lts_command("remove-tau", input_filename, output_filename, options, number_of_threads)
+  {}
+
+  void execute() override
+  {
+    lts_command::execute();
+    lts::remove_tau_action(ltsspec, 0, number_of_threads);
+    save();
+  }
+};
+
+/// \brief Removes duplicate transitions, and sorts the transitions
+struct remove_duplicate_transitions_command: public lts_command
+{
+  remove_duplicate_transitions_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const std::size_t& number_of_threads)
+    : lts_command("remove-duplicates", input_filename, output_filename, options, number_of_threads)
+  {}
+
+  void execute() override
+  {
+    lts_command::execute();
+    lts::remove_duplicate_transitions(ltsspec, number_of_threads);
+    save();
+  }
+};
+
+/// \brief Removes the states that are not reachable from the initial state
+struct remove_unreachable_states_command: public lts_command
+{
+  remove_unreachable_states_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const std::size_t& number_of_threads)
+    : lts_command("remove-unreachable", input_filename, output_filename, options, number_of_threads)
+  {}
+
+  void execute() override
+  {
+    lts_command::execute();
+    lts::remove_unreachable_states(ltsspec, number_of_threads);
+    save();
+  }
+};
+
+/// \brief Renumbers the states such that the states without transitions disappear
+struct remove_unused_states_command: public lts_command
+{
+  remove_unused_states_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const std::size_t& number_of_threads)
+    : lts_command("remove-unused", input_filename, output_filename, options, number_of_threads)
+  {}
+
+  void execute() override
+  {
+    lts_command::execute();
+    lts::remove_unused_states(ltsspec, number_of_threads);
+    save();
+  }
+};
+
+/// \brief Reduces the LTS modulo strong bisimulation
+struct strong_bisimulation_reduce_command: public lts_command
+{
+  strong_bisimulation_reduce_command(const std::string& input_filename, const std::string& output_filename, const std::vector<std::string>& options, const std::size_t& number_of_threads)
+    : lts_command("bisim", input_filename, output_filename, options, number_of_threads)
   {}
 
   void execute() override
   {
     lts_command::execute();
-    lts::remove_tau_action(ltsspec);
+    lts::strong_bisimulation_reduce(ltsspec, number_of_threads);
     save();
   }
 };
@@ -78,9 +147,32 @@ class ltstransform_tool: public transform_tool<input_output_tool>
              )
     {}
 
+  protected:
+    std::size_t m_number_of_threads = 0;
+
+    void add_options(interface_description& desc) override
+    {
+      super::add_options(desc);
+      desc.add_option("threads", make_mandatory_argument("NUM"),
+                      "use NUM threads; the default is the number of hardware threads", 't');
+    }
+
+    void parse_options(const command_line_parser& parser) override
+    {
+      super::parse_options(parser);
+      if (parser.options.count("threads"))
+      {
+        m_number_of_threads = parser.option_argument_as<std::size_t>("threads");
+      }
+    }
+
     void add_commands(const std::vector<std::string>& options) override
     {
-      add_command(std::make_shared<remove_tau_action_command>(input_filename(), output_filename(), options));
+      add_command(std::make_shared<remove_tau_action_command>(input_filename(), output_filename(), options, m_number_of_threads));
+      add_command(std::make_shared<remove_duplicate_transitions_command>(input_filename(), output_filename(), options, m_number_of_threads));
+      add_command(std::make_shared<remove_unreachable_states_command>(input_filename(), output_filename(), options, m_number_of_threads));
+      add_command(std::make_shared<remove_unused_states_command>(input_filename(), output_filename(), options, m_number_of_threads));
+      add_command(std::make_shared<strong_bisimulation_reduce_command>(input_filename(), output_filename(), options, m_number_of_threads));
     }
 };
 
@@ -15,6 +15,7 @@
 #include <string>
 
 #include "mcrl2/data/rewriter_tool.h"
+#include "mcrl2/lps/confluence_checker.h"
 #include "mcrl2/lps/io.h"
 #include "mcrl2/lts/detail/exploration.h"
 #include "mcrl2/lts/lts_io.h"
@@ -72,6 +73,7 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
     lts_generation_options m_options;
     std::string m_filename;
     abortable* m_abortable = nullptr;
+    bool m_check_confluence = false;
 
   public:
     mcrl3explore_tool():
@@ -116,6 +118,20 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
     {
       load_lps(m_options.specification, m_filename);
 
+      if (m_check_confluence)
+      {
+        try
+        {
+          lps::detail::Confluence_Checker<lps::specification> checker(m_options.specification, m_options.strat);
+          checker.check_confluence_and_mark(data::sort_bool::true_(), 0);
+        }
+        catch (mcrl2::runtime_error& e)
+        {
+          mCRL2log(error) << e.what() << std::endl;
+          return false;
+        }
+      }
+
       try
       {
         if (m_options.use_enumeration_caching)
@@ -148,6 +164,21 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       desc.
       add_option("cached",
                  "use enumeration caching techniques to speed up state space generation. ").
+      add_option("transition-caching", make_optional_argument("SIZE", "1073741824"),
+                 "cache the transitions of each summand, with the values of the process parameters "
+                 "that the summand reads as the key, and compute successor states by updating the "
+                 "parameters that it writes. The cache uses at most approximately SIZE bytes "
+                 "(default 1073741824). This is effective for summands that depend on few parameters. "
+                 "It cannot be combined with --cached. ").
+      add_option("confluence", make_optional_argument("NAME", "ctau"),
+                 "apply confluence reduction: the summands with action NAME (default 'ctau') are treated as "
+                 "confluent tau summands. From every new state the confluent transitions are followed to a "
+                 "representative, and only the representatives are explored. The confluent transitions are "
+                 "labelled tau. The resulting LTS is branching bisimilar to the original one, provided that "
+                 "the summands are indeed confluent. Use NAME 'tau' to treat all tau summands as confluent. ", 'c').
+      add_option("check-confluence",
+                 "check which tau summands are confluent before the exploration, and mark them with the "
+                 "action 'ctau' for --confluence. This option implies --confluence. ").
       add_option("dummy", make_mandatory_argument("BOOL"),
                  "replace free variables in the LPS with dummy values based on the value of BOOL: 'yes' (default) or 'no'. ", 'y').
       add_option("unused-data",
@@ -162,8 +193,22 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
                  "detect nondeterministic states, i.e. states with outgoing transitions with the same label to different states. ", 'n').
       add_option("deadlock",
                  "detect deadlocks (i.e. for every deadlock a message is printed). ", 'D').
+      add_option("trace", make_optional_argument("NUM", std::to_string(lts_generation_options::default_max_traces)),
+                 "write a shortest trace to each state that is reported by --deadlock or --nondeterminism "
+                 "to a file. No more than NUM traces are written. If NUM is not supplied, the number of "
+                 "traces is not limited. For each state the state number of its parent and the index of "
+                 "the summand of the transition from its parent are stored, which takes a few bytes per "
+                 "state. The traces are named INFILE_dlk_N.trc or INFILE_nondet_N.trc, where INFILE is the "
+                 "name of the input file without extension. This option can only be used in combination "
+                 "with the default breadth first exploration. ", 't').
+      add_option("trace-memory", make_mandatory_argument("SIZE"),
+                 "use at most SIZE bytes of memory for the parents of the states in combination with "
+                 "--trace (default is 1073741824). The parents that do not fit are written to a file in "
+                 "the directory of the traces, which is removed afterwards. ").
       add_option("out", make_mandatory_argument("FORMAT"),
                  "save the output in the specified FORMAT. ", 'o').
+      add_option("indexed", "save an LTS in .lts format in the indexed layout, which can be memory mapped "
+                 "and loaded lazily, instead of as a single binary aterm. ").
       add_option("no-info", "do not add state information to OUTFILE. "
                  "Without this option mcrl3explore adds state vector to the LTS. This "
                  "option causes this information to be discarded and states are only "
@@ -176,7 +221,30 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
                  "horrendous. This feature helps to suppress those. Other verbose messages, "
                  "such as the total number of states explored, just remain visible. ").
       add_option("init-tsize", make_mandatory_argument("NUM"),
-                 "set the initial size of the internally used hash tables (default is 10000). ");
+                 "set the initial size of the internally used hash tables (default is 10000). ").
+      add_option("bithashing", make_mandatory_argument("SIZE"),
+                 "use bit state hashing: instead of the visited states, only SIZE bits are stored, "
+                 "with three bits set per state. States may be omitted; the estimated probability "
+                 "of this is printed at the end. This option cannot be combined with saving the LTS. ").
+      add_option("hash-compaction",
+                 "use hash compaction: instead of the visited states, only 64 bit fingerprints of the "
+                 "states are stored. States may be omitted; the estimated probability of this is "
+                 "printed at the end. This option cannot be combined with saving the LTS. ").
+      add_option("external-memory", make_mandatory_argument("DIR"),
+                 "store the visited states on disk in the directory DIR instead of in memory. The "
+                 "successors of a breadth first level are collected in a buffer of bounded size, "
+                 "that is written to disk in sorted runs when it is full. When a level is finished, "
+                 "the runs are merged with the visited states to detect duplicates. The files are "
+                 "removed afterwards. This option cannot be combined with saving the LTS. ").
+      add_option("external-memory-buffer", make_mandatory_argument("SIZE"),
+                 "use at most SIZE bytes for the buffer of successor states in combination with "
+                 "--external-memory (default is 268435456). ").
+      add_option("processes", make_mandatory_argument("NUM"),
+                 "explore the state space with NUM cooperating worker processes (default is 1). Every "
+                 "worker owns the states with a hash value in its partition, and sends the states it "
+                 "finds to their owners over UNIX sockets. The state numbers and the transitions are "
+                 "merged afterwards. With more than one process the LTS can only be saved in the aut "
+                 "format, and the limit of --max is divided evenly over the workers. ");
     }
 
     void parse_options(const command_line_parser& parser) override
@@ -186,15 +254,44 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       m_options.detect_deadlock             = parser.options.count("deadlock") != 0;
       m_options.detect_nondeterminism       = parser.options.count("nondeterminism") != 0;
       m_options.outinfo                     = parser.options.count("no-info") == 0;
+      m_options.save_indexed                = parser.options.count("indexed") != 0;
       m_options.suppress_progress_messages  = parser.options.count("suppress") != 0;
       m_options.strat                       = parser.option_argument_as<mcrl2::data::rewriter::strategy>("rewriter");
       m_options.use_enumeration_caching     = parser.options.count("cached") > 0;
+      m_options.use_transition_caching      = parser.options.count("transition-caching") > 0;
+      m_check_confluence                    = parser.options.count("check-confluence") > 0;
+
+      if (parser.options.count("confluence"))
+      {
+        m_options.confluence_action = parser.option_argument("confluence");
+        if (m_options.confluence_action.empty())
+        {
+          throw parser.error("The argument of option --confluence must be an action name.");
+        }
+      }
+      if (m_check_confluence)
+      {
+        if (!m_options.confluence_action.empty() && m_options.confluence_action != "ctau")
+        {
+          throw parser.error("Option --check-confluence can only be combined with --confluence=ctau.");
+        }
+        m_options.confluence_action = "ctau";
+      }
+
+      if (m_options.use_transition_caching)
+      {
+        if (m_options.use_enumeration_caching)
+        {
+          throw parser.error("Options --cached and --transition-caching cannot be combined.");
+        }
+        m_options.transition_cache_size = parser.option_argument_as< unsigned long >("transition-caching");
+      }
 
       if (parser.options.count("dummy"))
       {
         if (parser.options.count("dummy") > 1)
         {
-          parser.error("Multiple use of option -y/--dummy; only one occurrence is allowed.");
+          throw parser.error("Multiple use of option -y/--dummy; only one occurrence is allowed.");
         }
         std::string dummy_str(parser.option_argument("dummy"));
         if (dummy_str == "yes")
@@ -207,7 +304,7 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
         }
         else
         {
-          parser.error("Option -y/--dummy has illegal argument '" + dummy_str + "'.");
+          throw parser.error("Option -y/--dummy has illegal argument '" + dummy_str + "'.");
         }
       }
 
@@ -216,13 +313,31 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
         m_options.max_states = parser.option_argument_as<unsigned long> ("max");
       }
 
+      if (parser.options.count("trace"))
+      {
+        if (!m_options.detect_deadlock && !m_options.detect_nondeterminism)
+        {
+          throw parser.error("Option --trace requires --deadlock or --nondeterminism.");
+        }
+        m_options.save_traces = true;
+        m_options.max_traces = parser.option_argument_as<unsigned long>("trace");
+      }
+      if (parser.options.count("trace-memory"))
+      {
+        if (!m_options.save_traces)
+        {
+          throw parser.error("Option --trace-memory requires --trace.");
+        }
+        m_options.trace_memory_limit = parser.option_argument_as<unsigned long>("trace-memory");
+      }
+
       if (parser.options.count("out"))
       {
         m_options.outformat = mcrl2::lts::detail::parse_format(parser.option_argument("out"));
 
         if (m_options.outformat == lts_none)
         {
-          parser.error("Format '" + parser.option_argument("out") + "' is not recognised.");
+          throw parser.error("Format '" + parser.option_argument("out") + "' is not recognised.");
         }
       }
       if (parser.options.count("init-tsize"))
@@ -233,19 +348,72 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
       {
         m_options.todo_max = parser.option_argument_as< unsigned long >("todo-max");
       }
+      if (parser.options.count("bithashing"))
+      {
+        m_options.bithashing = parser.option_argument_as< unsigned long >("bithashing");
+        if (m_options.bithashing == 0)
+        {
+          throw parser.error("The argument of option --bithashing must be positive.");
+        }
+      }
+      m_options.hash_compaction = parser.options.count("hash-compaction") != 0;
+      if (m_options.bithashing > 0 && m_options.hash_compaction)
+      {
+        throw parser.error("Options --bithashing and --hash-compaction cannot be combined.");
+      }
+      if (parser.options.count("external-memory"))
+      {
+        m_options.external_memory_directory = parser.option_argument("external-memory");
+        if (m_options.external_memory_directory.empty())
+        {
+          throw parser.error("The argument of option --external-memory must be a directory.");
+        }
+        if (m_options.bithashing > 0 || m_options.hash_compaction)
+        {
+          throw parser.error("Option --external-memory cannot be combined with --bithashing or --hash-compaction.");
+        }
+      }
+      if (parser.options.count("external-memory-buffer"))
+      {
+        if (!parser.options.count("external-memory"))
+        {
+          throw parser.error("Option --external-memory-buffer requires --external-memory.");
+        }
+        m_options.external_memory_buffer_size = parser.option_argument_as< unsigned long >("external-memory-buffer");
+        if (m_options.external_memory_buffer_size == 0)
+        {
+          throw parser.error("The argument of option --external-memory-buffer must be positive.");
+        }
+      }
+
+      if (parser.options.count("processes"))
+      {
+        m_options.number_of_processes = parser.option_argument_as< unsigned long >("processes");
+        if (m_options.number_of_processes == 0)
+        {
+          throw parser.error("The argument of option --processes must be positive.");
+        }
+        if (m_options.number_of_processes > 1 && (m_options.bithashing > 0 || m_options.hash_compaction || !m_options.external_memory_directory.empty()))
+        {
+          throw parser.error("Option --processes cannot be combined with --bithashing, --hash-compaction or --external-memory.");
+        }
+      }
 
       if (parser.options.count("suppress") && !mCRL2logEnabled(verbose))
       {
-        parser.error("Option --suppress requires --verbose (of -v).");
+        throw parser.error("Option --suppress requires --verbose (of -v).");
       }
 
       if (2 < parser.arguments.size())
       {
-        parser.error("Too many file arguments.");
+        throw parser.error("Too many file arguments.");
       }
       if (!parser.arguments.empty())
       {
         m_filename = parser.arguments[0];
+        const std::size_t dot = m_filename.find_last_of('.');
+        const std::size_t slash = m_filename.find_last_of('/');
+        m_options.trace_prefix = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? m_filename.substr(0, dot) : m_filename;
       }
       if (1 < parser.arguments.size())
       {
@@ -262,6 +430,23 @@ class mcrl3explore_tool: public rewriter_tool<input_output_tool>
           m_options.outformat = lts_lts;
         }
       }
+
+      if ((m_options.bithashing > 0 || m_options.hash_compaction) && m_options.outformat != lts_none)
+      {
+        throw parser.error("Options --bithashing and --hash-compaction cannot be combined with saving the LTS.");
+      }
+      if (!m_options.external_memory_directory.empty() && m_options.outformat != lts_none)
+      {
+        throw parser.error("Option --external-memory cannot be combined with saving the LTS.");
+      }
+      if (m_options.number_of_processes > 1 && m_options.outformat != lts_none && m_options.outformat != lts_aut)
+      {
+        throw parser.error("With option --processes the LTS can only be saved in the aut format.");
+      }
+      if (m_options.save_traces && (m_options.bithashing > 0 || m_options.hash_compaction || !m_options.external_memory_directory.empty() || m_options.number_of_processes > 1))
+      {
+        throw parser.error("Option --trace cannot be combined with --bithashing, --hash-compaction, --external-memory or --processes.");
+      }
     }
 };
 
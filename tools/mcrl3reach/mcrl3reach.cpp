@@ -0,0 +1,136 @@
+// Author(s): Wieger Wesselink
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl3reach.cpp
+
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "mcrl2/data/rewriter_tool.h"
+#include "mcrl2/lps/detail/instantiate_global_variables.h"
+#include "mcrl2/lps/find.h"
+#include "mcrl2/lps/io.h"
+#include "mcrl2/lps/one_point_rule_rewrite.h"
+#include "mcrl2/lps/resolve_name_clashes.h"
+#include "mcrl2/lps/symbolic_reachability.h"
+#include "mcrl2/utilities/input_tool.h"
+#include "mcrl2/utilities/logger.h"
+
+using namespace mcrl2;
+using namespace mcrl2::utilities::tools;
+using namespace mcrl2::utilities;
+using namespace mcrl2::lps;
+using namespace mcrl2::log;
+using mcrl2::data::tools::rewriter_tool;
+
+class mcrl3reach_tool: public rewriter_tool<input_tool>
+{
+  protected:
+    typedef rewriter_tool<input_tool> super;
+
+    symbolic_reachability_strategy m_strategy = sr_chaining;
+    std::size_t m_log_cache_size = 20;
+    bool m_instantiate_global_variables = true;
+
+  public:
+    mcrl3reach_tool()
+      : super("mcrl3reach", "Wieger Wesselink",
+              "compute the reachable states of an LPS symbolically",
+              "Compute the number of reachable states of the LPS in INFILE, using list decision "
+              "diagrams (LDDs) to represent sets of states. If INFILE is not supplied, stdin is used. "
+              "The transition relation is learned on the fly, per group of summands that read "
+              "and write the same process parameters. This is effective for models with large but "
+              "regular state spaces.")
+    {}
+
+    bool run() override
+    {
+      specification spec;
+      load_lps(spec, input_filename());
+
+      resolve_summand_variable_name_clashes(spec);
+      if (m_instantiate_global_variables)
+      {
+        lps::detail::instantiate_global_variables(spec);
+      }
+      one_point_rule_rewrite(spec);
+
+      std::set<data::function_symbol> extra_function_symbols = lps::find_function_symbols(spec);
+      data::rewriter rewriter(spec.data(), data::used_data_equation_selector(spec.data(), extra_function_symbols, spec.global_variables()), rewrite_strategy());
+
+      symbolic_reachability_algorithm algorithm(spec, rewriter, m_log_cache_size);
+      auto states = algorithm.run(m_strategy);
+      std::cout << "number of states = " << std::fixed << std::setprecision(0) << algorithm.state_count(states) << std::endl;
+      mCRL2log(verbose) << "computed in " << algorithm.iteration_count() << " iterations using " << algorithm.manager().node_count() << " LDD nodes" << std::endl;
+      return true;
+    }
+
+  protected:
+    void add_options(interface_description& desc) override
+    {
+      super::add_options(desc);
+      desc.
+      add_option("strategy", make_mandatory_argument("NAME"),
+                 "use the exploration strategy NAME:\n"
+                 "'breadth' for breadth first search, where all groups are applied to the states of the previous level,\n"
+                 "'chaining' (default) for chaining, where the successors of a group are immediately used by the next group, or\n"
+                 "'saturation' for saturation, where groups are applied until a fixpoint is reached, the groups that "
+                 "depend on the last parameters first. ", 's').
+      add_option("cache-size", make_mandatory_argument("NUM"),
+                 "use an LDD operation cache of 2^NUM entries (default is 20). ").
+      add_option("dummy", make_mandatory_argument("BOOL"),
+                 "replace free variables in the LPS with dummy values based on the value of BOOL: 'yes' (default) or 'no'. ", 'y');
+    }
+
+    void parse_options(const command_line_parser& parser) override
+    {
+      super::parse_options(parser);
+      if (parser.options.count("strategy"))
+      {
+        try
+        {
+          m_strategy = parse_symbolic_reachability_strategy(parser.option_argument("strategy"));
+        }
+        catch (mcrl2::runtime_error&)
+        {
+          throw parser.error("Option --strategy has illegal argument '" + parser.option_argument("strategy") + "'.");
+        }
+      }
+      if (parser.options.count("cache-size"))
+      {
+        m_log_cache_size = parser.option_argument_as<std::size_t>("cache-size");
+        if (m_log_cache_size > 32)
+        {
+          throw parser.error("The argument of option --cache-size must be at most 32.");
+        }
+      }
+      if (parser.options.count("dummy"))
+      {
+        std::string dummy_str(parser.option_argument("dummy"));
+        if (dummy_str == "yes")
+        {
+          m_instantiate_global_variables = true;
+        }
+        else if (dummy_str == "no")
+        {
+          m_instantiate_global_variables = false;
+        }
+        else
+        {
+          throw parser.error("Option -y/--dummy has illegal argument '" + dummy_str + "'.");
+        }
+      }
+    }
+};
+
+int main(int argc, char** argv)
+{
+  return mcrl3reach_tool().execute(argc, argv);
+}